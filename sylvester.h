@@ -39,6 +39,11 @@
 #ifndef SYLVESTER_H
 #define SYLVESTER_H
 
+/* AVX paths use the SSE4 ones for 128 bit work */
+#if defined(SYL_ENABLE_AVX) && !defined(SYL_ENABLE_SSE4)
+#define SYL_ENABLE_SSE4
+#endif
+
 #if defined(SYL_ENABLE_AVX)
 #include <immintrin.h>
 #elif defined(SYL_ENABLE_SSE4)
@@ -49,16 +54,32 @@
 #include <math.h>
 #include <stdbool.h>
 
+#if defined(SYL_THREADS)
+#include <stdlib.h>
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+#if defined(SYL_PROFILE)
+#include <stdio.h>
+#include <stdlib.h>
+#include <x86intrin.h>
+#endif
+
 #if defined(__clang__)
 #	define _SYL_SET_SPEC_ALIGN(x) __attribute__((aligned(x)))
+#	define _SYL_FORCE_INLINE static inline __attribute__((always_inline))
 
 #elif defined(__GNUC__) || defined(__GNUG__)
 #	define _SYL_SET_SPEC_ALIGN(x) __attribute__((aligned(x)))
+#	define _SYL_FORCE_INLINE static inline __attribute__((always_inline))
 
 #elif defined(_MSC_VER)
 #	define _SYL_SET_SPEC_ALIGN(x) __declspec(align(x))
+#	define _SYL_FORCE_INLINE static __forceinline
 #else
 #	define _SYL_SET_SPEC_ALIGN(x)
+#	define _SYL_FORCE_INLINE static inline
 #endif
 
 #define SYL_INLINE
@@ -100,6 +121,16 @@ typedef union svec4
 #endif
 } _SYL_SET_SPEC_ALIGN(16) svec4;
 
+/* Quaternion, w is the scalar part */
+typedef union squat
+{
+	struct { float x; float y; float z; float w; };
+	float e[4];
+#if defined(SYL_ENABLE_SSE4)
+	__m128 v;
+#endif
+} _SYL_SET_SPEC_ALIGN(16) squat;
+
 /* We use column-major matricies */
 typedef union smat4
 {
@@ -121,6 +152,286 @@ typedef union smat4
 #endif
 } _SYL_SET_SPEC_ALIGN(16) smat4;
 
+/* Affine matrix stored as three rows, the last row is always (0, 0, 0, 1) */
+typedef union smat3x4
+{
+	struct
+	{
+		float m00, m01, m02, m03;
+		float m10, m11, m12, m13;
+		float m20, m21, m22, m23;
+	};
+	float e[12];
+	float e2[3][4];
+	svec4 v4d[3];
+#if defined(SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
+	__m128 v[3];
+#endif
+} _SYL_SET_SPEC_ALIGN(16) smat3x4;
+
+/* Position = Quantized * Scale + Offset, the same expression the shader decodes with */
+typedef struct squant_range
+{
+	svec3 Scale;
+	svec3 Offset;
+} squant_range;
+
+/* Structure of arrays particle buffers, the arrays are owned by the caller */
+typedef struct sparticles
+{
+	float* PosX;
+	float* PosY;
+	float* PosZ;
+	float* VelX;
+	float* VelY;
+	float* VelZ;
+	/* Only used by Verlet integration, can be NULL otherwise */
+	float* PrevX;
+	float* PrevY;
+	float* PrevZ;
+	float* Age;
+	float* Lifetime;
+	int Count;
+} sparticles;
+
+/* Drag pulls the velocity towards Wind, Drag * Dt should stay below 1 */
+typedef struct sparticle_forces
+{
+	svec3 Gravity;
+	svec3 Wind;
+	float Drag;
+} sparticle_forces;
+
+/* Octave settings for the noise functions, Ridged folds every octave into (1 - |n|)^2 */
+typedef struct snoise_fbm
+{
+	int Octaves;
+	float Frequency;
+	float Lacunarity;
+	float Gain;
+	bool Ridged;
+} snoise_fbm;
+
+#define _SYL_RAND_LANES 8
+
+/* xoshiro128+ state of 8 interleaved streams, one per SIMD lane */
+typedef struct srand_state
+{
+	unsigned int S[4][_SYL_RAND_LANES];
+} _SYL_SET_SPEC_ALIGN(32) srand_state;
+
+typedef enum sspline_type
+{
+	S_SPLINE_CATMULL_ROM,
+	S_SPLINE_BEZIER,
+	S_SPLINE_HERMITE,
+	S_SPLINE_BSPLINE
+} sspline_type;
+
+/* View over an svec2, svec3 or svec4 control point array, Dims floats per point */
+typedef struct sspline
+{
+	const float* Points;
+	int Count;
+	int Dims;
+	sspline_type Type;
+} sspline;
+
+/* Local transform, applied as scale, then rotation, then translation */
+typedef struct stransform
+{
+	svec3 Translation;
+	squat Rotation;
+	svec3 Scale;
+} stransform;
+
+/* Window rectangle and depth range points are mapped to, like glViewport and glDepthRange */
+typedef struct sviewport
+{
+	float X, Y, Width, Height;
+	float MinDepth, MaxDepth;
+} sviewport;
+
+/* Keyframe track, Values hold 3 floats per key for vectors and 4 for quaternions */
+typedef struct strack
+{
+	const float* Times;
+	const float* Values;
+	int KeyCount;
+	/* Key used by the last sample, makes coherent playback O(1) */
+	int Cursor;
+} strack;
+
+/* Interior node of a k-d tree, leaves are implied by the point range */
+typedef struct skdtree_node
+{
+	float Split;
+	int Axis;
+} skdtree_node;
+
+/*
+ * Static k-d tree over points. Points are stored again in tree order as
+ * structure of arrays, Index maps them back to the input array. All arrays
+ * live in the memory block passed to s_kdtree_build.
+ */
+typedef struct skdtree
+{
+	float *X, *Y, *Z;
+	int* Index;
+	skdtree_node* Nodes;
+	int Count;
+	int Depth;
+} skdtree;
+
+/* Pair of point indices found by a broad phase */
+typedef struct spair
+{
+	int A, B;
+} spair;
+
+/*
+ * Uniform grid hashed into buckets. Points are stored again sorted by bucket
+ * as structure of arrays, Index maps them back to the input array.
+ */
+typedef struct shashgrid
+{
+	float *X, *Y, *Z;
+	int* Index;
+	unsigned int* Keys;
+	int* Cells;
+	int Count;
+	int TableSize;
+	float CellSize;
+	float InvCellSize;
+} shashgrid;
+
+/*
+ * Sweep and prune over boxes. Bounds are kept sorted along the sweep axis as
+ * structure of arrays, Min[0] and Max[0] are the sweep axis and Order holds
+ * the body in every sorted slot.
+ */
+typedef struct ssap
+{
+	float *Min[3], *Max[3];
+	int* Order;
+	int Count;
+	int Axis;
+} ssap;
+
+typedef enum sconvex_type
+{
+	S_CONVEX_SPHERE,
+	S_CONVEX_BOX,
+	S_CONVEX_CAPSULE,
+	S_CONVEX_HULL,
+	S_CONVEX_CUSTOM
+} sconvex_type;
+
+/* Support point of a custom shape in its local space */
+typedef svec3 (*ssupport_fn)(svec3 Direction, const void* UserData);
+
+/*
+ * Convex shape for GJK. Transform places the shape in world space and Radius
+ * rounds it, a sphere is a point with a radius and a capsule a segment along
+ * the local y axis from -HalfHeight to HalfHeight. Boxes use Extents as half
+ * sizes, hulls use Points and custom shapes call Support.
+ */
+typedef struct sconvex
+{
+	sconvex_type Type;
+	smat3x4 Transform;
+	svec3 Extents;
+	float Radius;
+	float HalfHeight;
+	const svec3* Points;
+	int PointCount;
+	ssupport_fn Support;
+	const void* UserData;
+} sconvex;
+
+/* Search directions of the last simplex of a shape pair, zero it before the first query */
+typedef struct sgjk_cache
+{
+	svec3 Directions[4];
+	int Count;
+} sgjk_cache;
+
+/* Normal points from A to B, PointA - PointB is Normal * Depth when intersecting */
+typedef struct sgjk_result
+{
+	bool Intersect;
+	float Distance;
+	float Depth;
+	svec3 Normal;
+	svec3 PointA;
+	svec3 PointB;
+	int Iterations;
+} sgjk_result;
+
+/* Oriented box, Axes are the unit box axes in world space and Extents the half sizes along them */
+typedef struct sobb
+{
+	svec3 Center;
+	svec3 Extents;
+	svec3 Axes[3];
+} sobb;
+
+/* Boxes as structure of arrays for batch tests, Axes[k][c] is component c of axis k */
+typedef struct sobb_soa
+{
+	float *Center[3];
+	float *Extents[3];
+	float *Axes[3][3];
+	int Count;
+} sobb_soa;
+
+/* Sphere with a center and radius */
+typedef struct ssphere
+{
+	svec3 Center;
+	float Radius;
+} ssphere;
+
+/* Spheres as structure of arrays */
+typedef struct ssphere_soa
+{
+	float *X, *Y, *Z;
+	float* Radius;
+} ssphere_soa;
+
+/* Capsules as segments from P to Q with a radius, as structure of arrays */
+typedef struct scapsule_soa
+{
+	float *PX, *PY, *PZ;
+	float *QX, *QY, *QZ;
+	float* Radius;
+} scapsule_soa;
+
+/*
+ * Contacts of a batch of pairs. Distance is the gap between the surfaces and
+ * negative when they overlap, Normal points from A to B and Point is halfway
+ * between the surfaces. The Point arrays can be NULL.
+ */
+typedef struct scontact_soa
+{
+	float* Distance;
+	float *NormalX, *NormalY, *NormalZ;
+	float *PointX, *PointY, *PointZ;
+} scontact_soa;
+
+/*
+ * Triangles around every vertex, the triangles of vertex v are Triangles[Offsets[v]]
+ * up to Triangles[Offsets[v + 1]]. It is only read so meshes sharing a topology
+ * can share one adjacency across threads.
+ */
+typedef struct smesh_adjacency
+{
+	int* Offsets;
+	int* Triangles;
+	int VertexCount;
+	int TriangleCount;
+} smesh_adjacency;
+
 SYL_INLINE float s_radian_to_degree(float Radian);
 SYL_INLINE float s_degree_to_radian(float Degree);
 SYL_INLINE float s_roundf(float A);
@@ -156,7 +467,7 @@ SYL_INLINE double s_truncated(double Value, double Places);
 SYL_INLINE float s_normalize(float Value, float Min, float Max);
 SYL_INLINE float s_map(float Value, float SourceMin, float SourceMax, float DestMin, float DestMax);
 SYL_INLINE svec3 s_rgb_to_hsv(svec3 RGB);
-SYL_INLINE svec2 SVEC2F(float a, float b);
+SYL_INLINE svec2 SVEC2(float a, float b);
 SYL_INLINE svec2 SVEC2A(float* a);
 SYL_INLINE void s_vec2_zero(svec2* Vector);
 SYL_INLINE bool s_vec2_equal(svec2 vec1, svec2 Vec2);
@@ -252,7 +563,9 @@ SYL_INLINE float s_vec3_length(svec3 vec1);
 SYL_INLINE float s_vec3_distance(svec3 vec1, svec3 Vec2);
 SYL_INLINE svec3 s_vec3_normalize(svec3 a);
 SYL_INLINE float s_vec3_max(svec3 A);
+SYL_INLINE float s_vec3_min(svec3 A);
 SYL_INLINE float s_vec3_min_value(svec3 A);
+SYL_INLINE float s_vec3_sum(svec3 vec1);
 SYL_INLINE svec3 s_vec3_max_vector(svec3 vec1, svec3 Vec2);
 SYL_INLINE svec3 s_vec3_min_vector(svec3 vec1, svec3 Vec2);
 SYL_INLINE svec3 s_vec3_clamp(svec3 Value, svec3 Min, svec3 Max);
@@ -311,7 +624,7 @@ SYL_INLINE float s_vec4_max(svec4 A);
 SYL_INLINE float s_vec4_min(svec4 A);
 SYL_INLINE float s_vec4_sum(svec4 vec1);
 SYL_INLINE smat4 SMAT4(float value);
-SYL_INLINE smat4 SMAT4V(float m00, float m01, float m02, float m03,
+SYL_INLINE smat4 SMAT4F(float m00, float m01, float m02, float m03,
 		       float m10, float m11, float m12, float m13,
 		       float m20, float m21, float m22, float m23,
 		       float m30, float m31, float m32, float m33);
@@ -335,11 +648,179 @@ SYL_INLINE smat4 s_mat4_zrotation(float Angle);
 SYL_INLINE smat4 s_mat4_translation(svec3 Vector);
 SYL_INLINE smat4 s_mat4_perspective_projection_rh(float Fov, float AspectRatio, float NearClipPlane, float FarClipPlane);
 SYL_INLINE smat4 s_mat4_ortho_rh(float left, float right, float bottom, float top, float znear, float zfar);
+SYL_INLINE smat3x4 s_mat3x4_identity();
+SYL_INLINE smat3x4 s_mat3x4_from_mat4(smat4 Matrix);
+SYL_INLINE smat4 s_mat4_from_mat3x4(smat3x4 Matrix);
+SYL_INLINE smat3x4 s_mat3x4_mul(smat3x4 Matrix1, smat3x4 Matrix2);
+SYL_INLINE void s_mat3x4_mul_array(const smat3x4* Matrices1, const smat3x4* Matrices2, smat3x4* Out, int Count);
+SYL_INLINE smat3x4 s_mat3x4_inverse(smat3x4 Matrix);
+SYL_INLINE svec3 s_mat3x4_transform_point(smat3x4 Matrix, svec3 Point);
+SYL_INLINE svec3 s_mat3x4_transform_vector(smat3x4 Matrix, svec3 Vector);
+SYL_INLINE void s_pack_unorm8(const float* Src, unsigned char* Dst, int Count);
+SYL_INLINE void s_pack_snorm8(const float* Src, signed char* Dst, int Count);
+SYL_INLINE void s_pack_unorm16(const float* Src, unsigned short* Dst, int Count);
+SYL_INLINE void s_pack_snorm16(const float* Src, short* Dst, int Count);
+SYL_INLINE void s_unpack_unorm8(const unsigned char* Src, float* Dst, int Count);
+SYL_INLINE void s_unpack_snorm8(const signed char* Src, float* Dst, int Count);
+SYL_INLINE void s_unpack_unorm16(const unsigned short* Src, float* Dst, int Count);
+SYL_INLINE void s_unpack_snorm16(const short* Src, float* Dst, int Count);
+SYL_INLINE void s_vec4_pack_unorm1010102(const svec4* Src, unsigned int* Dst, int Count);
+SYL_INLINE void s_vec4_pack_snorm1010102(const svec4* Src, unsigned int* Dst, int Count);
+SYL_INLINE void s_vec4_unpack_unorm1010102(const unsigned int* Src, svec4* Dst, int Count);
+SYL_INLINE void s_vec4_unpack_snorm1010102(const unsigned int* Src, svec4* Dst, int Count);
+SYL_INLINE squant_range s_quant_range_from_aabb(svec3 Min, svec3 Max);
+SYL_INLINE squant_range s_quant_range_from_points(const svec3* Points, int Count);
+SYL_INLINE void s_vec3_pack_position_unorm16(const svec3* Src, unsigned short* Dst, int Count, squant_range Range);
+SYL_INLINE void s_vec3_unpack_position_unorm16(const unsigned short* Src, svec3* Dst, int Count, squant_range Range);
+SYL_INLINE void s_particles_integrate_euler(sparticles* Particles, int Begin, int End, sparticle_forces Forces, float Dt);
+SYL_INLINE void s_particles_integrate_verlet(sparticles* Particles, int Begin, int End, sparticle_forces Forces, float Dt);
+SYL_INLINE int s_particles_compact(sparticles* Particles, const svec3* KillMin, const svec3* KillMax, int KillCount);
+SYL_INLINE float s_noise_perlin2(svec2 P, int Seed);
+SYL_INLINE float s_noise_perlin3(svec3 P, int Seed);
+SYL_INLINE float s_noise_perlin4(svec4 P, int Seed);
+SYL_INLINE float s_noise_simplex2(svec2 P, int Seed);
+SYL_INLINE float s_noise_simplex3(svec3 P, int Seed);
+SYL_INLINE float s_noise_simplex4(svec4 P, int Seed);
+SYL_INLINE void s_noise_perlin2_array(const float* X, const float* Y, float* Out, int Count, int Seed, const snoise_fbm* Fbm);
+SYL_INLINE void s_noise_perlin3_array(const float* X, const float* Y, const float* Z, float* Out, int Count, int Seed, const snoise_fbm* Fbm);
+SYL_INLINE void s_noise_perlin4_array(const float* X, const float* Y, const float* Z, const float* W, float* Out, int Count, int Seed, const snoise_fbm* Fbm);
+SYL_INLINE void s_noise_simplex2_array(const float* X, const float* Y, float* Out, int Count, int Seed, const snoise_fbm* Fbm);
+SYL_INLINE void s_noise_simplex3_array(const float* X, const float* Y, const float* Z, float* Out, int Count, int Seed, const snoise_fbm* Fbm);
+SYL_INLINE void s_noise_simplex4_array(const float* X, const float* Y, const float* Z, const float* W, float* Out, int Count, int Seed, const snoise_fbm* Fbm);
+SYL_INLINE void s_noise_perlin2_deriv_array(const float* X, const float* Y, float* Out, float* OutDX, float* OutDY, int Count, int Seed, const snoise_fbm* Fbm);
+SYL_INLINE void s_noise_perlin3_deriv_array(const float* X, const float* Y, const float* Z, float* Out, float* OutDX, float* OutDY, float* OutDZ, int Count, int Seed, const snoise_fbm* Fbm);
+SYL_INLINE void s_noise_simplex2_deriv_array(const float* X, const float* Y, float* Out, float* OutDX, float* OutDY, int Count, int Seed, const snoise_fbm* Fbm);
+SYL_INLINE void s_noise_simplex3_deriv_array(const float* X, const float* Y, const float* Z, float* Out, float* OutDX, float* OutDY, float* OutDZ, int Count, int Seed, const snoise_fbm* Fbm);
+SYL_INLINE void s_noise_perlin2_grid(float* Out, int Width, int Height, svec2 Origin, float Step, int Seed, const snoise_fbm* Fbm);
+SYL_INLINE void s_noise_perlin3_grid(float* Out, int Width, int Height, int Depth, svec3 Origin, float Step, int Seed, const snoise_fbm* Fbm);
+SYL_INLINE void s_noise_simplex2_grid(float* Out, int Width, int Height, svec2 Origin, float Step, int Seed, const snoise_fbm* Fbm);
+SYL_INLINE void s_noise_simplex3_grid(float* Out, int Width, int Height, int Depth, svec3 Origin, float Step, int Seed, const snoise_fbm* Fbm);
+SYL_INLINE void s_rand_init(srand_state* State, unsigned long long Seed);
+SYL_INLINE void s_rand_jump(srand_state* State);
+SYL_INLINE void s_rand_uint(srand_state* State, unsigned int* Out, int Count);
+SYL_INLINE void s_rand_float(srand_state* State, float* Out, int Count);
+SYL_INLINE void s_rand_unit_disk(srand_state* State, float* X, float* Y, int Count);
+SYL_INLINE void s_rand_unit_sphere(srand_state* State, float* X, float* Y, float* Z, int Count);
+SYL_INLINE void s_rand_hemisphere(srand_state* State, float* X, float* Y, float* Z, int Count);
+SYL_INLINE void s_rand_cosine_hemisphere(srand_state* State, float* X, float* Y, float* Z, int Count);
+SYL_INLINE void s_rand_rotation(srand_state* State, squat* Out, int Count);
+SYL_INLINE sspline s_spline_vec2(const svec2* Points, int Count, sspline_type Type);
+SYL_INLINE sspline s_spline_vec3(const svec3* Points, int Count, sspline_type Type);
+SYL_INLINE sspline s_spline_vec4(const svec4* Points, int Count, sspline_type Type);
+SYL_INLINE int s_spline_segments(const sspline* Spline);
+SYL_INLINE void s_spline_eval(const sspline* Spline, const float* T, int Count, float* OutPos, float* OutTangent);
+SYL_INLINE float s_spline_build_arclength(const sspline* Spline, float* Table, int TableCount);
+SYL_INLINE void s_spline_distance_to_t(const float* Table, int TableCount, const float* Distance, float* OutT, int Count);
+SYL_INLINE void s_spline_sample_constant_speed(const sspline* Spline, const float* Table, int TableCount, int Count, float* OutPos, float* OutTangent);
+SYL_INLINE strack s_track(const float* Times, const float* Values, int KeyCount);
+SYL_INLINE void s_tracks_sample_vec3(strack* Tracks, int Count, float Time, svec3* Out, size_t Stride);
+SYL_INLINE void s_tracks_sample_quat(strack* Tracks, int Count, float Time, squat* Out, size_t Stride);
+SYL_INLINE void s_tracks_sample_transforms(strack* Translation, strack* Rotation, strack* Scale, int Count, float Time, stransform* Out);
+SYL_INLINE stransform s_mat4_decompose(smat4 Matrix);
+SYL_INLINE void s_mat4_decompose_array(const smat4* Matrices, stransform* Out, int Count);
+SYL_INLINE smat4 s_mat4_from_trs(svec3 Translation, squat Rotation, svec3 Scale);
+SYL_INLINE void s_mat4_from_trs_array(const stransform* Transforms, smat4* Out, smat4* OutInverse, int Count);
+SYL_INLINE int s_project_points(smat4 ViewProjection, sviewport Viewport, const svec3* Points, svec3* Out, unsigned char* Clipped, int Count);
+SYL_INLINE int s_unproject_points(smat4 ViewProjection, sviewport Viewport, const svec3* Points, svec3* Out, unsigned char* Clipped, int Count);
+SYL_INLINE void s_vec3_normalize_array(const svec3* In, svec3* Out, int Count, bool Precise);
+SYL_INLINE void s_vec3_length_array(const svec3* In, float* Out, int Count, bool Precise);
+SYL_INLINE void s_vec3_dot_array(const svec3* A, const svec3* B, float* Out, int Count);
+SYL_INLINE void s_vec4_normalize_array(const svec4* In, svec4* Out, int Count, bool Precise);
+SYL_INLINE void s_vec4_length_array(const svec4* In, float* Out, int Count, bool Precise);
+SYL_INLINE void s_vec4_dot_array(const svec4* A, const svec4* B, float* Out, int Count);
+SYL_INLINE void s_vec3_normalize_soa(const float* X, const float* Y, const float* Z, float* OutX, float* OutY, float* OutZ, int Count, bool Precise);
+SYL_INLINE void s_vec3_length_soa(const float* X, const float* Y, const float* Z, float* Out, int Count, bool Precise);
+SYL_INLINE void s_vec3_dot_soa(const float* AX, const float* AY, const float* AZ, const float* BX, const float* BY, const float* BZ, float* Out, int Count);
+SYL_INLINE void s_vec4_normalize_soa(const float* X, const float* Y, const float* Z, const float* W, float* OutX, float* OutY, float* OutZ, float* OutW, int Count, bool Precise);
+SYL_INLINE void s_vec4_length_soa(const float* X, const float* Y, const float* Z, const float* W, float* Out, int Count, bool Precise);
+SYL_INLINE void s_vec4_dot_soa(const float* AX, const float* AY, const float* AZ, const float* AW, const float* BX, const float* BY, const float* BZ, const float* BW, float* Out, int Count);
+SYL_INLINE svec2 s_vec2_min_array(const svec2* In, int Count);
+SYL_INLINE svec2 s_vec2_max_array(const svec2* In, int Count);
+SYL_INLINE void s_vec2_bounds_array(const svec2* In, int Count, svec2* Min, svec2* Max);
+SYL_INLINE svec2 s_vec2_sum_array(const svec2* In, int Count);
+SYL_INLINE svec2 s_vec2_mean_array(const svec2* In, int Count);
+SYL_INLINE svec2 s_vec2_centroid_array(const svec2* In, const float* Weights, int Count);
+SYL_INLINE svec3 s_vec3_min_array(const svec3* In, int Count);
+SYL_INLINE svec3 s_vec3_max_array(const svec3* In, int Count);
+SYL_INLINE void s_vec3_bounds_array(const svec3* In, int Count, svec3* Min, svec3* Max);
+SYL_INLINE svec3 s_vec3_sum_array(const svec3* In, int Count);
+SYL_INLINE svec3 s_vec3_mean_array(const svec3* In, int Count);
+SYL_INLINE svec3 s_vec3_centroid_array(const svec3* In, const float* Weights, int Count);
+SYL_INLINE svec4 s_vec4_min_array(const svec4* In, int Count);
+SYL_INLINE svec4 s_vec4_max_array(const svec4* In, int Count);
+SYL_INLINE void s_vec4_bounds_array(const svec4* In, int Count, svec4* Min, svec4* Max);
+SYL_INLINE svec4 s_vec4_sum_array(const svec4* In, int Count);
+SYL_INLINE svec4 s_vec4_mean_array(const svec4* In, int Count);
+SYL_INLINE svec4 s_vec4_centroid_array(const svec4* In, const float* Weights, int Count);
+SYL_INLINE size_t s_kdtree_memory_size(int Count);
+SYL_INLINE void s_kdtree_build(skdtree* Tree, void* Memory, const svec3* Points, int Count);
+SYL_INLINE int s_kdtree_nearest(const skdtree* Tree, svec3 Point, int K, int* OutIndex, float* OutDistanceSq);
+SYL_INLINE int s_kdtree_radius(const skdtree* Tree, svec3 Point, float Radius, int* OutIndex, float* OutDistanceSq, int Capacity);
+SYL_INLINE void s_kdtree_nearest_batch(const skdtree* Tree, const svec3* Points, int Count, int K, int* OutIndex, float* OutDistanceSq);
+SYL_INLINE void s_kdtree_radius_batch(const skdtree* Tree, const svec3* Points, int Count, float Radius, int* OutIndex, float* OutDistanceSq, int Capacity, int* OutCount);
+SYL_INLINE size_t s_hashgrid_memory_size(int Count);
+SYL_INLINE void s_hashgrid_build(shashgrid* Grid, void* Memory, const svec3* Points, int Count, float CellSize);
+SYL_INLINE int s_hashgrid_radius(const shashgrid* Grid, svec3 Point, float Radius, int* OutIndex, int Capacity);
+SYL_INLINE int s_hashgrid_pairs(const shashgrid* Grid, float Radius, int Begin, int End, spair* Out, int Capacity);
+SYL_INLINE size_t s_sap_memory_size(int Count);
+SYL_INLINE void s_sap_init(ssap* Sap, void* Memory, int Count);
+SYL_INLINE void s_sap_update(ssap* Sap, const svec3* Min, const svec3* Max);
+SYL_INLINE int s_sap_pairs(const ssap* Sap, int Begin, int End, spair* Out, int Capacity);
+SYL_INLINE svec3 s_convex_support(const sconvex* Shape, svec3 Direction);
+SYL_INLINE bool s_gjk_intersect(const sconvex* A, const sconvex* B, sgjk_cache* Cache);
+SYL_INLINE bool s_gjk_distance(const sconvex* A, const sconvex* B, sgjk_cache* Cache, sgjk_result* Result);
+SYL_INLINE bool s_gjk_penetration(const sconvex* A, const sconvex* B, sgjk_cache* Cache, sgjk_result* Result);
+SYL_INLINE sobb s_obb_from_quat(svec3 Center, svec3 Extents, squat Rotation);
+SYL_INLINE size_t s_obb_soa_memory_size(int Count);
+SYL_INLINE void s_obb_soa_build(sobb_soa* Soa, void* Memory, const sobb* Boxes, int Count);
+SYL_INLINE int s_obb_overlap_batch(const sobb* Box, const sobb_soa* Boxes, int Begin, int End, int* OutIndex, svec3* OutNormal, float* OutDepth, int Capacity);
+SYL_INLINE int s_sphere_sphere_batch(const ssphere_soa* A, const ssphere_soa* B, int Begin, int End, scontact_soa* Out);
+SYL_INLINE int s_sphere_capsule_batch(const ssphere_soa* A, const scapsule_soa* B, int Begin, int End, scontact_soa* Out);
+SYL_INLINE int s_capsule_capsule_batch(const scapsule_soa* A, const scapsule_soa* B, int Begin, int End, scontact_soa* Out);
+SYL_INLINE size_t s_mesh_adjacency_memory_size(int VertexCount, int TriangleCount);
+SYL_INLINE void s_mesh_adjacency_build(smesh_adjacency* Adjacency, void* Memory, const unsigned int* Indices, int VertexCount, int TriangleCount);
+SYL_INLINE size_t s_mesh_scratch_size(int TriangleCount);
+SYL_INLINE void s_mesh_normals(const svec3* Positions, const unsigned int* Indices, int VertexCount, int TriangleCount, const smesh_adjacency* Adjacency, void* Scratch, svec3* OutNormals);
+SYL_INLINE void s_mesh_tangents(const svec3* Positions, const svec3* Normals, const svec2* UVs, const unsigned int* Indices, int VertexCount, int TriangleCount, const smesh_adjacency* Adjacency, void* Scratch, svec4* OutTangents);
+SYL_INLINE ssphere s_bounding_sphere(const svec3* Points, int Count, int Iterations);
+SYL_INLINE sobb s_bounding_obb(const svec3* Points, int Count);
+
+#if defined(SYL_THREADS)
+/* Called for every chunk, End - Begin is at most Grain */
+typedef void (*sparallel_fn)(int Begin, int End, int WorkerIndex, void* UserData);
+
+SYL_INLINE bool s_threads_init(int WorkerCount, size_t ScratchSize);
+SYL_INLINE void s_threads_shutdown(void);
+SYL_INLINE int s_threads_count(void);
+SYL_INLINE void* s_threads_scratch(int WorkerIndex, size_t* Size);
+SYL_INLINE void s_parallel_for(int Count, int Grain, sparallel_fn Fn, void* UserData);
+#endif
+
+#if defined(SYL_PROFILE)
+typedef struct sprofile_entry
+{
+	const char* Name;
+	unsigned long long Calls;
+	unsigned long long Cycles;
+} sprofile_entry;
+
+SYL_INLINE int s_profile_collect(sprofile_entry* Out, int Capacity);
+SYL_INLINE void s_profile_report(void);
+SYL_INLINE void s_profile_reset(void);
+#endif
+
+#ifdef __cplusplus
+_SYL_CPP_EXTERN_END
+#endif
 
 #endif // SYLVESTER_H
 
 #ifdef SYL_IMPLEMENTATION
 
+#ifdef __cplusplus
+_SYL_CPP_EXTER_START
+#endif
+
 #define SYL_PI 3.14159265359f
 
 #define _SYL_SHUFFLE(a,b,c,d) (((a) << 6) | ((b) << 4) |	\
@@ -364,6 +845,8 @@ SYL_INLINE smat4 s_mat4_ortho_rh(float left, float right, float bottom, float to
 #define _SYL_VEC_SHUFFLE_0101(vec1, vec2)        _mm_movelh_ps(vec1, vec2)
 #define _SYL_VEC_SHUFFLE_2323(vec1, vec2)        _mm_movehl_ps(vec2, vec1)
 #define _SYL_SMALL_NUMBER		(1.e-8f)
+/* Squared lengths below this are treated as zero, 1e-15 as a length */
+#define _SYL_VEC_EPSILON_SQ 1e-30f
 
 #ifdef SYL_GENERIC_FUNCTIONS
 
@@ -679,14 +1162,189 @@ const __m128 _S_IDENT4x4R0 = { 1.0f, 0.0f, 0.0f, 0.0f };
 const __m128 _S_IDENT4x4R1 = { 0.0f, 1.0f, 0.0f, 0.0f };
 const __m128 _S_IDENT4x4R2 = { 0.0f, 0.0f, 1.0f, 0.0f };
 const __m128 _S_IDENT4x4R3 = { 0.0f, 0.0f, 0.0f, 1.0f };
-const __m128 _S_XMM_MASK_3 = { (float)0xFFFFFFFF, (float)0xFFFFFFFF, (float)0xFFFFFFFF, (float)0x00000000 };
-const __m128 _S_XMM_MASK_Y = { 0x00000000, (float)0xFFFFFFFF, 0x00000000, 0x00000000 };
 #endif
 
 #if defined(SYL_ENABLE_AVX)
-const __m256 _S_YMM_ZERO = { { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f } };
+const __m256 _S_YMM_ZERO = { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f };
 #endif
 
+#if defined(SYL_ENABLE_SSE4)
+/* svec3 is 12 bytes and 4 byte aligned, never load or store it as 16 */
+_SYL_FORCE_INLINE __m128 _s_load_vec3(const svec3* Vector)
+{
+	__m128 xy = _mm_castpd_ps(_mm_load_sd((const double*)Vector->e));
+	return(_mm_movelh_ps(xy, _mm_load_ss(Vector->e + 2)));
+}
+
+_SYL_FORCE_INLINE svec3 _s_store_vec3(__m128 Value)
+{
+	svec3 Result;
+	_mm_storel_pi((__m64*)Result.e, Value);
+	_mm_store_ss(Result.e + 2, _mm_movehl_ps(Value, Value));
+	return(Result);
+}
+#endif
+
+/*********************************************
+ *                  PROFILE                   *
+ *********************************************/
+
+#if defined(SYL_PROFILE)
+
+/*
+ * Every public function starts with _SYL_PROFILE, which owns a static site
+ * that gets a slot the first time the function runs. Counters live in a
+ * block per thread so the hot path never writes shared memory. Blocks are
+ * pushed on a global list the first time a thread enters a profiled
+ * function and are only merged by s_profile_collect. Cycles are inclusive,
+ * a function that calls other sylvester functions also counts theirs.
+ */
+
+#define _SYL_PROFILE_MAX_SITES 1024
+
+typedef struct _sprofile_site
+{
+	const char* Name;
+	int Index;
+} _sprofile_site;
+
+typedef struct _sprofile_thread
+{
+	unsigned long long Calls[_SYL_PROFILE_MAX_SITES];
+	unsigned long long Cycles[_SYL_PROFILE_MAX_SITES];
+	struct _sprofile_thread* Next;
+} _sprofile_thread;
+
+typedef struct _sprofile_scope
+{
+	unsigned long long* Cycles;
+	unsigned long long Start;
+} _sprofile_scope;
+
+const char* _S_PROFILE_NAMES[_SYL_PROFILE_MAX_SITES];
+int _S_PROFILE_SITES;
+_sprofile_thread* _S_PROFILE_THREADS;
+__thread _sprofile_thread* _s_profile_thread;
+
+/* Returns the slot of the site, negative while another thread is registering it */
+SYL_INLINE int _s_profile_register(_sprofile_site* Site)
+{
+	int Index = -1;
+	if (!__atomic_compare_exchange_n(&Site->Index, &Index, -2, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+		return(Index);
+
+	Index = __atomic_fetch_add(&_S_PROFILE_SITES, 1, __ATOMIC_ACQ_REL);
+	if (Index >= _SYL_PROFILE_MAX_SITES)
+		return(-2);
+
+	__atomic_store_n(&_S_PROFILE_NAMES[Index], Site->Name, __ATOMIC_RELEASE);
+	__atomic_store_n(&Site->Index, Index, __ATOMIC_RELEASE);
+	return(Index);
+}
+
+/* Blocks are never freed so the counts of finished threads are kept */
+SYL_INLINE _sprofile_thread* _s_profile_attach(void)
+{
+	_sprofile_thread* Thread = (_sprofile_thread*)calloc(1, sizeof(_sprofile_thread));
+	if (!Thread)
+		return(NULL);
+
+	Thread->Next = __atomic_load_n(&_S_PROFILE_THREADS, __ATOMIC_ACQUIRE);
+	while (!__atomic_compare_exchange_n(&_S_PROFILE_THREADS, &Thread->Next, Thread, true, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE));
+	_s_profile_thread = Thread;
+	return(Thread);
+}
+
+SYL_INLINE _sprofile_scope _s_profile_enter(_sprofile_site* Site)
+{
+	_sprofile_scope Scope = { NULL, 0 };
+	int Index = __atomic_load_n(&Site->Index, __ATOMIC_ACQUIRE);
+	if (Index < 0 && (Index = _s_profile_register(Site)) < 0)
+		return(Scope);
+
+	_sprofile_thread* Thread = _s_profile_thread;
+	if (!Thread && !(Thread = _s_profile_attach()))
+		return(Scope);
+
+	Thread->Calls[Index]++;
+	Scope.Cycles = &Thread->Cycles[Index];
+	Scope.Start = __rdtsc();
+	return(Scope);
+}
+
+SYL_INLINE void _s_profile_leave(_sprofile_scope* Scope)
+{
+	if (Scope->Cycles)
+		*Scope->Cycles += __rdtsc() - Scope->Start;
+}
+
+#define _SYL_PROFILE(Name)						\
+	static _sprofile_site _s_profile_site = { #Name, -1 };		\
+	_sprofile_scope _s_profile_scope __attribute__((cleanup(_s_profile_leave))) = _s_profile_enter(&_s_profile_site)
+
+SYL_INLINE int s_profile_collect(sprofile_entry* Out, int Capacity)
+{
+	int Sites = __atomic_load_n(&_S_PROFILE_SITES, __ATOMIC_ACQUIRE);
+	if (Sites > _SYL_PROFILE_MAX_SITES)
+		Sites = _SYL_PROFILE_MAX_SITES;
+
+	int Count = 0;
+	for (int i = 0; i < Sites; ++i) {
+		sprofile_entry Entry = { __atomic_load_n(&_S_PROFILE_NAMES[i], __ATOMIC_ACQUIRE), 0, 0 };
+		if (!Entry.Name)
+			continue;
+
+		_sprofile_thread* Thread = __atomic_load_n(&_S_PROFILE_THREADS, __ATOMIC_ACQUIRE);
+		for (; Thread; Thread = Thread->Next) {
+			Entry.Calls += Thread->Calls[i];
+			Entry.Cycles += Thread->Cycles[i];
+		}
+		if (!Entry.Calls)
+			continue;
+
+		/* Insertion keeps the heaviest Capacity entries sorted by cycles */
+		int At = Count;
+		while (At > 0 && Out[At - 1].Cycles < Entry.Cycles)
+			--At;
+		if (At >= Capacity)
+			continue;
+		if (Count < Capacity)
+			++Count;
+		memmove(Out + At + 1, Out + At, (Count - 1 - At) * sizeof(sprofile_entry));
+		Out[At] = Entry;
+	}
+	return(Count);
+}
+
+SYL_INLINE void s_profile_report(void)
+{
+	sprofile_entry* Entries = (sprofile_entry*)malloc(_SYL_PROFILE_MAX_SITES * sizeof(sprofile_entry));
+	if (!Entries)
+		return;
+
+	int Count = s_profile_collect(Entries, _SYL_PROFILE_MAX_SITES);
+	printf("%-40s %14s %18s %12s\n", "function", "calls", "cycles", "cycles/call");
+	for (int i = 0; i < Count; ++i) {
+		printf("%-40s %14llu %18llu %12.1f\n", Entries[i].Name, Entries[i].Calls, Entries[i].Cycles,
+		       (double)Entries[i].Cycles / (double)Entries[i].Calls);
+	}
+	free(Entries);
+}
+
+/* Not synchronized with profiled calls running on other threads */
+SYL_INLINE void s_profile_reset(void)
+{
+	_sprofile_thread* Thread = __atomic_load_n(&_S_PROFILE_THREADS, __ATOMIC_ACQUIRE);
+	for (; Thread; Thread = Thread->Next) {
+		memset(Thread->Calls, 0, sizeof(Thread->Calls));
+		memset(Thread->Cycles, 0, sizeof(Thread->Cycles));
+	}
+}
+
+#else
+#define _SYL_PROFILE(Name)
+#endif // SYL_PROFILE
+
 /*********************************************
  *                 Utility                   *
  *********************************************/
@@ -694,47 +1352,56 @@ const __m256 _S_YMM_ZERO = { { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f }
 
 SYL_INLINE float s_radian_to_degree(float Radian)
 {
+	_SYL_PROFILE(s_radian_to_degree);
 	return(Radian * (180 / SYL_PI));
 }
 
 SYL_INLINE float s_degree_to_radian(float Degree)
 {
+	_SYL_PROFILE(s_degree_to_radian);
 	return (Degree * (SYL_PI / 180));
 }
 
 SYL_INLINE float s_roundf(float A)
 {
+	_SYL_PROFILE(s_roundf);
 	return((int)(A + 0.5f));
 }
 
 SYL_INLINE double s_roundd(double A)
 {
+	_SYL_PROFILE(s_roundd);
 	return((int)(A + 0.5f));
 }
 
 SYL_INLINE float s_ceilf(float A)
 {
+	_SYL_PROFILE(s_ceilf);
 	return((int)(A + 1.0f));
 }
 
 SYL_INLINE double s_ceild(double A)
 {
+	_SYL_PROFILE(s_ceild);
 	return((int)(A + 1.0f));
 }
 
 SYL_INLINE float s_floorf(float A)
 {
+	_SYL_PROFILE(s_floorf);
 	return((int)A);
 }
 
 SYL_INLINE double s_floord(double A)
 {
+	_SYL_PROFILE(s_floord);
 	return((int)A);
 }
 
 /* Unpack four 8-bit BGRA values into vec4 */
 SYL_INLINE svec4 s_bgra_unpack(int Color)
 {
+	_SYL_PROFILE(s_bgra_unpack);
 	svec4 Result = { {
 			(float)((Color >> 16) & 0xFF),
 			(float)((Color >> 8) & 0xFF),
@@ -747,6 +1414,7 @@ SYL_INLINE svec4 s_bgra_unpack(int Color)
 /* Pack four 8-bit RGB values */
 SYL_INLINE unsigned int s_bgra_pack(svec4 Color)
 {
+	_SYL_PROFILE(s_bgra_pack);
 	unsigned int Result =
 		((unsigned int)(Color.a) << 24) |
 		((unsigned int)(Color.r) << 16) |
@@ -758,6 +1426,7 @@ SYL_INLINE unsigned int s_bgra_pack(svec4 Color)
 /* Unpack four 8-bit RGBA values into vec4 */
 SYL_INLINE svec4 s_rgba_unpack(unsigned int Color)
 {
+	_SYL_PROFILE(s_rgba_unpack);
 	svec4 Result = { {
 			(float)((Color >> 24) & 0xFF),
 			(float)((Color >> 16) & 0xFF),
@@ -770,6 +1439,7 @@ SYL_INLINE svec4 s_rgba_unpack(unsigned int Color)
 /* Pack four 8-bit RGBA values */
 SYL_INLINE unsigned int s_rgba_pack(svec4 Color)
 {
+	_SYL_PROFILE(s_rgba_pack);
 	unsigned int Result =
 		((unsigned int)(Color.a) << 24) |
 		((unsigned int)(Color.b) << 16) |
@@ -782,6 +1452,7 @@ SYL_INLINE unsigned int s_rgba_pack(svec4 Color)
 
 SYL_INLINE float s_clampf(float Value, float Min, float Max)
 {
+	_SYL_PROFILE(s_clampf);
 	float Result = Value;
 
 	if (Result < Min)
@@ -794,6 +1465,7 @@ SYL_INLINE float s_clampf(float Value, float Min, float Max)
 
 SYL_INLINE float s_clampd(float Value, float Min, float Max)
 {
+	_SYL_PROFILE(s_clampd);
 	float Result = Value;
 
 	if (Result < Min)
@@ -806,6 +1478,7 @@ SYL_INLINE float s_clampd(float Value, float Min, float Max)
 
 SYL_INLINE int s_clampi(int Value, int Min, int Max)
 {
+	_SYL_PROFILE(s_clampi);
 	int Result = Value;
 
 	if (Result < Min)
@@ -818,55 +1491,65 @@ SYL_INLINE int s_clampi(int Value, int Min, int Max)
 
 SYL_INLINE float s_clamp01f(float Value)
 {
+	_SYL_PROFILE(s_clamp01f);
 	return(s_clampf(0.0f, Value, 1.0f));
 }
 
 SYL_INLINE double s_clamp01d(double Value)
 {
+	_SYL_PROFILE(s_clamp01d);
 	return(s_clampf(0.0f, Value, 1.0f));
 }
 
 SYL_INLINE float s_clamp_above_zero(float Value)
 {
+	_SYL_PROFILE(s_clamp_above_zero);
 	return (Value < 0) ? 0.0f : Value;
 }
 
 SYL_INLINE float s_clamp_below_zero(float Value)
 {
+	_SYL_PROFILE(s_clamp_below_zero);
 	return (Value > 0) ? 0.0f : Value;
 }
 
 SYL_INLINE bool s_is_in_range(float Value, float Min, float Max)
 {
+	_SYL_PROFILE(s_is_in_range);
 	return(((Min <= Value) && (Value <= Max)));
 }
 
 SYL_INLINE float s_lerp(float A, float t, float B)
 {
+	_SYL_PROFILE(s_lerp);
 	return (1.0f - t) * A + t * B;
 }
 
 /* It is handy to type square if the expression happens to be very long */
 SYL_INLINE float s_square(float x)
 {
+	_SYL_PROFILE(s_square);
 	return(x * x);
 }
 
 /* Absoule value */
 SYL_INLINE float s_abs(float x)
 {
+	_SYL_PROFILE(s_abs);
 	return *((unsigned int*)(&x)) &= 0xffffffff >> 1;
 }
 
 /* Find the hypotenuse of a triangle given two other sides */
 SYL_INLINE float s_pythagorean(float x, float y)
 {
+	_SYL_PROFILE(s_pythagorean);
 	return sqrt(x * x + y * y);
 }
 
 /* Maximum of two values */
 SYL_INLINE float s_maxf(float x, float y)
 {
+	_SYL_PROFILE(s_maxf);
 	if (x > y)
 		return(x);
 	return(y);
@@ -874,6 +1557,7 @@ SYL_INLINE float s_maxf(float x, float y)
 
 SYL_INLINE int s_maxi(int x, int y)
 {
+	_SYL_PROFILE(s_maxi);
 	if (x > y)
 		return(x);
 	return(y);
@@ -881,6 +1565,7 @@ SYL_INLINE int s_maxi(int x, int y)
 
 SYL_INLINE int s_mini(int x, int y)
 {
+	_SYL_PROFILE(s_mini);
 	if (x < y)
 		return(x);
 	return(y);
@@ -888,6 +1573,7 @@ SYL_INLINE int s_mini(int x, int y)
 
 SYL_INLINE float s_minf(float x, float y)
 {
+	_SYL_PROFILE(s_minf);
 	if (x < y)
 		return(x);
 	return(y);
@@ -895,11 +1581,13 @@ SYL_INLINE float s_minf(float x, float y)
 
 SYL_INLINE float s_mod(float x, float y)
 {
+	_SYL_PROFILE(s_mod);
 	return(x - (s_roundf(x / y) * y));
 }
 
 SYL_INLINE float s_pow(float Value, float Times)
 {
+	_SYL_PROFILE(s_pow);
 	float pow = 1;
 	for (int i = 0; i < Times; i++) {
 		pow = pow * Value;
@@ -910,28 +1598,33 @@ SYL_INLINE float s_pow(float Value, float Times)
 /* Places -> How many digits you want to keep remained */
 SYL_INLINE float s_truncatef(float Value, float Remain)
 {
+	_SYL_PROFILE(s_truncatef);
 	int Remove = s_pow(10, Remain);
 	return(s_roundf(Value * Remove) / Remove);
 }
 
 SYL_INLINE double s_truncated(double Value, double Places)
 {
+	_SYL_PROFILE(s_truncated);
 	int Remove = pow(10, Places);
 	return(s_roundf(Value * Remove) / Remove);
 }
 
 SYL_INLINE float s_normalize(float Value, float Min, float Max)
 {
+	_SYL_PROFILE(s_normalize);
 	return (Value - Min) / (Max - Min);
 }
 
 SYL_INLINE float s_map(float Value, float SourceMin, float SourceMax, float DestMin, float DestMax)
 {
+	_SYL_PROFILE(s_map);
 	return s_lerp(s_normalize(Value, SourceMin, SourceMax), DestMin, DestMax);
 }
 
 SYL_INLINE svec3 s_rgb_to_hsv(svec3 RGB)
 {
+	_SYL_PROFILE(s_rgb_to_hsv);
 	/* Range the values between 1 and 0*/
 	RGB.r = RGB.r / 255.0;
 	RGB.g = RGB.g / 255.0;
@@ -983,12 +1676,14 @@ SYL_INLINE svec2 SVEC2A(float* a) // From array
 
 SYL_INLINE void s_vec2_zero(svec2* vector)
 {
+	_SYL_PROFILE(s_vec2_zero);
 	vector->x = 0;
 	vector->y = 0;
 }
 
 SYL_INLINE bool s_vec2_equal(svec2 vec1, svec2 vec2)
 {
+	_SYL_PROFILE(s_vec2_equal);
 	bool result = false;
 	if (vec1.x == vec2.x && vec1.y == vec2.y)
 		result = true;
@@ -997,6 +1692,7 @@ SYL_INLINE bool s_vec2_equal(svec2 vec1, svec2 vec2)
 
 SYL_INLINE bool s_vec2_equal_scalar(svec2 vec1, float Value)
 {
+	_SYL_PROFILE(s_vec2_equal_scalar);
 	bool result = false;
 	if (vec1.x == Value && vec1.y == Value)
 		result = true;
@@ -1005,6 +1701,7 @@ SYL_INLINE bool s_vec2_equal_scalar(svec2 vec1, float Value)
 
 SYL_INLINE bool s_vec2_not_equal(svec2 vec1, svec2 vec2)
 {
+	_SYL_PROFILE(s_vec2_not_equal);
 	bool result = false;
 	if (vec1.x != vec2.x && vec1.y != vec2.y)
 		result = true;
@@ -1013,6 +1710,7 @@ SYL_INLINE bool s_vec2_not_equal(svec2 vec1, svec2 vec2)
 
 SYL_INLINE bool s_vec2_not_equal_scalar(svec2 vec1, float Value)
 {
+	_SYL_PROFILE(s_vec2_not_equal_scalar);
 	bool result = false;
 	if (vec1.x != Value && vec1.y != Value)
 		result = true;
@@ -1021,6 +1719,7 @@ SYL_INLINE bool s_vec2_not_equal_scalar(svec2 vec1, float Value)
 
 SYL_INLINE bool s_vec2_greater(svec2 vec1, svec2 vec2)
 {
+	_SYL_PROFILE(s_vec2_greater);
 	bool result = false;
 	if (vec1.x > vec2.x && vec1.y > vec2.y)
 		result = true;
@@ -1029,6 +1728,7 @@ SYL_INLINE bool s_vec2_greater(svec2 vec1, svec2 vec2)
 
 SYL_INLINE bool s_vec2_greater_scalar(svec2 vec1, float value)
 {
+	_SYL_PROFILE(s_vec2_greater_scalar);
 	bool result = false;
 	if (vec1.x > value && vec1.y > value)
 		result = true;
@@ -1037,6 +1737,7 @@ SYL_INLINE bool s_vec2_greater_scalar(svec2 vec1, float value)
 
 SYL_INLINE bool s_vec2_greater_equal(svec2 vec1, svec2 vec2)
 {
+	_SYL_PROFILE(s_vec2_greater_equal);
 	bool result = false;
 	if (vec1.x >= vec2.x && vec1.y >= vec2.y)
 		result = true;
@@ -1045,6 +1746,7 @@ SYL_INLINE bool s_vec2_greater_equal(svec2 vec1, svec2 vec2)
 
 SYL_INLINE bool s_vec2_greater_equal_scalar(svec2 vec1, float value)
 {
+	_SYL_PROFILE(s_vec2_greater_equal_scalar);
 	bool result = false;
 	if (vec1.x >= value && vec1.y >= value)
 		result = true;
@@ -1054,6 +1756,7 @@ SYL_INLINE bool s_vec2_greater_equal_scalar(svec2 vec1, float value)
 
 SYL_INLINE bool s_vec2_less(svec2 vec1, svec2 vec2)
 {
+	_SYL_PROFILE(s_vec2_less);
 	bool result = false;
 	if (vec1.x < vec2.x && vec1.y < vec2.y)
 		result = true;
@@ -1062,6 +1765,7 @@ SYL_INLINE bool s_vec2_less(svec2 vec1, svec2 vec2)
 
 SYL_INLINE bool s_vec2_less_scalar(svec2 vec1, float value)
 {
+	_SYL_PROFILE(s_vec2_less_scalar);
 	bool result = false;
 	if (vec1.x < value && vec1.y < value)
 		result = true;
@@ -1070,6 +1774,7 @@ SYL_INLINE bool s_vec2_less_scalar(svec2 vec1, float value)
 
 SYL_INLINE bool s_vec2_less_equal(svec2 vec1, svec2 vec2)
 {
+	_SYL_PROFILE(s_vec2_less_equal);
 	bool result = false;
 	if (vec1.x <= vec2.x && vec1.y <= vec2.y)
 		result = true;
@@ -1078,6 +1783,7 @@ SYL_INLINE bool s_vec2_less_equal(svec2 vec1, svec2 vec2)
 
 SYL_INLINE bool s_vec2_less_equal_scalar(svec2 vec1, float value)
 {
+	_SYL_PROFILE(s_vec2_less_equal_scalar);
 	bool result = false;
 	if (vec1.x <= value && vec1.y <= value)
 		result = true;
@@ -1086,6 +1792,7 @@ SYL_INLINE bool s_vec2_less_equal_scalar(svec2 vec1, float value)
 
 SYL_INLINE svec2 s_vec2_add(svec2 vec1, svec2 vec2)
 {
+	_SYL_PROFILE(s_vec2_add);
 #if defined (SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
 	__m128 r = _mm_add_ps(_mm_loadl_pi(_mm_setzero_ps(), (__m64*) & vec1), _mm_loadl_pi(_mm_setzero_ps(), (__m64*) & vec2));
 	return *(svec2*)&r;
@@ -1097,6 +1804,7 @@ SYL_INLINE svec2 s_vec2_add(svec2 vec1, svec2 vec2)
 
 SYL_INLINE svec2 s_vec2p_add(svec2* vec1, svec2 vec2)
 {
+	_SYL_PROFILE(s_vec2p_add);
 #if defined (SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
 	__m128 r = _mm_add_ps(_mm_loadl_pi(_mm_setzero_ps(), (__m64*) & vec1->e), _mm_loadl_pi(_mm_setzero_ps(), (__m64*) & vec2));
 	*vec1 = *(svec2*)&r;
@@ -1110,6 +1818,7 @@ SYL_INLINE svec2 s_vec2p_add(svec2* vec1, svec2 vec2)
 
 SYL_INLINE svec2 s_vec2_add_scalar(svec2 vec1, float value)
 {
+	_SYL_PROFILE(s_vec2_add_scalar);
 #if defined (SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
 	__m128 r = _mm_add_ps(_mm_loadl_pi(_mm_setzero_ps(), (__m64*) & vec1), _mm_set1_ps(value));
 	return *(svec2*)&r;
@@ -1121,6 +1830,7 @@ SYL_INLINE svec2 s_vec2_add_scalar(svec2 vec1, float value)
 
 SYL_INLINE svec2 s_vec2p_add_scalar(svec2* vec1, float value)
 {
+	_SYL_PROFILE(s_vec2p_add_scalar);
 #if defined (SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
 	__m128 r = _mm_add_ps(_mm_loadl_pi(_mm_setzero_ps(), (__m64*) & vec1->e), _mm_set1_ps(value));
 	*vec1 = *(svec2*)&r;
@@ -1134,17 +1844,19 @@ SYL_INLINE svec2 s_vec2p_add_scalar(svec2* vec1, float value)
 
 SYL_INLINE svec2 s_vec2_sub(svec2 vec1, svec2 vec2)
 {
+	_SYL_PROFILE(s_vec2_sub);
 #if defined (SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
 	__m128 r = _mm_sub_ps(_mm_loadl_pi(_mm_setzero_ps(), (__m64*) & vec1), _mm_loadl_pi(_mm_setzero_ps(), (__m64*) & vec2));
 	return *(svec2*)&r;
 #else
-	svec2 Result = { { (vec1.x - vec2.x), (vec2.x - vec2.y) } };
+	svec2 Result = { { (vec1.x - vec2.x), (vec1.y - vec2.y) } };
 	return(Result);
 #endif
 }
 
 SYL_INLINE svec2 s_vec2p_sub(svec2* vec1, svec2 vec2)
 {
+	_SYL_PROFILE(s_vec2p_sub);
 #if defined (SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
 	__m128 r = _mm_sub_ps(_mm_loadl_pi(_mm_setzero_ps(), (__m64*) & vec1->e), _mm_loadl_pi(_mm_setzero_ps(), (__m64*) & vec2));
 	*vec1 = *(svec2*)&r;
@@ -1158,6 +1870,7 @@ SYL_INLINE svec2 s_vec2p_sub(svec2* vec1, svec2 vec2)
 
 SYL_INLINE svec2 s_vec2_sub_scalar(svec2 vec1, float value)
 {
+	_SYL_PROFILE(s_vec2_sub_scalar);
 #if defined (SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
 	__m128 r = _mm_sub_ps(_mm_loadl_pi(_mm_setzero_ps(), (__m64*) & vec1), _mm_set1_ps(value));
 	return *(svec2*)&r;
@@ -1169,6 +1882,7 @@ SYL_INLINE svec2 s_vec2_sub_scalar(svec2 vec1, float value)
 
 SYL_INLINE svec2 s_scalar_sub_vec2(float value, svec2 vec1)
 {
+	_SYL_PROFILE(s_scalar_sub_vec2);
 #if defined (SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
 	__m128 r = _mm_sub_ps(_mm_set1_ps(value), _mm_loadl_pi(_mm_setzero_ps(), (__m64*) & vec1));
 	return *(svec2*)&r;
@@ -1180,6 +1894,7 @@ SYL_INLINE svec2 s_scalar_sub_vec2(float value, svec2 vec1)
 
 SYL_INLINE svec2 s_vec2p_sub_scalar(svec2* vec1, float value)
 {
+	_SYL_PROFILE(s_vec2p_sub_scalar);
 #if defined (SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
 	__m128 r = _mm_sub_ps(_mm_loadl_pi(_mm_setzero_ps(), (__m64*) & vec1->e), _mm_set1_ps(value));
 	*vec1 = *(svec2*)&r;
@@ -1193,8 +1908,9 @@ SYL_INLINE svec2 s_vec2p_sub_scalar(svec2* vec1, float value)
 
 SYL_INLINE svec2 s_scalar_sub_vec2p(float value, svec2* vec1)
 {
+	_SYL_PROFILE(s_scalar_sub_vec2p);
 #if defined (SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
-	__m128 r = _mm_sub_ps(_mm_loadl_pi(_mm_setzero_ps(), (__m64*) & vec1->e), _mm_set1_ps(value));
+	__m128 r = _mm_sub_ps(_mm_set1_ps(value), _mm_loadl_pi(_mm_setzero_ps(), (__m64*) & vec1->e));
 	*vec1 = *(svec2*)&r;
 	return(*vec1);
 #else
@@ -1206,6 +1922,7 @@ SYL_INLINE svec2 s_scalar_sub_vec2p(float value, svec2* vec1)
 
 SYL_INLINE svec2 s_vec2_mul(svec2 vec1, svec2 vec2)
 {
+	_SYL_PROFILE(s_vec2_mul);
 #if defined (SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
 	__m128 r = _mm_mul_ps(_mm_loadl_pi(_mm_setzero_ps(), (__m64*) & vec1), _mm_loadl_pi(_mm_setzero_ps(), (__m64*) & vec2));
 	return *(svec2*)&r;
@@ -1217,6 +1934,7 @@ SYL_INLINE svec2 s_vec2_mul(svec2 vec1, svec2 vec2)
 
 SYL_INLINE svec2 s_vec2p_mul(svec2* vec1, svec2 vec2)
 {
+	_SYL_PROFILE(s_vec2p_mul);
 #if defined (SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
 	__m128 r = _mm_mul_ps(_mm_loadl_pi(_mm_setzero_ps(), (__m64*) & vec1->e), _mm_loadl_pi(_mm_setzero_ps(), (__m64*) & vec2));
 	*vec1 = *(svec2*)&r;
@@ -1230,6 +1948,7 @@ SYL_INLINE svec2 s_vec2p_mul(svec2* vec1, svec2 vec2)
 
 SYL_INLINE svec2 s_vec2_mul_scalar(svec2 vec1, float value)
 {
+	_SYL_PROFILE(s_vec2_mul_scalar);
 #if defined (SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
 	__m128 r = _mm_mul_ps(_mm_loadl_pi(_mm_setzero_ps(), (__m64*) & vec1), _mm_set1_ps(value));
 	return *(svec2*)&r;
@@ -1241,6 +1960,7 @@ SYL_INLINE svec2 s_vec2_mul_scalar(svec2 vec1, float value)
 
 SYL_INLINE svec2 s_vec2p_mul_scalar(svec2* vec1, float value)
 {
+	_SYL_PROFILE(s_vec2p_mul_scalar);
 #if defined (SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
 	__m128 r = _mm_mul_ps(_mm_loadl_pi(_mm_setzero_ps(), (__m64*) & vec1->e), _mm_set1_ps(value));
 	*vec1 = *(svec2*)&r;
@@ -1254,6 +1974,7 @@ SYL_INLINE svec2 s_vec2p_mul_scalar(svec2* vec1, float value)
 
 SYL_INLINE svec2 s_vec2_div(svec2 vec1, svec2 vec2)
 {
+	_SYL_PROFILE(s_vec2_div);
 #if defined (SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
 	__m128 r = _mm_div_ps(_mm_loadl_pi(_mm_setzero_ps(), (__m64*) & vec1), _mm_loadl_pi(_mm_setzero_ps(), (__m64*) & vec2));
 	return *(svec2*)&r;
@@ -1265,6 +1986,7 @@ SYL_INLINE svec2 s_vec2_div(svec2 vec1, svec2 vec2)
 
 SYL_INLINE svec2 s_vec2p_div(svec2* vec1, svec2 vec2)
 {
+	_SYL_PROFILE(s_vec2p_div);
 #if defined (SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
 	__m128 r = _mm_div_ps(_mm_loadl_pi(_mm_setzero_ps(), (__m64*) & vec1->e), _mm_loadl_pi(_mm_setzero_ps(), (__m64*) & vec2));
 	*vec1 = *(svec2*)&r;
@@ -1278,6 +2000,7 @@ SYL_INLINE svec2 s_vec2p_div(svec2* vec1, svec2 vec2)
 
 SYL_INLINE svec2 s_vec2_div_scalar(svec2 vec1, float value)
 {
+	_SYL_PROFILE(s_vec2_div_scalar);
 #if defined (SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
 	__m128 r = _mm_div_ps(_mm_loadl_pi(_mm_setzero_ps(), (__m64*) & vec1), _mm_set1_ps(value));
 	return *(svec2*)&r;
@@ -1289,6 +2012,7 @@ SYL_INLINE svec2 s_vec2_div_scalar(svec2 vec1, float value)
 
 SYL_INLINE svec2 s_scalar_div_vec2(float value, svec2 vec1)
 {
+	_SYL_PROFILE(s_scalar_div_vec2);
 #if defined (SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
 	__m128 r = _mm_div_ps(_mm_set1_ps(value), _mm_loadl_pi(_mm_setzero_ps(), (__m64*) & vec1));
 	return *(svec2*)&r;
@@ -1300,6 +2024,7 @@ SYL_INLINE svec2 s_scalar_div_vec2(float value, svec2 vec1)
 
 SYL_INLINE svec2 s_vec2p_div_scalar(svec2* vec1, float value)
 {
+	_SYL_PROFILE(s_vec2p_div_scalar);
 #if defined (SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
 	__m128 r = _mm_div_ps(_mm_loadl_pi(_mm_setzero_ps(), (__m64*) & vec1->e), _mm_set1_ps(value));
 	*vec1 = *(svec2*)&r;
@@ -1313,6 +2038,7 @@ SYL_INLINE svec2 s_vec2p_div_scalar(svec2* vec1, float value)
 
 SYL_INLINE svec2 s_scalar_div_vec2p(float value, svec2* vec1)
 {
+	_SYL_PROFILE(s_scalar_div_vec2p);
 #if defined (SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
 	__m128 r = _mm_div_ps(_mm_set1_ps(value), _mm_loadl_pi(_mm_setzero_ps(), (__m64*) & vec1->e));
 	*vec1 = *(svec2*)&r;
@@ -1327,12 +2053,14 @@ SYL_INLINE svec2 s_scalar_div_vec2p(float value, svec2* vec1)
 /* Negate all components of the vector */
 SYL_INLINE svec2 s_vec2_negate(svec2 a)
 {
+	_SYL_PROFILE(s_vec2_negate);
 	svec2 Result = { { -a.x, -a.y } };
 	return(Result);
 }
 
 SYL_INLINE svec2 s_vec2_floor(svec2 A)
 {
+	_SYL_PROFILE(s_vec2_floor);
 	svec2 Result = { { s_floorf(A.x), s_floorf(A.y) } };
 	return(Result);
 }
@@ -1340,56 +2068,67 @@ SYL_INLINE svec2 s_vec2_floor(svec2 A)
 /* Round all components of the vec3 to nearest integer*/
 SYL_INLINE svec2 s_vec2_round(svec2 A)
 {
+	_SYL_PROFILE(s_vec2_round);
 	svec2 Result = { { s_roundf(A.x), s_roundf(A.y) } };
 	return(Result);
 }
 
 SYL_INLINE float s_vec2_dot(svec2 vec1, svec2 vec2)
 {
+	_SYL_PROFILE(s_vec2_dot);
 	return((vec1.x * vec2.x) + (vec1.y * vec2.y));
 }
 
 SYL_INLINE svec2 s_vec2_hadamard(svec2 vec1, svec2 vec2)
 {
+	_SYL_PROFILE(s_vec2_hadamard);
 	svec2 Result = { { (vec1.x * vec2.x), (vec1.y * vec2.y) } };
 	return(Result);
 }
 
 SYL_INLINE svec2 s_vec2_lerp(svec2 vec1, svec2 vec2, float t)
 {
+	_SYL_PROFILE(s_vec2_lerp);
 	svec2 r = { { vec1.x + (vec2.x - vec1.x * t), vec1.y + ((vec2.y - vec1.y * t)) } };
 	return r;
 }
 
 SYL_INLINE svec2 s_vec2_clamp(svec2 value, svec2 Min, svec2 Max)
 {
+	_SYL_PROFILE(s_vec2_clamp);
 #if defined (SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
 	__m128 Result = _mm_min_ps(_mm_max_ps(_mm_loadl_pi(_mm_setzero_ps(), (__m64*) & value.v), _mm_loadl_pi(_mm_setzero_ps(), (__m64*) & Min.v)), _mm_loadl_pi(_mm_setzero_ps(), (__m64*) & Max.v));
 	return *(svec2*)&Result;
 #else
-	svec2 Result = { { s_clampf(value.x, Min.x, Max.x), s_clampf(value.y, Min.y, Max.y) } };
+	svec2 Result = s_vec2_min_vector(s_vec2_max_vector(value, Min), Max);
 	return(Result);
 #endif
 }
 
 SYL_INLINE float s_vec2_length(svec2 vec1)
 {
-	return(sqrt((vec1.x * vec1.x) + (vec1.y * vec1.y)));
+	_SYL_PROFILE(s_vec2_length);
+	return(sqrtf((vec1.x * vec1.x) + (vec1.y * vec1.y)));
 }
 
 SYL_INLINE float s_vec2_distance(svec2 vec1, svec2 vec2)
 {
+	_SYL_PROFILE(s_vec2_distance);
 	return s_vec2_length(s_vec2_sub(vec1, vec2));
 }
 
 SYL_INLINE svec2 s_vec2_normalize(svec2 a)
 {
-	return(s_vec2_mul_scalar(a, (1.0f / s_vec2_length(a))));
+	_SYL_PROFILE(s_vec2_normalize);
+	float LengthSq = s_vec2_dot(a, a);
+	/* Vectors too short to normalize become zero instead of NaN, as in the array kernels */
+	return(s_vec2_mul_scalar(a, LengthSq > _SYL_VEC_EPSILON_SQ ? 1.0f / sqrtf(LengthSq) : 0.0f));
 }
 
 /* Reflect a position to a normal plane */
 SYL_INLINE svec2 s_vec2_reflect(svec2 Pos, svec2 N)
 {
+	_SYL_PROFILE(s_vec2_reflect);
 	svec2 Normal = s_vec2_normalize(N);
 	float r = s_vec2_dot(Pos, Normal);
 	svec2 t = { { (float)(Pos.e[0] - Normal.e[0] * 2.0 * r), (float)(Pos.e[1] - Normal.e[1] * 2.0 * r) } };
@@ -1399,6 +2138,7 @@ SYL_INLINE svec2 s_vec2_reflect(svec2 Pos, svec2 N)
 /* Project from a position along a vector on to a plane */
 SYL_INLINE svec2 s_vec2_project(svec2 vectorToProject, svec2 Projectionvector)
 {
+	_SYL_PROFILE(s_vec2_project);
 	float scale = s_vec2_dot(Projectionvector, vectorToProject) / s_vec2_dot(Projectionvector, Projectionvector);
 	return(s_vec2_mul_scalar(Projectionvector, scale));
 }
@@ -1406,6 +2146,7 @@ SYL_INLINE svec2 s_vec2_project(svec2 vectorToProject, svec2 Projectionvector)
 /* Flattens a position to a normal plane */
 static inline svec2 s_vec2_flatten(svec2 Pos, svec2 Normal)
 {
+	_SYL_PROFILE(s_vec2_flatten);
 	float f = s_vec2_dot(Pos, Normal);
 	svec2 result = { { (Pos.e[0] - Normal.e[0] * f), (Pos.e[1] - Normal.e[1] * f) } };
 	return(result);
@@ -1414,6 +2155,7 @@ static inline svec2 s_vec2_flatten(svec2 Pos, svec2 Normal)
 /* Per component comparsion to return a vector containing the largest components */
 SYL_INLINE svec2 s_vec2_max_vector(svec2 vec1, svec2 vec2)
 {
+	_SYL_PROFILE(s_vec2_max_vector);
 #if defined (SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
 	__m128 r = _mm_max_ps(_mm_loadl_pi(_mm_setzero_ps(), (__m64*) & vec1.e), _mm_loadl_pi(_mm_setzero_ps(), (__m64*) & vec2.e));
 	return *(svec2*)&r;
@@ -1435,6 +2177,7 @@ SYL_INLINE svec2 s_vec2_max_vector(svec2 vec1, svec2 vec2)
 /* Per component comparsion to return a vector containing the smollest components */
 SYL_INLINE svec2 s_vec2_min_vector(svec2 vec1, svec2 vec2)
 {
+	_SYL_PROFILE(s_vec2_min_vector);
 #if defined (SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
 	__m128 r = _mm_min_ps(_mm_loadl_pi(_mm_setzero_ps(), (__m64*) & vec1.e), _mm_loadl_pi(_mm_setzero_ps(), (__m64*) & vec2.e));
 	return *(svec2*)&r;
@@ -1456,6 +2199,7 @@ SYL_INLINE svec2 s_vec2_min_vector(svec2 vec1, svec2 vec2)
 /* Return the biggest element inside vec4 */
 SYL_INLINE float s_vec2_max(svec2 A)
 {
+	_SYL_PROFILE(s_vec2_max);
 	if (A.e[0] > A.e[1])
 		return(A.e[0]);
 	else
@@ -1465,6 +2209,7 @@ SYL_INLINE float s_vec2_max(svec2 A)
 /* Return the smollest element inside vec4 */
 SYL_INLINE float s_vec2_min(svec2 A)
 {
+	_SYL_PROFILE(s_vec2_min);
 	if (A.e[0] < A.e[1])
 		return(A.e[0]);
 	else
@@ -1474,11 +2219,13 @@ SYL_INLINE float s_vec2_min(svec2 A)
 /* Add all components of the vector together */
 SYL_INLINE float s_vec2_sum(svec2 vec1)
 {
+	_SYL_PROFILE(s_vec2_sum);
 	return(vec1.x + vec1.y);
 }
 
 SYL_INLINE float s_triangle_area(svec2 vec1, svec2 vec2, svec2 Vec3)
 {
+	_SYL_PROFILE(s_triangle_area);
 	float r = ((vec1.x * vec2.y) + (vec2.x * Vec3.y) + (Vec3.x * vec1.y) - (vec1.y * vec2.x) - (vec2.y * Vec3.x) - (Vec3.y * vec1.x)) / 2;
 	if (r < 0)
 		{
@@ -1505,6 +2252,7 @@ SYL_INLINE svec3 SVEC3A(float* a)
 
 SYL_INLINE void s_vec3_zero(svec3* vector)
 {
+	_SYL_PROFILE(s_vec3_zero);
 	vector->x = 0;
 	vector->y = 0;
 	vector->z = 0;
@@ -1512,8 +2260,9 @@ SYL_INLINE void s_vec3_zero(svec3* vector)
 
 SYL_INLINE bool s_vec3_equal(svec3 vec1, svec3 vec2)
 {
+	_SYL_PROFILE(s_vec3_equal);
 #if defined (SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
-	__m128 Result = _mm_cmpeq_ps(_mm_load_ps(vec1.e), _mm_load_ps(vec2.e));
+	__m128 Result = _mm_cmpeq_ps(_s_load_vec3(&vec1), _s_load_vec3(&vec2));
 	return (((_mm_movemask_ps(Result) & 7) == 7) != 0);
 #else
 	if ((vec1.x == vec2.x) && (vec1.y == vec2.y) && (vec1.z == vec2.z))
@@ -1525,8 +2274,9 @@ SYL_INLINE bool s_vec3_equal(svec3 vec1, svec3 vec2)
 
 SYL_INLINE bool s_vec3_equal_scalar(svec3 vec1, float value)
 {
+	_SYL_PROFILE(s_vec3_equal_scalar);
 #if defined (SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
-	__m128 Result = _mm_cmpeq_ps(_mm_load_ps(vec1.e), _mm_set1_ps(value));
+	__m128 Result = _mm_cmpeq_ps(_s_load_vec3(&vec1), _mm_set1_ps(value));
 	return (((_mm_movemask_ps(Result) & 7) == 7) != 0);
 #else
 	if ((vec1.x == value) && (vec1.y == value) && (vec1.z == value))
@@ -1539,12 +2289,13 @@ SYL_INLINE bool s_vec3_equal_scalar(svec3 vec1, float value)
 
 SYL_INLINE bool s_vec3_not_equal(svec3 vec1, svec3 vec2)
 {
+	_SYL_PROFILE(s_vec3_not_equal);
 #if defined (SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
 
-	__m128 Result = _mm_cmpeq_ps(_mm_load_ps(vec1.e), _mm_load_ps(vec2.e));
-	return (((_mm_movemask_ps(Result) & 7) == 7) == 0);
+	__m128 Result = _mm_cmpneq_ps(_s_load_vec3(&vec1), _s_load_vec3(&vec2));
+	return (((_mm_movemask_ps(Result) & 7) == 7) != 0);
 #else
-	if ((vec1.x != vec2.x) && (vec1.y != vec2.y) && (vec1.z == vec2.z))
+	if ((vec1.x != vec2.x) && (vec1.y != vec2.y) && (vec1.z != vec2.z))
 		return(true);
 	else
 		return(false);
@@ -1553,11 +2304,12 @@ SYL_INLINE bool s_vec3_not_equal(svec3 vec1, svec3 vec2)
 
 SYL_INLINE bool s_vec3_not_equal_scalar(svec3 vec1, float value)
 {
+	_SYL_PROFILE(s_vec3_not_equal_scalar);
 #if defined (SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
-	__m128 Result = _mm_cmpneq_ps(_mm_load_ps(vec1.e), _mm_set1_ps(value));
+	__m128 Result = _mm_cmpneq_ps(_s_load_vec3(&vec1), _mm_set1_ps(value));
 	return (((_mm_movemask_ps(Result) & 7) == 7) != 0);
 #else
-	if ((vec1.x != value) && (vec1.y != value) && (vec1.z == value))
+	if ((vec1.x != value) && (vec1.y != value) && (vec1.z != value))
 		return(true);
 	else
 		return(false);
@@ -1566,12 +2318,13 @@ SYL_INLINE bool s_vec3_not_equal_scalar(svec3 vec1, float value)
 
 SYL_INLINE bool s_vec3_greater(svec3 vec1, svec3 vec2)
 {
+	_SYL_PROFILE(s_vec3_greater);
 #if defined (SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
 
-	__m128 Result = _mm_cmpgt_ps(_mm_load_ps(vec1.e), _mm_load_ps(vec2.e));
+	__m128 Result = _mm_cmpgt_ps(_s_load_vec3(&vec1), _s_load_vec3(&vec2));
 	return (((_mm_movemask_ps(Result) & 7) == 7) != 0);
 #else
-	if ((vec1.x > vec2.x) && (vec1.y > vec1.y) && (vec1.z > vec1.z))
+	if ((vec1.x > vec2.x) && (vec1.y > vec2.y) && (vec1.z > vec2.z))
 		return(true);
 	else
 		return(false);
@@ -1580,8 +2333,9 @@ SYL_INLINE bool s_vec3_greater(svec3 vec1, svec3 vec2)
 
 SYL_INLINE bool s_vec3_less(svec3 vec1, svec3 vec2)
 {
+	_SYL_PROFILE(s_vec3_less);
 #if defined (SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
-	__m128 Result = _mm_cmplt_ps(_mm_load_ps(vec1.e), _mm_load_ps(vec2.e));
+	__m128 Result = _mm_cmplt_ps(_s_load_vec3(&vec1), _s_load_vec3(&vec2));
 	return (((_mm_movemask_ps(Result) & 7) == 7) != 0);
 #else
 	if ((vec1.x < vec2.x) && (vec1.y < vec2.y) && (vec1.z < vec2.z))
@@ -1593,8 +2347,9 @@ SYL_INLINE bool s_vec3_less(svec3 vec1, svec3 vec2)
 
 SYL_INLINE bool s_vec3_less_scalar(svec3 vec1, float value)
 {
+	_SYL_PROFILE(s_vec3_less_scalar);
 #if defined (SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
-	__m128 Result = _mm_cmplt_ps(_mm_load_ps(vec1.e), _mm_set1_ps(value));
+	__m128 Result = _mm_cmplt_ps(_s_load_vec3(&vec1), _mm_set1_ps(value));
 	return (((_mm_movemask_ps(Result) & 7) == 7) != 0);
 #else
 	if ((vec1.x < value) && (vec1.y < value) && (vec1.z < value))
@@ -1607,11 +2362,12 @@ SYL_INLINE bool s_vec3_less_scalar(svec3 vec1, float value)
 
 SYL_INLINE bool s_vec3_greater_equal(svec3 vec1, svec3 vec2)
 {
+	_SYL_PROFILE(s_vec3_greater_equal);
 #if defined (SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
-	__m128 Result = _mm_cmpge_ps(_mm_load_ps(vec1.e), _mm_load_ps(vec2.e));
+	__m128 Result = _mm_cmpge_ps(_s_load_vec3(&vec1), _s_load_vec3(&vec2));
 	return (((_mm_movemask_ps(Result) & 7) == 7) != 0);
 #else
-	if ((vec1.x >= vec2.x) && (vec1.y >= vec2.y) && (vec1.z > vec2.z))
+	if ((vec1.x >= vec2.x) && (vec1.y >= vec2.y) && (vec1.z >= vec2.z))
 		return(true);
 	else
 		return(false);
@@ -1620,11 +2376,12 @@ SYL_INLINE bool s_vec3_greater_equal(svec3 vec1, svec3 vec2)
 
 SYL_INLINE bool s_vec3_greater_equal_scalar(svec3 vec1, float value)
 {
+	_SYL_PROFILE(s_vec3_greater_equal_scalar);
 #if defined (SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
-	__m128 Result = _mm_cmpge_ps(_mm_load_ps(vec1.e), _mm_set1_ps(value));
+	__m128 Result = _mm_cmpge_ps(_s_load_vec3(&vec1), _mm_set1_ps(value));
 	return (((_mm_movemask_ps(Result) & 7) == 7) != 0);
 #else
-	if ((vec1.x >= value) && (vec1.y >= value) && (vec1.z > value))
+	if ((vec1.x >= value) && (vec1.y >= value) && (vec1.z >= value))
 		return(true);
 	else
 		return(false);
@@ -1633,11 +2390,12 @@ SYL_INLINE bool s_vec3_greater_equal_scalar(svec3 vec1, float value)
 
 SYL_INLINE bool s_vec3_less_equal(svec3 vec1, svec3 vec2)
 {
+	_SYL_PROFILE(s_vec3_less_equal);
 #if defined (SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
-	__m128 Result = _mm_cmple_ps(_mm_load_ps(vec1.e), _mm_load_ps(vec2.e));
+	__m128 Result = _mm_cmple_ps(_s_load_vec3(&vec1), _s_load_vec3(&vec2));
 	return (((_mm_movemask_ps(Result) & 7) == 7) != 0);
 #else
-	if ((vec1.x <= vec2.x) && (vec1.y <= vec2.y) && (vec1.z > vec2.z))
+	if ((vec1.x <= vec2.x) && (vec1.y <= vec2.y) && (vec1.z <= vec2.z))
 		return(true);
 	else
 		return(false);
@@ -1646,11 +2404,12 @@ SYL_INLINE bool s_vec3_less_equal(svec3 vec1, svec3 vec2)
 
 SYL_INLINE bool s_vec3_less_equal_scalar(svec3 vec1, float value)
 {
+	_SYL_PROFILE(s_vec3_less_equal_scalar);
 #if defined (SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
-	__m128 Result = _mm_cmple_ps(_mm_load_ps(vec1.e), _mm_set1_ps(value));
+	__m128 Result = _mm_cmple_ps(_s_load_vec3(&vec1), _mm_set1_ps(value));
 	return (((_mm_movemask_ps(Result) & 7) == 7) != 0);
 #else
-	if ((vec1.x <= value) && (vec1.y <= value) && (vec1.z > value))
+	if ((vec1.x <= value) && (vec1.y <= value) && (vec1.z <= value))
 		return(true);
 	else
 		return(false);
@@ -1659,9 +2418,10 @@ SYL_INLINE bool s_vec3_less_equal_scalar(svec3 vec1, float value)
 
 SYL_INLINE svec3 s_vec3_add(svec3 vec1, svec3 vec2)
 {
+	_SYL_PROFILE(s_vec3_add);
 #if defined (SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
-	__m128 r = _mm_add_ps(_mm_loadl_pi(_mm_setzero_ps(), (__m64*) & vec1), _mm_loadl_pi(_mm_setzero_ps(), (__m64*) & vec2));
-	return *(svec3*)&r;
+	__m128 r = _mm_add_ps(_s_load_vec3(&vec1), _s_load_vec3(&vec2));
+	return(_s_store_vec3(r));
 #else
 	svec3 Result = { { (vec1.x + vec2.x), (vec1.y + vec2.y), (vec1.z + vec2.z) } };
 	return(Result);
@@ -1670,9 +2430,10 @@ SYL_INLINE svec3 s_vec3_add(svec3 vec1, svec3 vec2)
 
 SYL_INLINE svec3 s_vec3p_add(svec3* vec1, svec3 vec2)
 {
+	_SYL_PROFILE(s_vec3p_add);
 #if defined (SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
-	__m128 r = _mm_add_ps(_mm_load_ps(vec1->e), _mm_load_ps(vec2.e));
-	*vec1 = *(svec3*)&r;
+	__m128 r = _mm_add_ps(_s_load_vec3(vec1), _s_load_vec3(&vec2));
+	*vec1 = _s_store_vec3(r);
 	return(*vec1);
 #else
 	vec1->x = vec1->x + vec2.x;
@@ -1684,9 +2445,10 @@ SYL_INLINE svec3 s_vec3p_add(svec3* vec1, svec3 vec2)
 
 SYL_INLINE svec3 s_vec3_add_scalar(svec3 vec1, float value)
 {
+	_SYL_PROFILE(s_vec3_add_scalar);
 #if defined (SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
-	__m128 r = _mm_add_ps(_mm_load_ps(vec1.e), _mm_set1_ps(value));
-	return *(svec3*)&r;
+	__m128 r = _mm_add_ps(_s_load_vec3(&vec1), _mm_set1_ps(value));
+	return(_s_store_vec3(r));
 #else
 	svec3 Result = { { (vec1.x + value), (vec1.y + value), (vec1.z + value) } };
 	return(Result);
@@ -1695,9 +2457,10 @@ SYL_INLINE svec3 s_vec3_add_scalar(svec3 vec1, float value)
 
 SYL_INLINE svec3 s_vec3p_add_scalar(svec3* vec1, float value)
 {
+	_SYL_PROFILE(s_vec3p_add_scalar);
 #if defined (SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
-	__m128 r = _mm_add_ps(_mm_load_ps(vec1->e), _mm_set1_ps(value));
-	*vec1 = *(svec3*)&r;
+	__m128 r = _mm_add_ps(_s_load_vec3(vec1), _mm_set1_ps(value));
+	*vec1 = _s_store_vec3(r);
 	return(*vec1);
 #else
 	vec1->x = vec1->x + value;
@@ -1709,9 +2472,10 @@ SYL_INLINE svec3 s_vec3p_add_scalar(svec3* vec1, float value)
 
 SYL_INLINE svec3 s_vec3_sub(svec3 vec1, svec3 vec2)
 {
+	_SYL_PROFILE(s_vec3_sub);
 #if defined (SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
-	__m128 r = _mm_sub_ps(_mm_load_ps(vec1.e), _mm_load_ps(vec2.e));
-	return *(svec3*)&r;
+	__m128 r = _mm_sub_ps(_s_load_vec3(&vec1), _s_load_vec3(&vec2));
+	return(_s_store_vec3(r));
 #else
 	svec3 Result = { { (vec1.x - vec2.x), (vec1.y - vec2.y), (vec1.z - vec2.z) } };
 	return(Result);
@@ -1720,9 +2484,10 @@ SYL_INLINE svec3 s_vec3_sub(svec3 vec1, svec3 vec2)
 
 SYL_INLINE svec3 s_vec3p_sub(svec3* vec1, svec3 vec2)
 {
+	_SYL_PROFILE(s_vec3p_sub);
 #if defined (SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
-	__m128 r = _mm_sub_ps(_mm_load_ps(vec1->e), _mm_load_ps(vec2.e));
-	*vec1 = *(svec3*)&r;
+	__m128 r = _mm_sub_ps(_s_load_vec3(vec1), _s_load_vec3(&vec2));
+	*vec1 = _s_store_vec3(r);
 	return(*vec1);
 #else
 	vec1->x = vec1->x - vec2.x;
@@ -1734,9 +2499,10 @@ SYL_INLINE svec3 s_vec3p_sub(svec3* vec1, svec3 vec2)
 
 SYL_INLINE svec3 s_vec3_sub_scalar(svec3 vec1, float value)
 {
+	_SYL_PROFILE(s_vec3_sub_scalar);
 #if defined (SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
-	__m128 r = _mm_sub_ps(_mm_load_ps(vec1.e), _mm_set1_ps(value));
-	return *(svec3*)&r;
+	__m128 r = _mm_sub_ps(_s_load_vec3(&vec1), _mm_set1_ps(value));
+	return(_s_store_vec3(r));
 #else
 	svec3 Result = { { (vec1.x - value), (vec1.y - value), (vec1.z - value) } };
 	return(Result);
@@ -1745,9 +2511,10 @@ SYL_INLINE svec3 s_vec3_sub_scalar(svec3 vec1, float value)
 
 SYL_INLINE svec3 s_vec3p_sub_saclar(svec3* vec1, float value)
 {
+	_SYL_PROFILE(s_vec3p_sub_saclar);
 #if defined (SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
-	__m128 r = _mm_sub_ps(_mm_load_ps(vec1->e), _mm_set1_ps(value));
-	*vec1 = *(svec3*)&r;
+	__m128 r = _mm_sub_ps(_s_load_vec3(vec1), _mm_set1_ps(value));
+	*vec1 = _s_store_vec3(r);
 	return(*vec1);
 #else
 	vec1->x = vec1->x - value;
@@ -1759,9 +2526,10 @@ SYL_INLINE svec3 s_vec3p_sub_saclar(svec3* vec1, float value)
 
 SYL_INLINE svec3 s_scalar_sub_vec3(float value, svec3 vec1)
 {
+	_SYL_PROFILE(s_scalar_sub_vec3);
 #if defined (SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
-	__m128 r = _mm_sub_ps(_mm_set1_ps(value), _mm_load_ps(vec1.e));
-	return *(svec3*)&r;
+	__m128 r = _mm_sub_ps(_mm_set1_ps(value), _s_load_vec3(&vec1));
+	return(_s_store_vec3(r));
 #else
 	svec3 result = { { (value - vec1.x), (value - vec1.y), (value - vec1.z) } };
 	return(result);
@@ -1770,9 +2538,10 @@ SYL_INLINE svec3 s_scalar_sub_vec3(float value, svec3 vec1)
 
 SYL_INLINE svec3 s_scalar_sub_vec3p(float value, svec3* vec1)
 {
+	_SYL_PROFILE(s_scalar_sub_vec3p);
 #if defined (SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
-	__m128 r = _mm_sub_ps(_mm_set1_ps(value), _mm_load_ps(vec1->e));
-	*vec1 = *(svec3*)&r;
+	__m128 r = _mm_sub_ps(_mm_set1_ps(value), _s_load_vec3(vec1));
+	*vec1 = _s_store_vec3(r);
 	return(*vec1);
 #else
 	vec1->x = value - vec1->x;
@@ -1784,9 +2553,10 @@ SYL_INLINE svec3 s_scalar_sub_vec3p(float value, svec3* vec1)
 
 SYL_INLINE svec3 s_vec3_mul(svec3 vec1, svec3 vec2)
 {
+	_SYL_PROFILE(s_vec3_mul);
 #if defined (SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
-	__m128 r = _mm_mul_ps(_mm_load_ps(vec1.e), _mm_load_ps(vec2.e));
-	return *(svec3*)&r;
+	__m128 r = _mm_mul_ps(_s_load_vec3(&vec1), _s_load_vec3(&vec2));
+	return(_s_store_vec3(r));
 #else
 	svec3 Result = { { (vec1.x * vec2.x), (vec1.y * vec2.y), (vec1.z * vec2.z) } };
 	return(Result);
@@ -1795,9 +2565,10 @@ SYL_INLINE svec3 s_vec3_mul(svec3 vec1, svec3 vec2)
 
 SYL_INLINE svec3 s_vec3p_mul(svec3* vec1, svec3 vec2)
 {
+	_SYL_PROFILE(s_vec3p_mul);
 #if defined (SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
-	__m128 r = _mm_mul_ps(_mm_load_ps(vec1->e), _mm_load_ps(vec2.e));
-	*vec1 = *(svec3*)&r;
+	__m128 r = _mm_mul_ps(_s_load_vec3(vec1), _s_load_vec3(&vec2));
+	*vec1 = _s_store_vec3(r);
 	return(*vec1);
 #else
 	vec1->x = vec1->x * vec2.x;
@@ -1809,9 +2580,10 @@ SYL_INLINE svec3 s_vec3p_mul(svec3* vec1, svec3 vec2)
 
 SYL_INLINE svec3 s_vec3_mul_scalar(svec3 vec1, float value)
 {
+	_SYL_PROFILE(s_vec3_mul_scalar);
 #if defined (SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
-	__m128 r = _mm_mul_ps(_mm_load_ps(vec1.e), _mm_set1_ps(value));
-	return *(svec3*)&r;
+	__m128 r = _mm_mul_ps(_s_load_vec3(&vec1), _mm_set1_ps(value));
+	return(_s_store_vec3(r));
 #else
 	svec3 Result = { { (vec1.x * value), (vec1.y * value),  (vec1.z * value) } };
 	return(Result);
@@ -1820,9 +2592,10 @@ SYL_INLINE svec3 s_vec3_mul_scalar(svec3 vec1, float value)
 
 SYL_INLINE svec3 s_vec3p_mul_scalar(svec3* vec1, float value)
 {
+	_SYL_PROFILE(s_vec3p_mul_scalar);
 #if defined (SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
-	__m128 r = _mm_mul_ps(_mm_load_ps(vec1->e), _mm_set1_ps(value));
-	*vec1 = *(svec3*)&r;
+	__m128 r = _mm_mul_ps(_s_load_vec3(vec1), _mm_set1_ps(value));
+	*vec1 = _s_store_vec3(r);
 	return(*vec1);
 #else
 	vec1->x = vec1->x * value;
@@ -1834,9 +2607,10 @@ SYL_INLINE svec3 s_vec3p_mul_scalar(svec3* vec1, float value)
 
 SYL_INLINE svec3 s_vec3_div(svec3 vec1, svec3 vec2)
 {
+	_SYL_PROFILE(s_vec3_div);
 #if defined (SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
-	__m128 r = _mm_div_ps(_mm_load_ps(vec1.e), _mm_load_ps(vec2.e));
-	return *(svec3*)&r;
+	__m128 r = _mm_div_ps(_s_load_vec3(&vec1), _s_load_vec3(&vec2));
+	return(_s_store_vec3(r));
 #else
 	svec3 Result = { { (vec1.x / vec2.x), (vec1.y / vec2.y), (vec1.z / vec2.z) } };
 	return(Result);
@@ -1845,9 +2619,10 @@ SYL_INLINE svec3 s_vec3_div(svec3 vec1, svec3 vec2)
 
 SYL_INLINE svec3 s_vec3p_div(svec3* vec1, svec3 vec2)
 {
+	_SYL_PROFILE(s_vec3p_div);
 #if defined (SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
-	__m128 r = _mm_div_ps(_mm_load_ps(vec1->e), _mm_load_ps(vec2.e));
-	*vec1 = *(svec3*)&r;
+	__m128 r = _mm_div_ps(_s_load_vec3(vec1), _s_load_vec3(&vec2));
+	*vec1 = _s_store_vec3(r);
 	return(*vec1);
 #else
 	vec1->x = vec1->x / vec2.x;
@@ -1859,9 +2634,10 @@ SYL_INLINE svec3 s_vec3p_div(svec3* vec1, svec3 vec2)
 
 SYL_INLINE svec3 s_vec3_div_scalar(svec3 vec1, float value)
 {
+	_SYL_PROFILE(s_vec3_div_scalar);
 #if defined (SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
-	__m128 r = _mm_div_ps(_mm_load_ps(vec1.e), _mm_set1_ps(value));
-	return *(svec3*)&r;
+	__m128 r = _mm_div_ps(_s_load_vec3(&vec1), _mm_set1_ps(value));
+	return(_s_store_vec3(r));
 #else
 	svec3 Result = { { (vec1.x / value), (vec1.y / value), (vec1.z / value) } };
 	return(Result);
@@ -1870,9 +2646,10 @@ SYL_INLINE svec3 s_vec3_div_scalar(svec3 vec1, float value)
 
 SYL_INLINE svec3 s_vec3p_div_scalar(svec3* vec1, float value)
 {
+	_SYL_PROFILE(s_vec3p_div_scalar);
 #if defined (SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
-	__m128 r = _mm_div_ps(_mm_load_ps(vec1->e), _mm_set1_ps(value));
-	*vec1 = *(svec3*)&r;
+	__m128 r = _mm_div_ps(_s_load_vec3(vec1), _mm_set1_ps(value));
+	*vec1 = _s_store_vec3(r);
 	return(*vec1);
 #else
 	vec1->x = vec1->x / value;
@@ -1884,9 +2661,10 @@ SYL_INLINE svec3 s_vec3p_div_scalar(svec3* vec1, float value)
 
 SYL_INLINE svec3 s_scalar_div_vec3(float value, svec3 vec1)
 {
+	_SYL_PROFILE(s_scalar_div_vec3);
 #if defined (SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
-	__m128 r = _mm_div_ps(_mm_set1_ps(value), _mm_load_ps(vec1.e));
-	return *(svec3*)&r;
+	__m128 r = _mm_div_ps(_mm_set1_ps(value), _s_load_vec3(&vec1));
+	return(_s_store_vec3(r));
 #else
 	svec3 Result = { { (value / vec1.x), (value / vec1.y), (value / vec1.z) } };
 	return(Result);
@@ -1895,9 +2673,10 @@ SYL_INLINE svec3 s_scalar_div_vec3(float value, svec3 vec1)
 
 SYL_INLINE svec3 s_scalar_div_vec3p(float value, svec3* vec1)
 {
+	_SYL_PROFILE(s_scalar_div_vec3p);
 #if defined (SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
-	__m128 r = _mm_div_ps(_mm_set1_ps(value), _mm_load_ps(vec1->e));
-	*vec1 = *(svec3*)&r;
+	__m128 r = _mm_div_ps(_mm_set1_ps(value), _s_load_vec3(vec1));
+	*vec1 = _s_store_vec3(r);
 	return(*vec1);
 #else
 	vec1->x = value / vec1->x;
@@ -1909,6 +2688,7 @@ SYL_INLINE svec3 s_scalar_div_vec3p(float value, svec3* vec1)
 
 SYL_INLINE svec3 s_vec3_floor(svec3 A)
 {
+	_SYL_PROFILE(s_vec3_floor);
 	svec3 Result = { { s_floorf(A.x), s_floorf(A.y), s_floorf(A.z) } };
 	return(Result);
 }
@@ -1916,6 +2696,7 @@ SYL_INLINE svec3 s_vec3_floor(svec3 A)
 /* Round all components of the vec3 to nearest integer*/
 SYL_INLINE svec3 s_vec3_round(svec3 A)
 {
+	_SYL_PROFILE(s_vec3_round);
 	svec3 Result = { { s_roundf(A.x), s_roundf(A.y), s_roundf(A.z) } };
 	return(Result);
 }
@@ -1923,70 +2704,81 @@ SYL_INLINE svec3 s_vec3_round(svec3 A)
 /* Negate all components of the vector */
 SYL_INLINE svec3 s_vec3_negate(svec3 a)
 {
+	_SYL_PROFILE(s_vec3_negate);
 	svec3 r = { { -a.x, -a.y, -a.z } };
 	return(r);
 }
 
 SYL_INLINE float s_vec3_dot(svec3 vec1, svec3 vec2)
 {
+	_SYL_PROFILE(s_vec3_dot);
 	return((vec1.x * vec2.x) + (vec1.y * vec2.y) + (vec1.z * vec2.z));
 }
 
 SYL_INLINE svec3 s_vec3_hadamard(svec3 vec1, svec3 vec2)
 {
-	svec3 Result = { { (vec1.x * vec2.x), (vec1.y * vec2.y), (vec1.z * vec1.z) } };
+	_SYL_PROFILE(s_vec3_hadamard);
+	svec3 Result = { { (vec1.x * vec2.x), (vec1.y * vec2.y), (vec1.z * vec2.z) } };
 	return(Result);
 }
 
 SYL_INLINE float s_vec3_length(svec3 vec1)
 {
-	return(sqrt((vec1.x * vec1.x) + (vec1.y * vec1.y) + (vec1.z * vec1.z)));
+	_SYL_PROFILE(s_vec3_length);
+	return(sqrtf((vec1.x * vec1.x) + (vec1.y * vec1.y) + (vec1.z * vec1.z)));
 }
 
 SYL_INLINE float s_vec3_distance(svec3 vec1, svec3 vec2)
 {
+	_SYL_PROFILE(s_vec3_distance);
 	return s_vec3_length(s_vec3_sub(vec1, vec2));
 }
 
 SYL_INLINE svec3 s_vec3_normalize(svec3 a)
 {
-	return(s_vec3_mul_scalar(a, (1.0f / s_vec3_length(a))));
+	_SYL_PROFILE(s_vec3_normalize);
+	float LengthSq = s_vec3_dot(a, a);
+	/* Vectors too short to normalize become zero instead of NaN, as in the array kernels */
+	return(s_vec3_mul_scalar(a, LengthSq > _SYL_VEC_EPSILON_SQ ? 1.0f / sqrtf(LengthSq) : 0.0f));
 }
 
-/* Return the biggest element inside vec4 */
+/* Return the biggest element inside vec3 */
 SYL_INLINE float s_vec3_max(svec3 A)
 {
-	/* NOTE(hsnovel): Current SSE4 version doesn't work. It is removed for now. Reimplement it later.*/
-	if (A.e[0] >= A.e[1] && A.e[0] >= A.e[2])
-		return(A.e[0]);
-	if (A.e[1] >= A.e[0] && A.e[1] >= A.e[2])
-		return(A.e[1]);
-	if (A.e[2] >= A.e[0] && A.e[2] >= A.e[1])
-		return(A.e[2]);
+	_SYL_PROFILE(s_vec3_max);
+	float a = A.x > A.y ? A.x : A.y;
+	return(a > A.z ? a : A.z);
+}
 
-	return(A.e[0]); // HMMMMMMMMMMMMMMMMMMMM
+/* Return the smollest element inside vec3 */
+SYL_INLINE float s_vec3_min(svec3 A)
+{
+	_SYL_PROFILE(s_vec3_min);
+	float a = A.x < A.y ? A.x : A.y;
+	return(a < A.z ? a : A.z);
 }
 
-/* Return the smollest element inside vec4 */
+/* Old name of s_vec3_min */
 SYL_INLINE float s_vec3_min_value(svec3 A)
 {
-	/* NOTE(hsnovel): Current SSE4 version doesn't work. It is removed for now. Reimplement it later.*/
-	if (A.e[0] <= A.e[1] && A.e[0] <= A.e[2])
-		return(A.e[0]);
-	if (A.e[1] <= A.e[0] && A.e[1] <= A.e[2])
-		return(A.e[1]);
-	if (A.e[2] <= A.e[0] && A.e[2] <= A.e[1])
-		return(A.e[2]);
+	_SYL_PROFILE(s_vec3_min_value);
+	return(s_vec3_min(A));
+}
 
-	return(A.e[0]); // HMMMMMMMMMMMMMMMMMMMM
+/* Add all components of the vector together */
+SYL_INLINE float s_vec3_sum(svec3 vec1)
+{
+	_SYL_PROFILE(s_vec3_sum);
+	return(vec1.x + vec1.y + vec1.z);
 }
 
 /* Per component comparsion to return a vector containing the largest components */
 SYL_INLINE svec3 s_vec3_max_vector(svec3 vec1, svec3 vec2)
 {
+	_SYL_PROFILE(s_vec3_max_vector);
 #if defined (SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
-	__m128 r = _mm_max_ps(_mm_load_ps(vec1.e), _mm_load_ps(vec2.e));
-	return *(svec3*)&r;
+	__m128 r = _mm_max_ps(_s_load_vec3(&vec1), _s_load_vec3(&vec2));
+	return(_s_store_vec3(r));
 #else
 	svec3 Result;
 	if (vec1.x > vec2.x)
@@ -2011,9 +2803,10 @@ SYL_INLINE svec3 s_vec3_max_vector(svec3 vec1, svec3 vec2)
 /* Per component comparsion to return a vector containing the smollest components */
 SYL_INLINE svec3 s_vec3_min_vector(svec3 vec1, svec3 vec2)
 {
+	_SYL_PROFILE(s_vec3_min_vector);
 #if defined (SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
-	__m128 r = _mm_min_ps(_mm_load_ps(vec1.e), _mm_load_ps(vec2.e));
-	return *(svec3*)&r;
+	__m128 r = _mm_min_ps(_s_load_vec3(&vec1), _s_load_vec3(&vec2));
+	return(_s_store_vec3(r));
 #else
 	svec3 Result;
 	if (vec1.x < vec2.x)
@@ -2037,10 +2830,11 @@ SYL_INLINE svec3 s_vec3_min_vector(svec3 vec1, svec3 vec2)
 
 SYL_INLINE svec3 s_vec3_clamp(svec3 value, svec3 Min, svec3 Max)
 {
+	_SYL_PROFILE(s_vec3_clamp);
 #if defined (SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
 	__m128 Result = _mm_max_ps(_mm_setr_ps(Min.x, Min.y, Min.z, 0.0f), _mm_setr_ps(value.x, value.y, value.z, 0.0f));
 	Result = _mm_min_ps(_mm_setr_ps(Max.x, Max.y, Max.z, 0.0f), Result);
-	return *(svec3*)&Result;
+	return(_s_store_vec3(Result));
 #else
 	svec3 Result = s_vec3_min_vector(s_vec3_max_vector(value, Min), Max);
 	return(Result);
@@ -2050,6 +2844,7 @@ SYL_INLINE svec3 s_vec3_clamp(svec3 value, svec3 Min, svec3 Max)
 /* TODO(hsnovel): Faster ! */
 SYL_INLINE svec3 s_vec3_lerp(svec3 vec1, svec3 vec2, float t)
 {
+	_SYL_PROFILE(s_vec3_lerp);
 	svec3 Result = { { vec1.e[0] + ((vec2.e[0] - vec1.e[0]) * t),
 				   vec1.e[1] + ((vec2.e[1] - vec1.e[1]) * t),
 				   vec1.e[2] + ((vec2.e[2] - vec1.e[2]) * t) } };
@@ -2059,12 +2854,14 @@ SYL_INLINE svec3 s_vec3_lerp(svec3 vec1, svec3 vec2, float t)
 
 SYL_INLINE svec3 s_vec3_project(svec3 vectorToProject, svec3 Projectionvector)
 {
+	_SYL_PROFILE(s_vec3_project);
 	float scale = s_vec3_dot(Projectionvector, vectorToProject) / s_vec3_dot(Projectionvector, Projectionvector);
 	return(s_vec3_mul_scalar(Projectionvector, scale));
 }
 
 SYL_INLINE svec3 s_vec3_cross(svec3 vec1, svec3 vec2)
 {
+	_SYL_PROFILE(s_vec3_cross);
 #if defined(SYL_DEBUG)
 	svec3 Result;
 	Result.x = vec1.y * vec2.z - vec1.z * vec2.y;
@@ -2073,16 +2870,15 @@ SYL_INLINE svec3 s_vec3_cross(svec3 vec1, svec3 vec2)
 	return(Result);
 #else
 #if defined (SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
-	__m128 V1 = _mm_load_ps(vec1.e);
-	__m128 V2 = _mm_load_ps(vec2.e);
+	__m128 V1 = _s_load_vec3(&vec1);
+	__m128 V2 = _s_load_vec3(&vec2);
 	__m128 A1 = _SYL_PERMUTE_PS(V1, _SYL_SHUFFLE(3, 0, 2, 1));
 	__m128 A2 = _SYL_PERMUTE_PS(V2, _SYL_SHUFFLE(3, 1, 0, 2));
 	__m128 r = _mm_mul_ps(A1, A2);
 	A1 = _SYL_PERMUTE_PS(A1, _MM_SHUFFLE(3, 0, 2, 1));
 	A2 = _SYL_PERMUTE_PS(A2, _MM_SHUFFLE(3, 1, 0, 2));
 	r = _SYL_ADD_PS(A1, A2, r);
-	__m128 re = _mm_and_ps(r, _S_XMM_MASK_3);
-	return *(svec3*)&re;
+	return(_s_store_vec3(r));
 #else
 	svec3 Result = { { vec1.e[1] * vec2.e[2] - vec1.e[2] * vec2.e[1],
 				   vec1.e[2] * vec2.e[0] - vec1.e[0] * vec2.e[2],
@@ -2136,6 +2932,7 @@ SYL_INLINE svec4 SVEC4VF(svec3 vector, float value)
 
 SYL_INLINE void s_vector4_zero(svec4* vector)
 {
+	_SYL_PROFILE(s_vector4_zero);
 #if defined(SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
 	_mm_store_ps(vector->e, _S_XMM_ZERO);
 #else
@@ -2148,11 +2945,12 @@ SYL_INLINE void s_vector4_zero(svec4* vector)
 
 SYL_INLINE bool s_vec4_equal(svec4 vec1, svec4 vec2)
 {
+	_SYL_PROFILE(s_vec4_equal);
 #if defined (SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
 	__m128 Result = _mm_cmpeq_ps(_mm_load_ps(vec1.e), _mm_load_ps(vec2.e));
 	return ((_mm_movemask_ps(Result) == 0x0f) != 0);
 #else
-	if ((vec1.x == vec2.x) && (vec1.y == vec2.y) && (vec1.z == vec2.z)) {
+	if ((vec1.x == vec2.x) && (vec1.y == vec2.y) && (vec1.z == vec2.z) && (vec1.w == vec2.w)) {
 		return(true);
 	}
 	else {
@@ -2163,11 +2961,12 @@ SYL_INLINE bool s_vec4_equal(svec4 vec1, svec4 vec2)
 
 SYL_INLINE bool s_vec4_equal_scalar(svec4 vec1, float value)
 {
+	_SYL_PROFILE(s_vec4_equal_scalar);
 #if defined (SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
 	__m128 Result = _mm_cmpeq_ps(_mm_load_ps(vec1.e), _mm_set1_ps(value));
 	return ((_mm_movemask_ps(Result) == 0x0f) != 0);
 #else
-	if ((vec1.x == value) && (vec1.y == value) && (vec1.z == value)) {
+	if ((vec1.x == value) && (vec1.y == value) && (vec1.z == value) && (vec1.w == value)) {
 		return(true);
 	}
 	else {
@@ -2178,11 +2977,12 @@ SYL_INLINE bool s_vec4_equal_scalar(svec4 vec1, float value)
 
 SYL_INLINE bool s_vec4_not_equal(svec4 vec1, svec4 vec2)
 {
+	_SYL_PROFILE(s_vec4_not_equal);
 #if defined (SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
 	__m128 Result = _mm_cmpneq_ps(_mm_load_ps(vec1.e), _mm_load_ps(vec2.e));
 	return ((_mm_movemask_ps(Result) == 0x0f) != 0);
 #else
-	if ((vec1.x != vec2.x) && (vec1.y != vec2.y) && (vec1.z != vec2.z)) {
+	if ((vec1.x != vec2.x) && (vec1.y != vec2.y) && (vec1.z != vec2.z) && (vec1.w != vec2.w)) {
 		return(true);
 	}
 	else {
@@ -2194,11 +2994,12 @@ SYL_INLINE bool s_vec4_not_equal(svec4 vec1, svec4 vec2)
 
 SYL_INLINE bool s_vec4_not_equal_scalar(svec4 vec1, float value)
 {
+	_SYL_PROFILE(s_vec4_not_equal_scalar);
 #if defined (SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
 	__m128 Result = _mm_cmpneq_ps(_mm_load_ps(vec1.e), _mm_set1_ps(value));
 	return ((_mm_movemask_ps(Result) == 0x0f) != 0);
 #else
-	if ((vec1.x != value) && (vec1.y != value) && (vec1.z != value)) {
+	if ((vec1.x != value) && (vec1.y != value) && (vec1.z != value) && (vec1.w != value)) {
 		return(true);
 	}
 	else {
@@ -2209,11 +3010,12 @@ SYL_INLINE bool s_vec4_not_equal_scalar(svec4 vec1, float value)
 
 SYL_INLINE bool s_vec4_greater(svec4 vec1, svec4 vec2)
 {
+	_SYL_PROFILE(s_vec4_greater);
 #if defined (SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
 	__m128 Result = _mm_cmpgt_ps(_mm_load_ps(vec1.e), _mm_load_ps(vec2.e));
 	return ((_mm_movemask_ps(Result) == 0x0f) != 0);
 #else
-	if ((vec1.x > vec2.x) && (vec1.y > vec2.y) && (vec1.z > vec2.y)) {
+	if ((vec1.x > vec2.x) && (vec1.y > vec2.y) && (vec1.z > vec2.z) && (vec1.w > vec2.w)) {
 		return(true);
 	}
 	else {
@@ -2224,11 +3026,12 @@ SYL_INLINE bool s_vec4_greater(svec4 vec1, svec4 vec2)
 
 SYL_INLINE bool s_vec4_less(svec4 vec1, svec4 vec2)
 {
+	_SYL_PROFILE(s_vec4_less);
 #if defined (SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
 	__m128 Result = _mm_cmplt_ps(_mm_load_ps(vec1.e), _mm_load_ps(vec2.e));
 	return ((_mm_movemask_ps(Result) == 0x0f) != 0);
 #else
-	if ((vec1.x < vec2.x) && (vec1.y < vec2.y) && (vec1.z < vec2.y)) {
+	if ((vec1.x < vec2.x) && (vec1.y < vec2.y) && (vec1.z < vec2.z) && (vec1.w < vec2.w)) {
 		return(true);
 	}
 	else {
@@ -2239,11 +3042,12 @@ SYL_INLINE bool s_vec4_less(svec4 vec1, svec4 vec2)
 
 SYL_INLINE bool s_vec4_less_scalar(svec4 vec1, float value)
 {
+	_SYL_PROFILE(s_vec4_less_scalar);
 #if defined (SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
 	__m128 Result = _mm_cmplt_ps(_mm_load_ps(vec1.e), _mm_set1_ps(value));
 	return ((_mm_movemask_ps(Result) == 0x0f) != 0);
 #else
-	if ((vec1.x < value) && (vec1.y < value) && (vec1.z < value)) {
+	if ((vec1.x < value) && (vec1.y < value) && (vec1.z < value) && (vec1.w < value)) {
 		return(true);
 	}
 	else {
@@ -2255,11 +3059,12 @@ SYL_INLINE bool s_vec4_less_scalar(svec4 vec1, float value)
 
 SYL_INLINE bool s_vec4_greater_equal(svec4 vec1, svec4 vec2)
 {
+	_SYL_PROFILE(s_vec4_greater_equal);
 #if defined (SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
 	__m128 Result = _mm_cmpge_ps(_mm_load_ps(vec1.e), _mm_load_ps(vec2.e));
 	return ((_mm_movemask_ps(Result) == 0x0f) != 0);
 #else
-	if ((vec1.x >= vec2.x) && (vec1.y >= vec2.y) && (vec1.z >= vec2.y)) {
+	if ((vec1.x >= vec2.x) && (vec1.y >= vec2.y) && (vec1.z >= vec2.z) && (vec1.w >= vec2.w)) {
 		return(true);
 	}
 	else {
@@ -2270,11 +3075,12 @@ SYL_INLINE bool s_vec4_greater_equal(svec4 vec1, svec4 vec2)
 
 SYL_INLINE bool s_vec4_greater_equal_scalar(svec4 vec1, float value)
 {
+	_SYL_PROFILE(s_vec4_greater_equal_scalar);
 #if defined (SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
 	__m128 Result = _mm_cmpge_ps(_mm_load_ps(vec1.e), _mm_set1_ps(value));
 	return ((_mm_movemask_ps(Result) == 0x0f) != 0);
 #else
-	if ((vec1.x >= value) && (vec1.y >= value) && (vec1.z >= value)) {
+	if ((vec1.x >= value) && (vec1.y >= value) && (vec1.z >= value) && (vec1.w >= value)) {
 		return(true);
 	}
 	else {
@@ -2285,11 +3091,12 @@ SYL_INLINE bool s_vec4_greater_equal_scalar(svec4 vec1, float value)
 
 SYL_INLINE bool s_vec4_less_equal(svec4 vec1, svec4 vec2)
 {
+	_SYL_PROFILE(s_vec4_less_equal);
 #if defined (SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
 	__m128 Result = _mm_cmple_ps(_mm_load_ps(vec1.e), _mm_load_ps(vec2.e));
 	return ((_mm_movemask_ps(Result) == 0x0f) != 0);
 #else
-	if ((vec1.x <= vec2.x) && (vec1.y <= vec2.y) && (vec1.z <= vec2.y)) {
+	if ((vec1.x <= vec2.x) && (vec1.y <= vec2.y) && (vec1.z <= vec2.z) && (vec1.w <= vec2.w)) {
 		return(true);
 	}
 	else {
@@ -2301,11 +3108,12 @@ SYL_INLINE bool s_vec4_less_equal(svec4 vec1, svec4 vec2)
 
 SYL_INLINE bool s_vec4_less_equal_scalar(svec4 vec1, float value)
 {
+	_SYL_PROFILE(s_vec4_less_equal_scalar);
 #if defined (SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
 	__m128 Result = _mm_cmple_ps(_mm_load_ps(vec1.e), _mm_set1_ps(value));
 	return ((_mm_movemask_ps(Result) == 0x0f) != 0);
 #else
-	if ((vec1.x <= value) && (vec1.y <= value) && (vec1.z <= value)) {
+	if ((vec1.x <= value) && (vec1.y <= value) && (vec1.z <= value) && (vec1.w <= value)) {
 		return(true);
 	}
 	else {
@@ -2316,6 +3124,7 @@ SYL_INLINE bool s_vec4_less_equal_scalar(svec4 vec1, float value)
 
 SYL_INLINE svec4 s_vec4_add(svec4 vec1, svec4 vec2)
 {
+	_SYL_PROFILE(s_vec4_add);
 #if defined (SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
 	__m128 r = _mm_add_ps(vec1.v, vec2.v);
 	return *(svec4*)&r;
@@ -2327,6 +3136,7 @@ SYL_INLINE svec4 s_vec4_add(svec4 vec1, svec4 vec2)
 
 SYL_INLINE svec4 s_vec4p_add(svec4* vec1, svec4 vec2)
 {
+	_SYL_PROFILE(s_vec4p_add);
 #if defined (SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
 	__m128 r = _mm_add_ps(vec1->v, vec2.v);
 	*vec1 = *(svec4*)&r;
@@ -2342,6 +3152,7 @@ SYL_INLINE svec4 s_vec4p_add(svec4* vec1, svec4 vec2)
 
 SYL_INLINE svec4 s_vec4_add_scalar(svec4 vec1, float value)
 {
+	_SYL_PROFILE(s_vec4_add_scalar);
 #if defined (SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
 	__m128 r = _mm_add_ps(vec1.v, _mm_set1_ps(value));
 	return *(svec4*)&r;
@@ -2353,6 +3164,7 @@ SYL_INLINE svec4 s_vec4_add_scalar(svec4 vec1, float value)
 
 SYL_INLINE svec4 s_vec4p_add_scalar(svec4* vec1, float value)
 {
+	_SYL_PROFILE(s_vec4p_add_scalar);
 #if defined (SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
 	__m128 r = _mm_add_ps(vec1->v, _mm_set1_ps(value));
 	*vec1 = *(svec4*)&r;
@@ -2368,6 +3180,7 @@ SYL_INLINE svec4 s_vec4p_add_scalar(svec4* vec1, float value)
 
 SYL_INLINE svec4 s_vec4_sub(svec4 vec1, svec4 vec2)
 {
+	_SYL_PROFILE(s_vec4_sub);
 #if defined (SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
 	__m128 r = _mm_sub_ps(vec1.v, vec2.v);
 	return *(svec4*)&r;
@@ -2379,6 +3192,7 @@ SYL_INLINE svec4 s_vec4_sub(svec4 vec1, svec4 vec2)
 
 SYL_INLINE svec4 s_vec4p_sub(svec4* vec1, svec4 vec2)
 {
+	_SYL_PROFILE(s_vec4p_sub);
 #if defined (SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
 	__m128 r = _mm_sub_ps(vec1->v, vec2.v);
 	*vec1 = *(svec4*)&r;
@@ -2394,6 +3208,7 @@ SYL_INLINE svec4 s_vec4p_sub(svec4* vec1, svec4 vec2)
 
 SYL_INLINE svec4 s_vec4_sub_scalar(svec4 vec1, float value)
 {
+	_SYL_PROFILE(s_vec4_sub_scalar);
 #if defined (SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
 	__m128 r = _mm_sub_ps(vec1.v, _mm_set1_ps(value));
 	return *(svec4*)&r;
@@ -2405,6 +3220,7 @@ SYL_INLINE svec4 s_vec4_sub_scalar(svec4 vec1, float value)
 
 SYL_INLINE svec4 s_vec4p_sub_scalar(svec4* vec1, float value)
 {
+	_SYL_PROFILE(s_vec4p_sub_scalar);
 #if defined (SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
 	__m128 r = _mm_sub_ps(vec1->v, _mm_set1_ps(value));
 	*vec1 = *(svec4*)&r;
@@ -2420,6 +3236,7 @@ SYL_INLINE svec4 s_vec4p_sub_scalar(svec4* vec1, float value)
 
 SYL_INLINE svec4 s_scalar_vec4_sub(float value, svec4 vec1)
 {
+	_SYL_PROFILE(s_scalar_vec4_sub);
 #if defined (SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
 	__m128 r = _mm_sub_ps(_mm_set1_ps(value), vec1.v);
 	return *(svec4*)&r;
@@ -2431,6 +3248,7 @@ SYL_INLINE svec4 s_scalar_vec4_sub(float value, svec4 vec1)
 
 SYL_INLINE svec4 s_scalar_sub_vec4p(float value, svec4* vec1)
 {
+	_SYL_PROFILE(s_scalar_sub_vec4p);
 #if defined (SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
 	__m128 r = _mm_sub_ps(_mm_set1_ps(value), vec1->v);
 	*vec1 = *(svec4*)&r;
@@ -2447,17 +3265,19 @@ SYL_INLINE svec4 s_scalar_sub_vec4p(float value, svec4* vec1)
 
 SYL_INLINE svec4 s_vec4_mul(svec4 vec1, svec4 vec2)
 {
+	_SYL_PROFILE(s_vec4_mul);
 #if defined (SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
 	__m128 r = _mm_mul_ps(vec1.v, _mm_load_ps(vec2.e));
 	return *(svec4*)&r;
 #else
-	svec4 Result = { { (vec1.x - vec2.x), (vec1.y - vec2.y), (vec1.z - vec2.z), (vec1.w - vec2.w) } };
+	svec4 Result = { { (vec1.x * vec2.x), (vec1.y * vec2.y), (vec1.z * vec2.z), (vec1.w * vec2.w) } };
 	return(Result);
 #endif
 }
 
 SYL_INLINE svec4 s_vec4p_mul(svec4* vec1, svec4 vec2)
 {
+	_SYL_PROFILE(s_vec4p_mul);
 #if defined (SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
 	__m128 r = _mm_mul_ps(vec1->v, _mm_load_ps(vec2.e));
 	*vec1 = *(svec4*)&r;
@@ -2473,6 +3293,7 @@ SYL_INLINE svec4 s_vec4p_mul(svec4* vec1, svec4 vec2)
 
 SYL_INLINE svec4 s_vec4_mul_scalar(svec4 vec1, float value)
 {
+	_SYL_PROFILE(s_vec4_mul_scalar);
 #if defined (SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
 	__m128 r = _mm_mul_ps(vec1.v, _mm_set1_ps(value));
 	return *(svec4*)&r;
@@ -2484,6 +3305,7 @@ SYL_INLINE svec4 s_vec4_mul_scalar(svec4 vec1, float value)
 
 SYL_INLINE svec4 s_vec4p_mul_scalar(svec4* vec1, float value)
 {
+	_SYL_PROFILE(s_vec4p_mul_scalar);
 #if defined (SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
 	__m128 r = _mm_mul_ps(vec1->v, _mm_set1_ps(value));
 	*vec1 = *(svec4*)&r;
@@ -2499,6 +3321,7 @@ SYL_INLINE svec4 s_vec4p_mul_scalar(svec4* vec1, float value)
 
 SYL_INLINE svec4 s_vec4_div(svec4 vec1, svec4 vec2)
 {
+	_SYL_PROFILE(s_vec4_div);
 #if defined (SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
 	__m128 r = _mm_div_ps(vec1.v, vec2.v);
 	return *(svec4*)&r;
@@ -2510,6 +3333,7 @@ SYL_INLINE svec4 s_vec4_div(svec4 vec1, svec4 vec2)
 
 SYL_INLINE svec4 s_vec4p_div(svec4* vec1, svec4 vec2)
 {
+	_SYL_PROFILE(s_vec4p_div);
 #if defined (SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
 	__m128 Result = _mm_div_ps(vec1->v, vec2.v);
 	*vec1 = *(svec4*)&Result;
@@ -2525,6 +3349,7 @@ SYL_INLINE svec4 s_vec4p_div(svec4* vec1, svec4 vec2)
 
 SYL_INLINE svec4 s_vec4_div_scalar(svec4 vec1, float value)
 {
+	_SYL_PROFILE(s_vec4_div_scalar);
 #if defined (SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
 	__m128 Result = _mm_div_ps(vec1.v, _mm_set1_ps(value));
 	return *(svec4*)&Result;
@@ -2536,6 +3361,7 @@ SYL_INLINE svec4 s_vec4_div_scalar(svec4 vec1, float value)
 
 SYL_INLINE svec4 s_vec4p_div_scalar(svec4* vec1, float value)
 {
+	_SYL_PROFILE(s_vec4p_div_scalar);
 #if defined (SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
 	__m128 Result = _mm_div_ps(vec1->v, _mm_set1_ps(value));
 	*vec1 = *(svec4*)&Result;
@@ -2551,6 +3377,7 @@ SYL_INLINE svec4 s_vec4p_div_scalar(svec4* vec1, float value)
 
 SYL_INLINE svec4 s_vec4_floor(svec4 A)
 {
+	_SYL_PROFILE(s_vec4_floor);
 	svec4 Result = { { s_floorf(A.x), s_floorf(A.y), s_floorf(A.z), s_floorf(A.w) } };
 	return(Result);
 }
@@ -2558,6 +3385,7 @@ SYL_INLINE svec4 s_vec4_floor(svec4 A)
 /* Round all components of the vec3 to nearest integer*/
 SYL_INLINE svec4 s_vec4_round(svec4 A)
 {
+	_SYL_PROFILE(s_vec4_round);
 	svec4 Result = { { s_roundf(A.x), s_roundf(A.y), s_roundf(A.z), s_roundf(A.w) } };
 	return(Result);
 }
@@ -2565,6 +3393,7 @@ SYL_INLINE svec4 s_vec4_round(svec4 A)
 /* Negate all components of the vector */
 SYL_INLINE svec4 s_vec4_negate(svec4 a)
 {
+	_SYL_PROFILE(s_vec4_negate);
 #if defined (SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
 	__m128 Result = _mm_sub_ps(_mm_set1_ps(0), a.v);
 	return *(svec4*)&Result;
@@ -2576,6 +3405,7 @@ SYL_INLINE svec4 s_vec4_negate(svec4 a)
 
 SYL_INLINE float s_vec4_dot(svec4 vec1, svec4 vec2)
 {
+	_SYL_PROFILE(s_vec4_dot);
 #if defined(SYL_DEBUG)
 	return((vec1.x * vec2.x) + (vec1.y * vec2.y) + (vec1.z * vec2.z) + (vec1.w * vec2.w));
 #else
@@ -2590,14 +3420,16 @@ SYL_INLINE float s_vec4_dot(svec4 vec1, svec4 vec2)
 
 SYL_INLINE svec4 s_vec4_hadamard(svec4 vec1, svec4 vec2)
 {
+	_SYL_PROFILE(s_vec4_hadamard);
 	svec4 Result = { { (vec1.x * vec2.x), (vec1.y * vec2.y), (vec1.z * vec2.z), (vec1.w * vec2.w) } };
 	return(Result);
 }
 
 SYL_INLINE float s_vec4_length(svec4 vec1)
 {
+	_SYL_PROFILE(s_vec4_length);
 #if defined(SYL_DEBUG)
-	return(sqrt((vec1.x * vec1.x) + (vec1.y * vec1.y) + (vec1.z * vec1.z) + (vec1.w * vec1.w)));
+	return(sqrtf((vec1.x * vec1.x) + (vec1.y * vec1.y) + (vec1.z * vec1.z) + (vec1.w * vec1.w)));
 #else
 #if defined (SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
 	__m128 V = _mm_load_ps(vec1.e);
@@ -2606,23 +3438,28 @@ SYL_INLINE float s_vec4_length(svec4 vec1)
 	__m128 A3 = _mm_hadd_ps(A2, A2);
 	return sqrtf(_mm_cvtss_f32(A3));
 #else
-	return(sqrt((vec1.x * vec1.x) + (vec1.y * vec1.y) + (vec1.z * vec1.z) + (vec1.w * vec1.w)));
+	return(sqrtf((vec1.x * vec1.x) + (vec1.y * vec1.y) + (vec1.z * vec1.z) + (vec1.w * vec1.w)));
 #endif
 #endif
 }
 
 SYL_INLINE float s_vec4_distance(svec4 vec1, svec4 vec2)
 {
+	_SYL_PROFILE(s_vec4_distance);
 	return s_vec4_length(s_vec4_sub(vec1, vec2));
 }
 
 SYL_INLINE svec4 s_vec4_normalize(svec4 a)
 {
-	return(s_vec4_mul_scalar(a, (1.0f / s_vec4_length(a))));
+	_SYL_PROFILE(s_vec4_normalize);
+	float LengthSq = s_vec4_dot(a, a);
+	/* Vectors too short to normalize become zero instead of NaN, as in the array kernels */
+	return(s_vec4_mul_scalar(a, LengthSq > _SYL_VEC_EPSILON_SQ ? 1.0f / sqrtf(LengthSq) : 0.0f));
 }
 
 SYL_INLINE svec4 s_vec4_lerp(svec4 vec1, svec4 vec2, float t)
 {
+	_SYL_PROFILE(s_vec4_lerp);
 #if defined (SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
 	__m128 Result = _mm_add_ps(vec1.v, _mm_mul_ps((_mm_sub_ps(vec2.v, vec1.v)), _mm_set1_ps(t)));
 	return(*(svec4*)&Result);
@@ -2635,6 +3472,7 @@ SYL_INLINE svec4 s_vec4_lerp(svec4 vec1, svec4 vec2, float t)
 
 SYL_INLINE svec4 s_vec4_cross(svec4 vec1, svec4 vec2)
 {
+	_SYL_PROFILE(s_vec4_cross);
 #if defined (SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
 	__m128 a1 = _SYL_PERMUTE_PS(vec1.v, _SYL_SHUFFLE(3, 0, 2, 1));
 	__m128 a2 = _SYL_PERMUTE_PS(vec2.v, _SYL_SHUFFLE(3, 1, 0, 2));
@@ -2642,7 +3480,7 @@ SYL_INLINE svec4 s_vec4_cross(svec4 vec1, svec4 vec2)
 	a1 = _SYL_PERMUTE_PS(a1, _SYL_SHUFFLE(3, 0, 2, 1));
 	a2 = _SYL_PERMUTE_PS(a2, _SYL_SHUFFLE(3, 1, 0, 2));
 	r = _SYL_ADD_PS(a1, a2, r);
-	__m128 re = _mm_and_ps(r, _S_XMM_MASK_3);
+	__m128 re = _mm_blend_ps(r, _S_XMM_ZERO, 8);
 	return *(svec4*)&re;
 #else
 	svec4 Result = { { vec1.e[1] * vec2.e[2] - vec1.e[2] * vec2.e[1],
@@ -2654,6 +3492,7 @@ SYL_INLINE svec4 s_vec4_cross(svec4 vec1, svec4 vec2)
 
 SYL_INLINE svec4 s_vec4_project(svec4 vectorToProject, svec4 Projectionvector)
 {
+	_SYL_PROFILE(s_vec4_project);
 	float scale = s_vec4_dot(Projectionvector, vectorToProject) / s_vec4_dot(Projectionvector, Projectionvector);
 	return(s_vec4_mul_scalar(Projectionvector, scale));
 }
@@ -2661,6 +3500,7 @@ SYL_INLINE svec4 s_vec4_project(svec4 vectorToProject, svec4 Projectionvector)
 /* Per component comparsion to return a vector containing the largest components */
 SYL_INLINE svec4 s_vec4_max_vector(svec4 vec1, svec4 vec2)
 {
+	_SYL_PROFILE(s_vec4_max_vector);
 #if defined (SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
 	__m128 Result = _mm_max_ps(vec1.v, vec2.v);
 	return *(svec4*)&Result;
@@ -2693,6 +3533,7 @@ SYL_INLINE svec4 s_vec4_max_vector(svec4 vec1, svec4 vec2)
 /* Per component comparsion to return a vector containing the smollest components */
 SYL_INLINE svec4 s_vec4_min_vector(svec4 vec1, svec4 vec2)
 {
+	_SYL_PROFILE(s_vec4_min_vector);
 #if defined (SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
 	__m128 Result = _mm_min_ps(vec1.v, vec2.v);
 	return *(svec4*)&Result;
@@ -2724,6 +3565,7 @@ SYL_INLINE svec4 s_vec4_min_vector(svec4 vec1, svec4 vec2)
 
 SYL_INLINE svec4 s_vec4_clamp(svec4 value, svec4 Min, svec4 max)
 {
+	_SYL_PROFILE(s_vec4_clamp);
 #if defined (SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
 	// __m128 Result = _mm_max_ps(Min.v, max.v);
 	// Result = _mm_max_ps(max.v, Result);
@@ -2740,31 +3582,38 @@ SYL_INLINE svec4 s_vec4_clamp(svec4 value, svec4 Min, svec4 max)
 /* Return the biggest element inside vec4 */
 SYL_INLINE float s_vec4_max(svec4 A)
 {
+	_SYL_PROFILE(s_vec4_max);
 #if defined (SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
 	__m128 value = _mm_load_ps(A.e);
-	__m128 r = _mm_max_ps(value, value);
-	return *(float*)&r;
+	__m128 r = _mm_max_ps(value, _SYL_PERMUTE_PS(value, _SYL_SHUFFLE(2, 3, 0, 1)));
+	r = _mm_max_ps(r, _SYL_PERMUTE_PS(r, _SYL_SHUFFLE(1, 0, 3, 2)));
+	return(_mm_cvtss_f32(r));
 #else
-	/* TODO(hsnovel): Implement ! */
-	return(A.e[0]);
+	float a = A.x > A.y ? A.x : A.y;
+	float b = A.z > A.w ? A.z : A.w;
+	return(a > b ? a : b);
 #endif
 }
 
 /* Return the smollest element inside vec4 */
 SYL_INLINE float s_vec4_min(svec4 A)
 {
+	_SYL_PROFILE(s_vec4_min);
 #if defined (SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
 	__m128 value = _mm_load_ps(A.e);
-	__m128 r = _mm_min_ps(value, value);
-	return *(float*)&r;
+	__m128 r = _mm_min_ps(value, _SYL_PERMUTE_PS(value, _SYL_SHUFFLE(2, 3, 0, 1)));
+	r = _mm_min_ps(r, _SYL_PERMUTE_PS(r, _SYL_SHUFFLE(1, 0, 3, 2)));
+	return(_mm_cvtss_f32(r));
 #else
-	/* TODO(hsnovel): Implement ! */
-	return(A.e[0]);
+	float a = A.x < A.y ? A.x : A.y;
+	float b = A.z < A.w ? A.z : A.w;
+	return(a < b ? a : b);
 #endif
 }
 
 SYL_INLINE float s_vec4_sum(svec4 vec1)
 {
+	_SYL_PROFILE(s_vec4_sum);
 	return((vec1.x + vec1.y) + (vec1.z + vec1.w));
 }
 
@@ -2777,10 +3626,10 @@ SYL_INLINE smat4 SMAT4(float value)
 {
 #if defined (SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
 	smat4 R;
-	R.v[0] = _mm_set_ps(value, 0, 0, 0);
-	R.v[1] = _mm_set_ps(0, value, 0, 0);
-	R.v[2] = _mm_set_ps(0, 0, value, 0);
-	R.v[3] = _mm_set_ps(0, 0, 0, value);
+	R.v[0] = _mm_setr_ps(value, 0, 0, 0);
+	R.v[1] = _mm_setr_ps(0, value, 0, 0);
+	R.v[2] = _mm_setr_ps(0, 0, value, 0);
+	R.v[3] = _mm_setr_ps(0, 0, 0, value);
 	return(R);
 #else
 	smat4 Result = { { value, 0, 0, 0,
@@ -2798,10 +3647,10 @@ SYL_INLINE smat4 SMAT4F(float m00, float m01, float m02, float m03,
 {
 #if defined (SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
 	smat4 R;
-	R.v[0] = _mm_set_ps(m00, m01, m02, m03);
-	R.v[1] = _mm_set_ps(m10, m11, m12, m13);
-	R.v[2] = _mm_set_ps(m20, m21, m22, m23);
-	R.v[3] = _mm_set_ps(m30, m31, m32, m33);
+	R.v[0] = _mm_setr_ps(m00, m01, m02, m03);
+	R.v[1] = _mm_setr_ps(m10, m11, m12, m13);
+	R.v[2] = _mm_setr_ps(m20, m21, m22, m23);
+	R.v[3] = _mm_setr_ps(m30, m31, m32, m33);
 	return(R);
 #else
 	smat4 Result = { { m00, m01, m02, m03,
@@ -2816,10 +3665,10 @@ SYL_INLINE smat4 SMAT4A(float* a)
 {
 #if defined (SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
 	smat4 R;
-	R.v[0] = _mm_set_ps(a[0], a[1], a[2], a[3]);
-	R.v[1] = _mm_set_ps(a[4], a[5], a[6], a[7]);
-	R.v[2] = _mm_set_ps(a[8], a[9], a[10], a[11]);
-	R.v[3] = _mm_set_ps(a[12], a[13], a[14], a[15]);
+	R.v[0] = _mm_setr_ps(a[0], a[1], a[2], a[3]);
+	R.v[1] = _mm_setr_ps(a[4], a[5], a[6], a[7]);
+	R.v[2] = _mm_setr_ps(a[8], a[9], a[10], a[11]);
+	R.v[3] = _mm_setr_ps(a[12], a[13], a[14], a[15]);
 	return(R);
 #else
 	smat4 Result = { { a[0], a[1], a[2], a[3],
@@ -2832,9 +3681,10 @@ SYL_INLINE smat4 SMAT4A(float* a)
 
 SYL_INLINE void s_mat4_zero(smat4* Matrix)
 {
+	_SYL_PROFILE(s_mat4_zero);
 #if defined(SYL_ENABLE_AVX)
-	_mm256_store_ps(Matrix.e, _S_YMM_ZERO);
-	_mm256_store_ps(Matrix.e + 8, _S_YMM_ZERO);
+	_mm256_storeu_ps(Matrix->e, _S_YMM_ZERO);
+	_mm256_storeu_ps(Matrix->e + 8, _S_YMM_ZERO);
 #elif defined(SYL_ENABLE_SSE4)
 	_mm_store_ps(Matrix->e, _S_XMM_ZERO);
 	_mm_store_ps(Matrix->e + 4, _S_XMM_ZERO);
@@ -2847,11 +3697,13 @@ SYL_INLINE void s_mat4_zero(smat4* Matrix)
 
 SYL_INLINE smat4 s_mat4_identity()
 {
+	_SYL_PROFILE(s_mat4_identity);
 	return(_S_IDENT4X4);
 }
 
 SYL_INLINE void s_mat4_identityp(smat4 *ptr)
 {
+	_SYL_PROFILE(s_mat4_identityp);
 #if defined(SYL_ENABLE_SSE4)
 	ptr->v[0] = _mm_set_ps(0, 0, 0, 1);
 	ptr->v[1] = _mm_set_ps(0, 0, 1, 0);
@@ -2864,6 +3716,7 @@ SYL_INLINE void s_mat4_identityp(smat4 *ptr)
 
 SYL_INLINE bool s_mat4_is_identity(smat4 Mat)
 {
+	_SYL_PROFILE(s_mat4_is_identity);
 #if defined (SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
 	__m128 Temp1 = _mm_cmpeq_ps(Mat.v[0], _S_IDENT4x4R0);
 	__m128 Temp2 = _mm_cmpeq_ps(Mat.v[1], _S_IDENT4x4R1);
@@ -2893,8 +3746,9 @@ SYL_INLINE bool s_mat4_is_identity(smat4 Mat)
 /* Multiply two 4x4 Matricies */
 SYL_INLINE smat4 s_mat4_mul(smat4 Matrix1, smat4 Matrix2)
 {
+	_SYL_PROFILE(s_mat4_mul);
 #if defined(SYL_ENABLE_AVX)
-	mat4 Result;
+	smat4 Result;
 	__m256 Temp0 = _mm256_castps128_ps256(Matrix1.v[0]);
 	Temp0 = _mm256_insertf128_ps(Temp0, Matrix1.v[1], 1);
 
@@ -2951,7 +3805,7 @@ SYL_INLINE smat4 s_mat4_mul(smat4 Matrix1, smat4 Matrix2)
 	return(Result);
 #elif defined(SYL_ENABLE_SSE4)
 
-	smat4 Result = { 0 };
+	smat4 Result;
 
 	__m128 vW = Matrix1.v[0];
 	__m128 vX = _SYL_PERMUTE_PS(vW, _SYL_SHUFFLE(0, 0, 0, 0));
@@ -3036,16 +3890,17 @@ SYL_INLINE smat4 s_mat4_mul(smat4 Matrix1, smat4 Matrix2)
 
 SYL_INLINE smat4 s_mat4_transpose(smat4 Mat)
 {
+	_SYL_PROFILE(s_mat4_transpose);
 #if defined (SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
 	__m128 Temp1 = _mm_shuffle_ps(Mat.v[0], Mat.v[1], _SYL_SHUFFLE(1, 0, 1, 0));
 	__m128 Temp2 = _mm_shuffle_ps(Mat.v[0], Mat.v[1], _SYL_SHUFFLE(3, 2, 3, 2));
 	__m128 Temp3 = _mm_shuffle_ps(Mat.v[2], Mat.v[3], _SYL_SHUFFLE(1, 0, 1, 0));
 	__m128 Temp4 = _mm_shuffle_ps(Mat.v[2], Mat.v[3], _SYL_SHUFFLE(3, 2, 3, 2));
 	smat4 R;
-	R.v[0] = _mm_shuffle_ps(Temp1, Temp2, _SYL_SHUFFLE(2, 0, 2, 0));
-	R.v[1] = _mm_shuffle_ps(Temp1, Temp2, _SYL_SHUFFLE(3, 1, 3, 1));
-	R.v[2] = _mm_shuffle_ps(Temp3, Temp4, _SYL_SHUFFLE(2, 0, 2, 0));
-	R.v[3] = _mm_shuffle_ps(Temp3, Temp4, _SYL_SHUFFLE(3, 1, 3, 1));
+	R.v[0] = _mm_shuffle_ps(Temp1, Temp3, _SYL_SHUFFLE(2, 0, 2, 0));
+	R.v[1] = _mm_shuffle_ps(Temp1, Temp3, _SYL_SHUFFLE(3, 1, 3, 1));
+	R.v[2] = _mm_shuffle_ps(Temp2, Temp4, _SYL_SHUFFLE(2, 0, 2, 0));
+	R.v[3] = _mm_shuffle_ps(Temp2, Temp4, _SYL_SHUFFLE(3, 1, 3, 1));
 	return(R);
 #else
 	smat4 Result;
@@ -3062,15 +3917,16 @@ SYL_INLINE smat4 s_mat4_transpose(smat4 Mat)
 /* Inverse of a matrix but in the scale of this matrix should be 1 */
 SYL_INLINE smat4 s_mat4_inverse_noscale(smat4 Matrix)
 {
+	_SYL_PROFILE(s_mat4_inverse_noscale);
 #if defined (SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
 
 	__m128 Temp0 = _SYL_VEC_SHUFFLE_0101(Matrix.v[0], Matrix.v[1]); // 00, 01, 10, 11
 	__m128 Temp1 = _SYL_VEC_SHUFFLE_2323(Matrix.v[0], Matrix.v[1]); // 02, 03, 12, 13
 
 	smat4 Result;
-	Result.v[0] = _SYL_VEC_SHUFFLE(Temp0, Matrix.v[2], 0, 2, 0, 3); // 00, 10, 20, 23(=0)
-	Result.v[1] = _SYL_VEC_SHUFFLE(Temp0, Matrix.v[2], 1, 3, 1, 3); // 01, 11, 21, 23(=0)
-	Result.v[2] = _SYL_VEC_SHUFFLE(Temp1, Matrix.v[2], 0, 2, 2, 3); // 02, 12, 22, 23(=0)
+	Result.v[0] = _mm_blend_ps(_SYL_VEC_SHUFFLE(Temp0, Matrix.v[2], 0, 2, 0, 3), _S_XMM_ZERO, 8); // 00, 10, 20, 0
+	Result.v[1] = _mm_blend_ps(_SYL_VEC_SHUFFLE(Temp0, Matrix.v[2], 1, 3, 1, 3), _S_XMM_ZERO, 8); // 01, 11, 21, 0
+	Result.v[2] = _mm_blend_ps(_SYL_VEC_SHUFFLE(Temp1, Matrix.v[2], 0, 2, 2, 3), _S_XMM_ZERO, 8); // 02, 12, 22, 0
 
 	Result.v[3] = _mm_mul_ps(Result.v[0], _SYL_VEC_SWIZZLE1(Matrix.v[3], 0));
 	Result.v[3] = _mm_add_ps(Result.v[3], _mm_mul_ps(Result.v[1], _SYL_VEC_SWIZZLE1(Matrix.v[3], 1)));
@@ -3078,8 +3934,18 @@ SYL_INLINE smat4 s_mat4_inverse_noscale(smat4 Matrix)
 	Result.v[3] = _mm_sub_ps(_mm_setr_ps(0.f, 0.f, 0.f, 1.f), Result.v[3]);
 	return(Result);
 #else
-	/* TODO(hsnovel): This is temporary to prevent gcc warning, implemenet this later ! */
-	return(Matrix);
+	smat4 Result;
+	for (int j = 0; j < 3; ++j) {
+		for (int i = 0; i < 3; ++i) {
+			Result.e2[j][i] = Matrix.e2[i][j];
+		}
+		Result.e2[j][3] = 0.0f;
+	}
+	for (int i = 0; i < 3; ++i) {
+		Result.e2[3][i] = -(Result.e2[0][i] * Matrix.m30 + Result.e2[1][i] * Matrix.m31 + Result.e2[2][i] * Matrix.m32);
+	}
+	Result.m33 = 1.0f;
+	return(Result);
 #endif
 }
 
@@ -3120,24 +3986,25 @@ SYL_INLINE smat4 s_mat4_inverse_noscale(smat4 Matrix)
  */
 
 svec4 s_mat4_transform(smat4 Matrix, svec4 vector) {
+	_SYL_PROFILE(s_mat4_transform);
 #if defined (SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
 	svec4 Result;
 	Result.v = _SYL_PERMUTE_PS(vector.v, _MM_SHUFFLE(3, 3, 3, 3));
 	Result.v = _mm_mul_ps(Result.v, Matrix.v[3]);
 	__m128 Temp = _SYL_PERMUTE_PS(vector.v, _MM_SHUFFLE(2, 2, 2, 2));
-	Result.v = _SYL_ADD_PS(Temp, Matrix.v[2], Result.v);
+	Result.v = _mm_add_ps(Result.v, _mm_mul_ps(Temp, Matrix.v[2]));
 	Temp = _SYL_PERMUTE_PS(vector.v, _MM_SHUFFLE(1, 1, 1, 1));
-	Result.v = _SYL_ADD_PS(Temp, Matrix.v[1], Result.v);
+	Result.v = _mm_add_ps(Result.v, _mm_mul_ps(Temp, Matrix.v[1]));
 	Temp = _SYL_PERMUTE_PS(vector.v, _MM_SHUFFLE(0, 0, 0, 0));
-	Result.v = _SYL_ADD_PS(Temp, Matrix.v[0], Result.v);
+	Result.v = _mm_add_ps(Result.v, _mm_mul_ps(Temp, Matrix.v[0]));
 	return(Result);
 #else
 	svec4 Result;
 
-	Result.x = vector.x * Matrix.e2[0][0] + vector.y * Matrix.e2[0][1] + vector.z * Matrix.e2[0][2] + vector.w * Matrix.e2[0][3];
-	Result.y = vector.x * Matrix.e2[1][0] + vector.y * Matrix.e2[1][1] + vector.z * Matrix.e2[1][2] + vector.w * Matrix.e2[1][3];
-	Result.z = vector.x * Matrix.e2[2][0] + vector.y * Matrix.e2[2][1] + vector.z * Matrix.e2[2][2] + vector.w * Matrix.e2[2][3];
-	Result.w = vector.x * Matrix.e2[3][0] + vector.y * Matrix.e2[3][1] + vector.z * Matrix.e2[3][2] + vector.w * Matrix.e2[3][3];
+	Result.x = vector.x * Matrix.e2[0][0] + vector.y * Matrix.e2[1][0] + vector.z * Matrix.e2[2][0] + vector.w * Matrix.e2[3][0];
+	Result.y = vector.x * Matrix.e2[0][1] + vector.y * Matrix.e2[1][1] + vector.z * Matrix.e2[2][1] + vector.w * Matrix.e2[3][1];
+	Result.z = vector.x * Matrix.e2[0][2] + vector.y * Matrix.e2[1][2] + vector.z * Matrix.e2[2][2] + vector.w * Matrix.e2[3][2];
+	Result.w = vector.x * Matrix.e2[0][3] + vector.y * Matrix.e2[1][3] + vector.z * Matrix.e2[2][3] + vector.w * Matrix.e2[3][3];
 
 	return(Result);
 #endif
@@ -3145,11 +4012,13 @@ svec4 s_mat4_transform(smat4 Matrix, svec4 vector) {
 
 SYL_INLINE svec4 s_mat4_mul_vec4(smat4 Matrix1, svec4 vector)
 {
+	_SYL_PROFILE(s_mat4_mul_vec4);
 	return s_mat4_transform(Matrix1, vector);
 }
 
 SYL_INLINE svec3 s_mat4_mul_vec3(smat4 Matrix1, svec3 vector)
 {
+	_SYL_PROFILE(s_mat4_mul_vec3);
 	svec4 Vec = s_mat4_transform(Matrix1, SVEC4VF(vector, 1.0f));
 	svec3 Result = { { Vec.x, Vec.y, Vec.z } };
 	return(Result);
@@ -3157,6 +4026,7 @@ SYL_INLINE svec3 s_mat4_mul_vec3(smat4 Matrix1, svec3 vector)
 
 SYL_INLINE smat4 s_mat4_translate(smat4 matrix, svec3 vec)
 {
+	_SYL_PROFILE(s_mat4_translate);
 	/* TODO: add simd version if I can figure out how to */
 	// Result[3] = m[0] * v[0] + m[1] * v[1] + m[2] * v[2] + m[3];
 	svec4 r1 = s_vec4_mul_scalar(matrix.v4d[0], vec.x);
@@ -3173,6 +4043,7 @@ SYL_INLINE smat4 s_mat4_translate(smat4 matrix, svec3 vec)
 
 SYL_INLINE smat4 s_mat4_scale(smat4 matrix, svec3 vec)
 {
+	_SYL_PROFILE(s_mat4_scale);
 	smat4 result;
 	result.v4d[0] = s_vec4_mul_scalar(matrix.v4d[0], vec.x);
 	result.v4d[1] = s_vec4_mul_scalar(matrix.v4d[1], vec.y);
@@ -3184,6 +4055,7 @@ SYL_INLINE smat4 s_mat4_scale(smat4 matrix, svec3 vec)
 
 smat4 s_mat4_rotate(smat4 *matrix, float angle, svec3 vec)
 {
+	_SYL_PROFILE(s_mat4_rotate);
 	float c = cos(angle);
 	float s = sin(angle);
 
@@ -3215,6 +4087,7 @@ smat4 s_mat4_rotate(smat4 *matrix, float angle, svec3 vec)
 
 SYL_INLINE smat4 s_mat4_xrotation(float Angle)
 {
+	_SYL_PROFILE(s_mat4_xrotation);
 	float CosAngle = cos(Angle);
 	float SinAngle = sin(Angle);
 
@@ -3230,6 +4103,7 @@ SYL_INLINE smat4 s_mat4_xrotation(float Angle)
 
 SYL_INLINE smat4 s_mat4_yrotation(float Angle)
 {
+	_SYL_PROFILE(s_mat4_yrotation);
 	float CosAngle = cos(Angle);
 	float SinAngle = sin(Angle);
 
@@ -3245,6 +4119,7 @@ SYL_INLINE smat4 s_mat4_yrotation(float Angle)
 
 SYL_INLINE smat4 s_mat4_zrotation(float Angle)
 {
+	_SYL_PROFILE(s_mat4_zrotation);
 	float CosAngle = cos(Angle);
 	float SinAngle = sin(Angle);
 
@@ -3260,19 +4135,20 @@ SYL_INLINE smat4 s_mat4_zrotation(float Angle)
 
 SYL_INLINE smat4 s_mat4_translation(svec3 vector)
 {
+	_SYL_PROFILE(s_mat4_translation);
 #if defined(SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
 	smat4 result;
 	result.v[0] = _S_IDENT4x4R0;
 	result.v[1] = _S_IDENT4x4R1;
 	result.v[2] = _S_IDENT4x4R2;
-	result.v[0] = _mm_set_ps(vector.x, vector.y, vector.z, 1.0f);
+	result.v[3] = _mm_setr_ps(vector.x, vector.y, vector.z, 1.0f);
 	return(result);
 #else
 	smat4 result = { {
-			1, 0, 0, vector.x,
-			0, 1, 0, vector.y,
-			0, 0, 1, vector.z,
-			0, 0, 0, 1,
+			1, 0, 0, 0,
+			0, 1, 0, 0,
+			0, 0, 1, 0,
+			vector.x, vector.y, vector.z, 1,
 		} };
 
 	return(result);
@@ -3281,6 +4157,7 @@ SYL_INLINE smat4 s_mat4_translation(svec3 vector)
 
 smat4 s_perspective(float fov, float aspect, float znear, float zfar)
 {
+	_SYL_PROFILE(s_perspective);
 	smat4 result;
 	float tan_half_fov = tan(fov / 2);
 
@@ -3295,7 +4172,8 @@ smat4 s_perspective(float fov, float aspect, float znear, float zfar)
 /* No LH version for now...  */
 smat4 s_mat4_perspective_projection_rh(float fov, float aspect_ratio, float NearClipPlane, float FarClipPlane)
 {
-	smat4 result;
+	_SYL_PROFILE(s_mat4_perspective_projection_rh);
+	smat4 result = SMAT4(0.0f);
 	float han_half_fov;
 
 	han_half_fov = tan(fov / 2.0f);
@@ -3311,6 +4189,7 @@ smat4 s_mat4_perspective_projection_rh(float fov, float aspect_ratio, float Near
 
 smat4 s_mat4_ortho_rh(float left, float right, float bottom, float top, float znear, float zfar)
 {
+	_SYL_PROFILE(s_mat4_ortho_rh);
 	smat4 result;
 	s_mat4_identityp( &result );
 
@@ -3324,6 +4203,6755 @@ smat4 s_mat4_ortho_rh(float left, float right, float bottom, float top, float zn
 	return result;
 }
 
+/*********************************************
+ *               AFFINE MATRIX                *
+ *********************************************/
+
+/*
+ * smat3x4 stores the three rows of an affine matrix, the implicit last row is
+ * (0, 0, 0, 1). Row i is (R[i][0], R[i][1], R[i][2], T[i]) so a point is
+ * transformed with one dot product per row. smat4 is column-major, the
+ * conversions below transpose.
+ */
+SYL_INLINE smat3x4 s_mat3x4_identity()
+{
+	_SYL_PROFILE(s_mat3x4_identity);
+	smat3x4 Result = { { 1.0f, 0.0f, 0.0f, 0.0f,
+			     0.0f, 1.0f, 0.0f, 0.0f,
+			     0.0f, 0.0f, 1.0f, 0.0f } };
+	return(Result);
+}
+
+SYL_INLINE smat3x4 s_mat3x4_from_mat4(smat4 Matrix)
+{
+	_SYL_PROFILE(s_mat3x4_from_mat4);
+	smat3x4 Result;
+#if defined(SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
+	__m128 c0 = _mm_loadu_ps(Matrix.e), c1 = _mm_loadu_ps(Matrix.e + 4);
+	__m128 c2 = _mm_loadu_ps(Matrix.e + 8), c3 = _mm_loadu_ps(Matrix.e + 12);
+	_MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+	Result.v[0] = c0;
+	Result.v[1] = c1;
+	Result.v[2] = c2;
+#else
+	int r, c;
+	for (r = 0; r < 3; ++r)
+		for (c = 0; c < 4; ++c)
+			Result.e2[r][c] = Matrix.e[c * 4 + r];
+#endif
+	return(Result);
+}
+
+SYL_INLINE smat4 s_mat4_from_mat3x4(smat3x4 Matrix)
+{
+	_SYL_PROFILE(s_mat4_from_mat3x4);
+	smat4 Result;
+#if defined(SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
+	__m128 r0 = Matrix.v[0], r1 = Matrix.v[1], r2 = Matrix.v[2];
+	__m128 r3 = _mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f);
+	_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+	_mm_storeu_ps(Result.e, r0);
+	_mm_storeu_ps(Result.e + 4, r1);
+	_mm_storeu_ps(Result.e + 8, r2);
+	_mm_storeu_ps(Result.e + 12, r3);
+#else
+	int r, c;
+	for (c = 0; c < 4; ++c) {
+		for (r = 0; r < 3; ++r)
+			Result.e[c * 4 + r] = Matrix.e2[r][c];
+		Result.e[c * 4 + 3] = c == 3 ? 1.0f : 0.0f;
+	}
+#endif
+	return(Result);
+}
+
+/* Matrix1 * Matrix2, the last row is never multiplied, only the translation column picks it up */
+SYL_INLINE smat3x4 s_mat3x4_mul(smat3x4 Matrix1, smat3x4 Matrix2)
+{
+	_SYL_PROFILE(s_mat3x4_mul);
+	smat3x4 Result;
+#if defined(SYL_ENABLE_AVX)
+	__m256 A = _mm256_insertf128_ps(_mm256_castps128_ps256(Matrix1.v[0]), Matrix1.v[1], 1);
+	__m256 B0 = _mm256_broadcast_ps(&Matrix2.v[0]);
+	__m256 B1 = _mm256_broadcast_ps(&Matrix2.v[1]);
+	__m256 B2 = _mm256_broadcast_ps(&Matrix2.v[2]);
+
+	/* Rows 0 and 1 in one register, row 2 on its own */
+	__m256 R = _mm256_blend_ps(_mm256_setzero_ps(), A, 0x88);
+	R = _mm256_fmadd_ps(_mm256_permute_ps(A, _SYL_SHUFFLE(0, 0, 0, 0)), B0, R);
+	R = _mm256_fmadd_ps(_mm256_permute_ps(A, _SYL_SHUFFLE(1, 1, 1, 1)), B1, R);
+	R = _mm256_fmadd_ps(_mm256_permute_ps(A, _SYL_SHUFFLE(2, 2, 2, 2)), B2, R);
+
+	__m128 a = Matrix1.v[2];
+	__m128 r = _mm_blend_ps(_mm_setzero_ps(), a, 0x8);
+	r = _mm_fmadd_ps(_SYL_PERMUTE_PS(a, _SYL_SHUFFLE(0, 0, 0, 0)), Matrix2.v[0], r);
+	r = _mm_fmadd_ps(_SYL_PERMUTE_PS(a, _SYL_SHUFFLE(1, 1, 1, 1)), Matrix2.v[1], r);
+	r = _mm_fmadd_ps(_SYL_PERMUTE_PS(a, _SYL_SHUFFLE(2, 2, 2, 2)), Matrix2.v[2], r);
+
+	Result.v[0] = _mm256_castps256_ps128(R);
+	Result.v[1] = _mm256_extractf128_ps(R, 1);
+	Result.v[2] = r;
+#elif defined(SYL_ENABLE_SSE4)
+	int i;
+	for (i = 0; i < 3; ++i) {
+		__m128 a = Matrix1.v[i];
+		__m128 r = _mm_blend_ps(_mm_setzero_ps(), a, 0x8);
+		r = _mm_add_ps(r, _mm_mul_ps(_SYL_PERMUTE_PS(a, _SYL_SHUFFLE(0, 0, 0, 0)), Matrix2.v[0]));
+		r = _mm_add_ps(r, _mm_mul_ps(_SYL_PERMUTE_PS(a, _SYL_SHUFFLE(1, 1, 1, 1)), Matrix2.v[1]));
+		r = _mm_add_ps(r, _mm_mul_ps(_SYL_PERMUTE_PS(a, _SYL_SHUFFLE(2, 2, 2, 2)), Matrix2.v[2]));
+		Result.v[i] = r;
+	}
+#else
+	int i, c;
+	for (i = 0; i < 3; ++i)
+		for (c = 0; c < 4; ++c)
+			Result.e2[i][c] = Matrix1.e2[i][0] * Matrix2.e2[0][c] +
+				Matrix1.e2[i][1] * Matrix2.e2[1][c] +
+				Matrix1.e2[i][2] * Matrix2.e2[2][c] +
+				(c == 3 ? Matrix1.e2[i][3] : 0.0f);
+#endif
+	return(Result);
+}
+
+/*
+ * General affine inverse. The inverse of the 3x3 part has the cross products
+ * of its rows as columns, divided by the determinant. Singular matrices give
+ * inf/nan.
+ */
+SYL_INLINE smat3x4 s_mat3x4_inverse(smat3x4 Matrix)
+{
+	_SYL_PROFILE(s_mat3x4_inverse);
+	smat3x4 Result;
+#if defined(SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
+	__m128 r0 = Matrix.v[0], r1 = Matrix.v[1], r2 = Matrix.v[2];
+	__m128 r0s = _SYL_PERMUTE_PS(r0, _SYL_SHUFFLE(3, 0, 2, 1));
+	__m128 r1s = _SYL_PERMUTE_PS(r1, _SYL_SHUFFLE(3, 0, 2, 1));
+	__m128 r2s = _SYL_PERMUTE_PS(r2, _SYL_SHUFFLE(3, 0, 2, 1));
+
+	/* a x b = (a * b.yzx - a.yzx * b).yzx, w cancels to zero */
+	__m128 c0 = _mm_sub_ps(_mm_mul_ps(r1, r2s), _mm_mul_ps(r1s, r2));
+	__m128 c1 = _mm_sub_ps(_mm_mul_ps(r2, r0s), _mm_mul_ps(r2s, r0));
+	__m128 c2 = _mm_sub_ps(_mm_mul_ps(r0, r1s), _mm_mul_ps(r0s, r1));
+	c0 = _SYL_PERMUTE_PS(c0, _SYL_SHUFFLE(3, 0, 2, 1));
+	c1 = _SYL_PERMUTE_PS(c1, _SYL_SHUFFLE(3, 0, 2, 1));
+	c2 = _SYL_PERMUTE_PS(c2, _SYL_SHUFFLE(3, 0, 2, 1));
+
+	__m128 InvDet = _mm_div_ps(_mm_set1_ps(1.0f), _mm_dp_ps(r0, c0, 0x7F));
+	c0 = _mm_mul_ps(c0, InvDet);
+	c1 = _mm_mul_ps(c1, InvDet);
+	c2 = _mm_mul_ps(c2, InvDet);
+
+	/* -(R^-1 * T), then the transpose puts it in the w of each row */
+	__m128 t = _mm_mul_ps(c0, _SYL_PERMUTE_PS(r0, _SYL_SHUFFLE(3, 3, 3, 3)));
+	t = _mm_add_ps(t, _mm_mul_ps(c1, _SYL_PERMUTE_PS(r1, _SYL_SHUFFLE(3, 3, 3, 3))));
+	t = _mm_add_ps(t, _mm_mul_ps(c2, _SYL_PERMUTE_PS(r2, _SYL_SHUFFLE(3, 3, 3, 3))));
+	t = _mm_sub_ps(_mm_setzero_ps(), t);
+
+	_MM_TRANSPOSE4_PS(c0, c1, c2, t);
+	Result.v[0] = c0;
+	Result.v[1] = c1;
+	Result.v[2] = c2;
+#else
+	float (*m)[4] = Matrix.e2;
+	float c[3][3];
+	int i;
+
+	c[0][0] = m[1][1] * m[2][2] - m[1][2] * m[2][1];
+	c[0][1] = m[1][2] * m[2][0] - m[1][0] * m[2][2];
+	c[0][2] = m[1][0] * m[2][1] - m[1][1] * m[2][0];
+	c[1][0] = m[2][1] * m[0][2] - m[2][2] * m[0][1];
+	c[1][1] = m[2][2] * m[0][0] - m[2][0] * m[0][2];
+	c[1][2] = m[2][0] * m[0][1] - m[2][1] * m[0][0];
+	c[2][0] = m[0][1] * m[1][2] - m[0][2] * m[1][1];
+	c[2][1] = m[0][2] * m[1][0] - m[0][0] * m[1][2];
+	c[2][2] = m[0][0] * m[1][1] - m[0][1] * m[1][0];
+
+	float InvDet = 1.0f / (m[0][0] * c[0][0] + m[0][1] * c[0][1] + m[0][2] * c[0][2]);
+	for (i = 0; i < 3; ++i) {
+		Result.e2[i][0] = c[0][i] * InvDet;
+		Result.e2[i][1] = c[1][i] * InvDet;
+		Result.e2[i][2] = c[2][i] * InvDet;
+		Result.e2[i][3] = -(Result.e2[i][0] * m[0][3] + Result.e2[i][1] * m[1][3] + Result.e2[i][2] * m[2][3]);
+	}
+#endif
+	return(Result);
+}
+
+SYL_INLINE svec3 s_mat3x4_transform_point(smat3x4 Matrix, svec3 Point)
+{
+	_SYL_PROFILE(s_mat3x4_transform_point);
+	svec3 Result;
+#if defined(SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
+	__m128 p = _mm_setr_ps(Point.x, Point.y, Point.z, 1.0f);
+	Result.x = _mm_cvtss_f32(_mm_dp_ps(Matrix.v[0], p, 0xF1));
+	Result.y = _mm_cvtss_f32(_mm_dp_ps(Matrix.v[1], p, 0xF1));
+	Result.z = _mm_cvtss_f32(_mm_dp_ps(Matrix.v[2], p, 0xF1));
+#else
+	int i;
+	for (i = 0; i < 3; ++i)
+		Result.e[i] = Matrix.e2[i][0] * Point.x + Matrix.e2[i][1] * Point.y + Matrix.e2[i][2] * Point.z + Matrix.e2[i][3];
+#endif
+	return(Result);
+}
+
+/* Directions ignore the translation */
+SYL_INLINE svec3 s_mat3x4_transform_vector(smat3x4 Matrix, svec3 Vector)
+{
+	_SYL_PROFILE(s_mat3x4_transform_vector);
+	svec3 Result;
+#if defined(SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
+	__m128 p = _mm_setr_ps(Vector.x, Vector.y, Vector.z, 0.0f);
+	Result.x = _mm_cvtss_f32(_mm_dp_ps(Matrix.v[0], p, 0x71));
+	Result.y = _mm_cvtss_f32(_mm_dp_ps(Matrix.v[1], p, 0x71));
+	Result.z = _mm_cvtss_f32(_mm_dp_ps(Matrix.v[2], p, 0x71));
+#else
+	int i;
+	for (i = 0; i < 3; ++i)
+		Result.e[i] = Matrix.e2[i][0] * Vector.x + Matrix.e2[i][1] * Vector.y + Matrix.e2[i][2] * Vector.z;
+#endif
+	return(Result);
+}
+
+/*********************************************
+ *                QUANTIZATION                *
+ *********************************************/
+
+/*
+ * Encoding follows the D3D/Vulkan float to normalized integer rules: clamp,
+ * scale by the largest code and round to nearest even (the default rounding
+ * mode, same as cvtps2dq). NaN encodes as the smallest code. Decoding divides
+ * by the largest code and clamps snorm at -1 so the values read back exactly
+ * the way the GPU reads them.
+ */
+
+SYL_INLINE int _s_quantize_f(float Value, float Min, float Max, float Scale)
+{
+	/* Same operand order as max_ps/min_ps so NaN ends up as Min in both paths */
+	Value = (Value > Min) ? Value : Min;
+	Value = (Value < Max) ? Value : Max;
+	return((int)rintf(Value * Scale));
+}
+
+#if defined(SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
+SYL_INLINE __m128i _s_quantize_ps(__m128 Value, __m128 Min, __m128 Max, __m128 Scale)
+{
+	Value = _mm_min_ps(_mm_max_ps(Value, Min), Max);
+	return(_mm_cvtps_epi32(_mm_mul_ps(Value, Scale)));
+}
+
+/* Quantize 16 floats into four registers of int32 codes */
+SYL_INLINE void _s_quantize16_ps(const float* Src, float Min, float Max, float Scale, __m128i* Out)
+{
+#if defined(SYL_ENABLE_AVX)
+	__m256 Min8 = _mm256_set1_ps(Min);
+	__m256 Max8 = _mm256_set1_ps(Max);
+	__m256 Scale8 = _mm256_set1_ps(Scale);
+	__m256 V0 = _mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(Src), Min8), Max8);
+	__m256 V1 = _mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(Src + 8), Min8), Max8);
+	__m256i R0 = _mm256_cvtps_epi32(_mm256_mul_ps(V0, Scale8));
+	__m256i R1 = _mm256_cvtps_epi32(_mm256_mul_ps(V1, Scale8));
+	Out[0] = _mm256_castsi256_si128(R0);
+	Out[1] = _mm256_extractf128_si256(R0, 1);
+	Out[2] = _mm256_castsi256_si128(R1);
+	Out[3] = _mm256_extractf128_si256(R1, 1);
+#else
+	__m128 Min4 = _mm_set1_ps(Min);
+	__m128 Max4 = _mm_set1_ps(Max);
+	__m128 Scale4 = _mm_set1_ps(Scale);
+	Out[0] = _s_quantize_ps(_mm_loadu_ps(Src), Min4, Max4, Scale4);
+	Out[1] = _s_quantize_ps(_mm_loadu_ps(Src + 4), Min4, Max4, Scale4);
+	Out[2] = _s_quantize_ps(_mm_loadu_ps(Src + 8), Min4, Max4, Scale4);
+	Out[3] = _s_quantize_ps(_mm_loadu_ps(Src + 12), Min4, Max4, Scale4);
+#endif
+}
+#endif
+
+/* Count is the number of floats, pass Count * 2/3/4 for vector arrays */
+SYL_INLINE void s_pack_unorm8(const float* Src, unsigned char* Dst, int Count)
+{
+	_SYL_PROFILE(s_pack_unorm8);
+	int i = 0;
+#if defined(SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
+	__m128i q[4];
+	for (; i + 16 <= Count; i += 16) {
+		_s_quantize16_ps(Src + i, 0.0f, 1.0f, 255.0f, q);
+		__m128i r = _mm_packus_epi16(_mm_packus_epi32(q[0], q[1]), _mm_packus_epi32(q[2], q[3]));
+		_mm_storeu_si128((__m128i*)(Dst + i), r);
+	}
+#endif
+	for (; i < Count; ++i)
+		Dst[i] = (unsigned char)_s_quantize_f(Src[i], 0.0f, 1.0f, 255.0f);
+}
+
+SYL_INLINE void s_pack_snorm8(const float* Src, signed char* Dst, int Count)
+{
+	_SYL_PROFILE(s_pack_snorm8);
+	int i = 0;
+#if defined(SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
+	__m128i q[4];
+	for (; i + 16 <= Count; i += 16) {
+		_s_quantize16_ps(Src + i, -1.0f, 1.0f, 127.0f, q);
+		__m128i r = _mm_packs_epi16(_mm_packs_epi32(q[0], q[1]), _mm_packs_epi32(q[2], q[3]));
+		_mm_storeu_si128((__m128i*)(Dst + i), r);
+	}
+#endif
+	for (; i < Count; ++i)
+		Dst[i] = (signed char)_s_quantize_f(Src[i], -1.0f, 1.0f, 127.0f);
+}
+
+SYL_INLINE void s_pack_unorm16(const float* Src, unsigned short* Dst, int Count)
+{
+	_SYL_PROFILE(s_pack_unorm16);
+	int i = 0;
+#if defined(SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
+	__m128i q[4];
+	for (; i + 16 <= Count; i += 16) {
+		_s_quantize16_ps(Src + i, 0.0f, 1.0f, 65535.0f, q);
+		_mm_storeu_si128((__m128i*)(Dst + i), _mm_packus_epi32(q[0], q[1]));
+		_mm_storeu_si128((__m128i*)(Dst + i + 8), _mm_packus_epi32(q[2], q[3]));
+	}
+#endif
+	for (; i < Count; ++i)
+		Dst[i] = (unsigned short)_s_quantize_f(Src[i], 0.0f, 1.0f, 65535.0f);
+}
+
+SYL_INLINE void s_pack_snorm16(const float* Src, short* Dst, int Count)
+{
+	_SYL_PROFILE(s_pack_snorm16);
+	int i = 0;
+#if defined(SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
+	__m128i q[4];
+	for (; i + 16 <= Count; i += 16) {
+		_s_quantize16_ps(Src + i, -1.0f, 1.0f, 32767.0f, q);
+		_mm_storeu_si128((__m128i*)(Dst + i), _mm_packs_epi32(q[0], q[1]));
+		_mm_storeu_si128((__m128i*)(Dst + i + 8), _mm_packs_epi32(q[2], q[3]));
+	}
+#endif
+	for (; i < Count; ++i)
+		Dst[i] = (short)_s_quantize_f(Src[i], -1.0f, 1.0f, 32767.0f);
+}
+
+SYL_INLINE void s_unpack_unorm8(const unsigned char* Src, float* Dst, int Count)
+{
+	_SYL_PROFILE(s_unpack_unorm8);
+	int i = 0;
+#if defined(SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
+	__m128 Scale = _mm_set1_ps(255.0f);
+	for (; i + 16 <= Count; i += 16) {
+		__m128i v = _mm_loadu_si128((const __m128i*)(Src + i));
+		_mm_storeu_ps(Dst + i, _mm_div_ps(_mm_cvtepi32_ps(_mm_cvtepu8_epi32(v)), Scale));
+		_mm_storeu_ps(Dst + i + 4, _mm_div_ps(_mm_cvtepi32_ps(_mm_cvtepu8_epi32(_mm_srli_si128(v, 4))), Scale));
+		_mm_storeu_ps(Dst + i + 8, _mm_div_ps(_mm_cvtepi32_ps(_mm_cvtepu8_epi32(_mm_srli_si128(v, 8))), Scale));
+		_mm_storeu_ps(Dst + i + 12, _mm_div_ps(_mm_cvtepi32_ps(_mm_cvtepu8_epi32(_mm_srli_si128(v, 12))), Scale));
+	}
+#endif
+	for (; i < Count; ++i)
+		Dst[i] = (float)Src[i] / 255.0f;
+}
+
+SYL_INLINE void s_unpack_snorm8(const signed char* Src, float* Dst, int Count)
+{
+	_SYL_PROFILE(s_unpack_snorm8);
+	int i = 0;
+#if defined(SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
+	__m128 Scale = _mm_set1_ps(127.0f);
+	__m128 Min = _mm_set1_ps(-1.0f);
+	for (; i + 16 <= Count; i += 16) {
+		__m128i v = _mm_loadu_si128((const __m128i*)(Src + i));
+		_mm_storeu_ps(Dst + i, _mm_max_ps(_mm_div_ps(_mm_cvtepi32_ps(_mm_cvtepi8_epi32(v)), Scale), Min));
+		_mm_storeu_ps(Dst + i + 4, _mm_max_ps(_mm_div_ps(_mm_cvtepi32_ps(_mm_cvtepi8_epi32(_mm_srli_si128(v, 4))), Scale), Min));
+		_mm_storeu_ps(Dst + i + 8, _mm_max_ps(_mm_div_ps(_mm_cvtepi32_ps(_mm_cvtepi8_epi32(_mm_srli_si128(v, 8))), Scale), Min));
+		_mm_storeu_ps(Dst + i + 12, _mm_max_ps(_mm_div_ps(_mm_cvtepi32_ps(_mm_cvtepi8_epi32(_mm_srli_si128(v, 12))), Scale), Min));
+	}
+#endif
+	for (; i < Count; ++i)
+		Dst[i] = s_maxf((float)Src[i] / 127.0f, -1.0f);
+}
+
+SYL_INLINE void s_unpack_unorm16(const unsigned short* Src, float* Dst, int Count)
+{
+	_SYL_PROFILE(s_unpack_unorm16);
+	int i = 0;
+#if defined(SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
+	__m128 Scale = _mm_set1_ps(65535.0f);
+	for (; i + 8 <= Count; i += 8) {
+		__m128i v = _mm_loadu_si128((const __m128i*)(Src + i));
+		_mm_storeu_ps(Dst + i, _mm_div_ps(_mm_cvtepi32_ps(_mm_cvtepu16_epi32(v)), Scale));
+		_mm_storeu_ps(Dst + i + 4, _mm_div_ps(_mm_cvtepi32_ps(_mm_cvtepu16_epi32(_mm_srli_si128(v, 8))), Scale));
+	}
+#endif
+	for (; i < Count; ++i)
+		Dst[i] = (float)Src[i] / 65535.0f;
+}
+
+SYL_INLINE void s_unpack_snorm16(const short* Src, float* Dst, int Count)
+{
+	_SYL_PROFILE(s_unpack_snorm16);
+	int i = 0;
+#if defined(SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
+	__m128 Scale = _mm_set1_ps(32767.0f);
+	__m128 Min = _mm_set1_ps(-1.0f);
+	for (; i + 8 <= Count; i += 8) {
+		__m128i v = _mm_loadu_si128((const __m128i*)(Src + i));
+		_mm_storeu_ps(Dst + i, _mm_max_ps(_mm_div_ps(_mm_cvtepi32_ps(_mm_cvtepi16_epi32(v)), Scale), Min));
+		_mm_storeu_ps(Dst + i + 4, _mm_max_ps(_mm_div_ps(_mm_cvtepi32_ps(_mm_cvtepi16_epi32(_mm_srli_si128(v, 8))), Scale), Min));
+	}
+#endif
+	for (; i < Count; ++i)
+		Dst[i] = s_maxf((float)Src[i] / 32767.0f, -1.0f);
+}
+
+/* x in bits 0-9, y in 10-19, z in 20-29, w in 30-31 (R10G10B10A2 / A2B10G10R10_PACK32) */
+SYL_INLINE void s_vec4_pack_unorm1010102(const svec4* Src, unsigned int* Dst, int Count)
+{
+	_SYL_PROFILE(s_vec4_pack_unorm1010102);
+	int i = 0;
+#if defined(SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
+	__m128 Min = _mm_setzero_ps();
+	__m128 Max = _mm_set1_ps(1.0f);
+	__m128 Scale = _mm_setr_ps(1023.0f, 1023.0f, 1023.0f, 3.0f);
+	__m128i Shift = _mm_setr_epi32(1, 1 << 10, 1 << 20, 1 << 30);
+	for (; i + 4 <= Count; i += 4) {
+		/* Fields don't overlap so the horizontal adds act as ORs */
+		__m128i a = _mm_mullo_epi32(_s_quantize_ps(_mm_loadu_ps(Src[i + 0].e), Min, Max, Scale), Shift);
+		__m128i b = _mm_mullo_epi32(_s_quantize_ps(_mm_loadu_ps(Src[i + 1].e), Min, Max, Scale), Shift);
+		__m128i c = _mm_mullo_epi32(_s_quantize_ps(_mm_loadu_ps(Src[i + 2].e), Min, Max, Scale), Shift);
+		__m128i d = _mm_mullo_epi32(_s_quantize_ps(_mm_loadu_ps(Src[i + 3].e), Min, Max, Scale), Shift);
+		_mm_storeu_si128((__m128i*)(Dst + i), _mm_hadd_epi32(_mm_hadd_epi32(a, b), _mm_hadd_epi32(c, d)));
+	}
+#endif
+	for (; i < Count; ++i) {
+		Dst[i] = ((unsigned int)_s_quantize_f(Src[i].x, 0.0f, 1.0f, 1023.0f) << 0) |
+			((unsigned int)_s_quantize_f(Src[i].y, 0.0f, 1.0f, 1023.0f) << 10) |
+			((unsigned int)_s_quantize_f(Src[i].z, 0.0f, 1.0f, 1023.0f) << 20) |
+			((unsigned int)_s_quantize_f(Src[i].w, 0.0f, 1.0f, 3.0f) << 30);
+	}
+}
+
+SYL_INLINE void s_vec4_pack_snorm1010102(const svec4* Src, unsigned int* Dst, int Count)
+{
+	_SYL_PROFILE(s_vec4_pack_snorm1010102);
+	int i = 0;
+#if defined(SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
+	__m128 Min = _mm_set1_ps(-1.0f);
+	__m128 Max = _mm_set1_ps(1.0f);
+	__m128 Scale = _mm_setr_ps(511.0f, 511.0f, 511.0f, 1.0f);
+	__m128i Mask = _mm_setr_epi32(0x3FF, 0x3FF, 0x3FF, 0x3);
+	__m128i Shift = _mm_setr_epi32(1, 1 << 10, 1 << 20, 1 << 30);
+	for (; i + 4 <= Count; i += 4) {
+		__m128i a = _mm_mullo_epi32(_mm_and_si128(_s_quantize_ps(_mm_loadu_ps(Src[i + 0].e), Min, Max, Scale), Mask), Shift);
+		__m128i b = _mm_mullo_epi32(_mm_and_si128(_s_quantize_ps(_mm_loadu_ps(Src[i + 1].e), Min, Max, Scale), Mask), Shift);
+		__m128i c = _mm_mullo_epi32(_mm_and_si128(_s_quantize_ps(_mm_loadu_ps(Src[i + 2].e), Min, Max, Scale), Mask), Shift);
+		__m128i d = _mm_mullo_epi32(_mm_and_si128(_s_quantize_ps(_mm_loadu_ps(Src[i + 3].e), Min, Max, Scale), Mask), Shift);
+		_mm_storeu_si128((__m128i*)(Dst + i), _mm_hadd_epi32(_mm_hadd_epi32(a, b), _mm_hadd_epi32(c, d)));
+	}
+#endif
+	for (; i < Count; ++i) {
+		Dst[i] = (((unsigned int)_s_quantize_f(Src[i].x, -1.0f, 1.0f, 511.0f) & 0x3FF) << 0) |
+			(((unsigned int)_s_quantize_f(Src[i].y, -1.0f, 1.0f, 511.0f) & 0x3FF) << 10) |
+			(((unsigned int)_s_quantize_f(Src[i].z, -1.0f, 1.0f, 511.0f) & 0x3FF) << 20) |
+			(((unsigned int)_s_quantize_f(Src[i].w, -1.0f, 1.0f, 1.0f) & 0x3) << 30);
+	}
+}
+
+SYL_INLINE void s_vec4_unpack_unorm1010102(const unsigned int* Src, svec4* Dst, int Count)
+{
+	_SYL_PROFILE(s_vec4_unpack_unorm1010102);
+	int i = 0;
+#if defined(SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
+	/* Move every field to the top bits and shift them down together. The w lane
+	   keeps z's high bits below it, those are masked and w is rescaled by 1/256 */
+	__m128i Shift = _mm_setr_epi32(1 << 22, 1 << 12, 1 << 2, 1);
+	__m128i Mask = _mm_setr_epi32(0x3FF, 0x3FF, 0x3FF, 0x300);
+	__m128 Fix = _mm_setr_ps(1.0f, 1.0f, 1.0f, 1.0f / 256.0f);
+	__m128 Scale = _mm_setr_ps(1023.0f, 1023.0f, 1023.0f, 3.0f);
+	for (; i < Count; ++i) {
+		__m128i v = _mm_mullo_epi32(_mm_set1_epi32((int)Src[i]), Shift);
+		v = _mm_and_si128(_mm_srli_epi32(v, 22), Mask);
+		_mm_storeu_ps(Dst[i].e, _mm_div_ps(_mm_mul_ps(_mm_cvtepi32_ps(v), Fix), Scale));
+	}
+#endif
+	for (; i < Count; ++i) {
+		unsigned int v = Src[i];
+		Dst[i].x = (float)((v >> 0) & 0x3FF) / 1023.0f;
+		Dst[i].y = (float)((v >> 10) & 0x3FF) / 1023.0f;
+		Dst[i].z = (float)((v >> 20) & 0x3FF) / 1023.0f;
+		Dst[i].w = (float)(v >> 30) / 3.0f;
+	}
+}
+
+SYL_INLINE void s_vec4_unpack_snorm1010102(const unsigned int* Src, svec4* Dst, int Count)
+{
+	_SYL_PROFILE(s_vec4_unpack_snorm1010102);
+	int i = 0;
+#if defined(SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
+	__m128i Shift = _mm_setr_epi32(1 << 22, 1 << 12, 1 << 2, 1);
+	__m128i Mask = _mm_setr_epi32(-1, -1, -1, ~0xFF);
+	__m128 Fix = _mm_setr_ps(1.0f, 1.0f, 1.0f, 1.0f / 256.0f);
+	__m128 Scale = _mm_setr_ps(511.0f, 511.0f, 511.0f, 1.0f);
+	__m128 Min = _mm_set1_ps(-1.0f);
+	for (; i < Count; ++i) {
+		__m128i v = _mm_mullo_epi32(_mm_set1_epi32((int)Src[i]), Shift);
+		v = _mm_and_si128(_mm_srai_epi32(v, 22), Mask);
+		__m128 r = _mm_div_ps(_mm_mul_ps(_mm_cvtepi32_ps(v), Fix), Scale);
+		_mm_storeu_ps(Dst[i].e, _mm_max_ps(r, Min));
+	}
+#endif
+	for (; i < Count; ++i) {
+		unsigned int v = Src[i];
+		Dst[i].x = s_maxf((float)((int)(v << 22) >> 22) / 511.0f, -1.0f);
+		Dst[i].y = s_maxf((float)((int)(v << 12) >> 22) / 511.0f, -1.0f);
+		Dst[i].z = s_maxf((float)((int)(v << 2) >> 22) / 511.0f, -1.0f);
+		Dst[i].w = s_maxf((float)((int)v >> 30), -1.0f);
+	}
+}
+
+SYL_INLINE squant_range s_quant_range_from_aabb(svec3 Min, svec3 Max)
+{
+	_SYL_PROFILE(s_quant_range_from_aabb);
+	squant_range Result;
+	Result.Scale.x = Max.x - Min.x;
+	Result.Scale.y = Max.y - Min.y;
+	Result.Scale.z = Max.z - Min.z;
+	Result.Offset = Min;
+	return(Result);
+}
+
+SYL_INLINE squant_range s_quant_range_from_points(const svec3* Points, int Count)
+{
+	_SYL_PROFILE(s_quant_range_from_points);
+	svec3 Min = { { 0.0f, 0.0f, 0.0f } };
+	svec3 Max = { { 0.0f, 0.0f, 0.0f } };
+
+	if (Count > 0) {
+		Min = Points[0];
+		Max = Points[0];
+	}
+	for (int i = 1; i < Count; ++i) {
+		Min.x = s_minf(Min.x, Points[i].x);
+		Min.y = s_minf(Min.y, Points[i].y);
+		Min.z = s_minf(Min.z, Points[i].z);
+		Max.x = s_maxf(Max.x, Points[i].x);
+		Max.y = s_maxf(Max.y, Points[i].y);
+		Max.z = s_maxf(Max.z, Points[i].z);
+	}
+	return(s_quant_range_from_aabb(Min, Max));
+}
+
+SYL_INLINE void s_vec3_pack_position_unorm16(const svec3* Src, unsigned short* Dst, int Count, squant_range Range)
+{
+	_SYL_PROFILE(s_vec3_pack_position_unorm16);
+	/* A flat axis encodes as zero instead of dividing by zero */
+	float InvX = (Range.Scale.x != 0.0f) ? 1.0f / Range.Scale.x : 0.0f;
+	float InvY = (Range.Scale.y != 0.0f) ? 1.0f / Range.Scale.y : 0.0f;
+	float InvZ = (Range.Scale.z != 0.0f) ? 1.0f / Range.Scale.z : 0.0f;
+	const float* In = Src->e;
+	int i = 0;
+
+#if defined(SYL_ENABLE_AVX)
+	/* Eight svec3 fill three registers, the xyz pattern rotates two lanes per register */
+	__m256 Inv0 = _mm256_setr_ps(InvX, InvY, InvZ, InvX, InvY, InvZ, InvX, InvY);
+	__m256 Inv1 = _mm256_setr_ps(InvZ, InvX, InvY, InvZ, InvX, InvY, InvZ, InvX);
+	__m256 Inv2 = _mm256_setr_ps(InvY, InvZ, InvX, InvY, InvZ, InvX, InvY, InvZ);
+	__m256 Off0 = _mm256_setr_ps(Range.Offset.x, Range.Offset.y, Range.Offset.z, Range.Offset.x, Range.Offset.y, Range.Offset.z, Range.Offset.x, Range.Offset.y);
+	__m256 Off1 = _mm256_setr_ps(Range.Offset.z, Range.Offset.x, Range.Offset.y, Range.Offset.z, Range.Offset.x, Range.Offset.y, Range.Offset.z, Range.Offset.x);
+	__m256 Off2 = _mm256_setr_ps(Range.Offset.y, Range.Offset.z, Range.Offset.x, Range.Offset.y, Range.Offset.z, Range.Offset.x, Range.Offset.y, Range.Offset.z);
+	__m256 Zero8 = _mm256_setzero_ps();
+	__m256 One8 = _mm256_set1_ps(1.0f);
+	__m256 Scale8 = _mm256_set1_ps(65535.0f);
+	for (; i + 8 <= Count; i += 8) {
+		const float* p = In + i * 3;
+		__m256 v0 = _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(p), Off0), Inv0);
+		__m256 v1 = _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(p + 8), Off1), Inv1);
+		__m256 v2 = _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(p + 16), Off2), Inv2);
+		__m256i q0 = _mm256_cvtps_epi32(_mm256_mul_ps(_mm256_min_ps(_mm256_max_ps(v0, Zero8), One8), Scale8));
+		__m256i q1 = _mm256_cvtps_epi32(_mm256_mul_ps(_mm256_min_ps(_mm256_max_ps(v1, Zero8), One8), Scale8));
+		__m256i q2 = _mm256_cvtps_epi32(_mm256_mul_ps(_mm256_min_ps(_mm256_max_ps(v2, Zero8), One8), Scale8));
+		unsigned short* o = Dst + i * 3;
+		_mm_storeu_si128((__m128i*)(o + 0), _mm_packus_epi32(_mm256_castsi256_si128(q0), _mm256_extractf128_si256(q0, 1)));
+		_mm_storeu_si128((__m128i*)(o + 8), _mm_packus_epi32(_mm256_castsi256_si128(q1), _mm256_extractf128_si256(q1, 1)));
+		_mm_storeu_si128((__m128i*)(o + 16), _mm_packus_epi32(_mm256_castsi256_si128(q2), _mm256_extractf128_si256(q2, 1)));
+	}
+#endif
+#if defined(SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
+	/* Four svec3 fill three registers, the xyz pattern rotates one lane per register */
+	__m128 Inv4_0 = _mm_setr_ps(InvX, InvY, InvZ, InvX);
+	__m128 Inv4_1 = _mm_setr_ps(InvY, InvZ, InvX, InvY);
+	__m128 Inv4_2 = _mm_setr_ps(InvZ, InvX, InvY, InvZ);
+	__m128 Off4_0 = _mm_setr_ps(Range.Offset.x, Range.Offset.y, Range.Offset.z, Range.Offset.x);
+	__m128 Off4_1 = _mm_setr_ps(Range.Offset.y, Range.Offset.z, Range.Offset.x, Range.Offset.y);
+	__m128 Off4_2 = _mm_setr_ps(Range.Offset.z, Range.Offset.x, Range.Offset.y, Range.Offset.z);
+	__m128 Zero = _mm_setzero_ps();
+	__m128 One = _mm_set1_ps(1.0f);
+	__m128 Scale = _mm_set1_ps(65535.0f);
+	for (; i + 4 <= Count; i += 4) {
+		const float* p = In + i * 3;
+		__m128i a = _s_quantize_ps(_mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(p), Off4_0), Inv4_0), Zero, One, Scale);
+		__m128i b = _s_quantize_ps(_mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(p + 4), Off4_1), Inv4_1), Zero, One, Scale);
+		__m128i c = _s_quantize_ps(_mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(p + 8), Off4_2), Inv4_2), Zero, One, Scale);
+		_mm_storeu_si128((__m128i*)(Dst + i * 3), _mm_packus_epi32(a, b));
+		_mm_storel_epi64((__m128i*)(Dst + i * 3 + 8), _mm_packus_epi32(c, c));
+	}
+#endif
+	for (; i < Count; ++i) {
+		Dst[i * 3 + 0] = (unsigned short)_s_quantize_f((In[i * 3 + 0] - Range.Offset.x) * InvX, 0.0f, 1.0f, 65535.0f);
+		Dst[i * 3 + 1] = (unsigned short)_s_quantize_f((In[i * 3 + 1] - Range.Offset.y) * InvY, 0.0f, 1.0f, 65535.0f);
+		Dst[i * 3 + 2] = (unsigned short)_s_quantize_f((In[i * 3 + 2] - Range.Offset.z) * InvZ, 0.0f, 1.0f, 65535.0f);
+	}
+}
+
+SYL_INLINE void s_vec3_unpack_position_unorm16(const unsigned short* Src, svec3* Dst, int Count, squant_range Range)
+{
+	_SYL_PROFILE(s_vec3_unpack_position_unorm16);
+	float* Out = Dst->e;
+	int i = 0;
+
+#if defined(SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
+	__m128 Scale0 = _mm_setr_ps(Range.Scale.x, Range.Scale.y, Range.Scale.z, Range.Scale.x);
+	__m128 Scale1 = _mm_setr_ps(Range.Scale.y, Range.Scale.z, Range.Scale.x, Range.Scale.y);
+	__m128 Scale2 = _mm_setr_ps(Range.Scale.z, Range.Scale.x, Range.Scale.y, Range.Scale.z);
+	__m128 Off0 = _mm_setr_ps(Range.Offset.x, Range.Offset.y, Range.Offset.z, Range.Offset.x);
+	__m128 Off1 = _mm_setr_ps(Range.Offset.y, Range.Offset.z, Range.Offset.x, Range.Offset.y);
+	__m128 Off2 = _mm_setr_ps(Range.Offset.z, Range.Offset.x, Range.Offset.y, Range.Offset.z);
+	__m128 Max = _mm_set1_ps(65535.0f);
+	for (; i + 4 <= Count; i += 4) {
+		const unsigned short* p = Src + i * 3;
+		__m128 a = _mm_div_ps(_mm_cvtepi32_ps(_mm_cvtepu16_epi32(_mm_loadl_epi64((const __m128i*)(p + 0)))), Max);
+		__m128 b = _mm_div_ps(_mm_cvtepi32_ps(_mm_cvtepu16_epi32(_mm_loadl_epi64((const __m128i*)(p + 4)))), Max);
+		__m128 c = _mm_div_ps(_mm_cvtepi32_ps(_mm_cvtepu16_epi32(_mm_loadl_epi64((const __m128i*)(p + 8)))), Max);
+		_mm_storeu_ps(Out + i * 3 + 0, _mm_add_ps(_mm_mul_ps(a, Scale0), Off0));
+		_mm_storeu_ps(Out + i * 3 + 4, _mm_add_ps(_mm_mul_ps(b, Scale1), Off1));
+		_mm_storeu_ps(Out + i * 3 + 8, _mm_add_ps(_mm_mul_ps(c, Scale2), Off2));
+	}
+#endif
+	for (; i < Count; ++i) {
+		Out[i * 3 + 0] = ((float)Src[i * 3 + 0] / 65535.0f) * Range.Scale.x + Range.Offset.x;
+		Out[i * 3 + 1] = ((float)Src[i * 3 + 1] / 65535.0f) * Range.Scale.y + Range.Offset.y;
+		Out[i * 3 + 2] = ((float)Src[i * 3 + 2] / 65535.0f) * Range.Scale.z + Range.Offset.z;
+	}
+}
+
+/*********************************************
+ *                 PARTICLES                  *
+ *********************************************/
+
+/*
+ * Integration works on [Begin, End) so a buffer can be split into chunks and
+ * handed to different threads. Drag is folded into a damping factor and a
+ * constant acceleration so every axis is a single multiply-add per step:
+ *     v' = v + (Gravity + Drag * (Wind - v)) * Dt = v * (1 - Drag * Dt) + (Gravity + Drag * Wind) * Dt
+ */
+
+SYL_INLINE void _s_particles_euler_axis(float* Pos, float* Vel, int Begin, int End, float Damp, float Accel, float Dt)
+{
+	int i = Begin;
+#if defined(SYL_ENABLE_AVX)
+	__m256 Damp8 = _mm256_set1_ps(Damp);
+	__m256 Accel8 = _mm256_set1_ps(Accel);
+	__m256 Dt8 = _mm256_set1_ps(Dt);
+	for (; i + 8 <= End; i += 8) {
+		__m256 v = _mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(Vel + i), Damp8), Accel8);
+		_mm256_storeu_ps(Vel + i, v);
+		_mm256_storeu_ps(Pos + i, _mm256_add_ps(_mm256_loadu_ps(Pos + i), _mm256_mul_ps(v, Dt8)));
+	}
+#endif
+#if defined(SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
+	__m128 Damp4 = _mm_set1_ps(Damp);
+	__m128 Accel4 = _mm_set1_ps(Accel);
+	__m128 Dt4 = _mm_set1_ps(Dt);
+	for (; i + 4 <= End; i += 4) {
+		__m128 v = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(Vel + i), Damp4), Accel4);
+		_mm_storeu_ps(Vel + i, v);
+		_mm_storeu_ps(Pos + i, _mm_add_ps(_mm_loadu_ps(Pos + i), _mm_mul_ps(v, Dt4)));
+	}
+#endif
+	for (; i < End; ++i) {
+		Vel[i] = Vel[i] * Damp + Accel;
+		Pos[i] = Pos[i] + Vel[i] * Dt;
+	}
+}
+
+/* Next = Pos + (Pos - Prev) * Damp + Accel, Prev = Pos, Pos = Next */
+SYL_INLINE void _s_particles_verlet_axis(float* Pos, float* Prev, int Begin, int End, float Damp, float Accel)
+{
+	int i = Begin;
+#if defined(SYL_ENABLE_AVX)
+	__m256 Damp8 = _mm256_set1_ps(Damp);
+	__m256 Accel8 = _mm256_set1_ps(Accel);
+	for (; i + 8 <= End; i += 8) {
+		__m256 p = _mm256_loadu_ps(Pos + i);
+		__m256 d = _mm256_sub_ps(p, _mm256_loadu_ps(Prev + i));
+		_mm256_storeu_ps(Prev + i, p);
+		_mm256_storeu_ps(Pos + i, _mm256_add_ps(p, _mm256_add_ps(_mm256_mul_ps(d, Damp8), Accel8)));
+	}
+#endif
+#if defined(SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
+	__m128 Damp4 = _mm_set1_ps(Damp);
+	__m128 Accel4 = _mm_set1_ps(Accel);
+	for (; i + 4 <= End; i += 4) {
+		__m128 p = _mm_loadu_ps(Pos + i);
+		__m128 d = _mm_sub_ps(p, _mm_loadu_ps(Prev + i));
+		_mm_storeu_ps(Prev + i, p);
+		_mm_storeu_ps(Pos + i, _mm_add_ps(p, _mm_add_ps(_mm_mul_ps(d, Damp4), Accel4)));
+	}
+#endif
+	for (; i < End; ++i) {
+		float p = Pos[i];
+		float d = p - Prev[i];
+		Prev[i] = p;
+		Pos[i] = p + (d * Damp + Accel);
+	}
+}
+
+SYL_INLINE void _s_particles_age(float* Age, int Begin, int End, float Dt)
+{
+	int i = Begin;
+#if defined(SYL_ENABLE_AVX)
+	__m256 Dt8 = _mm256_set1_ps(Dt);
+	for (; i + 8 <= End; i += 8)
+		_mm256_storeu_ps(Age + i, _mm256_add_ps(_mm256_loadu_ps(Age + i), Dt8));
+#endif
+#if defined(SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
+	__m128 Dt4 = _mm_set1_ps(Dt);
+	for (; i + 4 <= End; i += 4)
+		_mm_storeu_ps(Age + i, _mm_add_ps(_mm_loadu_ps(Age + i), Dt4));
+#endif
+	for (; i < End; ++i)
+		Age[i] += Dt;
+}
+
+/* Semi-implicit Euler, velocity first then position with the new velocity */
+SYL_INLINE void s_particles_integrate_euler(sparticles* Particles, int Begin, int End, sparticle_forces Forces, float Dt)
+{
+	_SYL_PROFILE(s_particles_integrate_euler);
+	float Damp = 1.0f - Forces.Drag * Dt;
+
+	_s_particles_euler_axis(Particles->PosX, Particles->VelX, Begin, End, Damp, (Forces.Gravity.x + Forces.Drag * Forces.Wind.x) * Dt, Dt);
+	_s_particles_euler_axis(Particles->PosY, Particles->VelY, Begin, End, Damp, (Forces.Gravity.y + Forces.Drag * Forces.Wind.y) * Dt, Dt);
+	_s_particles_euler_axis(Particles->PosZ, Particles->VelZ, Begin, End, Damp, (Forces.Gravity.z + Forces.Drag * Forces.Wind.z) * Dt, Dt);
+	_s_particles_age(Particles->Age, Begin, End, Dt);
+}
+
+/* Position Verlet with a fixed Dt, velocity is implied by Pos - Prev and the
+   Vel arrays are left untouched */
+SYL_INLINE void s_particles_integrate_verlet(sparticles* Particles, int Begin, int End, sparticle_forces Forces, float Dt)
+{
+	_SYL_PROFILE(s_particles_integrate_verlet);
+	float Damp = 1.0f - Forces.Drag * Dt;
+	float Dt2 = Dt * Dt;
+
+	_s_particles_verlet_axis(Particles->PosX, Particles->PrevX, Begin, End, Damp, (Forces.Gravity.x + Forces.Drag * Forces.Wind.x) * Dt2);
+	_s_particles_verlet_axis(Particles->PosY, Particles->PrevY, Begin, End, Damp, (Forces.Gravity.y + Forces.Drag * Forces.Wind.y) * Dt2);
+	_s_particles_verlet_axis(Particles->PosZ, Particles->PrevZ, Begin, End, Damp, (Forces.Gravity.z + Forces.Drag * Forces.Wind.z) * Dt2);
+	_s_particles_age(Particles->Age, Begin, End, Dt);
+}
+
+SYL_INLINE bool _s_particle_is_dead(sparticles* Particles, int Index, const svec3* KillMin, const svec3* KillMax, int KillCount)
+{
+	if (Particles->Age[Index] >= Particles->Lifetime[Index])
+		return(true);
+
+	float x = Particles->PosX[Index];
+	float y = Particles->PosY[Index];
+	float z = Particles->PosZ[Index];
+	for (int k = 0; k < KillCount; ++k) {
+		if (x >= KillMin[k].x && x <= KillMax[k].x &&
+		    y >= KillMin[k].y && y <= KillMax[k].y &&
+		    z >= KillMin[k].z && z <= KillMax[k].z)
+			return(true);
+	}
+	return(false);
+}
+
+SYL_INLINE void _s_particles_move(sparticles* Particles, int From, int To)
+{
+	Particles->PosX[To] = Particles->PosX[From];
+	Particles->PosY[To] = Particles->PosY[From];
+	Particles->PosZ[To] = Particles->PosZ[From];
+	Particles->VelX[To] = Particles->VelX[From];
+	Particles->VelY[To] = Particles->VelY[From];
+	Particles->VelZ[To] = Particles->VelZ[From];
+	if (Particles->PrevX) {
+		Particles->PrevX[To] = Particles->PrevX[From];
+		Particles->PrevY[To] = Particles->PrevY[From];
+		Particles->PrevZ[To] = Particles->PrevZ[From];
+	}
+	Particles->Age[To] = Particles->Age[From];
+	Particles->Lifetime[To] = Particles->Lifetime[From];
+}
+
+/* Index of the lowest set bit, a is not zero */
+_SYL_FORCE_INLINE int _s_ctz(unsigned int a)
+{
+#if defined(__GNUC__) || defined(__clang__)
+	return(__builtin_ctz(a));
+#else
+	int n = 0;
+	for (; !(a & 1); a >>= 1)
+		++n;
+	return(n);
+#endif
+}
+
+/*
+ * Remove particles past their lifetime or inside one of the kill volumes by
+ * swapping the last particle into their slot. Order is not preserved. Blocks
+ * where every particle is alive are skipped with one SIMD test, otherwise the
+ * test jumps straight to the first dead one. Returns the number of removed
+ * particles.
+ */
+SYL_INLINE int s_particles_compact(sparticles* Particles, const svec3* KillMin, const svec3* KillMax, int KillCount)
+{
+	_SYL_PROFILE(s_particles_compact);
+	int Start = Particles->Count;
+	int i = 0;
+
+	while (i < Particles->Count) {
+#if defined(SYL_ENABLE_AVX)
+		if (i + 8 <= Particles->Count) {
+			__m256 x = _mm256_loadu_ps(Particles->PosX + i);
+			__m256 y = _mm256_loadu_ps(Particles->PosY + i);
+			__m256 z = _mm256_loadu_ps(Particles->PosZ + i);
+			__m256 Dead = _mm256_cmp_ps(_mm256_loadu_ps(Particles->Age + i), _mm256_loadu_ps(Particles->Lifetime + i), _CMP_GE_OQ);
+			for (int k = 0; k < KillCount; ++k) {
+				__m256 In = _mm256_and_ps(_mm256_cmp_ps(x, _mm256_set1_ps(KillMin[k].x), _CMP_GE_OQ), _mm256_cmp_ps(x, _mm256_set1_ps(KillMax[k].x), _CMP_LE_OQ));
+				In = _mm256_and_ps(In, _mm256_and_ps(_mm256_cmp_ps(y, _mm256_set1_ps(KillMin[k].y), _CMP_GE_OQ), _mm256_cmp_ps(y, _mm256_set1_ps(KillMax[k].y), _CMP_LE_OQ)));
+				In = _mm256_and_ps(In, _mm256_and_ps(_mm256_cmp_ps(z, _mm256_set1_ps(KillMin[k].z), _CMP_GE_OQ), _mm256_cmp_ps(z, _mm256_set1_ps(KillMax[k].z), _CMP_LE_OQ)));
+				Dead = _mm256_or_ps(Dead, In);
+			}
+			int Mask = _mm256_movemask_ps(Dead);
+			if (Mask == 0) {
+				i += 8;
+				continue;
+			}
+			/* Lanes before the first dead one are alive, the swapped in particle is tested again */
+			i += _s_ctz((unsigned int)Mask);
+			--Particles->Count;
+			_s_particles_move(Particles, Particles->Count, i);
+			continue;
+		}
+#elif defined(SYL_ENABLE_SSE4)
+		if (i + 4 <= Particles->Count) {
+			__m128 x = _mm_loadu_ps(Particles->PosX + i);
+			__m128 y = _mm_loadu_ps(Particles->PosY + i);
+			__m128 z = _mm_loadu_ps(Particles->PosZ + i);
+			__m128 Dead = _mm_cmpge_ps(_mm_loadu_ps(Particles->Age + i), _mm_loadu_ps(Particles->Lifetime + i));
+			for (int k = 0; k < KillCount; ++k) {
+				__m128 In = _mm_and_ps(_mm_cmpge_ps(x, _mm_set1_ps(KillMin[k].x)), _mm_cmple_ps(x, _mm_set1_ps(KillMax[k].x)));
+				In = _mm_and_ps(In, _mm_and_ps(_mm_cmpge_ps(y, _mm_set1_ps(KillMin[k].y)), _mm_cmple_ps(y, _mm_set1_ps(KillMax[k].y))));
+				In = _mm_and_ps(In, _mm_and_ps(_mm_cmpge_ps(z, _mm_set1_ps(KillMin[k].z)), _mm_cmple_ps(z, _mm_set1_ps(KillMax[k].z))));
+				Dead = _mm_or_ps(Dead, In);
+			}
+			int Mask = _mm_movemask_ps(Dead);
+			if (Mask == 0) {
+				i += 4;
+				continue;
+			}
+			/* Lanes before the first dead one are alive, the swapped in particle is tested again */
+			i += _s_ctz((unsigned int)Mask);
+			--Particles->Count;
+			_s_particles_move(Particles, Particles->Count, i);
+			continue;
+		}
+#endif
+		if (_s_particle_is_dead(Particles, i, KillMin, KillMax, KillCount)) {
+			/* The swapped in particle is tested again on the next iteration */
+			--Particles->Count;
+			_s_particles_move(Particles, Particles->Count, i);
+		}
+		else {
+			++i;
+		}
+	}
+	return(Start - Particles->Count);
+}
+
+/*********************************************
+ *                  THREADS                   *
+ *********************************************/
+
+#if defined(SYL_THREADS)
+
+/*
+ * Small fork-join pool for s_parallel_for. The calling thread works as
+ * worker 0, the other workers sleep on a condition variable between
+ * dispatches. Every worker owns a range of chunk indices packed into one
+ * 64-bit word (Begin | End << 32). The owner pops from the front, idle
+ * workers steal the back half of someone else's range, both with CAS, so a
+ * dispatch never allocates or takes a lock on the hot path.
+ */
+
+#define _SYL_MAX_THREADS 64
+
+typedef struct _sthread_worker
+{
+	unsigned long long Range;
+	void* Scratch;
+	pthread_t Thread;
+} _SYL_SET_SPEC_ALIGN(64) _sthread_worker;
+
+typedef struct _sthread_pool
+{
+	_sthread_worker Workers[_SYL_MAX_THREADS];
+	int WorkerCount;
+	size_t ScratchSize;
+
+	pthread_mutex_t DispatchLock;
+	pthread_mutex_t Lock;
+	pthread_cond_t Wake;
+	pthread_cond_t Done;
+	unsigned int Generation;
+	int Pending;
+	bool Quit;
+
+	sparallel_fn Fn;
+	void* UserData;
+	int Count;
+	int Grain;
+} _sthread_pool;
+
+_sthread_pool _S_THREADS;
+__thread int _s_thread_index = -1;
+
+SYL_INLINE int _s_threads_pop(_sthread_worker* Worker)
+{
+	unsigned long long Range = __atomic_load_n(&Worker->Range, __ATOMIC_ACQUIRE);
+	for (;;) {
+		unsigned int Begin = (unsigned int)Range;
+		unsigned int End = (unsigned int)(Range >> 32);
+		if (Begin >= End)
+			return(-1);
+		unsigned long long Next = (unsigned long long)(Begin + 1) | ((unsigned long long)End << 32);
+		if (__atomic_compare_exchange_n(&Worker->Range, &Range, Next, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+			return((int)Begin);
+	}
+}
+
+/* Take the back half of the first non empty range and make it our own */
+SYL_INLINE bool _s_threads_steal(int Index)
+{
+	for (int i = 1; i < _S_THREADS.WorkerCount; ++i) {
+		_sthread_worker* Victim = &_S_THREADS.Workers[(Index + i) % _S_THREADS.WorkerCount];
+		unsigned long long Range = __atomic_load_n(&Victim->Range, __ATOMIC_ACQUIRE);
+		for (;;) {
+			unsigned int Begin = (unsigned int)Range;
+			unsigned int End = (unsigned int)(Range >> 32);
+			if (Begin >= End)
+				break;
+			unsigned int Take = (End - Begin + 1) / 2;
+			unsigned long long Left = (unsigned long long)Begin | ((unsigned long long)(End - Take) << 32);
+			if (__atomic_compare_exchange_n(&Victim->Range, &Range, Left, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+				/* Our range is empty so nobody else writes it until this store */
+				unsigned long long Mine = (unsigned long long)(End - Take) | ((unsigned long long)End << 32);
+				__atomic_store_n(&_S_THREADS.Workers[Index].Range, Mine, __ATOMIC_RELEASE);
+				return(true);
+			}
+		}
+	}
+	return(false);
+}
+
+SYL_INLINE void _s_threads_run(int Index)
+{
+	_sthread_worker* Worker = &_S_THREADS.Workers[Index];
+	do {
+		int Chunk;
+		while ((Chunk = _s_threads_pop(Worker)) >= 0) {
+			int Begin = Chunk * _S_THREADS.Grain;
+			int End = (_S_THREADS.Count - Begin < _S_THREADS.Grain) ? _S_THREADS.Count : Begin + _S_THREADS.Grain;
+			_S_THREADS.Fn(Begin, End, Index, _S_THREADS.UserData);
+		}
+	} while (_s_threads_steal(Index));
+}
+
+SYL_INLINE void* _s_thread_main(void* Arg)
+{
+	int Index = (int)(size_t)Arg;
+	unsigned int Seen = 0;
+
+	_s_thread_index = Index;
+	for (;;) {
+		pthread_mutex_lock(&_S_THREADS.Lock);
+		while (_S_THREADS.Generation == Seen && !_S_THREADS.Quit)
+			pthread_cond_wait(&_S_THREADS.Wake, &_S_THREADS.Lock);
+		Seen = _S_THREADS.Generation;
+		bool Quit = _S_THREADS.Quit;
+		pthread_mutex_unlock(&_S_THREADS.Lock);
+		if (Quit)
+			break;
+
+		_s_threads_run(Index);
+
+		if (__atomic_sub_fetch(&_S_THREADS.Pending, 1, __ATOMIC_ACQ_REL) == 0) {
+			pthread_mutex_lock(&_S_THREADS.Lock);
+			pthread_cond_signal(&_S_THREADS.Done);
+			pthread_mutex_unlock(&_S_THREADS.Lock);
+		}
+	}
+	return(NULL);
+}
+
+/* WorkerCount <= 0 uses one worker per online core. Scratch memory is
+   allocated once here and handed out per worker with s_threads_scratch */
+SYL_INLINE bool s_threads_init(int WorkerCount, size_t ScratchSize)
+{
+	_SYL_PROFILE(s_threads_init);
+	if (_S_THREADS.WorkerCount > 0)
+		return(true);
+
+	if (WorkerCount <= 0)
+		WorkerCount = (int)sysconf(_SC_NPROCESSORS_ONLN);
+	WorkerCount = s_clampi(WorkerCount, 1, _SYL_MAX_THREADS);
+
+	/* Without all of the scratch there is no pool */
+	for (int i = 0; i < WorkerCount; ++i) {
+		_S_THREADS.Workers[i].Range = 0;
+		_S_THREADS.Workers[i].Scratch = ScratchSize ? malloc(ScratchSize) : NULL;
+		if (ScratchSize && !_S_THREADS.Workers[i].Scratch) {
+			while (i-- > 0) {
+				free(_S_THREADS.Workers[i].Scratch);
+				_S_THREADS.Workers[i].Scratch = NULL;
+			}
+			return(false);
+		}
+	}
+
+	pthread_mutex_init(&_S_THREADS.DispatchLock, NULL);
+	pthread_mutex_init(&_S_THREADS.Lock, NULL);
+	pthread_cond_init(&_S_THREADS.Wake, NULL);
+	pthread_cond_init(&_S_THREADS.Done, NULL);
+	_S_THREADS.Generation = 0;
+	_S_THREADS.Quit = false;
+	_S_THREADS.ScratchSize = ScratchSize;
+
+	_S_THREADS.WorkerCount = 1;
+	for (int i = 1; i < WorkerCount; ++i) {
+		if (pthread_create(&_S_THREADS.Workers[i].Thread, NULL, _s_thread_main, (void*)(size_t)i) != 0)
+			break;
+		_S_THREADS.WorkerCount++;
+	}
+	/* Shutdown only frees the workers that started */
+	for (int i = _S_THREADS.WorkerCount; i < WorkerCount; ++i) {
+		free(_S_THREADS.Workers[i].Scratch);
+		_S_THREADS.Workers[i].Scratch = NULL;
+	}
+	return(_S_THREADS.WorkerCount == WorkerCount);
+}
+
+SYL_INLINE void s_threads_shutdown(void)
+{
+	_SYL_PROFILE(s_threads_shutdown);
+	if (_S_THREADS.WorkerCount == 0)
+		return;
+
+	pthread_mutex_lock(&_S_THREADS.Lock);
+	_S_THREADS.Quit = true;
+	pthread_cond_broadcast(&_S_THREADS.Wake);
+	pthread_mutex_unlock(&_S_THREADS.Lock);
+
+	for (int i = 1; i < _S_THREADS.WorkerCount; ++i)
+		pthread_join(_S_THREADS.Workers[i].Thread, NULL);
+	for (int i = 0; i < _S_THREADS.WorkerCount; ++i) {
+		free(_S_THREADS.Workers[i].Scratch);
+		_S_THREADS.Workers[i].Scratch = NULL;
+	}
+
+	pthread_cond_destroy(&_S_THREADS.Done);
+	pthread_cond_destroy(&_S_THREADS.Wake);
+	pthread_mutex_destroy(&_S_THREADS.Lock);
+	pthread_mutex_destroy(&_S_THREADS.DispatchLock);
+	_S_THREADS.WorkerCount = 0;
+}
+
+/* Number of workers including the calling thread, 1 before s_threads_init */
+SYL_INLINE int s_threads_count(void)
+{
+	_SYL_PROFILE(s_threads_count);
+	return((_S_THREADS.WorkerCount > 0) ? _S_THREADS.WorkerCount : 1);
+}
+
+SYL_INLINE void* s_threads_scratch(int WorkerIndex, size_t* Size)
+{
+	if (Size)
+		*Size = _S_THREADS.ScratchSize;
+	if (WorkerIndex < 0 || WorkerIndex >= _S_THREADS.WorkerCount)
+		return(NULL);
+	return(_S_THREADS.Workers[WorkerIndex].Scratch);
+}
+
+/*
+ * Split [0, Count) into chunks of Grain and run Fn over them on every worker.
+ * Returns once all chunks are done. Without a pool, with a single chunk or
+ * when called from inside a chunk, the chunks run in order on the calling
+ * thread.
+ */
+SYL_INLINE void s_parallel_for(int Count, int Grain, sparallel_fn Fn, void* UserData)
+{
+	_SYL_PROFILE(s_parallel_for);
+	if (Count <= 0)
+		return;
+	if (Grain < 1)
+		Grain = 1;
+
+	int Chunks = (Count + Grain - 1) / Grain;
+	if (_S_THREADS.WorkerCount <= 1 || Chunks == 1 || _s_thread_index >= 0) {
+		int Index = (_s_thread_index >= 0) ? _s_thread_index : 0;
+		for (int Begin = 0; Begin < Count; Begin += Grain)
+			Fn(Begin, (Count - Begin < Grain) ? Count : Begin + Grain, Index, UserData);
+		return;
+	}
+
+	pthread_mutex_lock(&_S_THREADS.DispatchLock);
+
+	int Workers = _S_THREADS.WorkerCount;
+	_S_THREADS.Fn = Fn;
+	_S_THREADS.UserData = UserData;
+	_S_THREADS.Count = Count;
+	_S_THREADS.Grain = Grain;
+	for (int i = 0; i < Workers; ++i) {
+		unsigned long long Begin = (unsigned long long)Chunks * i / Workers;
+		unsigned long long End = (unsigned long long)Chunks * (i + 1) / Workers;
+		__atomic_store_n(&_S_THREADS.Workers[i].Range, Begin | (End << 32), __ATOMIC_RELAXED);
+	}
+	__atomic_store_n(&_S_THREADS.Pending, Workers - 1, __ATOMIC_RELEASE);
+
+	pthread_mutex_lock(&_S_THREADS.Lock);
+	_S_THREADS.Generation++;
+	pthread_cond_broadcast(&_S_THREADS.Wake);
+	pthread_mutex_unlock(&_S_THREADS.Lock);
+
+	_s_thread_index = 0;
+	_s_threads_run(0);
+	_s_thread_index = -1;
+
+	pthread_mutex_lock(&_S_THREADS.Lock);
+	while (__atomic_load_n(&_S_THREADS.Pending, __ATOMIC_ACQUIRE) != 0)
+		pthread_cond_wait(&_S_THREADS.Done, &_S_THREADS.Lock);
+	pthread_mutex_unlock(&_S_THREADS.Lock);
+
+	pthread_mutex_unlock(&_S_THREADS.DispatchLock);
+}
+
+#endif // SYL_THREADS
+
+/*********************************************
+ *                   NOISE                    *
+ *********************************************/
+
+/*
+ * Gradient noise and random sampling are written once against the _snf
+ * (float lanes), _sni (int lanes) and _snm (mask lanes) helpers below. They
+ * are 8 wide with AVX, 4 wide with SSE4 and plain scalars otherwise, so every
+ * build runs the same arithmetic. Lattice points are hashed with integer
+ * multiplies instead of a permutation table, which keeps the kernels free of
+ * gathers. The AVX path uses AVX2 integer instructions, like s_mat4_mul
+ * assumes FMA.
+ */
+
+#if defined(SYL_ENABLE_AVX)
+typedef __m256 _snf;
+typedef __m256i _sni;
+typedef __m256 _snm;
+#define _SYL_LANES 8
+
+_SYL_FORCE_INLINE _snf _s_nf_set1(float a) { return(_mm256_set1_ps(a)); }
+_SYL_FORCE_INLINE _snf _s_nf_load(const float* p) { return(_mm256_loadu_ps(p)); }
+_SYL_FORCE_INLINE void _s_nf_store(float* p, _snf a) { _mm256_storeu_ps(p, a); }
+_SYL_FORCE_INLINE _snf _s_nf_ramp(float a, float Step) { return(_mm256_add_ps(_mm256_set1_ps(a), _mm256_mul_ps(_mm256_setr_ps(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_ps(Step)))); }
+_SYL_FORCE_INLINE _snf _s_nf_add(_snf a, _snf b) { return(_mm256_add_ps(a, b)); }
+_SYL_FORCE_INLINE _snf _s_nf_sub(_snf a, _snf b) { return(_mm256_sub_ps(a, b)); }
+_SYL_FORCE_INLINE _snf _s_nf_mul(_snf a, _snf b) { return(_mm256_mul_ps(a, b)); }
+_SYL_FORCE_INLINE _snf _s_nf_abs(_snf a) { return(_mm256_andnot_ps(_mm256_set1_ps(-0.0f), a)); }
+_SYL_FORCE_INLINE _snf _s_nf_min(_snf a, _snf b) { return(_mm256_min_ps(a, b)); }
+_SYL_FORCE_INLINE _snf _s_nf_max(_snf a, _snf b) { return(_mm256_max_ps(a, b)); }
+_SYL_FORCE_INLINE _snf _s_nf_floor(_snf a) { return(_mm256_floor_ps(a)); }
+_SYL_FORCE_INLINE _sni _s_nf_to_int(_snf a) { return(_mm256_cvttps_epi32(a)); }
+_SYL_FORCE_INLINE _snm _s_nf_gt(_snf a, _snf b) { return(_mm256_cmp_ps(a, b, _CMP_GT_OQ)); }
+_SYL_FORCE_INLINE _snf _s_nf_select(_snm m, _snf a, _snf b) { return(_mm256_blendv_ps(b, a, m)); }
+_SYL_FORCE_INLINE _snf _s_nf_mask(_snm m, _snf a) { return(_mm256_and_ps(m, a)); }
+_SYL_FORCE_INLINE _snm _s_nm_and(_snm a, _snm b) { return(_mm256_and_ps(a, b)); }
+_SYL_FORCE_INLINE _snm _s_nm_or(_snm a, _snm b) { return(_mm256_or_ps(a, b)); }
+_SYL_FORCE_INLINE _snm _s_nm_andnot(_snm a, _snm b) { return(_mm256_andnot_ps(a, b)); }
+_SYL_FORCE_INLINE int _s_nm_bits(_snm a) { return(_mm256_movemask_ps(a)); }
+_SYL_FORCE_INLINE _sni _s_ni_set1(unsigned int a) { return(_mm256_set1_epi32((int)a)); }
+_SYL_FORCE_INLINE _sni _s_ni_add(_sni a, _sni b) { return(_mm256_add_epi32(a, b)); }
+_SYL_FORCE_INLINE _sni _s_ni_mul(_sni a, _sni b) { return(_mm256_mullo_epi32(a, b)); }
+_SYL_FORCE_INLINE _sni _s_ni_xor(_sni a, _sni b) { return(_mm256_xor_si256(a, b)); }
+_SYL_FORCE_INLINE _sni _s_ni_srl(_sni a, int n) { return(_mm256_srl_epi32(a, _mm_cvtsi32_si128(n))); }
+_SYL_FORCE_INLINE _snm _s_ni_bit(_sni a, unsigned int Bit) { __m256i b = _mm256_set1_epi32((int)Bit); return(_mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(a, b), b))); }
+_SYL_FORCE_INLINE _snm _s_ni_eq(_sni a, unsigned int Value) { return(_mm256_castsi256_ps(_mm256_cmpeq_epi32(a, _mm256_set1_epi32((int)Value)))); }
+_SYL_FORCE_INLINE _snm _s_ni_lt(_sni a, unsigned int Value) { return(_mm256_castsi256_ps(_mm256_cmpgt_epi32(_mm256_set1_epi32((int)Value), a))); }
+_SYL_FORCE_INLINE _sni _s_ni_and(_sni a, unsigned int Value) { return(_mm256_and_si256(a, _mm256_set1_epi32((int)Value))); }
+_SYL_FORCE_INLINE _sni _s_ni_select(_snm m, _sni a, _sni b) { return(_mm256_castps_si256(_mm256_blendv_ps(_mm256_castsi256_ps(b), _mm256_castsi256_ps(a), m))); }
+_SYL_FORCE_INLINE _sni _s_ni_load(const unsigned int* p) { return(_mm256_loadu_si256((const __m256i*)p)); }
+_SYL_FORCE_INLINE void _s_ni_store(unsigned int* p, _sni a) { _mm256_storeu_si256((__m256i*)p, a); }
+_SYL_FORCE_INLINE _sni _s_ni_or(_sni a, _sni b) { return(_mm256_or_si256(a, b)); }
+_SYL_FORCE_INLINE _sni _s_ni_sll(_sni a, int n) { return(_mm256_sll_epi32(a, _mm_cvtsi32_si128(n))); }
+_SYL_FORCE_INLINE _snf _s_ni_to_float(_sni a) { return(_mm256_cvtepi32_ps(a)); }
+_SYL_FORCE_INLINE _snf _s_nf_rsqrt(_snf a) { return(_mm256_rsqrt_ps(a)); }
+_SYL_FORCE_INLINE _snf _s_nf_div(_snf a, _snf b) { return(_mm256_div_ps(a, b)); }
+_SYL_FORCE_INLINE _snf _s_nf_rcp(_snf a) { return(_mm256_rcp_ps(a)); }
+_SYL_FORCE_INLINE _snf _s_nf_sqrt_exact(_snf a) { return(_mm256_sqrt_ps(a)); }
+_SYL_FORCE_INLINE _snf _s_nf_unpacklo(_snf a, _snf b) { return(_mm256_unpacklo_ps(a, b)); }
+_SYL_FORCE_INLINE _snf _s_nf_unpackhi(_snf a, _snf b) { return(_mm256_unpackhi_ps(a, b)); }
+_SYL_FORCE_INLINE _snf _s_nf_movelh(_snf a, _snf b) { return(_mm256_castpd_ps(_mm256_unpacklo_pd(_mm256_castps_pd(a), _mm256_castps_pd(b)))); }
+_SYL_FORCE_INLINE _snf _s_nf_movehl(_snf a, _snf b) { return(_mm256_castpd_ps(_mm256_unpackhi_pd(_mm256_castps_pd(b), _mm256_castps_pd(a)))); }
+#elif defined(SYL_ENABLE_SSE4)
+typedef __m128 _snf;
+typedef __m128i _sni;
+typedef __m128 _snm;
+#define _SYL_LANES 4
+
+_SYL_FORCE_INLINE _snf _s_nf_set1(float a) { return(_mm_set1_ps(a)); }
+_SYL_FORCE_INLINE _snf _s_nf_load(const float* p) { return(_mm_loadu_ps(p)); }
+_SYL_FORCE_INLINE void _s_nf_store(float* p, _snf a) { _mm_storeu_ps(p, a); }
+_SYL_FORCE_INLINE _snf _s_nf_ramp(float a, float Step) { return(_mm_add_ps(_mm_set1_ps(a), _mm_mul_ps(_mm_setr_ps(0, 1, 2, 3), _mm_set1_ps(Step)))); }
+_SYL_FORCE_INLINE _snf _s_nf_add(_snf a, _snf b) { return(_mm_add_ps(a, b)); }
+_SYL_FORCE_INLINE _snf _s_nf_sub(_snf a, _snf b) { return(_mm_sub_ps(a, b)); }
+_SYL_FORCE_INLINE _snf _s_nf_mul(_snf a, _snf b) { return(_mm_mul_ps(a, b)); }
+_SYL_FORCE_INLINE _snf _s_nf_abs(_snf a) { return(_mm_andnot_ps(_mm_set1_ps(-0.0f), a)); }
+_SYL_FORCE_INLINE _snf _s_nf_min(_snf a, _snf b) { return(_mm_min_ps(a, b)); }
+_SYL_FORCE_INLINE _snf _s_nf_max(_snf a, _snf b) { return(_mm_max_ps(a, b)); }
+_SYL_FORCE_INLINE _snf _s_nf_floor(_snf a) { return(_mm_floor_ps(a)); }
+_SYL_FORCE_INLINE _sni _s_nf_to_int(_snf a) { return(_mm_cvttps_epi32(a)); }
+_SYL_FORCE_INLINE _snm _s_nf_gt(_snf a, _snf b) { return(_mm_cmpgt_ps(a, b)); }
+_SYL_FORCE_INLINE _snf _s_nf_select(_snm m, _snf a, _snf b) { return(_mm_blendv_ps(b, a, m)); }
+_SYL_FORCE_INLINE _snf _s_nf_mask(_snm m, _snf a) { return(_mm_and_ps(m, a)); }
+_SYL_FORCE_INLINE _snm _s_nm_and(_snm a, _snm b) { return(_mm_and_ps(a, b)); }
+_SYL_FORCE_INLINE _snm _s_nm_or(_snm a, _snm b) { return(_mm_or_ps(a, b)); }
+_SYL_FORCE_INLINE _snm _s_nm_andnot(_snm a, _snm b) { return(_mm_andnot_ps(a, b)); }
+_SYL_FORCE_INLINE int _s_nm_bits(_snm a) { return(_mm_movemask_ps(a)); }
+_SYL_FORCE_INLINE _sni _s_ni_set1(unsigned int a) { return(_mm_set1_epi32((int)a)); }
+_SYL_FORCE_INLINE _sni _s_ni_add(_sni a, _sni b) { return(_mm_add_epi32(a, b)); }
+_SYL_FORCE_INLINE _sni _s_ni_mul(_sni a, _sni b) { return(_mm_mullo_epi32(a, b)); }
+_SYL_FORCE_INLINE _sni _s_ni_xor(_sni a, _sni b) { return(_mm_xor_si128(a, b)); }
+_SYL_FORCE_INLINE _sni _s_ni_srl(_sni a, int n) { return(_mm_srl_epi32(a, _mm_cvtsi32_si128(n))); }
+_SYL_FORCE_INLINE _snm _s_ni_bit(_sni a, unsigned int Bit) { __m128i b = _mm_set1_epi32((int)Bit); return(_mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(a, b), b))); }
+_SYL_FORCE_INLINE _snm _s_ni_eq(_sni a, unsigned int Value) { return(_mm_castsi128_ps(_mm_cmpeq_epi32(a, _mm_set1_epi32((int)Value)))); }
+_SYL_FORCE_INLINE _snm _s_ni_lt(_sni a, unsigned int Value) { return(_mm_castsi128_ps(_mm_cmplt_epi32(a, _mm_set1_epi32((int)Value)))); }
+_SYL_FORCE_INLINE _sni _s_ni_and(_sni a, unsigned int Value) { return(_mm_and_si128(a, _mm_set1_epi32((int)Value))); }
+_SYL_FORCE_INLINE _sni _s_ni_select(_snm m, _sni a, _sni b) { return(_mm_castps_si128(_mm_blendv_ps(_mm_castsi128_ps(b), _mm_castsi128_ps(a), m))); }
+_SYL_FORCE_INLINE _sni _s_ni_load(const unsigned int* p) { return(_mm_loadu_si128((const __m128i*)p)); }
+_SYL_FORCE_INLINE void _s_ni_store(unsigned int* p, _sni a) { _mm_storeu_si128((__m128i*)p, a); }
+_SYL_FORCE_INLINE _sni _s_ni_or(_sni a, _sni b) { return(_mm_or_si128(a, b)); }
+_SYL_FORCE_INLINE _sni _s_ni_sll(_sni a, int n) { return(_mm_sll_epi32(a, _mm_cvtsi32_si128(n))); }
+_SYL_FORCE_INLINE _snf _s_ni_to_float(_sni a) { return(_mm_cvtepi32_ps(a)); }
+_SYL_FORCE_INLINE _snf _s_nf_rsqrt(_snf a) { return(_mm_rsqrt_ps(a)); }
+_SYL_FORCE_INLINE _snf _s_nf_div(_snf a, _snf b) { return(_mm_div_ps(a, b)); }
+_SYL_FORCE_INLINE _snf _s_nf_rcp(_snf a) { return(_mm_rcp_ps(a)); }
+_SYL_FORCE_INLINE _snf _s_nf_sqrt_exact(_snf a) { return(_mm_sqrt_ps(a)); }
+_SYL_FORCE_INLINE _snf _s_nf_unpacklo(_snf a, _snf b) { return(_mm_unpacklo_ps(a, b)); }
+_SYL_FORCE_INLINE _snf _s_nf_unpackhi(_snf a, _snf b) { return(_mm_unpackhi_ps(a, b)); }
+_SYL_FORCE_INLINE _snf _s_nf_movelh(_snf a, _snf b) { return(_mm_movelh_ps(a, b)); }
+_SYL_FORCE_INLINE _snf _s_nf_movehl(_snf a, _snf b) { return(_mm_movehl_ps(a, b)); }
+#else
+typedef float _snf;
+typedef unsigned int _sni;
+typedef bool _snm;
+#define _SYL_LANES 1
+
+_SYL_FORCE_INLINE _snf _s_nf_set1(float a) { return(a); }
+_SYL_FORCE_INLINE _snf _s_nf_load(const float* p) { return(*p); }
+_SYL_FORCE_INLINE void _s_nf_store(float* p, _snf a) { *p = a; }
+_SYL_FORCE_INLINE _snf _s_nf_ramp(float a, float Step) { (void)Step; return(a); }
+_SYL_FORCE_INLINE _snf _s_nf_add(_snf a, _snf b) { return(a + b); }
+_SYL_FORCE_INLINE _snf _s_nf_sub(_snf a, _snf b) { return(a - b); }
+_SYL_FORCE_INLINE _snf _s_nf_mul(_snf a, _snf b) { return(a * b); }
+_SYL_FORCE_INLINE _snf _s_nf_abs(_snf a) { return(fabsf(a)); }
+_SYL_FORCE_INLINE _snf _s_nf_min(_snf a, _snf b) { return(a < b ? a : b); }
+_SYL_FORCE_INLINE _snf _s_nf_max(_snf a, _snf b) { return(a > b ? a : b); }
+_SYL_FORCE_INLINE _snf _s_nf_floor(_snf a) { return(floorf(a)); }
+_SYL_FORCE_INLINE _sni _s_nf_to_int(_snf a) { return((unsigned int)(int)a); }
+_SYL_FORCE_INLINE _snm _s_nf_gt(_snf a, _snf b) { return(a > b); }
+_SYL_FORCE_INLINE _snf _s_nf_select(_snm m, _snf a, _snf b) { return(m ? a : b); }
+_SYL_FORCE_INLINE _snf _s_nf_mask(_snm m, _snf a) { return(m ? a : 0.0f); }
+_SYL_FORCE_INLINE _snm _s_nm_and(_snm a, _snm b) { return(a && b); }
+_SYL_FORCE_INLINE _snm _s_nm_or(_snm a, _snm b) { return(a || b); }
+_SYL_FORCE_INLINE _snm _s_nm_andnot(_snm a, _snm b) { return(!a && b); }
+_SYL_FORCE_INLINE int _s_nm_bits(_snm a) { return(a ? 1 : 0); }
+_SYL_FORCE_INLINE _sni _s_ni_set1(unsigned int a) { return(a); }
+_SYL_FORCE_INLINE _sni _s_ni_add(_sni a, _sni b) { return(a + b); }
+_SYL_FORCE_INLINE _sni _s_ni_mul(_sni a, _sni b) { return(a * b); }
+_SYL_FORCE_INLINE _sni _s_ni_xor(_sni a, _sni b) { return(a ^ b); }
+_SYL_FORCE_INLINE _sni _s_ni_srl(_sni a, int n) { return(a >> n); }
+_SYL_FORCE_INLINE _snm _s_ni_bit(_sni a, unsigned int Bit) { return((a & Bit) == Bit); }
+_SYL_FORCE_INLINE _snm _s_ni_eq(_sni a, unsigned int Value) { return(a == Value); }
+_SYL_FORCE_INLINE _snm _s_ni_lt(_sni a, unsigned int Value) { return(a < Value); }
+_SYL_FORCE_INLINE _sni _s_ni_and(_sni a, unsigned int Value) { return(a & Value); }
+_SYL_FORCE_INLINE _sni _s_ni_select(_snm m, _sni a, _sni b) { return(m ? a : b); }
+_SYL_FORCE_INLINE _sni _s_ni_load(const unsigned int* p) { return(*p); }
+_SYL_FORCE_INLINE void _s_ni_store(unsigned int* p, _sni a) { *p = a; }
+_SYL_FORCE_INLINE _sni _s_ni_or(_sni a, _sni b) { return(a | b); }
+_SYL_FORCE_INLINE _sni _s_ni_sll(_sni a, int n) { return(a << n); }
+_SYL_FORCE_INLINE _snf _s_ni_to_float(_sni a) { return((float)(int)a); }
+_SYL_FORCE_INLINE _snf _s_nf_rsqrt(_snf a) { return(1.0f / sqrtf(a)); }
+_SYL_FORCE_INLINE _snf _s_nf_div(_snf a, _snf b) { return(a / b); }
+_SYL_FORCE_INLINE _snf _s_nf_rcp(_snf a) { return(1.0f / a); }
+_SYL_FORCE_INLINE _snf _s_nf_sqrt_exact(_snf a) { return(sqrtf(a)); }
+#endif
+
+_SYL_FORCE_INLINE _snf _s_nf_madd(_snf a, _snf b, _snf c) { return(_s_nf_add(_s_nf_mul(a, b), c)); }
+_SYL_FORCE_INLINE _snf _s_nf_lerp(_snf a, _snf b, _snf t) { return(_s_nf_madd(t, _s_nf_sub(b, a), a)); }
+
+/* rsqrt refined with one Newton step, close to full float precision */
+_SYL_FORCE_INLINE _snf _s_nf_rsqrt_nr(_snf a)
+{
+	_snf r = _s_nf_rsqrt(a);
+	return(_s_nf_mul(r, _s_nf_sub(_s_nf_set1(1.5f), _s_nf_mul(_s_nf_mul(_s_nf_set1(0.5f), a), _s_nf_mul(r, r)))));
+}
+
+/* rcp refined with one Newton step */
+_SYL_FORCE_INLINE _snf _s_nf_rcp_nr(_snf a)
+{
+	_snf r = _s_nf_rcp(a);
+	return(_s_nf_mul(r, _s_nf_sub(_s_nf_set1(2.0f), _s_nf_mul(a, r))));
+}
+
+/*
+ * Full blocks of svec3 and svec4 are transposed in registers. With AVX the
+ * low and high 128 bits hold elements 0-3 and 4-7, and the 128 bit shuffles
+ * work on both halves at once.
+ */
+#if defined(SYL_ENABLE_SSE4)
+#if defined(SYL_ENABLE_AVX)
+#define _SYL_VEC_LOAD4(p, Half) _mm256_loadu2_m128((p) + (Half), (p))
+#define _SYL_VEC_STORE4(p, Half, v) _mm256_storeu2_m128((p) + (Half), (p), (v))
+#define _SYL_VEC_BLEND(a, b, m) _mm256_blend_ps((a), (b), (m) | ((m) << 4))
+#define _SYL_VEC_PERMUTE(a, m) _mm256_permute_ps((a), (m))
+#else
+#define _SYL_VEC_LOAD4(p, Half) _mm_loadu_ps(p)
+#define _SYL_VEC_STORE4(p, Half, v) _mm_storeu_ps((p), (v))
+#define _SYL_VEC_BLEND(a, b, m) _mm_blend_ps((a), (b), (m))
+#define _SYL_VEC_PERMUTE(a, m) _mm_shuffle_ps((a), (a), (m))
+#endif
+
+/* x0 y0 z0 x1 | y1 z1 x2 y2 | z2 x3 y3 z3 */
+_SYL_FORCE_INLINE void _s_nf_load_aos3(const float* p, _snf* V)
+{
+	_snf a = _SYL_VEC_LOAD4(p, 12), b = _SYL_VEC_LOAD4(p + 4, 12), c = _SYL_VEC_LOAD4(p + 8, 12);
+	V[0] = _SYL_VEC_PERMUTE(_SYL_VEC_BLEND(_SYL_VEC_BLEND(a, b, 4), c, 2), _MM_SHUFFLE(1, 2, 3, 0));
+	V[1] = _SYL_VEC_PERMUTE(_SYL_VEC_BLEND(_SYL_VEC_BLEND(a, b, 9), c, 4), _MM_SHUFFLE(2, 3, 0, 1));
+	V[2] = _SYL_VEC_PERMUTE(_SYL_VEC_BLEND(_SYL_VEC_BLEND(a, b, 2), c, 9), _MM_SHUFFLE(3, 0, 1, 2));
+}
+
+_SYL_FORCE_INLINE void _s_nf_store_aos3(float* p, const _snf* V)
+{
+	_snf x = _SYL_VEC_PERMUTE(V[0], _MM_SHUFFLE(1, 2, 3, 0));
+	_snf y = _SYL_VEC_PERMUTE(V[1], _MM_SHUFFLE(2, 3, 0, 1));
+	_snf z = _SYL_VEC_PERMUTE(V[2], _MM_SHUFFLE(3, 0, 1, 2));
+	_SYL_VEC_STORE4(p, 12, _SYL_VEC_BLEND(_SYL_VEC_BLEND(x, y, 2), z, 4));
+	_SYL_VEC_STORE4(p + 4, 12, _SYL_VEC_BLEND(_SYL_VEC_BLEND(y, z, 2), x, 4));
+	_SYL_VEC_STORE4(p + 8, 12, _SYL_VEC_BLEND(_SYL_VEC_BLEND(z, x, 2), y, 4));
+}
+
+_SYL_FORCE_INLINE void _s_nf_load_aos4(const float* p, _snf* V)
+{
+	_snf a = _SYL_VEC_LOAD4(p, 16), b = _SYL_VEC_LOAD4(p + 4, 16), c = _SYL_VEC_LOAD4(p + 8, 16), d = _SYL_VEC_LOAD4(p + 12, 16);
+	_snf ab0 = _s_nf_unpacklo(a, b), ab1 = _s_nf_unpackhi(a, b);
+	_snf cd0 = _s_nf_unpacklo(c, d), cd1 = _s_nf_unpackhi(c, d);
+	V[0] = _s_nf_movelh(ab0, cd0);
+	V[1] = _s_nf_movehl(cd0, ab0);
+	V[2] = _s_nf_movelh(ab1, cd1);
+	V[3] = _s_nf_movehl(cd1, ab1);
+}
+
+_SYL_FORCE_INLINE void _s_nf_store_aos4(float* p, const _snf* V)
+{
+	_snf xy0 = _s_nf_unpacklo(V[0], V[1]), xy1 = _s_nf_unpackhi(V[0], V[1]);
+	_snf zw0 = _s_nf_unpacklo(V[2], V[3]), zw1 = _s_nf_unpackhi(V[2], V[3]);
+	_SYL_VEC_STORE4(p, 16, _s_nf_movelh(xy0, zw0));
+	_SYL_VEC_STORE4(p + 4, 16, _s_nf_movehl(zw0, xy0));
+	_SYL_VEC_STORE4(p + 8, 16, _s_nf_movelh(xy1, zw1));
+	_SYL_VEC_STORE4(p + 12, 16, _s_nf_movehl(zw1, xy1));
+}
+#endif
+
+/* Component k of element i is In[k][i * Stride], lanes past Rest load as zero */
+_SYL_FORCE_INLINE void _s_vec_load(const float* const* In, int Dims, int Stride, int Index, int Rest, _snf* V)
+{
+	float Block[_SYL_LANES];
+	int j, k;
+
+	if (Rest == _SYL_LANES) {
+		if (Stride == 1) {
+			for (k = 0; k < Dims; ++k)
+				V[k] = _s_nf_load(In[k] + Index);
+			return;
+		}
+#if defined(SYL_ENABLE_SSE4)
+		if (Stride == 3 && Dims == 3) {
+			_s_nf_load_aos3(In[0] + Index * 3, V);
+			return;
+		}
+		if (Stride == 4 && Dims == 4) {
+			_s_nf_load_aos4(In[0] + Index * 4, V);
+			return;
+		}
+#endif
+	}
+
+	for (k = 0; k < Dims; ++k) {
+		for (j = 0; j < _SYL_LANES; ++j)
+			Block[j] = j < Rest ? In[k][(Index + j) * Stride] : 0.0f;
+		V[k] = _s_nf_load(Block);
+	}
+}
+
+_SYL_FORCE_INLINE void _s_vec_store(float* const* Out, int Dims, int Stride, int Index, int Rest, const _snf* V)
+{
+	float Block[_SYL_LANES];
+	int j, k;
+
+	if (Rest == _SYL_LANES) {
+		if (Stride == 1) {
+			for (k = 0; k < Dims; ++k)
+				_s_nf_store(Out[k] + Index, V[k]);
+			return;
+		}
+#if defined(SYL_ENABLE_SSE4)
+		if (Stride == 3 && Dims == 3) {
+			_s_nf_store_aos3(Out[0] + Index * 3, V);
+			return;
+		}
+		if (Stride == 4 && Dims == 4) {
+			_s_nf_store_aos4(Out[0] + Index * 4, V);
+			return;
+		}
+#endif
+	}
+
+	for (k = 0; k < Dims; ++k) {
+		_s_nf_store(Block, V[k]);
+		for (j = 0; j < Rest; ++j)
+			Out[k][(Index + j) * Stride] = Block[j];
+	}
+}
+
+/*
+ * Lattice coordinates are hashed as (x * P0) ^ (y * P1) ^ ... ^ Seed followed
+ * by a finalizer. The neighbouring cell only adds the prime, so every axis
+ * costs one multiply per point rather than one per corner.
+ */
+static const unsigned int _S_NOISE_PRIMES[4] = { 0x8da6b343u, 0xd8163841u, 0xcb1ab31fu, 0x165667b1u };
+
+/* Output scales, each brings the peak of its kernel to about 1 */
+#define _S_NOISE_PERLIN4_SCALE 0.83f  /* The unscaled 4D Perlin peak measures about 1.2 */
+#define _S_NOISE_SIMPLEX2_SCALE 70.0f /* Gustavson's reference scale for a 0.5 kernel radius */
+#define _S_NOISE_SIMPLEX3_SCALE 76.0f /* The unscaled 3D peak measures about 1 / 77 with a 0.5 radius */
+#define _S_NOISE_SIMPLEX4_SCALE 62.0f /* The unscaled 4D peak measures about 1 / 63 with a 0.5 radius */
+
+_SYL_FORCE_INLINE void _s_noise_lattice(_sni Cell, int Axis, _sni* Lattice)
+{
+	Lattice[0] = _s_ni_mul(Cell, _s_ni_set1(_S_NOISE_PRIMES[Axis]));
+	Lattice[1] = _s_ni_add(Lattice[0], _s_ni_set1(_S_NOISE_PRIMES[Axis]));
+}
+
+_SYL_FORCE_INLINE _sni _s_noise_hash(_sni h)
+{
+	h = _s_ni_xor(h, _s_ni_srl(h, 16));
+	h = _s_ni_mul(h, _s_ni_set1(0x7feb352du));
+	h = _s_ni_xor(h, _s_ni_srl(h, 15));
+	h = _s_ni_mul(h, _s_ni_set1(0x846ca68bu));
+	h = _s_ni_xor(h, _s_ni_srl(h, 16));
+	return(h);
+}
+
+/*
+ * Gradients of the improved Perlin noise: the 12 cube edges (with 4 of them
+ * repeated). 2D noise uses the xy part, which gives the 8 axis and diagonal
+ * directions.
+ */
+_SYL_FORCE_INLINE void _s_noise_grad3(_sni Hash, _snf* gx, _snf* gy, _snf* gz)
+{
+	_sni h = _s_ni_and(Hash, 15);
+	_snf One = _s_nf_set1(1.0f);
+	_snf MinusOne = _s_nf_set1(-1.0f);
+	_snf s1 = _s_nf_select(_s_ni_bit(h, 1), MinusOne, One);
+	_snf s2 = _s_nf_select(_s_ni_bit(h, 2), MinusOne, One);
+	_snm UX = _s_ni_lt(h, 8);
+	_snm VY = _s_ni_lt(h, 4);
+	_snm VX = _s_nm_andnot(VY, _s_nm_or(_s_ni_eq(h, 12), _s_ni_eq(h, 14)));
+	_snm VZ = _s_nm_andnot(_s_nm_or(VY, VX), _s_ni_lt(h, 16));
+
+	*gx = _s_nf_add(_s_nf_mask(UX, s1), _s_nf_mask(VX, s2));
+	*gy = _s_nf_add(_s_nf_select(UX, _s_nf_set1(0.0f), s1), _s_nf_mask(VY, s2));
+	*gz = _s_nf_mask(VZ, s2);
+}
+
+/* 32 gradients of the form (0, ±1, ±1, ±1) and its permutations, returns the dot product */
+_SYL_FORCE_INLINE _snf _s_noise_grad4_dot(_sni Hash, _snf x, _snf y, _snf z, _snf w)
+{
+	_sni h = _s_ni_and(Hash, 31);
+	_snf Zero = _s_nf_set1(0.0f);
+	_snf u = _s_nf_select(_s_ni_lt(h, 24), x, y);
+	_snf v = _s_nf_select(_s_ni_lt(h, 16), y, z);
+	_snf t = _s_nf_select(_s_ni_lt(h, 8), z, w);
+	u = _s_nf_select(_s_ni_bit(h, 1), _s_nf_sub(Zero, u), u);
+	v = _s_nf_select(_s_ni_bit(h, 2), _s_nf_sub(Zero, v), v);
+	t = _s_nf_select(_s_ni_bit(h, 4), _s_nf_sub(Zero, t), t);
+	return(_s_nf_add(u, _s_nf_add(v, t)));
+}
+
+/* Quintic fade curve 6t^5 - 15t^4 + 10t^3 and its derivative */
+_SYL_FORCE_INLINE _snf _s_noise_fade(_snf t)
+{
+	_snf f = _s_nf_madd(t, _s_nf_set1(6.0f), _s_nf_set1(-15.0f));
+	f = _s_nf_madd(t, f, _s_nf_set1(10.0f));
+	return(_s_nf_mul(_s_nf_mul(t, t), _s_nf_mul(t, f)));
+}
+
+_SYL_FORCE_INLINE _snf _s_noise_dfade(_snf t)
+{
+	_snf f = _s_nf_madd(t, _s_nf_sub(t, _s_nf_set1(2.0f)), _s_nf_set1(1.0f));
+	return(_s_nf_mul(_s_nf_mul(_s_nf_set1(30.0f), _s_nf_mul(t, t)), f));
+}
+
+/*
+ * Perlin noise written as a polynomial in the fade weights so the derivative
+ * falls out of the same coefficients. D receives the gradient when not NULL.
+ */
+SYL_INLINE _snf _s_noise_perlin2(const _snf* P, _sni Seed, _snf* D)
+{
+	_snf Floor[2], F[2], G[2][4], V[4];
+	_sni L[2][2];
+	int c, k;
+
+	for (k = 0; k < 2; ++k) {
+		Floor[k] = _s_nf_floor(P[k]);
+		F[k] = _s_nf_sub(P[k], Floor[k]);
+		_s_noise_lattice(_s_nf_to_int(Floor[k]), k, L[k]);
+	}
+
+	for (c = 0; c < 4; ++c) {
+		_snf x = (c & 1) ? _s_nf_sub(F[0], _s_nf_set1(1.0f)) : F[0];
+		_snf y = (c & 2) ? _s_nf_sub(F[1], _s_nf_set1(1.0f)) : F[1];
+		_sni h = _s_noise_hash(_s_ni_xor(_s_ni_xor(L[0][c & 1], L[1][(c >> 1) & 1]), Seed));
+		_snf gz;
+		_s_noise_grad3(h, &G[0][c], &G[1][c], &gz);
+		V[c] = _s_nf_madd(G[0][c], x, _s_nf_mul(G[1][c], y));
+	}
+
+	_snf u = _s_noise_fade(F[0]);
+	_snf v = _s_noise_fade(F[1]);
+	_snf k1 = _s_nf_sub(V[1], V[0]);
+	_snf k2 = _s_nf_sub(V[2], V[0]);
+	_snf k3 = _s_nf_sub(_s_nf_add(V[0], V[3]), _s_nf_add(V[1], V[2]));
+	_snf Result = _s_nf_add(V[0], _s_nf_madd(u, k1, _s_nf_mul(v, _s_nf_madd(u, k3, k2))));
+
+	if (D) {
+		_snf du = _s_noise_dfade(F[0]);
+		_snf dv = _s_noise_dfade(F[1]);
+		for (k = 0; k < 2; ++k) {
+			_snf g1 = _s_nf_sub(G[k][1], G[k][0]);
+			_snf g2 = _s_nf_sub(G[k][2], G[k][0]);
+			_snf g3 = _s_nf_sub(_s_nf_add(G[k][0], G[k][3]), _s_nf_add(G[k][1], G[k][2]));
+			D[k] = _s_nf_add(G[k][0], _s_nf_madd(u, g1, _s_nf_mul(v, _s_nf_madd(u, g3, g2))));
+		}
+		D[0] = _s_nf_madd(du, _s_nf_madd(v, k3, k1), D[0]);
+		D[1] = _s_nf_madd(dv, _s_nf_madd(u, k3, k2), D[1]);
+	}
+	return(Result);
+}
+
+/* Coefficients of the trilinear polynomial over corners ordered x, y, z from the lowest bit */
+_SYL_FORCE_INLINE void _s_noise_trilinear(const _snf* C, _snf* K)
+{
+	K[0] = C[0];
+	K[1] = _s_nf_sub(C[1], C[0]);
+	K[2] = _s_nf_sub(C[2], C[0]);
+	K[3] = _s_nf_sub(C[4], C[0]);
+	K[4] = _s_nf_sub(_s_nf_add(C[0], C[3]), _s_nf_add(C[1], C[2]));
+	K[5] = _s_nf_sub(_s_nf_add(C[0], C[6]), _s_nf_add(C[2], C[4]));
+	K[6] = _s_nf_sub(_s_nf_add(C[0], C[5]), _s_nf_add(C[1], C[4]));
+	K[7] = _s_nf_sub(_s_nf_add(_s_nf_add(C[1], C[2]), _s_nf_add(C[4], C[7])),
+			 _s_nf_add(_s_nf_add(C[0], C[3]), _s_nf_add(C[5], C[6])));
+}
+
+_SYL_FORCE_INLINE _snf _s_noise_trilinear_eval(const _snf* K, _snf u, _snf v, _snf w)
+{
+	_snf r = _s_nf_madd(u, K[1], K[0]);
+	r = _s_nf_madd(v, _s_nf_madd(u, K[4], K[2]), r);
+	r = _s_nf_madd(w, _s_nf_madd(v, _s_nf_madd(u, K[7], K[5]), _s_nf_madd(u, K[6], K[3])), r);
+	return(r);
+}
+
+SYL_INLINE _snf _s_noise_perlin3(const _snf* P, _sni Seed, _snf* D)
+{
+	_snf Floor[3], F[3], G[3][8], V[8], K[8];
+	_sni L[3][2];
+	int c, k;
+
+	for (k = 0; k < 3; ++k) {
+		Floor[k] = _s_nf_floor(P[k]);
+		F[k] = _s_nf_sub(P[k], Floor[k]);
+		_s_noise_lattice(_s_nf_to_int(Floor[k]), k, L[k]);
+	}
+
+	for (c = 0; c < 8; ++c) {
+		_snf x = (c & 1) ? _s_nf_sub(F[0], _s_nf_set1(1.0f)) : F[0];
+		_snf y = (c & 2) ? _s_nf_sub(F[1], _s_nf_set1(1.0f)) : F[1];
+		_snf z = (c & 4) ? _s_nf_sub(F[2], _s_nf_set1(1.0f)) : F[2];
+		_sni h = _s_noise_hash(_s_ni_xor(_s_ni_xor(L[0][c & 1], L[1][(c >> 1) & 1]), _s_ni_xor(L[2][(c >> 2) & 1], Seed)));
+		_s_noise_grad3(h, &G[0][c], &G[1][c], &G[2][c]);
+		V[c] = _s_nf_madd(G[0][c], x, _s_nf_madd(G[1][c], y, _s_nf_mul(G[2][c], z)));
+	}
+
+	_snf u = _s_noise_fade(F[0]);
+	_snf v = _s_noise_fade(F[1]);
+	_snf w = _s_noise_fade(F[2]);
+
+	_s_noise_trilinear(V, K);
+	_snf Result = _s_noise_trilinear_eval(K, u, v, w);
+
+	if (D) {
+		_snf GK[8];
+		_snf du = _s_noise_dfade(F[0]);
+		_snf dv = _s_noise_dfade(F[1]);
+		_snf dw = _s_noise_dfade(F[2]);
+		_snf Dx = _s_nf_madd(v, K[4], K[1]);
+		_snf Dy = _s_nf_madd(u, K[4], K[2]);
+		_snf Dz = _s_nf_madd(v, K[5], K[3]);
+		Dx = _s_nf_madd(w, _s_nf_madd(v, K[7], K[6]), Dx);
+		Dy = _s_nf_madd(w, _s_nf_madd(u, K[7], K[5]), Dy);
+		Dz = _s_nf_madd(u, _s_nf_madd(v, K[7], K[6]), Dz);
+
+		for (k = 0; k < 3; ++k) {
+			_s_noise_trilinear(G[k], GK);
+			D[k] = _s_noise_trilinear_eval(GK, u, v, w);
+		}
+		D[0] = _s_nf_madd(du, Dx, D[0]);
+		D[1] = _s_nf_madd(dv, Dy, D[1]);
+		D[2] = _s_nf_madd(dw, Dz, D[2]);
+	}
+	return(Result);
+}
+
+/* Value only, like simplex4, there are no 4D derivative functions */
+SYL_INLINE _snf _s_noise_perlin4(const _snf* P, _sni Seed)
+{
+	_snf Floor[4], F[4], U[4], V[16];
+	_sni L[4][2];
+	int c, k;
+
+	for (k = 0; k < 4; ++k) {
+		Floor[k] = _s_nf_floor(P[k]);
+		F[k] = _s_nf_sub(P[k], Floor[k]);
+		U[k] = _s_noise_fade(F[k]);
+		_s_noise_lattice(_s_nf_to_int(Floor[k]), k, L[k]);
+	}
+
+	for (c = 0; c < 16; ++c) {
+		_snf Q[4];
+		_sni h = Seed;
+		for (k = 0; k < 4; ++k) {
+			Q[k] = (c & (1 << k)) ? _s_nf_sub(F[k], _s_nf_set1(1.0f)) : F[k];
+			h = _s_ni_xor(h, L[k][(c >> k) & 1]);
+		}
+		V[c] = _s_noise_grad4_dot(_s_noise_hash(h), Q[0], Q[1], Q[2], Q[3]);
+	}
+
+	/* Collapse one axis at a time, corners are ordered x, y, z, w from the lowest bit */
+	for (k = 0; k < 4; ++k) {
+		int Half = 8 >> k;
+		for (c = 0; c < Half; ++c)
+			V[c] = _s_nf_lerp(V[c * 2], V[c * 2 + 1], U[k]);
+	}
+	return(_s_nf_mul(V[0], _s_nf_set1(_S_NOISE_PERLIN4_SCALE)));
+}
+
+/*
+ * Simplex corner contribution (R - |d|^2)^4 * dot(g, d). The derivative is
+ * t^4 * g - 8 * t^3 * dot(g, d) * d and is accumulated into D.
+ */
+_SYL_FORCE_INLINE _snf _s_noise_simplex_corner(int Dims, const _snf* Q, const _snf* G, _snf R, _snf* D)
+{
+	_snf t = R, gd = _s_nf_set1(0.0f);
+	int k;
+
+	for (k = 0; k < Dims; ++k) {
+		t = _s_nf_sub(t, _s_nf_mul(Q[k], Q[k]));
+		gd = _s_nf_madd(G[k], Q[k], gd);
+	}
+	t = _s_nf_mask(_s_nf_gt(t, _s_nf_set1(0.0f)), t);
+
+	_snf t2 = _s_nf_mul(t, t);
+	_snf t4 = _s_nf_mul(t2, t2);
+
+	if (D) {
+		_snf s = _s_nf_mul(_s_nf_mul(_s_nf_set1(-8.0f), _s_nf_mul(t2, t)), gd);
+		for (k = 0; k < Dims; ++k)
+			D[k] = _s_nf_add(D[k], _s_nf_madd(t4, G[k], _s_nf_mul(s, Q[k])));
+	}
+	return(_s_nf_mul(t4, gd));
+}
+
+SYL_INLINE _snf _s_noise_simplex2(const _snf* P, _sni Seed, _snf* D)
+{
+	const float F2 = 0.366025403784f, G2 = 0.211324865405f;
+	_snf One = _s_nf_set1(1.0f), Zero = _s_nf_set1(0.0f);
+	int k;
+
+	_snf s = _s_nf_mul(_s_nf_add(P[0], P[1]), _s_nf_set1(F2));
+	_snf i = _s_nf_floor(_s_nf_add(P[0], s));
+	_snf j = _s_nf_floor(_s_nf_add(P[1], s));
+	_snf t = _s_nf_mul(_s_nf_add(i, j), _s_nf_set1(G2));
+	_snf Q0[2], Q1[2], Q2[2], G[2], gz;
+
+	Q0[0] = _s_nf_add(_s_nf_sub(P[0], i), t);
+	Q0[1] = _s_nf_add(_s_nf_sub(P[1], j), t);
+
+	/* Lower or upper triangle of the skewed cell */
+	_snm XGreater = _s_nf_gt(Q0[0], Q0[1]);
+	_snf i1 = _s_nf_select(XGreater, One, Zero);
+	_snf j1 = _s_nf_sub(One, i1);
+
+	Q1[0] = _s_nf_add(_s_nf_sub(Q0[0], i1), _s_nf_set1(G2));
+	Q1[1] = _s_nf_add(_s_nf_sub(Q0[1], j1), _s_nf_set1(G2));
+	Q2[0] = _s_nf_add(Q0[0], _s_nf_set1(2.0f * G2 - 1.0f));
+	Q2[1] = _s_nf_add(Q0[1], _s_nf_set1(2.0f * G2 - 1.0f));
+
+	_sni LX[2], LY[2];
+	_s_noise_lattice(_s_nf_to_int(i), 0, LX);
+	_s_noise_lattice(_s_nf_to_int(j), 1, LY);
+	_snf R = _s_nf_set1(0.5f);
+	_snf Result;
+
+	if (D)
+		D[0] = D[1] = Zero;
+
+	_s_noise_grad3(_s_noise_hash(_s_ni_xor(_s_ni_xor(LX[0], LY[0]), Seed)), &G[0], &G[1], &gz);
+	Result = _s_noise_simplex_corner(2, Q0, G, R, D);
+	_s_noise_grad3(_s_noise_hash(_s_ni_xor(_s_ni_select(XGreater, _s_ni_xor(LX[1], LY[0]), _s_ni_xor(LX[0], LY[1])), Seed)), &G[0], &G[1], &gz);
+	Result = _s_nf_add(Result, _s_noise_simplex_corner(2, Q1, G, R, D));
+	_s_noise_grad3(_s_noise_hash(_s_ni_xor(_s_ni_xor(LX[1], LY[1]), Seed)), &G[0], &G[1], &gz);
+	Result = _s_nf_add(Result, _s_noise_simplex_corner(2, Q2, G, R, D));
+
+	_snf Scale = _s_nf_set1(_S_NOISE_SIMPLEX2_SCALE);
+	if (D)
+		for (k = 0; k < 2; ++k)
+			D[k] = _s_nf_mul(D[k], Scale);
+	return(_s_nf_mul(Result, Scale));
+}
+
+SYL_INLINE _snf _s_noise_simplex3(const _snf* P, _sni Seed, _snf* D)
+{
+	const float F3 = 1.0f / 3.0f, G3 = 1.0f / 6.0f;
+	_snf One = _s_nf_set1(1.0f), Zero = _s_nf_set1(0.0f);
+	_snf Cell[3], Q[4][3], G[3];
+	_snm M[2][3];
+	_sni L[3][2], H[4];
+	int c, k;
+
+	_snf s = _s_nf_mul(_s_nf_add(P[0], _s_nf_add(P[1], P[2])), _s_nf_set1(F3));
+	for (k = 0; k < 3; ++k)
+		Cell[k] = _s_nf_floor(_s_nf_add(P[k], s));
+	_snf t = _s_nf_mul(_s_nf_add(Cell[0], _s_nf_add(Cell[1], Cell[2])), _s_nf_set1(G3));
+	for (k = 0; k < 3; ++k) {
+		Q[0][k] = _s_nf_add(_s_nf_sub(P[k], Cell[k]), t);
+		_s_noise_lattice(_s_nf_to_int(Cell[k]), k, L[k]);
+	}
+
+	/* Pick the tetrahedron from the ordering of the offsets */
+	_snm All = _s_nf_gt(One, Zero);
+	_snm xy = _s_nm_andnot(_s_nf_gt(Q[0][1], Q[0][0]), All);
+	_snm yz = _s_nm_andnot(_s_nf_gt(Q[0][2], Q[0][1]), All);
+	_snm xz = _s_nm_andnot(_s_nf_gt(Q[0][2], Q[0][0]), All);
+
+	M[0][0] = _s_nm_and(xy, xz);
+	M[0][1] = _s_nm_andnot(xy, yz);
+	M[0][2] = _s_nm_andnot(xz, _s_nm_andnot(yz, All));
+	M[1][0] = _s_nm_or(xy, xz);
+	M[1][1] = _s_nm_or(_s_nm_andnot(xy, All), yz);
+	M[1][2] = _s_nm_andnot(_s_nm_and(xz, yz), All);
+
+	H[0] = H[1] = H[2] = H[3] = Seed;
+	for (k = 0; k < 3; ++k) {
+		Q[1][k] = _s_nf_add(_s_nf_sub(Q[0][k], _s_nf_mask(M[0][k], One)), _s_nf_set1(G3));
+		Q[2][k] = _s_nf_add(_s_nf_sub(Q[0][k], _s_nf_mask(M[1][k], One)), _s_nf_set1(2.0f * G3));
+		Q[3][k] = _s_nf_add(Q[0][k], _s_nf_set1(3.0f * G3 - 1.0f));
+		H[0] = _s_ni_xor(H[0], L[k][0]);
+		H[1] = _s_ni_xor(H[1], _s_ni_select(M[0][k], L[k][1], L[k][0]));
+		H[2] = _s_ni_xor(H[2], _s_ni_select(M[1][k], L[k][1], L[k][0]));
+		H[3] = _s_ni_xor(H[3], L[k][1]);
+	}
+
+	_snf R = _s_nf_set1(0.5f);
+	_snf Result = Zero;
+
+	if (D)
+		D[0] = D[1] = D[2] = Zero;
+
+	for (c = 0; c < 4; ++c) {
+		_s_noise_grad3(_s_noise_hash(H[c]), &G[0], &G[1], &G[2]);
+		Result = _s_nf_add(Result, _s_noise_simplex_corner(3, Q[c], G, R, D));
+	}
+
+	_snf Scale = _s_nf_set1(_S_NOISE_SIMPLEX3_SCALE);
+	if (D)
+		for (k = 0; k < 3; ++k)
+			D[k] = _s_nf_mul(D[k], Scale);
+	return(_s_nf_mul(Result, Scale));
+}
+
+SYL_INLINE _snf _s_noise_simplex4(const _snf* P, _sni Seed)
+{
+	const float F4 = 0.309016994375f, G4 = 0.138196601125f;
+	_snf One = _s_nf_set1(1.0f), Zero = _s_nf_set1(0.0f);
+	_snf Cell[4], Q0[4], Rank[4];
+	_sni L[4][2];
+	int a, b, c, k;
+
+	_snf s = _s_nf_mul(_s_nf_add(_s_nf_add(P[0], P[1]), _s_nf_add(P[2], P[3])), _s_nf_set1(F4));
+	for (k = 0; k < 4; ++k)
+		Cell[k] = _s_nf_floor(_s_nf_add(P[k], s));
+	_snf t = _s_nf_mul(_s_nf_add(_s_nf_add(Cell[0], Cell[1]), _s_nf_add(Cell[2], Cell[3])), _s_nf_set1(G4));
+	for (k = 0; k < 4; ++k) {
+		Q0[k] = _s_nf_add(_s_nf_sub(P[k], Cell[k]), t);
+		_s_noise_lattice(_s_nf_to_int(Cell[k]), k, L[k]);
+		Rank[k] = Zero;
+	}
+
+	/* Rank the offsets, the simplex walks the axes from the largest to the smallest */
+	for (a = 0; a < 4; ++a) {
+		for (b = a + 1; b < 4; ++b) {
+			_snm Greater = _s_nf_gt(Q0[a], Q0[b]);
+			Rank[a] = _s_nf_add(Rank[a], _s_nf_mask(Greater, One));
+			Rank[b] = _s_nf_add(Rank[b], _s_nf_select(Greater, Zero, One));
+		}
+	}
+
+	_snf R = _s_nf_set1(0.5f);
+	_snf Result = Zero;
+
+	for (c = 0; c < 5; ++c) {
+		_snf Q[4];
+		_sni h = Seed;
+		for (k = 0; k < 4; ++k) {
+			/* Corner c steps along the c axes with the largest offsets */
+			_snm Step = _s_nf_gt(Rank[k], _s_nf_set1(3.5f - (float)c));
+			Q[k] = _s_nf_add(_s_nf_sub(Q0[k], _s_nf_mask(Step, One)), _s_nf_set1((float)c * G4));
+			h = _s_ni_xor(h, _s_ni_select(Step, L[k][1], L[k][0]));
+		}
+
+		_snf t0 = R;
+		for (k = 0; k < 4; ++k)
+			t0 = _s_nf_sub(t0, _s_nf_mul(Q[k], Q[k]));
+		t0 = _s_nf_mask(_s_nf_gt(t0, Zero), t0);
+		t0 = _s_nf_mul(t0, t0);
+		t0 = _s_nf_mul(t0, t0);
+		Result = _s_nf_madd(t0, _s_noise_grad4_dot(_s_noise_hash(h), Q[0], Q[1], Q[2], Q[3]), Result);
+	}
+	return(_s_nf_mul(Result, _s_nf_set1(_S_NOISE_SIMPLEX4_SCALE)));
+}
+
+typedef enum _snoise_kernel
+{
+	_S_NOISE_PERLIN2,
+	_S_NOISE_PERLIN3,
+	_S_NOISE_PERLIN4,
+	_S_NOISE_SIMPLEX2,
+	_S_NOISE_SIMPLEX3,
+	_S_NOISE_SIMPLEX4
+} _snoise_kernel;
+
+/* Kernel is a constant wherever this is inlined, so the switch folds into a direct call. D is ignored in 4D */
+_SYL_FORCE_INLINE _snf _s_noise_kernel(_snoise_kernel Kernel, const _snf* P, _sni Seed, _snf* D)
+{
+	switch (Kernel) {
+	case _S_NOISE_PERLIN2: return(_s_noise_perlin2(P, Seed, D));
+	case _S_NOISE_PERLIN3: return(_s_noise_perlin3(P, Seed, D));
+	case _S_NOISE_PERLIN4: return(_s_noise_perlin4(P, Seed));
+	case _S_NOISE_SIMPLEX2: return(_s_noise_simplex2(P, Seed, D));
+	case _S_NOISE_SIMPLEX3: return(_s_noise_simplex3(P, Seed, D));
+	default: return(_s_noise_simplex4(P, Seed));
+	}
+}
+
+/* Evaluates one block of points, summing octaves when Fbm is given. R[0] is the value, R[1..] the gradient */
+_SYL_FORCE_INLINE void _s_noise_octaves(_snoise_kernel Kernel, int Dims, bool Deriv, const _snf* P, int Seed, const snoise_fbm* Fbm, _snf* R)
+{
+	_snf Q[4], N[4];
+	int k, o;
+
+	if (!Fbm) {
+		R[0] = _s_noise_kernel(Kernel, P, _s_ni_set1((unsigned int)Seed), Deriv ? R + 1 : NULL);
+		return;
+	}
+
+	float Frequency = Fbm->Frequency;
+	float Amplitude = 1.0f;
+	float Norm = 0.0f;
+
+	for (k = 0; k <= (Deriv ? Dims : 0); ++k)
+		R[k] = _s_nf_set1(0.0f);
+
+	for (o = 0; o < Fbm->Octaves; ++o) {
+		_snf Freq = _s_nf_set1(Frequency);
+		_snf Amp = _s_nf_set1(Amplitude);
+		for (k = 0; k < Dims; ++k)
+			Q[k] = _s_nf_mul(P[k], Freq);
+
+		_snf n = _s_noise_kernel(Kernel, Q, _s_ni_set1((unsigned int)(Seed + o)), Deriv ? N : NULL);
+
+		if (Fbm->Ridged) {
+			/* (1 - |n|)^2, so the creases of the noise turn into sharp ridges */
+			_snf r = _s_nf_sub(_s_nf_set1(1.0f), _s_nf_abs(n));
+			R[0] = _s_nf_madd(_s_nf_mul(r, r), Amp, R[0]);
+			if (Deriv) {
+				_snf Sign = _s_nf_select(_s_nf_gt(n, _s_nf_set1(0.0f)), _s_nf_set1(-2.0f), _s_nf_set1(2.0f));
+				_snf s = _s_nf_mul(_s_nf_mul(Sign, r), _s_nf_mul(Amp, Freq));
+				for (k = 0; k < Dims; ++k)
+					R[k + 1] = _s_nf_madd(s, N[k], R[k + 1]);
+			}
+		} else {
+			R[0] = _s_nf_madd(n, Amp, R[0]);
+			if (Deriv) {
+				_snf s = _s_nf_mul(Amp, Freq);
+				for (k = 0; k < Dims; ++k)
+					R[k + 1] = _s_nf_madd(s, N[k], R[k + 1]);
+			}
+		}
+
+		Norm += Amplitude;
+		Amplitude *= Fbm->Gain;
+		Frequency *= Fbm->Lacunarity;
+	}
+
+	_snf InvNorm = _s_nf_set1(Norm > 0.0f ? 1.0f / Norm : 0.0f);
+	for (k = 0; k <= (Deriv ? Dims : 0); ++k)
+		R[k] = _s_nf_mul(R[k], InvNorm);
+}
+
+/* Runs Kernel over SoA coordinate arrays, the tail goes through a padded block */
+_SYL_FORCE_INLINE void _s_noise_points(_snoise_kernel Kernel, int Dims, const float* const* In, float* const* Out, bool Deriv, int Count, int Seed, const snoise_fbm* Fbm)
+{
+	_snf P[4], R[5];
+	int Outputs = Deriv ? Dims + 1 : 1;
+	int i = 0, k;
+
+	for (; i + _SYL_LANES <= Count; i += _SYL_LANES) {
+		for (k = 0; k < Dims; ++k)
+			P[k] = _s_nf_load(In[k] + i);
+		_s_noise_octaves(Kernel, Dims, Deriv, P, Seed, Fbm, R);
+		for (k = 0; k < Outputs; ++k)
+			_s_nf_store(Out[k] + i, R[k]);
+	}
+
+	if (i < Count) {
+		float Block[5][_SYL_LANES] = { { 0 } };
+		int Rest = Count - i, j;
+
+		for (k = 0; k < Dims; ++k) {
+			for (j = 0; j < Rest; ++j)
+				Block[k][j] = In[k][i + j];
+			P[k] = _s_nf_load(Block[k]);
+		}
+		_s_noise_octaves(Kernel, Dims, Deriv, P, Seed, Fbm, R);
+		for (k = 0; k < Outputs; ++k) {
+			_s_nf_store(Block[k], R[k]);
+			for (j = 0; j < Rest; ++j)
+				Out[k][i + j] = Block[k][j];
+		}
+	}
+}
+
+typedef struct _snoise_grid
+{
+	_snoise_kernel Kernel;
+	int Dims;
+	int Width;
+	int Height;
+	float Origin[3];
+	float Step;
+	int Seed;
+	const snoise_fbm* Fbm;
+	float* Out;
+} _snoise_grid;
+
+/* Fills rows [Begin, End), a row index runs over Height * Depth. x comes from whole lane indices so every ISA samples the same points */
+_SYL_FORCE_INLINE void _s_noise_grid_range(const _snoise_grid* Grid, _snoise_kernel Kernel, int Begin, int End)
+{
+	_snf Origin = _s_nf_set1(Grid->Origin[0]), Step = _s_nf_set1(Grid->Step);
+	_snf P[3], R[1];
+	int Row, x;
+
+	for (Row = Begin; Row < End; ++Row) {
+		float* Out = Grid->Out + (size_t)Row * (size_t)Grid->Width;
+		P[1] = _s_nf_set1(Grid->Origin[1] + (float)(Row % Grid->Height) * Grid->Step);
+		P[2] = _s_nf_set1(Grid->Origin[2] + (float)(Row / Grid->Height) * Grid->Step);
+
+		for (x = 0; x + _SYL_LANES <= Grid->Width; x += _SYL_LANES) {
+			P[0] = _s_nf_add(Origin, _s_nf_mul(_s_nf_ramp((float)x, 1.0f), Step));
+			_s_noise_octaves(Kernel, Grid->Dims, false, P, Grid->Seed, Grid->Fbm, R);
+			_s_nf_store(Out + x, R[0]);
+		}
+
+		if (x < Grid->Width) {
+			float Block[_SYL_LANES];
+			int j;
+			P[0] = _s_nf_add(Origin, _s_nf_mul(_s_nf_ramp((float)x, 1.0f), Step));
+			_s_noise_octaves(Kernel, Grid->Dims, false, P, Grid->Seed, Grid->Fbm, R);
+			_s_nf_store(Block, R[0]);
+			for (j = 0; x + j < Grid->Width; ++j)
+				Out[x + j] = Block[j];
+		}
+	}
+}
+
+SYL_INLINE void _s_noise_grid_rows(int Begin, int End, int WorkerIndex, void* UserData)
+{
+	const _snoise_grid* Grid = (const _snoise_grid*)UserData;
+	(void)WorkerIndex;
+
+	switch (Grid->Kernel) {
+	case _S_NOISE_PERLIN2: _s_noise_grid_range(Grid, _S_NOISE_PERLIN2, Begin, End); break;
+	case _S_NOISE_PERLIN3: _s_noise_grid_range(Grid, _S_NOISE_PERLIN3, Begin, End); break;
+	case _S_NOISE_SIMPLEX2: _s_noise_grid_range(Grid, _S_NOISE_SIMPLEX2, Begin, End); break;
+	default: _s_noise_grid_range(Grid, _S_NOISE_SIMPLEX3, Begin, End); break;
+	}
+}
+
+SYL_INLINE void _s_noise_grid(_snoise_kernel Kernel, int Dims, float* Out, int Width, int Height, int Depth, const float* Origin, float Step, int Seed, const snoise_fbm* Fbm)
+{
+	_snoise_grid Grid;
+	int k;
+
+	if (Width <= 0 || Height <= 0 || Depth <= 0)
+		return;
+
+	Grid.Kernel = Kernel;
+	Grid.Dims = Dims;
+	Grid.Width = Width;
+	Grid.Height = Height;
+	for (k = 0; k < 3; ++k)
+		Grid.Origin[k] = k < Dims ? Origin[k] : 0.0f;
+	Grid.Step = Step;
+	Grid.Seed = Seed;
+	Grid.Fbm = Fbm;
+	Grid.Out = Out;
+
+#if defined(SYL_THREADS)
+	s_parallel_for(Height * Depth, 16, _s_noise_grid_rows, &Grid);
+#else
+	_s_noise_grid_rows(0, Height * Depth, 0, &Grid);
+#endif
+}
+
+/* Single point evaluation, lane 0 of a broadcast block */
+_SYL_FORCE_INLINE float _s_noise_point(_snoise_kernel Kernel, const float* P, int Dims, int Seed)
+{
+	_snf Q[4];
+	float Block[_SYL_LANES];
+	int k;
+
+	for (k = 0; k < Dims; ++k)
+		Q[k] = _s_nf_set1(P[k]);
+	_s_nf_store(Block, _s_noise_kernel(Kernel, Q, _s_ni_set1((unsigned int)Seed), NULL));
+	return(Block[0]);
+}
+
+SYL_INLINE float s_noise_perlin2(svec2 P, int Seed)
+{
+	_SYL_PROFILE(s_noise_perlin2);
+	return(_s_noise_point(_S_NOISE_PERLIN2, P.e, 2, Seed));
+}
+
+SYL_INLINE float s_noise_perlin3(svec3 P, int Seed)
+{
+	_SYL_PROFILE(s_noise_perlin3);
+	return(_s_noise_point(_S_NOISE_PERLIN3, P.e, 3, Seed));
+}
+
+SYL_INLINE float s_noise_perlin4(svec4 P, int Seed)
+{
+	_SYL_PROFILE(s_noise_perlin4);
+	return(_s_noise_point(_S_NOISE_PERLIN4, P.e, 4, Seed));
+}
+
+SYL_INLINE float s_noise_simplex2(svec2 P, int Seed)
+{
+	_SYL_PROFILE(s_noise_simplex2);
+	return(_s_noise_point(_S_NOISE_SIMPLEX2, P.e, 2, Seed));
+}
+
+SYL_INLINE float s_noise_simplex3(svec3 P, int Seed)
+{
+	_SYL_PROFILE(s_noise_simplex3);
+	return(_s_noise_point(_S_NOISE_SIMPLEX3, P.e, 3, Seed));
+}
+
+SYL_INLINE float s_noise_simplex4(svec4 P, int Seed)
+{
+	_SYL_PROFILE(s_noise_simplex4);
+	return(_s_noise_point(_S_NOISE_SIMPLEX4, P.e, 4, Seed));
+}
+
+SYL_INLINE void s_noise_perlin2_array(const float* X, const float* Y, float* Out, int Count, int Seed, const snoise_fbm* Fbm)
+{
+	_SYL_PROFILE(s_noise_perlin2_array);
+	const float* In[2] = { X, Y };
+	_s_noise_points(_S_NOISE_PERLIN2, 2, In, &Out, false, Count, Seed, Fbm);
+}
+
+SYL_INLINE void s_noise_perlin3_array(const float* X, const float* Y, const float* Z, float* Out, int Count, int Seed, const snoise_fbm* Fbm)
+{
+	_SYL_PROFILE(s_noise_perlin3_array);
+	const float* In[3] = { X, Y, Z };
+	_s_noise_points(_S_NOISE_PERLIN3, 3, In, &Out, false, Count, Seed, Fbm);
+}
+
+SYL_INLINE void s_noise_perlin4_array(const float* X, const float* Y, const float* Z, const float* W, float* Out, int Count, int Seed, const snoise_fbm* Fbm)
+{
+	_SYL_PROFILE(s_noise_perlin4_array);
+	const float* In[4] = { X, Y, Z, W };
+	_s_noise_points(_S_NOISE_PERLIN4, 4, In, &Out, false, Count, Seed, Fbm);
+}
+
+SYL_INLINE void s_noise_simplex2_array(const float* X, const float* Y, float* Out, int Count, int Seed, const snoise_fbm* Fbm)
+{
+	_SYL_PROFILE(s_noise_simplex2_array);
+	const float* In[2] = { X, Y };
+	_s_noise_points(_S_NOISE_SIMPLEX2, 2, In, &Out, false, Count, Seed, Fbm);
+}
+
+SYL_INLINE void s_noise_simplex3_array(const float* X, const float* Y, const float* Z, float* Out, int Count, int Seed, const snoise_fbm* Fbm)
+{
+	_SYL_PROFILE(s_noise_simplex3_array);
+	const float* In[3] = { X, Y, Z };
+	_s_noise_points(_S_NOISE_SIMPLEX3, 3, In, &Out, false, Count, Seed, Fbm);
+}
+
+SYL_INLINE void s_noise_simplex4_array(const float* X, const float* Y, const float* Z, const float* W, float* Out, int Count, int Seed, const snoise_fbm* Fbm)
+{
+	_SYL_PROFILE(s_noise_simplex4_array);
+	const float* In[4] = { X, Y, Z, W };
+	_s_noise_points(_S_NOISE_SIMPLEX4, 4, In, &Out, false, Count, Seed, Fbm);
+}
+
+SYL_INLINE void s_noise_perlin2_deriv_array(const float* X, const float* Y, float* Out, float* OutDX, float* OutDY, int Count, int Seed, const snoise_fbm* Fbm)
+{
+	_SYL_PROFILE(s_noise_perlin2_deriv_array);
+	const float* In[2] = { X, Y };
+	float* Dst[3] = { Out, OutDX, OutDY };
+	_s_noise_points(_S_NOISE_PERLIN2, 2, In, Dst, true, Count, Seed, Fbm);
+}
+
+SYL_INLINE void s_noise_perlin3_deriv_array(const float* X, const float* Y, const float* Z, float* Out, float* OutDX, float* OutDY, float* OutDZ, int Count, int Seed, const snoise_fbm* Fbm)
+{
+	_SYL_PROFILE(s_noise_perlin3_deriv_array);
+	const float* In[3] = { X, Y, Z };
+	float* Dst[4] = { Out, OutDX, OutDY, OutDZ };
+	_s_noise_points(_S_NOISE_PERLIN3, 3, In, Dst, true, Count, Seed, Fbm);
+}
+
+SYL_INLINE void s_noise_simplex2_deriv_array(const float* X, const float* Y, float* Out, float* OutDX, float* OutDY, int Count, int Seed, const snoise_fbm* Fbm)
+{
+	_SYL_PROFILE(s_noise_simplex2_deriv_array);
+	const float* In[2] = { X, Y };
+	float* Dst[3] = { Out, OutDX, OutDY };
+	_s_noise_points(_S_NOISE_SIMPLEX2, 2, In, Dst, true, Count, Seed, Fbm);
+}
+
+SYL_INLINE void s_noise_simplex3_deriv_array(const float* X, const float* Y, const float* Z, float* Out, float* OutDX, float* OutDY, float* OutDZ, int Count, int Seed, const snoise_fbm* Fbm)
+{
+	_SYL_PROFILE(s_noise_simplex3_deriv_array);
+	const float* In[3] = { X, Y, Z };
+	float* Dst[4] = { Out, OutDX, OutDY, OutDZ };
+	_s_noise_points(_S_NOISE_SIMPLEX3, 3, In, Dst, true, Count, Seed, Fbm);
+}
+
+SYL_INLINE void s_noise_perlin2_grid(float* Out, int Width, int Height, svec2 Origin, float Step, int Seed, const snoise_fbm* Fbm)
+{
+	_SYL_PROFILE(s_noise_perlin2_grid);
+	_s_noise_grid(_S_NOISE_PERLIN2, 2, Out, Width, Height, 1, Origin.e, Step, Seed, Fbm);
+}
+
+SYL_INLINE void s_noise_perlin3_grid(float* Out, int Width, int Height, int Depth, svec3 Origin, float Step, int Seed, const snoise_fbm* Fbm)
+{
+	_SYL_PROFILE(s_noise_perlin3_grid);
+	_s_noise_grid(_S_NOISE_PERLIN3, 3, Out, Width, Height, Depth, Origin.e, Step, Seed, Fbm);
+}
+
+SYL_INLINE void s_noise_simplex2_grid(float* Out, int Width, int Height, svec2 Origin, float Step, int Seed, const snoise_fbm* Fbm)
+{
+	_SYL_PROFILE(s_noise_simplex2_grid);
+	_s_noise_grid(_S_NOISE_SIMPLEX2, 2, Out, Width, Height, 1, Origin.e, Step, Seed, Fbm);
+}
+
+SYL_INLINE void s_noise_simplex3_grid(float* Out, int Width, int Height, int Depth, svec3 Origin, float Step, int Seed, const snoise_fbm* Fbm)
+{
+	_SYL_PROFILE(s_noise_simplex3_grid);
+	_s_noise_grid(_S_NOISE_SIMPLEX3, 3, Out, Width, Height, Depth, Origin.e, Step, Seed, Fbm);
+}
+
+/*********************************************
+ *                   RANDOM                   *
+ *********************************************/
+
+/*
+ * xoshiro128+ with one stream per lane of srand_state. Lane k starts 2^64
+ * steps after lane k - 1 and s_rand_jump moves every lane 2^96 steps ahead,
+ * which gives non overlapping streams for threads. Samplers always consume
+ * whole groups of 8 lanes, so a seed produces the same sequence with and
+ * without SIMD.
+ */
+
+static const unsigned int _S_RAND_JUMP[4] = { 0x8764000bu, 0xf542d2d3u, 0x6fa035c3u, 0x77f2db5bu };
+static const unsigned int _S_RAND_LONG_JUMP[4] = { 0xb523952eu, 0x0b6f099fu, 0xccf5a0efu, 0x1c580662u };
+
+/* Scalar step of a single lane, only used for jumping */
+SYL_INLINE void _s_rand_step(unsigned int* s)
+{
+	unsigned int t = s[1] << 9;
+
+	s[2] ^= s[0];
+	s[3] ^= s[1];
+	s[1] ^= s[2];
+	s[0] ^= s[3];
+	s[2] ^= t;
+	s[3] = (s[3] << 11) | (s[3] >> 21);
+}
+
+SYL_INLINE void _s_rand_jump_lane(srand_state* State, int Lane, const unsigned int* Poly)
+{
+	unsigned int s[4], r[4] = { 0, 0, 0, 0 };
+	int i, b, k;
+
+	for (k = 0; k < 4; ++k)
+		s[k] = State->S[k][Lane];
+
+	for (i = 0; i < 4; ++i) {
+		for (b = 0; b < 32; ++b) {
+			if (Poly[i] & (1u << b))
+				for (k = 0; k < 4; ++k)
+					r[k] ^= s[k];
+			_s_rand_step(s);
+		}
+	}
+
+	for (k = 0; k < 4; ++k)
+		State->S[k][Lane] = r[k];
+}
+
+SYL_INLINE void s_rand_init(srand_state* State, unsigned long long Seed)
+{
+	_SYL_PROFILE(s_rand_init);
+	int k, Lane;
+
+	/* splitmix64 fills the first lane, the others are jumped from it */
+	for (k = 0; k < 4; k += 2) {
+		unsigned long long z = (Seed += 0x9e3779b97f4a7c15ull);
+		z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+		z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+		z ^= z >> 31;
+		State->S[k][0] = (unsigned int)z;
+		State->S[k + 1][0] = (unsigned int)(z >> 32);
+	}
+	if (!(State->S[0][0] | State->S[1][0] | State->S[2][0] | State->S[3][0]))
+		State->S[0][0] = 1;
+
+	for (Lane = 1; Lane < _SYL_RAND_LANES; ++Lane) {
+		for (k = 0; k < 4; ++k)
+			State->S[k][Lane] = State->S[k][Lane - 1];
+		_s_rand_jump_lane(State, Lane, _S_RAND_JUMP);
+	}
+}
+
+SYL_INLINE void s_rand_jump(srand_state* State)
+{
+	_SYL_PROFILE(s_rand_jump);
+	int Lane;
+	for (Lane = 0; Lane < _SYL_RAND_LANES; ++Lane)
+		_s_rand_jump_lane(State, Lane, _S_RAND_LONG_JUMP);
+}
+
+/* Steps the lanes [Lane, Lane + _SYL_LANES) */
+_SYL_FORCE_INLINE _sni _s_rand_next(srand_state* State, int Lane)
+{
+	_sni s0 = _s_ni_load(State->S[0] + Lane);
+	_sni s1 = _s_ni_load(State->S[1] + Lane);
+	_sni s2 = _s_ni_load(State->S[2] + Lane);
+	_sni s3 = _s_ni_load(State->S[3] + Lane);
+	_sni Result = _s_ni_add(s0, s3);
+	_sni t = _s_ni_sll(s1, 9);
+
+	s2 = _s_ni_xor(s2, s0);
+	s3 = _s_ni_xor(s3, s1);
+	s1 = _s_ni_xor(s1, s2);
+	s0 = _s_ni_xor(s0, s3);
+	s2 = _s_ni_xor(s2, t);
+	s3 = _s_ni_or(_s_ni_sll(s3, 11), _s_ni_srl(s3, 21));
+
+	_s_ni_store(State->S[0] + Lane, s0);
+	_s_ni_store(State->S[1] + Lane, s1);
+	_s_ni_store(State->S[2] + Lane, s2);
+	_s_ni_store(State->S[3] + Lane, s3);
+	return(Result);
+}
+
+/* Uniform float in [0, 1) from the top 24 bits, the low bits of xoshiro128+ are weak */
+_SYL_FORCE_INLINE _snf _s_rand_uniform(srand_state* State, int Lane)
+{
+	return(_s_nf_mul(_s_ni_to_float(_s_ni_srl(_s_rand_next(State, Lane), 8)), _s_nf_set1(1.0f / 16777216.0f)));
+}
+
+/* Sine and cosine of 2 * pi * t for t in [0, 1), polynomials on a quarter turn */
+_SYL_FORCE_INLINE void _s_rand_sincos(_snf t, _snf* Sin, _snf* Cos)
+{
+	_snf q4 = _s_nf_mul(t, _s_nf_set1(4.0f));
+	_snf q = _s_nf_floor(q4);
+	_snf x = _s_nf_mul(_s_nf_sub(q4, q), _s_nf_set1(1.57079632679f));
+	_snf x2 = _s_nf_mul(x, x);
+	_snf Zero = _s_nf_set1(0.0f);
+
+	_snf s = _s_nf_madd(x2, _s_nf_set1(-1.0f / 39916800.0f), _s_nf_set1(1.0f / 362880.0f));
+	s = _s_nf_madd(x2, s, _s_nf_set1(-1.0f / 5040.0f));
+	s = _s_nf_madd(x2, s, _s_nf_set1(1.0f / 120.0f));
+	s = _s_nf_madd(x2, s, _s_nf_set1(-1.0f / 6.0f));
+	s = _s_nf_mul(x, _s_nf_madd(x2, s, _s_nf_set1(1.0f)));
+
+	_snf c = _s_nf_madd(x2, _s_nf_set1(1.0f / 479001600.0f), _s_nf_set1(-1.0f / 3628800.0f));
+	c = _s_nf_madd(x2, c, _s_nf_set1(1.0f / 40320.0f));
+	c = _s_nf_madd(x2, c, _s_nf_set1(-1.0f / 720.0f));
+	c = _s_nf_madd(x2, c, _s_nf_set1(1.0f / 24.0f));
+	c = _s_nf_madd(x2, c, _s_nf_set1(-0.5f));
+	c = _s_nf_madd(x2, c, _s_nf_set1(1.0f));
+
+	/* Rotate the quarter turn result into its quadrant */
+	_sni Quadrant = _s_nf_to_int(q);
+	_snm Swap = _s_ni_bit(Quadrant, 1);
+	_snm NegSin = _s_ni_bit(Quadrant, 2);
+	_snm NegCos = _s_nm_or(_s_ni_eq(Quadrant, 1), _s_ni_eq(Quadrant, 2));
+	_snf rs = _s_nf_select(Swap, c, s);
+	_snf rc = _s_nf_select(Swap, s, c);
+
+	*Sin = _s_nf_select(NegSin, _s_nf_sub(Zero, rs), rs);
+	*Cos = _s_nf_select(NegCos, _s_nf_sub(Zero, rc), rc);
+}
+
+/* Stores lanes starting at Index, the ones at or past Count are dropped */
+_SYL_FORCE_INLINE void _s_rand_store(float* Dst, int Index, int Count, _snf Value)
+{
+	float Block[_SYL_LANES];
+	int j;
+
+	if (Index + _SYL_LANES <= Count) {
+		_s_nf_store(Dst + Index, Value);
+		return;
+	}
+	_s_nf_store(Block, Value);
+	for (j = 0; Index + j < Count; ++j)
+		Dst[Index + j] = Block[j];
+}
+
+SYL_INLINE void s_rand_uint(srand_state* State, unsigned int* Out, int Count)
+{
+	_SYL_PROFILE(s_rand_uint);
+	unsigned int Block[_SYL_LANES];
+	int i, Lane, j;
+
+	for (i = 0; i < Count; i += _SYL_RAND_LANES) {
+		for (Lane = 0; Lane < _SYL_RAND_LANES; Lane += _SYL_LANES) {
+			_sni r = _s_rand_next(State, Lane);
+			if (i + Lane + _SYL_LANES <= Count) {
+				_s_ni_store(Out + i + Lane, r);
+			} else {
+				_s_ni_store(Block, r);
+				for (j = 0; i + Lane + j < Count; ++j)
+					Out[i + Lane + j] = Block[j];
+			}
+		}
+	}
+}
+
+SYL_INLINE void s_rand_float(srand_state* State, float* Out, int Count)
+{
+	_SYL_PROFILE(s_rand_float);
+	int i, Lane;
+
+	for (i = 0; i < Count; i += _SYL_RAND_LANES)
+		for (Lane = 0; Lane < _SYL_RAND_LANES; Lane += _SYL_LANES)
+			_s_rand_store(Out, i + Lane, Count, _s_rand_uniform(State, Lane));
+}
+
+/* Uniform inside the unit disk, sqrt keeps the density uniform over the area */
+SYL_INLINE void s_rand_unit_disk(srand_state* State, float* X, float* Y, int Count)
+{
+	_SYL_PROFILE(s_rand_unit_disk);
+	_snf s, c, r;
+	int i, Lane;
+
+	for (i = 0; i < Count; i += _SYL_RAND_LANES) {
+		for (Lane = 0; Lane < _SYL_RAND_LANES; Lane += _SYL_LANES) {
+			r = _s_nf_sqrt_exact(_s_rand_uniform(State, Lane));
+			_s_rand_sincos(_s_rand_uniform(State, Lane), &s, &c);
+			_s_rand_store(X, i + Lane, Count, _s_nf_mul(r, c));
+			_s_rand_store(Y, i + Lane, Count, _s_nf_mul(r, s));
+		}
+	}
+}
+
+/* Uniform on the unit sphere, z is uniform in [-1, 1] by Archimedes' hat box theorem */
+SYL_INLINE void s_rand_unit_sphere(srand_state* State, float* X, float* Y, float* Z, int Count)
+{
+	_SYL_PROFILE(s_rand_unit_sphere);
+	_snf s, c, r, z;
+	int i, Lane;
+
+	for (i = 0; i < Count; i += _SYL_RAND_LANES) {
+		for (Lane = 0; Lane < _SYL_RAND_LANES; Lane += _SYL_LANES) {
+			z = _s_nf_sub(_s_nf_set1(1.0f), _s_nf_mul(_s_nf_set1(2.0f), _s_rand_uniform(State, Lane)));
+			r = _s_nf_sqrt_exact(_s_nf_sub(_s_nf_set1(1.0f), _s_nf_mul(z, z)));
+			_s_rand_sincos(_s_rand_uniform(State, Lane), &s, &c);
+			_s_rand_store(X, i + Lane, Count, _s_nf_mul(r, c));
+			_s_rand_store(Y, i + Lane, Count, _s_nf_mul(r, s));
+			_s_rand_store(Z, i + Lane, Count, z);
+		}
+	}
+}
+
+/* Uniform on the unit hemisphere around +Z */
+SYL_INLINE void s_rand_hemisphere(srand_state* State, float* X, float* Y, float* Z, int Count)
+{
+	_SYL_PROFILE(s_rand_hemisphere);
+	_snf s, c, r, z;
+	int i, Lane;
+
+	for (i = 0; i < Count; i += _SYL_RAND_LANES) {
+		for (Lane = 0; Lane < _SYL_RAND_LANES; Lane += _SYL_LANES) {
+			z = _s_nf_sub(_s_nf_set1(1.0f), _s_rand_uniform(State, Lane));
+			r = _s_nf_sqrt_exact(_s_nf_sub(_s_nf_set1(1.0f), _s_nf_mul(z, z)));
+			_s_rand_sincos(_s_rand_uniform(State, Lane), &s, &c);
+			_s_rand_store(X, i + Lane, Count, _s_nf_mul(r, c));
+			_s_rand_store(Y, i + Lane, Count, _s_nf_mul(r, s));
+			_s_rand_store(Z, i + Lane, Count, z);
+		}
+	}
+}
+
+/* Cosine weighted around +Z, a disk sample lifted onto the hemisphere */
+SYL_INLINE void s_rand_cosine_hemisphere(srand_state* State, float* X, float* Y, float* Z, int Count)
+{
+	_SYL_PROFILE(s_rand_cosine_hemisphere);
+	_snf s, c, u;
+	int i, Lane;
+
+	for (i = 0; i < Count; i += _SYL_RAND_LANES) {
+		for (Lane = 0; Lane < _SYL_RAND_LANES; Lane += _SYL_LANES) {
+			u = _s_rand_uniform(State, Lane);
+			_snf r = _s_nf_sqrt_exact(u);
+			_s_rand_sincos(_s_rand_uniform(State, Lane), &s, &c);
+			_s_rand_store(X, i + Lane, Count, _s_nf_mul(r, c));
+			_s_rand_store(Y, i + Lane, Count, _s_nf_mul(r, s));
+			_s_rand_store(Z, i + Lane, Count, _s_nf_sqrt_exact(_s_nf_sub(_s_nf_set1(1.0f), u)));
+		}
+	}
+}
+
+/* Uniformly distributed rotations with Shoemake's method */
+SYL_INLINE void s_rand_rotation(srand_state* State, squat* Out, int Count)
+{
+	_SYL_PROFILE(s_rand_rotation);
+	float Block[4][_SYL_LANES];
+	_snf s, c, u, r1, r2;
+	int i, Lane, j;
+
+	for (i = 0; i < Count; i += _SYL_RAND_LANES) {
+		for (Lane = 0; Lane < _SYL_RAND_LANES; Lane += _SYL_LANES) {
+			u = _s_rand_uniform(State, Lane);
+			r1 = _s_nf_sqrt_exact(_s_nf_sub(_s_nf_set1(1.0f), u));
+			r2 = _s_nf_sqrt_exact(u);
+			_s_rand_sincos(_s_rand_uniform(State, Lane), &s, &c);
+			_s_nf_store(Block[0], _s_nf_mul(r1, s));
+			_s_nf_store(Block[1], _s_nf_mul(r1, c));
+			_s_rand_sincos(_s_rand_uniform(State, Lane), &s, &c);
+			_s_nf_store(Block[2], _s_nf_mul(r2, s));
+			_s_nf_store(Block[3], _s_nf_mul(r2, c));
+
+			for (j = 0; j < _SYL_LANES && i + Lane + j < Count; ++j) {
+				squat* q = Out + i + Lane + j;
+				q->x = Block[0][j];
+				q->y = Block[1][j];
+				q->z = Block[2][j];
+				q->w = Block[3][j];
+			}
+		}
+	}
+}
+
+/*********************************************
+ *                   SPLINE                   *
+ *********************************************/
+
+/*
+ * Every spline type is a cubic basis over 4 control points. Row k holds the
+ * power basis coefficients of the weight of point k, so the weight is
+ * c0 + c1 * s + c2 * s^2 + c3 * s^3 and the tangent weight is its derivative.
+ */
+static const float _S_SPLINE_BASIS[4][4][4] =
+{
+	/* Catmull-Rom */
+	{ { 0.0f, -0.5f, 1.0f, -0.5f }, { 1.0f, 0.0f, -2.5f, 1.5f }, { 0.0f, 0.5f, 2.0f, -1.5f }, { 0.0f, 0.0f, -0.5f, 0.5f } },
+	/* Bezier */
+	{ { 1.0f, -3.0f, 3.0f, -1.0f }, { 0.0f, 3.0f, -6.0f, 3.0f }, { 0.0f, 0.0f, 3.0f, -3.0f }, { 0.0f, 0.0f, 0.0f, 1.0f } },
+	/* Hermite, points are ordered P0, T0, P1, T1 */
+	{ { 1.0f, 0.0f, -3.0f, 2.0f }, { 0.0f, 1.0f, -2.0f, 1.0f }, { 0.0f, 0.0f, 3.0f, -2.0f }, { 0.0f, 0.0f, -1.0f, 1.0f } },
+	/* Uniform B-spline */
+	{ { 1.0f / 6.0f, -0.5f, 0.5f, -1.0f / 6.0f }, { 4.0f / 6.0f, 0.0f, -1.0f, 0.5f }, { 1.0f / 6.0f, 0.5f, 0.5f, -0.5f }, { 0.0f, 0.0f, 0.0f, 1.0f / 6.0f } },
+};
+
+#define _SYL_SPLINE_BATCH 64
+/* Chord samples per arc length table entry */
+#define _SYL_SPLINE_SUBSTEPS 8
+
+/* Index step between the first control points of two segments */
+static const int _S_SPLINE_STRIDE[4] = { 1, 3, 2, 1 };
+
+SYL_INLINE sspline _s_spline(const float* Points, int Count, int Dims, sspline_type Type)
+{
+	sspline Result;
+	Result.Points = Points;
+	Result.Count = Count;
+	Result.Dims = Dims;
+	Result.Type = Type;
+	return(Result);
+}
+
+SYL_INLINE sspline s_spline_vec2(const svec2* Points, int Count, sspline_type Type)
+{
+	_SYL_PROFILE(s_spline_vec2);
+	return(_s_spline(Points->e, Count, 2, Type));
+}
+
+SYL_INLINE sspline s_spline_vec3(const svec3* Points, int Count, sspline_type Type)
+{
+	_SYL_PROFILE(s_spline_vec3);
+	return(_s_spline(Points->e, Count, 3, Type));
+}
+
+SYL_INLINE sspline s_spline_vec4(const svec4* Points, int Count, sspline_type Type)
+{
+	_SYL_PROFILE(s_spline_vec4);
+	return(_s_spline(Points->e, Count, 4, Type));
+}
+
+SYL_INLINE int s_spline_segments(const sspline* Spline)
+{
+	_SYL_PROFILE(s_spline_segments);
+	int Segments = 0;
+
+	switch (Spline->Type) {
+	case S_SPLINE_CATMULL_ROM:
+	case S_SPLINE_BSPLINE:
+		Segments = Spline->Count - 3;
+		break;
+	case S_SPLINE_BEZIER:
+		Segments = (Spline->Count - 1) / 3;
+		break;
+	case S_SPLINE_HERMITE:
+		Segments = (Spline->Count - 2) / 2;
+		break;
+	}
+	return(Segments > 0 ? Segments : 0);
+}
+
+/*
+ * Samples are evaluated _SYL_LANES at a time. When the whole block lies on
+ * one segment, the usual case for sorted parameters, the control points are
+ * broadcast and combined in lanes. Gathering them for mixed segments costs
+ * more than it saves, those blocks combine one sample at a time.
+ */
+SYL_INLINE void s_spline_eval(const sspline* Spline, const float* T, int Count, float* OutPos, float* OutTangent)
+{
+	_SYL_PROFILE(s_spline_eval);
+	const float (*Basis)[4] = _S_SPLINE_BASIS[Spline->Type];
+	int Segments = s_spline_segments(Spline);
+	int Stride = _S_SPLINE_STRIDE[Spline->Type];
+	int Dims = Spline->Dims;
+	float* PosOut[4] = { NULL, NULL, NULL, NULL };
+	float* TanOut[4] = { NULL, NULL, NULL, NULL };
+	float Seg[_SYL_LANES], Block[_SYL_LANES], Weights[4][_SYL_LANES], DWeights[4][_SYL_LANES];
+	_snf W[4], DW[4], Pos[4], Tan[4];
+	int i, j, k, d;
+
+	if (!Segments)
+		return;
+	for (d = 0; d < Dims; ++d) {
+		PosOut[d] = OutPos + d;
+		if (OutTangent)
+			TanOut[d] = OutTangent + d;
+	}
+
+	for (i = 0; i < Count; i += _SYL_LANES) {
+		int Rest = Count - i < _SYL_LANES ? Count - i : _SYL_LANES;
+
+		for (j = 0; j < _SYL_LANES; ++j)
+			Block[j] = j < Rest ? T[i + j] : 0.0f;
+
+		/* Segment and local parameter, t = 1 stays on the end of the last segment */
+		_snf u = _s_nf_mul(_s_nf_min(_s_nf_max(_s_nf_load(Block), _s_nf_set1(0.0f)), _s_nf_set1(1.0f)), _s_nf_set1((float)Segments));
+		_snf Index = _s_nf_min(_s_nf_floor(u), _s_nf_set1((float)(Segments - 1)));
+		_snf s = _s_nf_sub(u, Index);
+		_snf s2 = _s_nf_mul(s, s);
+		_s_nf_store(Seg, Index);
+
+		for (k = 0; k < 4; ++k) {
+			_snf w = _s_nf_madd(s, _s_nf_set1(Basis[k][3]), _s_nf_set1(Basis[k][2]));
+			w = _s_nf_madd(s, w, _s_nf_set1(Basis[k][1]));
+			W[k] = _s_nf_madd(s, w, _s_nf_set1(Basis[k][0]));
+
+			/* dP/dt = dP/ds * Segments */
+			_snf dw = _s_nf_madd(s2, _s_nf_set1(3.0f * Basis[k][3]), _s_nf_madd(s, _s_nf_set1(2.0f * Basis[k][2]), _s_nf_set1(Basis[k][1])));
+			DW[k] = _s_nf_mul(dw, _s_nf_set1((float)Segments));
+		}
+
+		/* Lanes past Rest don't count, the scalar build has nothing to broadcast into */
+		_snf First = _s_nf_set1(Seg[0]);
+		int Mixed = (_s_nm_bits(_s_nf_gt(Index, First)) | _s_nm_bits(_s_nf_gt(First, Index))) & ((1 << Rest) - 1);
+
+		if (_SYL_LANES > 1 && !Mixed) {
+			const float* P = Spline->Points + (size_t)((int)Seg[0] * Stride) * (size_t)Dims;
+			for (d = 0; d < Dims; ++d) {
+				_snf C0 = _s_nf_set1(P[d]), C1 = _s_nf_set1(P[Dims + d]), C2 = _s_nf_set1(P[2 * Dims + d]), C3 = _s_nf_set1(P[3 * Dims + d]);
+				Pos[d] = _s_nf_madd(W[3], C3, _s_nf_madd(W[2], C2, _s_nf_madd(W[1], C1, _s_nf_mul(W[0], C0))));
+				if (OutTangent)
+					Tan[d] = _s_nf_madd(DW[3], C3, _s_nf_madd(DW[2], C2, _s_nf_madd(DW[1], C1, _s_nf_mul(DW[0], C0))));
+			}
+			_s_vec_store(PosOut, Dims, Dims, i, Rest, Pos);
+			if (OutTangent)
+				_s_vec_store(TanOut, Dims, Dims, i, Rest, Tan);
+			continue;
+		}
+
+		for (k = 0; k < 4; ++k) {
+			_s_nf_store(Weights[k], W[k]);
+			_s_nf_store(DWeights[k], DW[k]);
+		}
+		for (j = 0; j < Rest; ++j) {
+			const float* P = Spline->Points + (size_t)((int)Seg[j] * Stride) * (size_t)Dims;
+			float* Out = OutPos + (size_t)(i + j) * (size_t)Dims;
+			for (d = 0; d < Dims; ++d)
+				Out[d] = Weights[0][j] * P[d] + Weights[1][j] * P[Dims + d] + Weights[2][j] * P[2 * Dims + d] + Weights[3][j] * P[3 * Dims + d];
+			if (OutTangent) {
+				Out = OutTangent + (size_t)(i + j) * (size_t)Dims;
+				for (d = 0; d < Dims; ++d)
+					Out[d] = DWeights[0][j] * P[d] + DWeights[1][j] * P[Dims + d] + DWeights[2][j] * P[2 * Dims + d] + DWeights[3][j] * P[3 * Dims + d];
+			}
+		}
+	}
+}
+
+SYL_INLINE float s_spline_build_arclength(const sspline* Spline, float* Table, int TableCount)
+{
+	_SYL_PROFILE(s_spline_build_arclength);
+	float T[_SYL_SPLINE_BATCH], Pos[_SYL_SPLINE_BATCH * 4], Prev[4];
+	int Samples = (TableCount - 1) * _SYL_SPLINE_SUBSTEPS + 1;
+	float Length = 0.0f;
+	int i, j, d, Dims = Spline->Dims;
+
+	if (TableCount < 2 || !s_spline_segments(Spline))
+		return(0.0f);
+
+	for (i = 0; i < Samples; i += _SYL_SPLINE_BATCH) {
+		int Rest = Samples - i < _SYL_SPLINE_BATCH ? Samples - i : _SYL_SPLINE_BATCH;
+		for (j = 0; j < Rest; ++j)
+			T[j] = (float)(i + j) / (float)(Samples - 1);
+		s_spline_eval(Spline, T, Rest, Pos, NULL);
+
+		for (j = 0; j < Rest; ++j) {
+			const float* P = Pos + j * Dims;
+			if (i + j) {
+				float Sq = 0.0f;
+				for (d = 0; d < Dims; ++d)
+					Sq += (P[d] - Prev[d]) * (P[d] - Prev[d]);
+				Length += sqrtf(Sq);
+			}
+			if ((i + j) % _SYL_SPLINE_SUBSTEPS == 0)
+				Table[(i + j) / _SYL_SPLINE_SUBSTEPS] = Length;
+			for (d = 0; d < Dims; ++d)
+				Prev[d] = P[d];
+		}
+	}
+	return(Length);
+}
+
+SYL_INLINE void s_spline_distance_to_t(const float* Table, int TableCount, const float* Distance, float* OutT, int Count)
+{
+	_SYL_PROFILE(s_spline_distance_to_t);
+	float Step;
+	int i;
+
+	/* A single entry has no length to walk, everything maps to the start */
+	if (TableCount < 2) {
+		for (i = 0; i < Count; ++i)
+			OutT[i] = 0.0f;
+		return;
+	}
+	Step = 1.0f / (float)(TableCount - 1);
+
+	for (i = 0; i < Count; ++i) {
+		float Dist = Distance[i];
+		int Lo = 0, Hi = TableCount - 1;
+
+		if (Dist <= Table[0]) {
+			OutT[i] = 0.0f;
+			continue;
+		}
+		if (Dist >= Table[Hi]) {
+			OutT[i] = 1.0f;
+			continue;
+		}
+		while (Hi - Lo > 1) {
+			int Mid = (Lo + Hi) / 2;
+			if (Table[Mid] <= Dist)
+				Lo = Mid;
+			else
+				Hi = Mid;
+		}
+		float Span = Table[Hi] - Table[Lo];
+		OutT[i] = ((float)Lo + (Span > 0.0f ? (Dist - Table[Lo]) / Span : 0.0f)) * Step;
+	}
+}
+
+SYL_INLINE void s_spline_sample_constant_speed(const sspline* Spline, const float* Table, int TableCount, int Count, float* OutPos, float* OutTangent)
+{
+	_SYL_PROFILE(s_spline_sample_constant_speed);
+	float T[_SYL_SPLINE_BATCH], Total, Step;
+	int i, j, Entry = 0;
+
+	if (Count < 1 || TableCount < 2)
+		return;
+	Total = Table[TableCount - 1];
+	Step = 1.0f / (float)(TableCount - 1);
+
+	for (i = 0; i < Count; i += _SYL_SPLINE_BATCH) {
+		int Rest = Count - i < _SYL_SPLINE_BATCH ? Count - i : _SYL_SPLINE_BATCH;
+
+		/* Distances only grow, so the table is walked once instead of searched per sample */
+		for (j = 0; j < Rest; ++j) {
+			float Dist = Count > 1 ? Total * (float)(i + j) / (float)(Count - 1) : 0.0f;
+			while (Entry < TableCount - 2 && Table[Entry + 1] < Dist)
+				++Entry;
+			float Span = Table[Entry + 1] - Table[Entry];
+			float f = Span > 0.0f ? (Dist - Table[Entry]) / Span : 0.0f;
+			T[j] = ((float)Entry + (f < 1.0f ? f : 1.0f)) * Step;
+		}
+		s_spline_eval(Spline, T, Rest, OutPos + (size_t)i * (size_t)Spline->Dims,
+			      OutTangent ? OutTangent + (size_t)i * (size_t)Spline->Dims : NULL);
+	}
+}
+
+/*********************************************
+ *                 ANIMATION                  *
+ *********************************************/
+
+SYL_INLINE strack s_track(const float* Times, const float* Values, int KeyCount)
+{
+	_SYL_PROFILE(s_track);
+	strack Result;
+	Result.Times = Times;
+	Result.Values = Values;
+	Result.KeyCount = KeyCount;
+	Result.Cursor = 0;
+	return(Result);
+}
+
+/* Largest key in [Lo, Hi] whose time is not after Time, Lo when there is none */
+SYL_INLINE int _s_track_search(const float* Times, int Lo, int Hi, float Time)
+{
+	while (Lo < Hi) {
+		int Mid = (Lo + Hi + 1) / 2;
+		if (Times[Mid] <= Time)
+			Lo = Mid;
+		else
+			Hi = Mid - 1;
+	}
+	return(Lo);
+}
+
+/* Key k with Times[k] <= Time < Times[k + 1], clamped to [0, KeyCount - 2] */
+SYL_INLINE int _s_track_find(strack* Track, float Time)
+{
+	const float* Times = Track->Times;
+	int Last = Track->KeyCount - 2;
+	int k = Track->Cursor;
+	int Steps;
+
+	if (k < 0 || k > Last)
+		k = 0;
+
+	if (Time < Times[k]) {
+		/* Looping or scrubbing backwards */
+		k = _s_track_search(Times, 0, k, Time);
+	} else {
+		/* Coherent playback moves at most a key or two per frame */
+		for (Steps = 0; k < Last && Times[k + 1] <= Time; ++Steps, ++k) {
+			if (Steps == 4) {
+				k = _s_track_search(Times, k, Last, Time);
+				break;
+			}
+		}
+	}
+
+	Track->Cursor = k;
+	return(k);
+}
+
+/*
+ * Tracks are sampled in blocks of _SYL_LANES. The two keys of every track are
+ * transposed into lanes so the lerp, and the normalize for rotations, run on
+ * a whole block at once.
+ */
+SYL_INLINE void _s_tracks_sample(strack* Tracks, int Count, float Time, float* Out, size_t Stride, int Dims, bool Rotation)
+{
+	float A[4][_SYL_LANES], B[4][_SYL_LANES], F[_SYL_LANES];
+	_snf a[4], b[4];
+	int i, j, d;
+
+	for (i = 0; i < Count; i += _SYL_LANES) {
+		int Rest = Count - i < _SYL_LANES ? Count - i : _SYL_LANES;
+
+		for (j = 0; j < _SYL_LANES; ++j) {
+			strack* Track = j < Rest ? Tracks + i + j : NULL;
+			const float* Va;
+			const float* Vb;
+
+			F[j] = 0.0f;
+			if (!Track || Track->KeyCount < 1) {
+				for (d = 0; d < Dims; ++d)
+					A[d][j] = B[d][j] = 0.0f;
+				continue;
+			}
+
+			if (Track->KeyCount == 1) {
+				Va = Vb = Track->Values;
+			} else {
+				int k = _s_track_find(Track, Time);
+				float t0 = Track->Times[k], t1 = Track->Times[k + 1];
+				float f = t1 > t0 ? (Time - t0) / (t1 - t0) : 1.0f;
+				F[j] = f < 0.0f ? 0.0f : (f > 1.0f ? 1.0f : f);
+				Va = Track->Values + (size_t)k * (size_t)Dims;
+				Vb = Va + Dims;
+			}
+			for (d = 0; d < Dims; ++d) {
+				A[d][j] = Va[d];
+				B[d][j] = Vb[d];
+			}
+		}
+
+		_snf f = _s_nf_load(F);
+		for (d = 0; d < Dims; ++d) {
+			a[d] = _s_nf_load(A[d]);
+			b[d] = _s_nf_load(B[d]);
+		}
+
+		if (Rotation) {
+			/* nlerp along the shorter arc, q and -q are the same rotation */
+			_snf Dot = _s_nf_set1(0.0f);
+			for (d = 0; d < 4; ++d)
+				Dot = _s_nf_madd(a[d], b[d], Dot);
+			_snm Flip = _s_nf_gt(_s_nf_set1(0.0f), Dot);
+			for (d = 0; d < 4; ++d)
+				b[d] = _s_nf_select(Flip, _s_nf_sub(_s_nf_set1(0.0f), b[d]), b[d]);
+		}
+
+		for (d = 0; d < Dims; ++d)
+			a[d] = _s_nf_lerp(a[d], b[d], f);
+
+		if (Rotation) {
+			_snf Sq = _s_nf_set1(0.0f);
+			for (d = 0; d < 4; ++d)
+				Sq = _s_nf_madd(a[d], a[d], Sq);
+			/* Empty lanes hold zero and are never written */
+			_snf r = _s_nf_rsqrt_nr(_s_nf_max(Sq, _s_nf_set1(1e-30f)));
+			for (d = 0; d < 4; ++d)
+				a[d] = _s_nf_mul(a[d], r);
+		}
+
+		for (d = 0; d < Dims; ++d)
+			_s_nf_store(A[d], a[d]);
+
+		for (j = 0; j < Rest; ++j) {
+			float* Dst;
+			if (Tracks[i + j].KeyCount < 1)
+				continue;
+			Dst = (float*)((char*)Out + (size_t)(i + j) * Stride);
+			for (d = 0; d < Dims; ++d)
+				Dst[d] = A[d][j];
+		}
+	}
+}
+
+SYL_INLINE void s_tracks_sample_vec3(strack* Tracks, int Count, float Time, svec3* Out, size_t Stride)
+{
+	_SYL_PROFILE(s_tracks_sample_vec3);
+	_s_tracks_sample(Tracks, Count, Time, Out->e, Stride ? Stride : sizeof(svec3), 3, false);
+}
+
+SYL_INLINE void s_tracks_sample_quat(strack* Tracks, int Count, float Time, squat* Out, size_t Stride)
+{
+	_SYL_PROFILE(s_tracks_sample_quat);
+	_s_tracks_sample(Tracks, Count, Time, Out->e, Stride ? Stride : sizeof(squat), 4, true);
+}
+
+SYL_INLINE void s_tracks_sample_transforms(strack* Translation, strack* Rotation, strack* Scale, int Count, float Time, stransform* Out)
+{
+	_SYL_PROFILE(s_tracks_sample_transforms);
+	if (Translation)
+		s_tracks_sample_vec3(Translation, Count, Time, &Out->Translation, sizeof(stransform));
+	if (Rotation)
+		s_tracks_sample_quat(Rotation, Count, Time, &Out->Rotation, sizeof(stransform));
+	if (Scale)
+		s_tracks_sample_vec3(Scale, Count, Time, &Out->Scale, sizeof(stransform));
+}
+
+/*********************************************
+ *               DECOMPOSITION                *
+ *********************************************/
+
+/*
+ * Matrices are taken as T * R * S like s_mat4_translate, s_mat4_rotate and
+ * s_mat4_scale build them: v4d[3] is the translation and the columns of the
+ * upper 3x3 are the rotated axes times the scale. A block of matrices is
+ * transposed into lanes, one lane per matrix.
+ */
+SYL_INLINE void s_mat4_decompose_array(const smat4* Matrices, stransform* Out, int Count)
+{
+	_SYL_PROFILE(s_mat4_decompose_array);
+	float M[9][_SYL_LANES], Q[4][_SYL_LANES], S[3][_SYL_LANES];
+	_snf c[3][3], Scale[3], Zero = _s_nf_set1(0.0f);
+	int i, j, k, r;
+
+	for (i = 0; i < Count; i += _SYL_LANES) {
+		int Rest = Count - i < _SYL_LANES ? Count - i : _SYL_LANES;
+
+		for (j = 0; j < _SYL_LANES; ++j)
+			for (k = 0; k < 9; ++k)
+				M[k][j] = j < Rest ? Matrices[i + j].e[(k / 3) * 4 + k % 3] : (k % 4 == 0 ? 1.0f : 0.0f);
+
+		for (k = 0; k < 3; ++k) {
+			_snf Sq;
+			for (r = 0; r < 3; ++r)
+				c[k][r] = _s_nf_load(M[k * 3 + r]);
+			Sq = _s_nf_madd(c[k][0], c[k][0], _s_nf_madd(c[k][1], c[k][1], _s_nf_mul(c[k][2], c[k][2])));
+
+			/* Degenerate axes get a zero scale and don't contribute to the rotation */
+			_snf Inv = _s_nf_mask(_s_nf_gt(Sq, Zero), _s_nf_rsqrt_nr(_s_nf_max(Sq, _s_nf_set1(1e-30f))));
+			Scale[k] = _s_nf_mul(Sq, Inv);
+			for (r = 0; r < 3; ++r)
+				c[k][r] = _s_nf_mul(c[k][r], Inv);
+		}
+
+		/* A mirrored basis is a negative scale, it is put on x */
+		_snf Det = _s_nf_mul(c[0][0], _s_nf_sub(_s_nf_mul(c[1][1], c[2][2]), _s_nf_mul(c[1][2], c[2][1])));
+		Det = _s_nf_madd(c[0][1], _s_nf_sub(_s_nf_mul(c[1][2], c[2][0]), _s_nf_mul(c[1][0], c[2][2])), Det);
+		Det = _s_nf_madd(c[0][2], _s_nf_sub(_s_nf_mul(c[1][0], c[2][1]), _s_nf_mul(c[1][1], c[2][0])), Det);
+		_snm Mirror = _s_nf_gt(Zero, Det);
+		Scale[0] = _s_nf_select(Mirror, _s_nf_sub(Zero, Scale[0]), Scale[0]);
+		for (r = 0; r < 3; ++r)
+			c[0][r] = _s_nf_select(Mirror, _s_nf_sub(Zero, c[0][r]), c[0][r]);
+
+		/*
+		 * Quaternion from the rotation, R[row][col] = c[col][row]. The largest
+		 * of 4w^2, 4x^2, 4y^2 and 4z^2 is taken with a square root and the rest
+		 * follow from the off diagonal sums and differences.
+		 */
+		_snf One = _s_nf_set1(1.0f);
+		_snf d0 = c[0][0], d1 = c[1][1], d2 = c[2][2];
+		_snf A = _s_nf_sub(c[1][2], c[2][1]);
+		_snf B = _s_nf_sub(c[2][0], c[0][2]);
+		_snf C = _s_nf_sub(c[0][1], c[1][0]);
+		_snf D = _s_nf_add(c[1][0], c[0][1]);
+		_snf E = _s_nf_add(c[2][0], c[0][2]);
+		_snf F = _s_nf_add(c[2][1], c[1][2]);
+		_snf t0 = _s_nf_add(One, _s_nf_add(d0, _s_nf_add(d1, d2)));
+		_snf t1 = _s_nf_add(One, _s_nf_sub(d0, _s_nf_add(d1, d2)));
+		_snf t2 = _s_nf_add(One, _s_nf_sub(d1, _s_nf_add(d0, d2)));
+		_snf t3 = _s_nf_add(One, _s_nf_sub(d2, _s_nf_add(d0, d1)));
+		_snf qx = A, qy = B, qz = C, qw = t0, Best = t0;
+		_snm m;
+
+		m = _s_nf_gt(t1, Best);
+		qx = _s_nf_select(m, t1, qx);
+		qy = _s_nf_select(m, D, qy);
+		qz = _s_nf_select(m, E, qz);
+		qw = _s_nf_select(m, A, qw);
+		Best = _s_nf_max(Best, t1);
+
+		m = _s_nf_gt(t2, Best);
+		qx = _s_nf_select(m, D, qx);
+		qy = _s_nf_select(m, t2, qy);
+		qz = _s_nf_select(m, F, qz);
+		qw = _s_nf_select(m, B, qw);
+		Best = _s_nf_max(Best, t2);
+
+		m = _s_nf_gt(t3, Best);
+		qx = _s_nf_select(m, E, qx);
+		qy = _s_nf_select(m, F, qy);
+		qz = _s_nf_select(m, t3, qz);
+		qw = _s_nf_select(m, C, qw);
+		Best = _s_nf_max(Best, t3);
+
+		/* Keep w positive so equal rotations give equal quaternions */
+		_snf k2 = _s_nf_mul(_s_nf_set1(0.5f), _s_nf_rsqrt_nr(_s_nf_max(Best, _s_nf_set1(1e-30f))));
+		k2 = _s_nf_select(_s_nf_gt(Zero, qw), _s_nf_sub(Zero, k2), k2);
+
+		_s_nf_store(Q[0], _s_nf_mul(qx, k2));
+		_s_nf_store(Q[1], _s_nf_mul(qy, k2));
+		_s_nf_store(Q[2], _s_nf_mul(qz, k2));
+		_s_nf_store(Q[3], _s_nf_mul(qw, k2));
+		for (k = 0; k < 3; ++k)
+			_s_nf_store(S[k], Scale[k]);
+
+		for (j = 0; j < Rest; ++j) {
+			stransform* T = Out + i + j;
+			for (k = 0; k < 3; ++k) {
+				T->Translation.e[k] = Matrices[i + j].e[12 + k];
+				T->Scale.e[k] = S[k][j];
+			}
+			for (k = 0; k < 4; ++k)
+				T->Rotation.e[k] = Q[k][j];
+		}
+	}
+}
+
+SYL_INLINE stransform s_mat4_decompose(smat4 Matrix)
+{
+	_SYL_PROFILE(s_mat4_decompose);
+	stransform Result;
+	s_mat4_decompose_array(&Matrix, &Result, 1);
+	return(Result);
+}
+
+/*********************************************
+ *                COMPOSITION                 *
+ *********************************************/
+
+/*
+ * Builds T * R * S directly, the rotation is expanded from the quaternion and
+ * each column is scaled, so no matrix product is done. The quaternion doesn't
+ * have to be normalized. The inverse is S^-1 * R^T * T^-1 and needs a nonzero
+ * scale on every axis.
+ */
+SYL_INLINE void s_mat4_from_trs_array(const stransform* Transforms, smat4* Out, smat4* OutInverse, int Count)
+{
+	_SYL_PROFILE(s_mat4_from_trs_array);
+	float In[10][_SYL_LANES], M[12][_SYL_LANES], I[12][_SYL_LANES];
+	_snf t[3], q[4], s[3], R[3][3];
+	int i, j, k, r;
+
+	for (i = 0; i < Count; i += _SYL_LANES) {
+		int Rest = Count - i < _SYL_LANES ? Count - i : _SYL_LANES;
+
+		/* Unused lanes get an identity transform */
+		for (j = 0; j < _SYL_LANES; ++j) {
+			const stransform* T = j < Rest ? Transforms + i + j : NULL;
+			for (k = 0; k < 3; ++k) {
+				In[k][j] = T ? T->Translation.e[k] : 0.0f;
+				In[7 + k][j] = T ? T->Scale.e[k] : 1.0f;
+			}
+			for (k = 0; k < 4; ++k)
+				In[3 + k][j] = T ? T->Rotation.e[k] : (k == 3 ? 1.0f : 0.0f);
+		}
+
+		for (k = 0; k < 3; ++k) {
+			t[k] = _s_nf_load(In[k]);
+			s[k] = _s_nf_load(In[7 + k]);
+		}
+		for (k = 0; k < 4; ++k)
+			q[k] = _s_nf_load(In[3 + k]);
+
+		/* 2 / |q|^2 folds the normalization into the expansion */
+		_snf Len2 = _s_nf_madd(q[0], q[0], _s_nf_madd(q[1], q[1], _s_nf_madd(q[2], q[2], _s_nf_mul(q[3], q[3]))));
+		_snf Inv = _s_nf_rsqrt_nr(Len2);
+		_snf Two = _s_nf_mul(_s_nf_set1(2.0f), _s_nf_mul(Inv, Inv));
+		_snf x2 = _s_nf_mul(q[0], Two), y2 = _s_nf_mul(q[1], Two), z2 = _s_nf_mul(q[2], Two);
+		_snf xx = _s_nf_mul(q[0], x2), yy = _s_nf_mul(q[1], y2), zz = _s_nf_mul(q[2], z2);
+		_snf xy = _s_nf_mul(q[0], y2), xz = _s_nf_mul(q[0], z2), yz = _s_nf_mul(q[1], z2);
+		_snf wx = _s_nf_mul(q[3], x2), wy = _s_nf_mul(q[3], y2), wz = _s_nf_mul(q[3], z2);
+		_snf One = _s_nf_set1(1.0f);
+
+		/* R[row][col] */
+		R[0][0] = _s_nf_sub(One, _s_nf_add(yy, zz));
+		R[0][1] = _s_nf_sub(xy, wz);
+		R[0][2] = _s_nf_add(xz, wy);
+		R[1][0] = _s_nf_add(xy, wz);
+		R[1][1] = _s_nf_sub(One, _s_nf_add(xx, zz));
+		R[1][2] = _s_nf_sub(yz, wx);
+		R[2][0] = _s_nf_sub(xz, wy);
+		R[2][1] = _s_nf_add(yz, wx);
+		R[2][2] = _s_nf_sub(One, _s_nf_add(xx, yy));
+
+		for (k = 0; k < 3; ++k) {
+			for (r = 0; r < 3; ++r)
+				_s_nf_store(M[k * 3 + r], _s_nf_mul(R[r][k], s[k]));
+			_s_nf_store(M[9 + k], t[k]);
+		}
+
+		if (OutInverse) {
+			_snf InvS[3], Col[3][3];
+			for (k = 0; k < 3; ++k)
+				InvS[k] = _s_nf_div(One, s[k]);
+
+			/* Column k of the inverse is row k of R, each row scaled by 1 / s */
+			for (k = 0; k < 3; ++k)
+				for (r = 0; r < 3; ++r) {
+					Col[k][r] = _s_nf_mul(R[k][r], InvS[r]);
+					_s_nf_store(I[k * 3 + r], Col[k][r]);
+				}
+			for (r = 0; r < 3; ++r) {
+				_snf v = _s_nf_madd(Col[0][r], t[0], _s_nf_madd(Col[1][r], t[1], _s_nf_mul(Col[2][r], t[2])));
+				_s_nf_store(I[9 + r], _s_nf_sub(_s_nf_set1(0.0f), v));
+			}
+		}
+
+		for (j = 0; j < Rest; ++j) {
+			smat4* Dst = Out + i + j;
+			for (k = 0; k < 4; ++k) {
+				for (r = 0; r < 3; ++r)
+					Dst->e[k * 4 + r] = M[k * 3 + r][j];
+				Dst->e[k * 4 + 3] = k == 3 ? 1.0f : 0.0f;
+			}
+			if (OutInverse) {
+				Dst = OutInverse + i + j;
+				for (k = 0; k < 4; ++k) {
+					for (r = 0; r < 3; ++r)
+						Dst->e[k * 4 + r] = I[k * 3 + r][j];
+					Dst->e[k * 4 + 3] = k == 3 ? 1.0f : 0.0f;
+				}
+			}
+		}
+	}
+}
+
+SYL_INLINE smat4 s_mat4_from_trs(svec3 Translation, squat Rotation, svec3 Scale)
+{
+	_SYL_PROFILE(s_mat4_from_trs);
+	stransform Transform;
+	smat4 Result;
+	Transform.Translation = Translation;
+	Transform.Rotation = Rotation;
+	Transform.Scale = Scale;
+	s_mat4_from_trs_array(&Transform, &Result, NULL, 1);
+	return(Result);
+}
+
+/*
+ * A block of matrices is transposed into lanes, one lane per pair, and
+ * element e2[r][c] of every product is summed in the order s_mat3x4_mul uses.
+ * Out may be the same array as either input.
+ */
+SYL_INLINE void s_mat3x4_mul_array(const smat3x4* Matrices1, const smat3x4* Matrices2, smat3x4* Out, int Count)
+{
+	_SYL_PROFILE(s_mat3x4_mul_array);
+	const float *A[12], *B[12];
+	float* O[12];
+	_snf a[12], b[12], r[12];
+	int i, k, c;
+
+	if (Count <= 0)
+		return;
+	for (k = 0; k < 12; ++k) {
+		A[k] = Matrices1->e + k;
+		B[k] = Matrices2->e + k;
+		O[k] = Out->e + k;
+	}
+
+	for (i = 0; i < Count; i += _SYL_LANES) {
+		int Rest = Count - i < _SYL_LANES ? Count - i : _SYL_LANES;
+
+		_s_vec_load(A, 12, 12, i, Rest, a);
+		_s_vec_load(B, 12, 12, i, Rest, b);
+		for (k = 0; k < 3; ++k)
+			for (c = 0; c < 4; ++c) {
+				_snf Sum = _s_nf_mul(a[k * 4], b[c]);
+				Sum = _s_nf_madd(a[k * 4 + 1], b[4 + c], Sum);
+				Sum = _s_nf_madd(a[k * 4 + 2], b[8 + c], Sum);
+				r[k * 4 + c] = c == 3 ? _s_nf_add(Sum, a[k * 4 + 3]) : Sum;
+			}
+		_s_vec_store(O, 12, 12, i, Rest, r);
+	}
+}
+
+/*********************************************
+ *                 PROJECTION                 *
+ *********************************************/
+
+/*
+ * Points go through the matrix as (x, y, z, 1) with the columns of the
+ * matrix, the same as s_mat4_mul_vec4. NDC is -1 to 1 on every axis like
+ * s_mat4_perspective_projection_rh makes it, and is mapped to the viewport
+ * the way glm::project does, y goes up from Viewport.Y. A block of points is
+ * transposed into lanes, one lane per point.
+ */
+_SYL_FORCE_INLINE void _s_project_lanes(const smat4* Matrix, _snf x, _snf y, _snf z, _snf* Out)
+{
+	for (int r = 0; r < 4; ++r) {
+		_snf v = _s_nf_madd(x, _s_nf_set1(Matrix->e[r]), _s_nf_set1(Matrix->e[12 + r]));
+		v = _s_nf_madd(y, _s_nf_set1(Matrix->e[4 + r]), v);
+		Out[r] = _s_nf_madd(z, _s_nf_set1(Matrix->e[8 + r]), v);
+	}
+}
+
+/* Below the smallest normal float rcp overflows, such w are clipped */
+#define _SYL_PROJECT_MIN_W 1.17549435e-38f
+
+/* An empty viewport or depth range has no inverse, every point is clipped */
+_SYL_FORCE_INLINE bool _s_viewport_empty(const sviewport* Viewport)
+{
+	return(Viewport->Width == 0.0f || Viewport->Height == 0.0f || Viewport->MaxDepth == Viewport->MinDepth);
+}
+
+/*
+ * Points with w <= 0 are behind the camera, they are flagged and written as
+ * if w was 1. Tiny w and an empty viewport are flagged the same way.
+ */
+SYL_INLINE int s_project_points(smat4 ViewProjection, sviewport Viewport, const svec3* Points, svec3* Out, unsigned char* Clipped, int Count)
+{
+	_SYL_PROFILE(s_project_points);
+	float P[3][_SYL_LANES], Front[_SYL_LANES];
+	_snf c[4], One = _s_nf_set1(1.0f);
+	_snf MinW = _s_nf_set1(_s_viewport_empty(&Viewport) ? INFINITY : _SYL_PROJECT_MIN_W);
+	_snf Scale[3] = { _s_nf_set1(0.5f * Viewport.Width), _s_nf_set1(0.5f * Viewport.Height), _s_nf_set1(0.5f * (Viewport.MaxDepth - Viewport.MinDepth)) };
+	_snf Offset[3] = { _s_nf_set1(Viewport.X + 0.5f * Viewport.Width), _s_nf_set1(Viewport.Y + 0.5f * Viewport.Height), _s_nf_set1(0.5f * (Viewport.MinDepth + Viewport.MaxDepth)) };
+	int Visible = 0, i, j, k;
+
+	for (i = 0; i < Count; i += _SYL_LANES) {
+		int Rest = Count - i < _SYL_LANES ? Count - i : _SYL_LANES;
+
+		for (j = 0; j < _SYL_LANES; ++j)
+			for (k = 0; k < 3; ++k)
+				P[k][j] = j < Rest ? Points[i + j].e[k] : 0.0f;
+
+		_s_project_lanes(&ViewProjection, _s_nf_load(P[0]), _s_nf_load(P[1]), _s_nf_load(P[2]), c);
+
+		_snm InFront = _s_nf_gt(c[3], MinW);
+		_snf InvW = _s_nf_rcp_nr(_s_nf_select(InFront, c[3], One));
+		for (k = 0; k < 3; ++k)
+			_s_nf_store(P[k], _s_nf_madd(_s_nf_mul(c[k], InvW), Scale[k], Offset[k]));
+		_s_nf_store(Front, _s_nf_mask(InFront, One));
+
+		for (j = 0; j < Rest; ++j) {
+			for (k = 0; k < 3; ++k)
+				Out[i + j].e[k] = P[k][j];
+			Visible += Front[j] != 0.0f;
+			if (Clipped)
+				Clipped[i + j] = Front[j] == 0.0f;
+		}
+	}
+	return(Visible);
+}
+
+/* Full inverse by cofactors, done once per call so a projection can be passed as is */
+_SYL_FORCE_INLINE smat4 _s_mat4_inverse_cofactor(const smat4* M, float* Determinant)
+{
+	const float* m = M->e;
+	smat4 R;
+	float* r = R.e;
+
+	r[0] = m[5] * m[10] * m[15] - m[5] * m[11] * m[14] - m[9] * m[6] * m[15] + m[9] * m[7] * m[14] + m[13] * m[6] * m[11] - m[13] * m[7] * m[10];
+	r[4] = -m[4] * m[10] * m[15] + m[4] * m[11] * m[14] + m[8] * m[6] * m[15] - m[8] * m[7] * m[14] - m[12] * m[6] * m[11] + m[12] * m[7] * m[10];
+	r[8] = m[4] * m[9] * m[15] - m[4] * m[11] * m[13] - m[8] * m[5] * m[15] + m[8] * m[7] * m[13] + m[12] * m[5] * m[11] - m[12] * m[7] * m[9];
+	r[12] = -m[4] * m[9] * m[14] + m[4] * m[10] * m[13] + m[8] * m[5] * m[14] - m[8] * m[6] * m[13] - m[12] * m[5] * m[10] + m[12] * m[6] * m[9];
+	r[1] = -m[1] * m[10] * m[15] + m[1] * m[11] * m[14] + m[9] * m[2] * m[15] - m[9] * m[3] * m[14] - m[13] * m[2] * m[11] + m[13] * m[3] * m[10];
+	r[5] = m[0] * m[10] * m[15] - m[0] * m[11] * m[14] - m[8] * m[2] * m[15] + m[8] * m[3] * m[14] + m[12] * m[2] * m[11] - m[12] * m[3] * m[10];
+	r[9] = -m[0] * m[9] * m[15] + m[0] * m[11] * m[13] + m[8] * m[1] * m[15] - m[8] * m[3] * m[13] - m[12] * m[1] * m[11] + m[12] * m[3] * m[9];
+	r[13] = m[0] * m[9] * m[14] - m[0] * m[10] * m[13] - m[8] * m[1] * m[14] + m[8] * m[2] * m[13] + m[12] * m[1] * m[10] - m[12] * m[2] * m[9];
+	r[2] = m[1] * m[6] * m[15] - m[1] * m[7] * m[14] - m[5] * m[2] * m[15] + m[5] * m[3] * m[14] + m[13] * m[2] * m[7] - m[13] * m[3] * m[6];
+	r[6] = -m[0] * m[6] * m[15] + m[0] * m[7] * m[14] + m[4] * m[2] * m[15] - m[4] * m[3] * m[14] - m[12] * m[2] * m[7] + m[12] * m[3] * m[6];
+	r[10] = m[0] * m[5] * m[15] - m[0] * m[7] * m[13] - m[4] * m[1] * m[15] + m[4] * m[3] * m[13] + m[12] * m[1] * m[7] - m[12] * m[3] * m[5];
+	r[14] = -m[0] * m[5] * m[14] + m[0] * m[6] * m[13] + m[4] * m[1] * m[14] - m[4] * m[2] * m[13] - m[12] * m[1] * m[6] + m[12] * m[2] * m[5];
+	r[3] = -m[1] * m[6] * m[11] + m[1] * m[7] * m[10] + m[5] * m[2] * m[11] - m[5] * m[3] * m[10] - m[9] * m[2] * m[7] + m[9] * m[3] * m[6];
+	r[7] = m[0] * m[6] * m[11] - m[0] * m[7] * m[10] - m[4] * m[2] * m[11] + m[4] * m[3] * m[10] + m[8] * m[2] * m[7] - m[8] * m[3] * m[6];
+	r[11] = -m[0] * m[5] * m[11] + m[0] * m[7] * m[9] + m[4] * m[1] * m[11] - m[4] * m[3] * m[9] - m[8] * m[1] * m[7] + m[8] * m[3] * m[5];
+	r[15] = m[0] * m[5] * m[10] - m[0] * m[6] * m[9] - m[4] * m[1] * m[10] + m[4] * m[2] * m[9] + m[8] * m[1] * m[6] - m[8] * m[2] * m[5];
+
+	float Det = m[0] * r[0] + m[1] * r[4] + m[2] * r[8] + m[3] * r[12];
+	float InvDet = Det != 0.0f ? 1.0f / Det : 0.0f;
+	for (int i = 0; i < 16; ++i)
+		r[i] *= InvDet;
+	*Determinant = Det;
+	return(R);
+}
+
+/*
+ * Inverse of s_project_points, Points hold window x, y and depth. Points
+ * that map to a w near zero have no position, they are flagged and written
+ * as if w was 1. With an empty viewport or a singular matrix every point is
+ * flagged.
+ */
+SYL_INLINE int s_unproject_points(smat4 ViewProjection, sviewport Viewport, const svec3* Points, svec3* Out, unsigned char* Clipped, int Count)
+{
+	_SYL_PROFILE(s_unproject_points);
+	float Determinant;
+	smat4 InverseViewProjection = _s_mat4_inverse_cofactor(&ViewProjection, &Determinant);
+	float P[3][_SYL_LANES], Valid[_SYL_LANES];
+	bool Empty = _s_viewport_empty(&Viewport) || Determinant == 0.0f;
+	_snf c[4], Ndc[3], Zero = _s_nf_set1(0.0f), One = _s_nf_set1(1.0f);
+	_snf MinW = _s_nf_set1(Empty ? INFINITY : _SYL_PROJECT_MIN_W);
+	_snf Scale[3] = { _s_nf_set1(Empty ? 0.0f : 2.0f / Viewport.Width), _s_nf_set1(Empty ? 0.0f : 2.0f / Viewport.Height),
+		_s_nf_set1(Empty ? 0.0f : 2.0f / (Viewport.MaxDepth - Viewport.MinDepth)) };
+	_snf Offset[3] = { _s_nf_set1(Viewport.X), _s_nf_set1(Viewport.Y), _s_nf_set1(Viewport.MinDepth) };
+	int Unclipped = 0, i, j, k;
+
+	for (i = 0; i < Count; i += _SYL_LANES) {
+		int Rest = Count - i < _SYL_LANES ? Count - i : _SYL_LANES;
+
+		for (j = 0; j < _SYL_LANES; ++j)
+			for (k = 0; k < 3; ++k)
+				P[k][j] = j < Rest ? Points[i + j].e[k] : 0.0f;
+
+		for (k = 0; k < 3; ++k)
+			Ndc[k] = _s_nf_sub(_s_nf_mul(_s_nf_sub(_s_nf_load(P[k]), Offset[k]), Scale[k]), _s_nf_set1(1.0f));
+
+		_s_project_lanes(&InverseViewProjection, Ndc[0], Ndc[1], Ndc[2], c);
+
+		_snm Finite = _s_nf_gt(_s_nf_max(c[3], _s_nf_sub(Zero, c[3])), MinW);
+		_snf InvW = _s_nf_rcp_nr(_s_nf_select(Finite, c[3], One));
+		for (k = 0; k < 3; ++k)
+			_s_nf_store(P[k], _s_nf_mul(c[k], InvW));
+		_s_nf_store(Valid, _s_nf_mask(Finite, One));
+
+		for (j = 0; j < Rest; ++j) {
+			for (k = 0; k < 3; ++k)
+				Out[i + j].e[k] = P[k][j];
+			Unclipped += Valid[j] != 0.0f;
+			if (Clipped)
+				Clipped[i + j] = Valid[j] == 0.0f;
+		}
+	}
+	return(Unclipped);
+}
+
+/*********************************************
+ *               VECTOR ARRAYS                *
+ *********************************************/
+
+/*
+ * Every kernel goes through _s_vec_array. Component k of element i is read
+ * from In[k][i * Stride], so AoS arrays pass pointers into the first element
+ * with a stride of 3 or 4 and SoA arrays pass one array per component with a
+ * stride of 1. Contiguous full blocks are loaded directly, everything else is
+ * gathered into a padded block. Output may alias the input.
+ *
+ * The fast mode uses rsqrt with one Newton step, about 22 bits. The precise
+ * mode uses sqrt and a divide. Zero vectors normalize to zero in both.
+ */
+
+#define _S_VEC_DOT 0
+#define _S_VEC_LENGTH 1
+#define _S_VEC_NORMALIZE 2
+
+_SYL_FORCE_INLINE void _s_vec_array(int Op, int Dims, const float* const* A, const float* const* B, int Stride, float* const* Out, int OutStride, int Count, bool Precise)
+{
+	_snf a[4], b[4], r[4];
+	_snf Epsilon = _s_nf_set1(_SYL_VEC_EPSILON_SQ);
+	int i, k;
+
+	for (i = 0; i < Count; i += _SYL_LANES) {
+		int Rest = Count - i < _SYL_LANES ? Count - i : _SYL_LANES;
+
+		_s_vec_load(A, Dims, Stride, i, Rest, a);
+		if (Op == _S_VEC_DOT)
+			_s_vec_load(B, Dims, Stride, i, Rest, b);
+		else
+			for (k = 0; k < Dims; ++k)
+				b[k] = a[k];
+
+		_snf Dot = _s_nf_mul(a[0], b[0]);
+		for (k = 1; k < Dims; ++k)
+			Dot = _s_nf_madd(a[k], b[k], Dot);
+
+		if (Op == _S_VEC_DOT) {
+			r[0] = Dot;
+			_s_vec_store(Out, 1, OutStride, i, Rest, r);
+			continue;
+		}
+
+		_snm NonZero = _s_nf_gt(Dot, Epsilon);
+		_snf Inv;
+		if (Precise) {
+			_snf Length = _s_nf_sqrt_exact(Dot);
+			if (Op == _S_VEC_LENGTH) {
+				r[0] = Length;
+				_s_vec_store(Out, 1, OutStride, i, Rest, r);
+				continue;
+			}
+			Inv = _s_nf_div(_s_nf_set1(1.0f), _s_nf_max(Length, Epsilon));
+		}
+		else {
+			Inv = _s_nf_rsqrt_nr(_s_nf_max(Dot, Epsilon));
+			if (Op == _S_VEC_LENGTH) {
+				r[0] = _s_nf_mask(NonZero, _s_nf_mul(Dot, Inv));
+				_s_vec_store(Out, 1, OutStride, i, Rest, r);
+				continue;
+			}
+		}
+
+		Inv = _s_nf_mask(NonZero, Inv);
+		for (k = 0; k < Dims; ++k)
+			r[k] = _s_nf_mul(a[k], Inv);
+		_s_vec_store(Out, Dims, OutStride, i, Rest, r);
+	}
+}
+
+SYL_INLINE void s_vec3_normalize_array(const svec3* In, svec3* Out, int Count, bool Precise)
+{
+	_SYL_PROFILE(s_vec3_normalize_array);
+	const float* A[3] = { In->e, In->e + 1, In->e + 2 };
+	float* O[3] = { Out->e, Out->e + 1, Out->e + 2 };
+	_s_vec_array(_S_VEC_NORMALIZE, 3, A, NULL, 3, O, 3, Count, Precise);
+}
+
+SYL_INLINE void s_vec3_length_array(const svec3* In, float* Out, int Count, bool Precise)
+{
+	_SYL_PROFILE(s_vec3_length_array);
+	const float* A[3] = { In->e, In->e + 1, In->e + 2 };
+	_s_vec_array(_S_VEC_LENGTH, 3, A, NULL, 3, &Out, 1, Count, Precise);
+}
+
+SYL_INLINE void s_vec3_dot_array(const svec3* A, const svec3* B, float* Out, int Count)
+{
+	_SYL_PROFILE(s_vec3_dot_array);
+	const float* Ap[3] = { A->e, A->e + 1, A->e + 2 };
+	const float* Bp[3] = { B->e, B->e + 1, B->e + 2 };
+	_s_vec_array(_S_VEC_DOT, 3, Ap, Bp, 3, &Out, 1, Count, false);
+}
+
+SYL_INLINE void s_vec4_normalize_array(const svec4* In, svec4* Out, int Count, bool Precise)
+{
+	_SYL_PROFILE(s_vec4_normalize_array);
+	const float* A[4] = { In->e, In->e + 1, In->e + 2, In->e + 3 };
+	float* O[4] = { Out->e, Out->e + 1, Out->e + 2, Out->e + 3 };
+	_s_vec_array(_S_VEC_NORMALIZE, 4, A, NULL, 4, O, 4, Count, Precise);
+}
+
+SYL_INLINE void s_vec4_length_array(const svec4* In, float* Out, int Count, bool Precise)
+{
+	_SYL_PROFILE(s_vec4_length_array);
+	const float* A[4] = { In->e, In->e + 1, In->e + 2, In->e + 3 };
+	_s_vec_array(_S_VEC_LENGTH, 4, A, NULL, 4, &Out, 1, Count, Precise);
+}
+
+SYL_INLINE void s_vec4_dot_array(const svec4* A, const svec4* B, float* Out, int Count)
+{
+	_SYL_PROFILE(s_vec4_dot_array);
+	const float* Ap[4] = { A->e, A->e + 1, A->e + 2, A->e + 3 };
+	const float* Bp[4] = { B->e, B->e + 1, B->e + 2, B->e + 3 };
+	_s_vec_array(_S_VEC_DOT, 4, Ap, Bp, 4, &Out, 1, Count, false);
+}
+
+SYL_INLINE void s_vec3_normalize_soa(const float* X, const float* Y, const float* Z, float* OutX, float* OutY, float* OutZ, int Count, bool Precise)
+{
+	_SYL_PROFILE(s_vec3_normalize_soa);
+	const float* A[3] = { X, Y, Z };
+	float* O[3] = { OutX, OutY, OutZ };
+	_s_vec_array(_S_VEC_NORMALIZE, 3, A, NULL, 1, O, 1, Count, Precise);
+}
+
+SYL_INLINE void s_vec3_length_soa(const float* X, const float* Y, const float* Z, float* Out, int Count, bool Precise)
+{
+	_SYL_PROFILE(s_vec3_length_soa);
+	const float* A[3] = { X, Y, Z };
+	_s_vec_array(_S_VEC_LENGTH, 3, A, NULL, 1, &Out, 1, Count, Precise);
+}
+
+SYL_INLINE void s_vec3_dot_soa(const float* AX, const float* AY, const float* AZ, const float* BX, const float* BY, const float* BZ, float* Out, int Count)
+{
+	_SYL_PROFILE(s_vec3_dot_soa);
+	const float* A[3] = { AX, AY, AZ };
+	const float* B[3] = { BX, BY, BZ };
+	_s_vec_array(_S_VEC_DOT, 3, A, B, 1, &Out, 1, Count, false);
+}
+
+SYL_INLINE void s_vec4_normalize_soa(const float* X, const float* Y, const float* Z, const float* W, float* OutX, float* OutY, float* OutZ, float* OutW, int Count, bool Precise)
+{
+	_SYL_PROFILE(s_vec4_normalize_soa);
+	const float* A[4] = { X, Y, Z, W };
+	float* O[4] = { OutX, OutY, OutZ, OutW };
+	_s_vec_array(_S_VEC_NORMALIZE, 4, A, NULL, 1, O, 1, Count, Precise);
+}
+
+SYL_INLINE void s_vec4_length_soa(const float* X, const float* Y, const float* Z, const float* W, float* Out, int Count, bool Precise)
+{
+	_SYL_PROFILE(s_vec4_length_soa);
+	const float* A[4] = { X, Y, Z, W };
+	_s_vec_array(_S_VEC_LENGTH, 4, A, NULL, 1, &Out, 1, Count, Precise);
+}
+
+SYL_INLINE void s_vec4_dot_soa(const float* AX, const float* AY, const float* AZ, const float* AW, const float* BX, const float* BY, const float* BZ, const float* BW, float* Out, int Count)
+{
+	_SYL_PROFILE(s_vec4_dot_soa);
+	const float* A[4] = { AX, AY, AZ, AW };
+	const float* B[4] = { BX, BY, BZ, BW };
+	_s_vec_array(_S_VEC_DOT, 4, A, B, 1, &Out, 1, Count, false);
+}
+
+/*********************************************
+ *             VECTOR REDUCTIONS              *
+ *********************************************/
+
+/*
+ * Arrays are cut into chunks of _SYL_REDUCE_GRAIN vectors, at most
+ * _SYL_REDUCE_MAX_CHUNKS of them. Every chunk is reduced on its own, with
+ * SYL_THREADS the chunks run on the pool, and the partial results are then
+ * combined pairwise in chunk order. Chunk bounds only depend on Count so the
+ * result is the same with and without threads.
+ *
+ * Min, max and sum read the array as a flat float stream in steps of Dims
+ * registers. Every lane then always sees the same component and no transpose
+ * is needed, the lanes are folded by component at the end of the chunk. Sums
+ * are moved from the float lanes into doubles every _SYL_REDUCE_FLUSH steps.
+ */
+
+#define _S_REDUCE_MIN 1
+#define _S_REDUCE_MAX 2
+#define _S_REDUCE_SUM 4
+
+#define _SYL_REDUCE_GRAIN 16384
+#define _SYL_REDUCE_MAX_CHUNKS 64
+#define _SYL_REDUCE_FLUSH 64
+
+typedef struct _svec_reduce
+{
+	float Min[4];
+	float Max[4];
+	double Sum[4];
+	double Weight;
+} _svec_reduce;
+
+typedef struct _svec_reduce_job
+{
+	int Ops;
+	int Dims;
+	int Grain;
+	const float* In;
+	const float* Weights;
+	_svec_reduce* Partials;
+} _svec_reduce_job;
+
+_SYL_FORCE_INLINE void _s_vec_reduce_flush(int Dims, _snf* Sum, double (*Total)[_SYL_LANES])
+{
+	float Block[_SYL_LANES];
+	int j, k;
+
+	for (k = 0; k < Dims; ++k) {
+		_s_nf_store(Block, Sum[k]);
+		for (j = 0; j < _SYL_LANES; ++j)
+			Total[k][j] += Block[j];
+		Sum[k] = _s_nf_set1(0.0f);
+	}
+}
+
+_SYL_FORCE_INLINE void _s_vec_reduce_flat(int Ops, int Dims, const float* In, int Count, _svec_reduce* R)
+{
+	_snf Min[4], Max[4], Sum[4];
+	double Total[4][_SYL_LANES];
+	float Block[_SYL_LANES];
+	int Floats = Count * Dims;
+	int Step = Dims * _SYL_LANES;
+	int i, j, k, Flush = 0;
+
+	for (k = 0; k < Dims; ++k) {
+		Min[k] = _s_nf_set1(INFINITY);
+		Max[k] = _s_nf_set1(-INFINITY);
+		Sum[k] = _s_nf_set1(0.0f);
+		for (j = 0; j < _SYL_LANES; ++j)
+			Total[k][j] = 0.0;
+	}
+
+	for (i = 0; i + Step <= Floats; i += Step) {
+		for (k = 0; k < Dims; ++k) {
+			_snf v = _s_nf_load(In + i + k * _SYL_LANES);
+			if (Ops & _S_REDUCE_MIN)
+				Min[k] = _s_nf_min(Min[k], v);
+			if (Ops & _S_REDUCE_MAX)
+				Max[k] = _s_nf_max(Max[k], v);
+			if (Ops & _S_REDUCE_SUM)
+				Sum[k] = _s_nf_add(Sum[k], v);
+		}
+		if ((Ops & _S_REDUCE_SUM) && ++Flush == _SYL_REDUCE_FLUSH) {
+			_s_vec_reduce_flush(Dims, Sum, Total);
+			Flush = 0;
+		}
+	}
+	if (Ops & _S_REDUCE_SUM)
+		_s_vec_reduce_flush(Dims, Sum, Total);
+
+	/* Lane j of register k holds component (k * _SYL_LANES + j) % Dims */
+	for (k = 0; k < Dims; ++k) {
+		R->Min[k] = INFINITY;
+		R->Max[k] = -INFINITY;
+		R->Sum[k] = 0.0;
+	}
+	for (k = 0; k < Dims; ++k) {
+		if (Ops & _S_REDUCE_MIN) {
+			_s_nf_store(Block, Min[k]);
+			for (j = 0; j < _SYL_LANES; ++j) {
+				int c = (k * _SYL_LANES + j) % Dims;
+				R->Min[c] = Block[j] < R->Min[c] ? Block[j] : R->Min[c];
+			}
+		}
+		if (Ops & _S_REDUCE_MAX) {
+			_s_nf_store(Block, Max[k]);
+			for (j = 0; j < _SYL_LANES; ++j) {
+				int c = (k * _SYL_LANES + j) % Dims;
+				R->Max[c] = Block[j] > R->Max[c] ? Block[j] : R->Max[c];
+			}
+		}
+		for (j = 0; j < _SYL_LANES; ++j)
+			R->Sum[(k * _SYL_LANES + j) % Dims] += Total[k][j];
+	}
+
+	for (; i < Floats; ++i) {
+		int c = i % Dims;
+		R->Min[c] = In[i] < R->Min[c] ? In[i] : R->Min[c];
+		R->Max[c] = In[i] > R->Max[c] ? In[i] : R->Max[c];
+		R->Sum[c] += In[i];
+	}
+	R->Weight = Count;
+}
+
+/* Weighted sums need the weight next to every component, these go through the transposing loader */
+SYL_INLINE void _s_vec_reduce_weighted(int Dims, const float* In, const float* Weights, int Count, _svec_reduce* R)
+{
+	const float* A[4] = { In, In + 1, In + 2, In + 3 };
+	const float* W[1] = { Weights };
+	_snf v[4], w, Sum[4], WSum = _s_nf_set1(0.0f);
+	double Total[4][_SYL_LANES], WTotal = 0.0;
+	float Block[_SYL_LANES];
+	int i, j, k, Flush = 0;
+
+	for (k = 0; k < Dims; ++k) {
+		Sum[k] = _s_nf_set1(0.0f);
+		for (j = 0; j < _SYL_LANES; ++j)
+			Total[k][j] = 0.0;
+	}
+
+	for (i = 0; i < Count; i += _SYL_LANES) {
+		int Rest = Count - i < _SYL_LANES ? Count - i : _SYL_LANES;
+		_s_vec_load(A, Dims, Dims, i, Rest, v);
+		_s_vec_load(W, 1, 1, i, Rest, &w);
+		for (k = 0; k < Dims; ++k)
+			Sum[k] = _s_nf_madd(v[k], w, Sum[k]);
+		WSum = _s_nf_add(WSum, w);
+		if (++Flush == _SYL_REDUCE_FLUSH) {
+			_s_vec_reduce_flush(Dims, Sum, Total);
+			_s_nf_store(Block, WSum);
+			for (j = 0; j < _SYL_LANES; ++j)
+				WTotal += Block[j];
+			WSum = _s_nf_set1(0.0f);
+			Flush = 0;
+		}
+	}
+	_s_vec_reduce_flush(Dims, Sum, Total);
+	_s_nf_store(Block, WSum);
+	for (j = 0; j < _SYL_LANES; ++j)
+		WTotal += Block[j];
+
+	for (k = 0; k < Dims; ++k) {
+		R->Sum[k] = 0.0;
+		for (j = 0; j < _SYL_LANES; ++j)
+			R->Sum[k] += Total[k][j];
+	}
+	R->Weight = WTotal;
+}
+
+SYL_INLINE void _s_vec_reduce_chunks(int Begin, int End, int WorkerIndex, void* UserData)
+{
+	_svec_reduce_job* Job = (_svec_reduce_job*)UserData;
+	const float* In = Job->In + (size_t)Begin * Job->Dims;
+	_svec_reduce* R = Job->Partials + Begin / Job->Grain;
+	(void)WorkerIndex;
+
+	/* Constant operations so the unused ones drop out of the loop */
+	if (Job->Weights)
+		_s_vec_reduce_weighted(Job->Dims, In, Job->Weights + Begin, End - Begin, R);
+	else if (Job->Ops == _S_REDUCE_MIN)
+		_s_vec_reduce_flat(_S_REDUCE_MIN, Job->Dims, In, End - Begin, R);
+	else if (Job->Ops == _S_REDUCE_MAX)
+		_s_vec_reduce_flat(_S_REDUCE_MAX, Job->Dims, In, End - Begin, R);
+	else if (Job->Ops == _S_REDUCE_SUM)
+		_s_vec_reduce_flat(_S_REDUCE_SUM, Job->Dims, In, End - Begin, R);
+	else
+		_s_vec_reduce_flat(_S_REDUCE_MIN | _S_REDUCE_MAX, Job->Dims, In, End - Begin, R);
+}
+
+SYL_INLINE void _s_vec_reduce(int Ops, int Dims, const float* In, const float* Weights, int Count, _svec_reduce* Result)
+{
+	_svec_reduce Partials[_SYL_REDUCE_MAX_CHUNKS];
+	_svec_reduce_job Job;
+	int Chunks, Width, c, k;
+
+	if (Count <= 0) {
+		memset(Result, 0, sizeof(*Result));
+		return;
+	}
+
+	Job.Ops = Ops;
+	Job.Dims = Dims;
+	Job.Grain = _SYL_REDUCE_GRAIN;
+	if ((Count + Job.Grain - 1) / Job.Grain > _SYL_REDUCE_MAX_CHUNKS)
+		Job.Grain = (Count + _SYL_REDUCE_MAX_CHUNKS - 1) / _SYL_REDUCE_MAX_CHUNKS;
+	Job.In = In;
+	Job.Weights = Weights;
+	Job.Partials = Partials;
+	Chunks = (Count + Job.Grain - 1) / Job.Grain;
+
+#if defined(SYL_THREADS)
+	s_parallel_for(Count, Job.Grain, _s_vec_reduce_chunks, &Job);
+#else
+	for (c = 0; c < Chunks; ++c)
+		_s_vec_reduce_chunks(c * Job.Grain, (c + 1 == Chunks) ? Count : (c + 1) * Job.Grain, 0, &Job);
+#endif
+
+	for (Width = 1; Width < Chunks; Width *= 2) {
+		for (c = 0; c + Width < Chunks; c += 2 * Width) {
+			_svec_reduce* a = &Partials[c];
+			_svec_reduce* b = &Partials[c + Width];
+			for (k = 0; k < Dims; ++k) {
+				a->Min[k] = b->Min[k] < a->Min[k] ? b->Min[k] : a->Min[k];
+				a->Max[k] = b->Max[k] > a->Max[k] ? b->Max[k] : a->Max[k];
+				a->Sum[k] += b->Sum[k];
+			}
+			a->Weight += b->Weight;
+		}
+	}
+	*Result = Partials[0];
+}
+
+SYL_INLINE svec2 s_vec2_min_array(const svec2* In, int Count)
+{
+	_SYL_PROFILE(s_vec2_min_array);
+	_svec_reduce R;
+	_s_vec_reduce(_S_REDUCE_MIN, 2, In->e, NULL, Count, &R);
+	svec2 Result = { { R.Min[0], R.Min[1] } };
+	return(Result);
+}
+
+SYL_INLINE svec2 s_vec2_max_array(const svec2* In, int Count)
+{
+	_SYL_PROFILE(s_vec2_max_array);
+	_svec_reduce R;
+	_s_vec_reduce(_S_REDUCE_MAX, 2, In->e, NULL, Count, &R);
+	svec2 Result = { { R.Max[0], R.Max[1] } };
+	return(Result);
+}
+
+SYL_INLINE void s_vec2_bounds_array(const svec2* In, int Count, svec2* Min, svec2* Max)
+{
+	_SYL_PROFILE(s_vec2_bounds_array);
+	_svec_reduce R;
+	int k;
+	_s_vec_reduce(_S_REDUCE_MIN | _S_REDUCE_MAX, 2, In->e, NULL, Count, &R);
+	for (k = 0; k < 2; ++k) {
+		Min->e[k] = R.Min[k];
+		Max->e[k] = R.Max[k];
+	}
+}
+
+SYL_INLINE svec2 s_vec2_sum_array(const svec2* In, int Count)
+{
+	_SYL_PROFILE(s_vec2_sum_array);
+	_svec_reduce R;
+	_s_vec_reduce(_S_REDUCE_SUM, 2, In->e, NULL, Count, &R);
+	svec2 Result = { { (float)R.Sum[0], (float)R.Sum[1] } };
+	return(Result);
+}
+
+SYL_INLINE svec2 s_vec2_mean_array(const svec2* In, int Count)
+{
+	_SYL_PROFILE(s_vec2_mean_array);
+	return(s_vec2_centroid_array(In, NULL, Count));
+}
+
+SYL_INLINE svec2 s_vec2_centroid_array(const svec2* In, const float* Weights, int Count)
+{
+	_SYL_PROFILE(s_vec2_centroid_array);
+	_svec_reduce R;
+	_s_vec_reduce(_S_REDUCE_SUM, 2, In->e, Weights, Count, &R);
+	double Inv = R.Weight != 0.0 ? 1.0 / R.Weight : 0.0;
+	svec2 Result = { { (float)(R.Sum[0] * Inv), (float)(R.Sum[1] * Inv) } };
+	return(Result);
+}
+
+SYL_INLINE svec3 s_vec3_min_array(const svec3* In, int Count)
+{
+	_SYL_PROFILE(s_vec3_min_array);
+	_svec_reduce R;
+	_s_vec_reduce(_S_REDUCE_MIN, 3, In->e, NULL, Count, &R);
+	svec3 Result = { { R.Min[0], R.Min[1], R.Min[2] } };
+	return(Result);
+}
+
+SYL_INLINE svec3 s_vec3_max_array(const svec3* In, int Count)
+{
+	_SYL_PROFILE(s_vec3_max_array);
+	_svec_reduce R;
+	_s_vec_reduce(_S_REDUCE_MAX, 3, In->e, NULL, Count, &R);
+	svec3 Result = { { R.Max[0], R.Max[1], R.Max[2] } };
+	return(Result);
+}
+
+SYL_INLINE void s_vec3_bounds_array(const svec3* In, int Count, svec3* Min, svec3* Max)
+{
+	_SYL_PROFILE(s_vec3_bounds_array);
+	_svec_reduce R;
+	int k;
+	_s_vec_reduce(_S_REDUCE_MIN | _S_REDUCE_MAX, 3, In->e, NULL, Count, &R);
+	for (k = 0; k < 3; ++k) {
+		Min->e[k] = R.Min[k];
+		Max->e[k] = R.Max[k];
+	}
+}
+
+SYL_INLINE svec3 s_vec3_sum_array(const svec3* In, int Count)
+{
+	_SYL_PROFILE(s_vec3_sum_array);
+	_svec_reduce R;
+	_s_vec_reduce(_S_REDUCE_SUM, 3, In->e, NULL, Count, &R);
+	svec3 Result = { { (float)R.Sum[0], (float)R.Sum[1], (float)R.Sum[2] } };
+	return(Result);
+}
+
+SYL_INLINE svec3 s_vec3_mean_array(const svec3* In, int Count)
+{
+	_SYL_PROFILE(s_vec3_mean_array);
+	return(s_vec3_centroid_array(In, NULL, Count));
+}
+
+SYL_INLINE svec3 s_vec3_centroid_array(const svec3* In, const float* Weights, int Count)
+{
+	_SYL_PROFILE(s_vec3_centroid_array);
+	_svec_reduce R;
+	_s_vec_reduce(_S_REDUCE_SUM, 3, In->e, Weights, Count, &R);
+	double Inv = R.Weight != 0.0 ? 1.0 / R.Weight : 0.0;
+	svec3 Result = { { (float)(R.Sum[0] * Inv), (float)(R.Sum[1] * Inv), (float)(R.Sum[2] * Inv) } };
+	return(Result);
+}
+
+SYL_INLINE svec4 s_vec4_min_array(const svec4* In, int Count)
+{
+	_SYL_PROFILE(s_vec4_min_array);
+	_svec_reduce R;
+	_s_vec_reduce(_S_REDUCE_MIN, 4, In->e, NULL, Count, &R);
+	svec4 Result = { { R.Min[0], R.Min[1], R.Min[2], R.Min[3] } };
+	return(Result);
+}
+
+SYL_INLINE svec4 s_vec4_max_array(const svec4* In, int Count)
+{
+	_SYL_PROFILE(s_vec4_max_array);
+	_svec_reduce R;
+	_s_vec_reduce(_S_REDUCE_MAX, 4, In->e, NULL, Count, &R);
+	svec4 Result = { { R.Max[0], R.Max[1], R.Max[2], R.Max[3] } };
+	return(Result);
+}
+
+SYL_INLINE void s_vec4_bounds_array(const svec4* In, int Count, svec4* Min, svec4* Max)
+{
+	_SYL_PROFILE(s_vec4_bounds_array);
+	_svec_reduce R;
+	int k;
+	_s_vec_reduce(_S_REDUCE_MIN | _S_REDUCE_MAX, 4, In->e, NULL, Count, &R);
+	for (k = 0; k < 4; ++k) {
+		Min->e[k] = R.Min[k];
+		Max->e[k] = R.Max[k];
+	}
+}
+
+SYL_INLINE svec4 s_vec4_sum_array(const svec4* In, int Count)
+{
+	_SYL_PROFILE(s_vec4_sum_array);
+	_svec_reduce R;
+	_s_vec_reduce(_S_REDUCE_SUM, 4, In->e, NULL, Count, &R);
+	svec4 Result = { { (float)R.Sum[0], (float)R.Sum[1], (float)R.Sum[2], (float)R.Sum[3] } };
+	return(Result);
+}
+
+SYL_INLINE svec4 s_vec4_mean_array(const svec4* In, int Count)
+{
+	_SYL_PROFILE(s_vec4_mean_array);
+	return(s_vec4_centroid_array(In, NULL, Count));
+}
+
+SYL_INLINE svec4 s_vec4_centroid_array(const svec4* In, const float* Weights, int Count)
+{
+	_SYL_PROFILE(s_vec4_centroid_array);
+	_svec_reduce R;
+	_s_vec_reduce(_S_REDUCE_SUM, 4, In->e, Weights, Count, &R);
+	double Inv = R.Weight != 0.0 ? 1.0 / R.Weight : 0.0;
+	svec4 Result = { { (float)(R.Sum[0] * Inv), (float)(R.Sum[1] * Inv), (float)(R.Sum[2] * Inv), (float)(R.Sum[3] * Inv) } };
+	return(Result);
+}
+
+/*********************************************
+ *                  KD TREE                   *
+ *********************************************/
+
+/*
+ * The tree is implicit. Node i has children 2i+1 and 2i+2 and splits its
+ * point range at the median, the left child gets Count / 2 points. A range
+ * of _SYL_KDTREE_LEAF points or less is a leaf, so leaves hold 8 to 16 points
+ * and only interior nodes are stored. Ranges are recomputed while walking
+ * down, a node only keeps its split plane.
+ *
+ * Leaves are scanned _SYL_LANES points at a time straight from the X, Y and Z
+ * arrays. The arrays are padded by _SYL_LANES so the last leaf can be read in
+ * full blocks, lanes past the end of a leaf are masked out.
+ *
+ * The build copies the points, then splits one level at a time. Nodes of a
+ * level own disjoint ranges so with SYL_THREADS they are split in parallel.
+ * The first levels have fewer nodes than workers, there a node's extent and
+ * median are found with s_parallel_for instead. Every partition pass splits
+ * the range in blocks, partitions the blocks on their own and then swaps the
+ * items that ended up on the wrong side of the total split.
+ */
+
+#define _SYL_KDTREE_LEAF 16
+/* Every level pushes at most one far child, the depth is below 32 */
+#define _SYL_KDTREE_STACK 64
+/* Nodes above this many points are split with parallel passes in the first levels */
+#define _SYL_KDTREE_WIDE 65536
+#define _SYL_KDTREE_BLOCKS 64
+
+typedef struct _skdtree_range
+{
+	int Node;
+	int Begin;
+	int Count;
+	float DistanceSq;
+} _skdtree_range;
+
+typedef struct _skdtree_build
+{
+	skdtree* Tree;
+	const svec3* Points;
+	int Level;
+} _skdtree_build;
+
+typedef struct _skdtree_partition
+{
+	skdtree* Tree;
+	const float* Key;
+	float Pivot;
+	/* Items <= Pivot go left instead of items < Pivot */
+	bool Inclusive;
+	int Lo;
+	int Grain;
+	int Left[_SYL_KDTREE_BLOCKS];
+	/* Per block, right items before the split and left items after it */
+	int StrayA[_SYL_KDTREE_BLOCKS], StrayB[_SYL_KDTREE_BLOCKS];
+	int SumA[_SYL_KDTREE_BLOCKS + 1], SumB[_SYL_KDTREE_BLOCKS + 1];
+} _skdtree_partition;
+
+typedef struct _skdtree_batch
+{
+	const skdtree* Tree;
+	const svec3* Points;
+	bool Radius;
+	int K;
+	float RadiusSq;
+	int* OutIndex;
+	float* OutDistanceSq;
+	int Capacity;
+	int* OutCount;
+} _skdtree_batch;
+
+/* Levels of interior nodes, ranges at level d hold at most ceil(Count / 2^d) points */
+SYL_INLINE int _s_kdtree_depth(int Count)
+{
+	int Depth = 0;
+	while (((long long)Count + (1ll << Depth) - 1) >> Depth > _SYL_KDTREE_LEAF)
+		++Depth;
+	return(Depth);
+}
+
+/* The bits of Node + 1 below the leading one are the path from the root, 1 goes right */
+SYL_INLINE void _s_kdtree_node_range(int Count, int Node, int Level, int* Begin, int* Size)
+{
+	int b = 0, n = Count, l;
+
+	for (l = Level - 1; l >= 0; --l) {
+		int Half = n / 2;
+		if (((Node + 1) >> l) & 1) {
+			b += Half;
+			n -= Half;
+		}
+		else
+			n = Half;
+	}
+	*Begin = b;
+	*Size = n;
+}
+
+_SYL_FORCE_INLINE void _s_kdtree_swap(skdtree* Tree, int a, int b)
+{
+	float t;
+	int i;
+
+	t = Tree->X[a]; Tree->X[a] = Tree->X[b]; Tree->X[b] = t;
+	t = Tree->Y[a]; Tree->Y[a] = Tree->Y[b]; Tree->Y[b] = t;
+	t = Tree->Z[a]; Tree->Z[a] = Tree->Z[b]; Tree->Z[b] = t;
+	i = Tree->Index[a]; Tree->Index[a] = Tree->Index[b]; Tree->Index[b] = i;
+}
+
+/* Hoare quickselect on [Lo, Hi], afterwards [Lo, Kth) <= Key[Kth] <= (Kth, Hi] */
+SYL_INLINE void _s_kdtree_select(skdtree* Tree, const float* Key, int Lo, int Hi, int Kth)
+{
+	while (Hi > Lo) {
+		float a = Key[Lo], b = Key[Lo + (Hi - Lo) / 2], c = Key[Hi];
+		float Pivot = a < b ? (b < c ? b : (a < c ? c : a)) : (a < c ? a : (b < c ? c : b));
+		int i = Lo, j = Hi;
+
+		while (i <= j) {
+			while (Key[i] < Pivot)
+				++i;
+			while (Key[j] > Pivot)
+				--j;
+			if (i <= j)
+				_s_kdtree_swap(Tree, i++, j--);
+		}
+		if (Kth <= j)
+			Hi = j;
+		else if (Kth >= i)
+			Lo = i;
+		else
+			break;
+	}
+}
+
+SYL_INLINE void _s_kdtree_copy(int Begin, int End, int WorkerIndex, void* UserData)
+{
+	_skdtree_build* Build = (_skdtree_build*)UserData;
+	skdtree* Tree = Build->Tree;
+	int i;
+	(void)WorkerIndex;
+
+	for (i = Begin; i < End; ++i) {
+		Tree->X[i] = Build->Points[i].x;
+		Tree->Y[i] = Build->Points[i].y;
+		Tree->Z[i] = Build->Points[i].z;
+		Tree->Index[i] = i;
+	}
+}
+
+#if defined(SYL_THREADS)
+SYL_INLINE void _s_kdtree_partition_blocks(int Begin, int End, int WorkerIndex, void* UserData)
+{
+	_skdtree_partition* P = (_skdtree_partition*)UserData;
+	const float* Key = P->Key;
+	float Pivot = P->Pivot;
+	int i = P->Lo + Begin, j = P->Lo + End - 1;
+	(void)WorkerIndex;
+
+	for (;;) {
+		if (P->Inclusive) {
+			while (i <= j && Key[i] <= Pivot)
+				++i;
+			while (i <= j && !(Key[j] <= Pivot))
+				--j;
+		}
+		else {
+			while (i <= j && Key[i] < Pivot)
+				++i;
+			while (i <= j && !(Key[j] < Pivot))
+				--j;
+		}
+		if (i >= j)
+			break;
+		_s_kdtree_swap(P->Tree, i++, j--);
+	}
+	P->Left[Begin / P->Grain] = i - (P->Lo + Begin);
+}
+
+/* The t-th stray of A is swapped with the t-th stray of B */
+SYL_INLINE void _s_kdtree_partition_strays(int Begin, int End, int WorkerIndex, void* UserData)
+{
+	_skdtree_partition* P = (_skdtree_partition*)UserData;
+	int a = 0, b = 0, t;
+	(void)WorkerIndex;
+
+	while (P->SumA[a + 1] <= Begin)
+		++a;
+	while (P->SumB[b + 1] <= Begin)
+		++b;
+	for (t = Begin; t < End; ++t) {
+		while (P->SumA[a + 1] <= t)
+			++a;
+		while (P->SumB[b + 1] <= t)
+			++b;
+		_s_kdtree_swap(P->Tree, P->StrayA[a] + t - P->SumA[a], P->StrayB[b] + t - P->SumB[b]);
+	}
+}
+
+/* Moves the items below Pivot in [Lo, Hi] to the front, returns the first index of the rest */
+SYL_INLINE int _s_kdtree_partition(skdtree* Tree, const float* Key, int Lo, int Hi, float Pivot, bool Inclusive)
+{
+	_skdtree_partition P;
+	int Count = Hi - Lo + 1, Blocks, Split, b;
+
+	P.Tree = Tree;
+	P.Key = Key;
+	P.Pivot = Pivot;
+	P.Inclusive = Inclusive;
+	P.Lo = Lo;
+	P.Grain = (Count + _SYL_KDTREE_BLOCKS - 1) / _SYL_KDTREE_BLOCKS;
+	Blocks = (Count + P.Grain - 1) / P.Grain;
+	s_parallel_for(Count, P.Grain, _s_kdtree_partition_blocks, &P);
+
+	Split = Lo;
+	for (b = 0; b < Blocks; ++b)
+		Split += P.Left[b];
+
+	P.SumA[0] = P.SumB[0] = 0;
+	for (b = 0; b < Blocks; ++b) {
+		int First = Lo + b * P.Grain;
+		int Last = (b + 1 == Blocks) ? Hi + 1 : First + P.Grain;
+		int Middle = First + P.Left[b];
+		int EndA = Last < Split ? Last : Split;
+		P.StrayA[b] = Middle;
+		P.StrayB[b] = First > Split ? First : Split;
+		P.SumA[b + 1] = P.SumA[b] + (EndA > Middle ? EndA - Middle : 0);
+		P.SumB[b + 1] = P.SumB[b] + (Middle > P.StrayB[b] ? Middle - P.StrayB[b] : 0);
+	}
+	if (P.SumA[Blocks] > 0)
+		s_parallel_for(P.SumA[Blocks], 4096, _s_kdtree_partition_strays, &P);
+	return(Split);
+}
+
+/* Like _s_kdtree_select, ranges above _SYL_KDTREE_WIDE are partitioned in parallel */
+SYL_INLINE void _s_kdtree_select_wide(skdtree* Tree, const float* Key, int Lo, int Hi, int Kth)
+{
+	while (Hi - Lo + 1 > _SYL_KDTREE_WIDE) {
+		float a = Key[Lo], b = Key[Lo + (Hi - Lo) / 2], c = Key[Hi];
+		float Pivot = a < b ? (b < c ? b : (a < c ? c : a)) : (a < c ? a : (b < c ? c : b));
+		int Split = _s_kdtree_partition(Tree, Key, Lo, Hi, Pivot, false);
+
+		if (Split == Lo) {
+			/* Pivot is the smallest key, take the run equal to it off the front */
+			Split = _s_kdtree_partition(Tree, Key, Lo, Hi, Pivot, true);
+			if (Split == Lo)
+				break;
+			if (Kth < Split)
+				return;
+		}
+		if (Kth < Split)
+			Hi = Split - 1;
+		else
+			Lo = Split;
+	}
+	_s_kdtree_select(Tree, Key, Lo, Hi, Kth);
+}
+#endif
+
+/* Split Node along the axis with the largest extent, Wide nodes use every worker */
+SYL_INLINE void _s_kdtree_split_node(skdtree* Tree, int Node, int Level, bool Wide)
+{
+	float* Axes[3] = { Tree->X, Tree->Y, Tree->Z };
+	int First, Count, Axis = 0, k;
+	float Extent = -1.0f;
+
+	Tree->Nodes[Node].Split = 0.0f;
+	Tree->Nodes[Node].Axis = 0;
+	_s_kdtree_node_range(Tree->Count, Node, Level, &First, &Count);
+	if (Count <= _SYL_KDTREE_LEAF)
+		return;
+
+	for (k = 0; k < 3; ++k) {
+		_svec_reduce R;
+		if (Wide)
+			_s_vec_reduce(_S_REDUCE_MIN | _S_REDUCE_MAX, 1, Axes[k] + First, NULL, Count, &R);
+		else
+			_s_vec_reduce_flat(_S_REDUCE_MIN | _S_REDUCE_MAX, 1, Axes[k] + First, Count, &R);
+		if (R.Max[0] - R.Min[0] > Extent) {
+			Extent = R.Max[0] - R.Min[0];
+			Axis = k;
+		}
+	}
+
+#if defined(SYL_THREADS)
+	if (Wide)
+		_s_kdtree_select_wide(Tree, Axes[Axis], First, First + Count - 1, First + Count / 2);
+	else
+#endif
+		_s_kdtree_select(Tree, Axes[Axis], First, First + Count - 1, First + Count / 2);
+	Tree->Nodes[Node].Split = Axes[Axis][First + Count / 2];
+	Tree->Nodes[Node].Axis = Axis;
+}
+
+/* Split nodes [Begin, End) of the current level */
+SYL_INLINE void _s_kdtree_split(int Begin, int End, int WorkerIndex, void* UserData)
+{
+	_skdtree_build* Build = (_skdtree_build*)UserData;
+	int i;
+	(void)WorkerIndex;
+
+	for (i = Begin; i < End; ++i)
+		_s_kdtree_split_node(Build->Tree, (1 << Build->Level) - 1 + i, Build->Level, false);
+}
+
+/*
+ * Without Radius the K nearest points are kept sorted by distance in OutIndex
+ * and OutDistanceSq. With Radius every point within it is appended until
+ * Capacity is reached. Returns the number of points found, which can be more
+ * than Capacity for radius queries.
+ */
+_SYL_FORCE_INLINE int _s_kdtree_query(const skdtree* Tree, const float* Point, bool Radius, int K, float RadiusSq, int* OutIndex, float* OutDistanceSq, int Capacity)
+{
+	_skdtree_range Stack[_SYL_KDTREE_STACK];
+	_snf PX = _s_nf_set1(Point[0]), PY = _s_nf_set1(Point[1]), PZ = _s_nf_set1(Point[2]);
+	float Block[_SYL_LANES];
+	float Limit = Radius ? RadiusSq : INFINITY;
+	int Top = 1, Found = 0, j, l;
+
+	if (Tree->Count <= 0 || (!Radius && K <= 0))
+		return(0);
+
+	Stack[0].Node = 0;
+	Stack[0].Begin = 0;
+	Stack[0].Count = Tree->Count;
+	Stack[0].DistanceSq = 0.0f;
+
+	while (Top > 0) {
+		_skdtree_range r = Stack[--Top];
+		if (Radius ? r.DistanceSq > Limit : r.DistanceSq >= Limit)
+			continue;
+
+		while (r.Count > _SYL_KDTREE_LEAF) {
+			skdtree_node Node = Tree->Nodes[r.Node];
+			int Half = r.Count / 2;
+			float Diff = Point[Node.Axis] - Node.Split;
+			_skdtree_range Near, Far;
+
+			Near.Node = 2 * r.Node + 1;
+			Near.Begin = r.Begin;
+			Near.Count = Half;
+			Far.Node = 2 * r.Node + 2;
+			Far.Begin = r.Begin + Half;
+			Far.Count = r.Count - Half;
+			if (Diff >= 0.0f) {
+				_skdtree_range t = Near;
+				Near = Far;
+				Far = t;
+			}
+			Near.DistanceSq = r.DistanceSq;
+			Far.DistanceSq = r.DistanceSq > Diff * Diff ? r.DistanceSq : Diff * Diff;
+			if (Radius ? Far.DistanceSq <= Limit : Far.DistanceSq < Limit)
+				Stack[Top++] = Far;
+			r = Near;
+		}
+
+		for (j = 0; j < r.Count; j += _SYL_LANES) {
+			int First = r.Begin + j;
+			_snf dx = _s_nf_sub(_s_nf_load(Tree->X + First), PX);
+			_snf dy = _s_nf_sub(_s_nf_load(Tree->Y + First), PY);
+			_snf dz = _s_nf_sub(_s_nf_load(Tree->Z + First), PZ);
+			_snf Distance = _s_nf_madd(dz, dz, _s_nf_madd(dy, dy, _s_nf_mul(dx, dx)));
+			int Rest = r.Count - j < _SYL_LANES ? r.Count - j : _SYL_LANES;
+			int Bits = Radius ? ~_s_nm_bits(_s_nf_gt(Distance, _s_nf_set1(Limit))) : _s_nm_bits(_s_nf_gt(_s_nf_set1(Limit), Distance));
+
+			Bits &= (1 << Rest) - 1;
+			if (!Bits)
+				continue;
+
+			_s_nf_store(Block, Distance);
+			for (l = 0; l < Rest; ++l) {
+				if (!((Bits >> l) & 1))
+					continue;
+				if (Radius) {
+					if (Found < Capacity) {
+						OutIndex[Found] = Tree->Index[First + l];
+						if (OutDistanceSq)
+							OutDistanceSq[Found] = Block[l];
+					}
+					++Found;
+				}
+				else if (Block[l] < Limit) {
+					/* Insert sorted, a full list drops its farthest point */
+					int n = Found < K ? Found++ : K - 1;
+					while (n > 0 && OutDistanceSq[n - 1] > Block[l]) {
+						OutDistanceSq[n] = OutDistanceSq[n - 1];
+						OutIndex[n] = OutIndex[n - 1];
+						--n;
+					}
+					OutDistanceSq[n] = Block[l];
+					OutIndex[n] = Tree->Index[First + l];
+					if (Found == K)
+						Limit = OutDistanceSq[K - 1];
+				}
+			}
+		}
+	}
+	return(Found);
+}
+
+SYL_INLINE void _s_kdtree_batch(int Begin, int End, int WorkerIndex, void* UserData)
+{
+	_skdtree_batch* Batch = (_skdtree_batch*)UserData;
+	int i, j;
+	(void)WorkerIndex;
+
+	for (i = Begin; i < End; ++i) {
+		int* Index = Batch->OutIndex + (size_t)i * Batch->Capacity;
+		float* Distance = Batch->OutDistanceSq ? Batch->OutDistanceSq + (size_t)i * Batch->Capacity : NULL;
+		int Found = _s_kdtree_query(Batch->Tree, Batch->Points[i].e, Batch->Radius, Batch->K, Batch->RadiusSq, Index, Distance, Batch->Capacity);
+
+		if (Batch->Radius) {
+			Batch->OutCount[i] = Found;
+			continue;
+		}
+		for (j = Found; j < Batch->K; ++j) {
+			Index[j] = -1;
+			Distance[j] = INFINITY;
+		}
+	}
+}
+
+SYL_INLINE void _s_kdtree_run_batch(_skdtree_batch* Batch, int Count)
+{
+#if defined(SYL_THREADS)
+	s_parallel_for(Count, 64, _s_kdtree_batch, Batch);
+#else
+	_s_kdtree_batch(0, Count, 0, Batch);
+#endif
+}
+
+/* Bytes s_kdtree_build needs for Count points */
+SYL_INLINE size_t s_kdtree_memory_size(int Count)
+{
+	_SYL_PROFILE(s_kdtree_memory_size);
+	if (Count < 0)
+		Count = 0;
+	size_t Nodes = ((size_t)1 << _s_kdtree_depth(Count)) - 1;
+	return(3 * ((size_t)Count + _SYL_LANES) * sizeof(float) + (size_t)Count * sizeof(int) + Nodes * sizeof(skdtree_node));
+}
+
+SYL_INLINE void s_kdtree_build(skdtree* Tree, void* Memory, const svec3* Points, int Count)
+{
+	_SYL_PROFILE(s_kdtree_build);
+	_skdtree_build Build;
+	size_t Padded;
+	int Level, k;
+
+	if (Count < 0)
+		Count = 0;
+	Padded = (size_t)Count + _SYL_LANES;
+	Tree->X = (float*)Memory;
+	Tree->Y = Tree->X + Padded;
+	Tree->Z = Tree->Y + Padded;
+	Tree->Index = (int*)(Tree->Z + Padded);
+	Tree->Nodes = (skdtree_node*)(Tree->Index + Count);
+	Tree->Count = Count;
+	Tree->Depth = _s_kdtree_depth(Count);
+	for (k = 0; k < _SYL_LANES; ++k) {
+		Tree->X[Count + k] = 0.0f;
+		Tree->Y[Count + k] = 0.0f;
+		Tree->Z[Count + k] = 0.0f;
+	}
+
+	Build.Tree = Tree;
+	Build.Points = Points;
+	Build.Level = 0;
+#if defined(SYL_THREADS)
+	s_parallel_for(Count, 16384, _s_kdtree_copy, &Build);
+	for (Level = 0; Level < Tree->Depth; ++Level) {
+		Build.Level = Level;
+		if ((1 << Level) < s_threads_count() && (Count >> Level) > _SYL_KDTREE_WIDE) {
+			for (k = 0; k < (1 << Level); ++k)
+				_s_kdtree_split_node(Tree, (1 << Level) - 1 + k, Level, true);
+		}
+		else
+			s_parallel_for(1 << Level, ((1 << Level) + 255) / 256, _s_kdtree_split, &Build);
+	}
+#else
+	_s_kdtree_copy(0, Count, 0, &Build);
+	for (Level = 0; Level < Tree->Depth; ++Level) {
+		Build.Level = Level;
+		_s_kdtree_split(0, 1 << Level, 0, &Build);
+	}
+#endif
+}
+
+/* K nearest points sorted by distance, returns how many were found */
+SYL_INLINE int s_kdtree_nearest(const skdtree* Tree, svec3 Point, int K, int* OutIndex, float* OutDistanceSq)
+{
+	_SYL_PROFILE(s_kdtree_nearest);
+	return(_s_kdtree_query(Tree, Point.e, false, K, 0.0f, OutIndex, OutDistanceSq, K));
+}
+
+/* Points within Radius in no particular order, returns the total even past Capacity */
+SYL_INLINE int s_kdtree_radius(const skdtree* Tree, svec3 Point, float Radius, int* OutIndex, float* OutDistanceSq, int Capacity)
+{
+	_SYL_PROFILE(s_kdtree_radius);
+	return(_s_kdtree_query(Tree, Point.e, true, 0, Radius * Radius, OutIndex, OutDistanceSq, Capacity));
+}
+
+SYL_INLINE void s_kdtree_nearest_batch(const skdtree* Tree, const svec3* Points, int Count, int K, int* OutIndex, float* OutDistanceSq)
+{
+	_SYL_PROFILE(s_kdtree_nearest_batch);
+	_skdtree_batch Batch;
+
+	if (K <= 0)
+		return;
+	Batch.Tree = Tree;
+	Batch.Points = Points;
+	Batch.Radius = false;
+	Batch.K = K;
+	Batch.RadiusSq = 0.0f;
+	Batch.OutIndex = OutIndex;
+	Batch.OutDistanceSq = OutDistanceSq;
+	Batch.Capacity = K;
+	Batch.OutCount = NULL;
+	_s_kdtree_run_batch(&Batch, Count);
+}
+
+SYL_INLINE void s_kdtree_radius_batch(const skdtree* Tree, const svec3* Points, int Count, float Radius, int* OutIndex, float* OutDistanceSq, int Capacity, int* OutCount)
+{
+	_SYL_PROFILE(s_kdtree_radius_batch);
+	_skdtree_batch Batch;
+
+	Batch.Tree = Tree;
+	Batch.Points = Points;
+	Batch.Radius = true;
+	Batch.K = 0;
+	Batch.RadiusSq = Radius * Radius;
+	Batch.OutIndex = OutIndex;
+	Batch.OutDistanceSq = OutDistanceSq;
+	Batch.Capacity = Capacity;
+	Batch.OutCount = OutCount;
+	_s_kdtree_run_batch(&Batch, Count);
+}
+
+/*********************************************
+ *               SPATIAL HASH                 *
+ *********************************************/
+
+/*
+ * Points are bucketed by the hash of their cell, cells are CellSize wide.
+ * Different cells can share a bucket, so scans always test the distance.
+ * The build is a counting sort over bucket keys. Keys are computed in SIMD
+ * blocks, counted, turned into bucket starts and the points are scattered in
+ * bucket order into padded SoA arrays. Points keep their input order inside a
+ * bucket. The memory block also holds the keys and a record per point used
+ * during the build. With SYL_THREADS large builds count and scatter per chunk
+ * on the top key bits first, then sort every digit's records in parallel.
+ *
+ * A query visits the distinct buckets of the 27 cells around it, so any point
+ * within CellSize is found exactly once. Neighbors along x have adjacent keys,
+ * so the buckets merge into at most 9 contiguous point ranges. Pairs are only
+ * emitted by the point with the lower sorted position. Points of the same cell
+ * follow each other and share their ranges.
+ */
+
+/* x is not scrambled, a row of cells maps to adjacent buckets */
+#define _SYL_HASH_Y 19349663u
+#define _SYL_HASH_Z 83492791u
+
+/* With SYL_THREADS larger builds sort by the top 8 key bits first, then every digit on its own */
+#define _SYL_HASHGRID_WIDE 65536
+#define _SYL_HASHGRID_CHUNKS 32
+#define _SYL_HASHGRID_DIGITS 256
+
+typedef struct _shashgrid_build
+{
+	shashgrid* Grid;
+	const svec3* Points;
+	float* Records;
+	int Grain;
+	int Shift;
+	/* Digit counts per chunk, turned into the chunk's first record of every digit */
+	int (*Histogram)[_SYL_HASHGRID_DIGITS];
+	int Digits[_SYL_HASHGRID_DIGITS + 1];
+} _shashgrid_build;
+
+/* Power of two with at least two buckets per point */
+SYL_INLINE int _s_hashgrid_table_size(int Count)
+{
+	int Size = 64;
+	while (Size < 2 * Count && Size < (1 << 30))
+		Size *= 2;
+	return(Size);
+}
+
+_SYL_FORCE_INLINE unsigned int _s_hashgrid_key(int x, int y, int z, int TableSize)
+{
+	return(((unsigned int)x + (unsigned int)y * _SYL_HASH_Y + (unsigned int)z * _SYL_HASH_Z) & (unsigned int)(TableSize - 1));
+}
+
+SYL_INLINE void _s_hashgrid_keys(int Begin, int End, int WorkerIndex, void* UserData)
+{
+	_shashgrid_build* Build = (_shashgrid_build*)UserData;
+	shashgrid* Grid = Build->Grid;
+	const float* In[3] = { Build->Points->e, Build->Points->e + 1, Build->Points->e + 2 };
+	_snf Inv = _s_nf_set1(Grid->InvCellSize);
+	unsigned int Block[_SYL_LANES];
+	_snf V[3];
+	int i, j;
+	(void)WorkerIndex;
+
+	for (i = Begin; i < End; i += _SYL_LANES) {
+		int Rest = End - i < _SYL_LANES ? End - i : _SYL_LANES;
+		_s_vec_load(In, 3, 3, i, Rest, V);
+		_sni x = _s_nf_to_int(_s_nf_floor(_s_nf_mul(V[0], Inv)));
+		_sni y = _s_ni_mul(_s_nf_to_int(_s_nf_floor(_s_nf_mul(V[1], Inv))), _s_ni_set1(_SYL_HASH_Y));
+		_sni z = _s_ni_mul(_s_nf_to_int(_s_nf_floor(_s_nf_mul(V[2], Inv))), _s_ni_set1(_SYL_HASH_Z));
+		_sni Key = _s_ni_and(_s_ni_add(_s_ni_add(x, y), z), (unsigned int)(Grid->TableSize - 1));
+
+		if (Rest == _SYL_LANES) {
+			_s_ni_store(Grid->Keys + i, Key);
+			continue;
+		}
+		_s_ni_store(Block, Key);
+		for (j = 0; j < Rest; ++j)
+			Grid->Keys[i + j] = Block[j];
+	}
+}
+
+#if defined(SYL_THREADS)
+SYL_INLINE void _s_hashgrid_count(int Begin, int End, int WorkerIndex, void* UserData)
+{
+	_shashgrid_build* Build = (_shashgrid_build*)UserData;
+	int* Histogram = Build->Histogram[Begin / Build->Grain];
+	int i;
+
+	_s_hashgrid_keys(Begin, End, WorkerIndex, UserData);
+	memset(Histogram, 0, _SYL_HASHGRID_DIGITS * sizeof(int));
+	for (i = Begin; i < End; ++i)
+		Histogram[Build->Grid->Keys[i] >> Build->Shift]++;
+}
+
+SYL_INLINE void _s_hashgrid_scatter(int Begin, int End, int WorkerIndex, void* UserData)
+{
+	_shashgrid_build* Build = (_shashgrid_build*)UserData;
+	int* Next = Build->Histogram[Begin / Build->Grain];
+	int i;
+	(void)WorkerIndex;
+
+	for (i = Begin; i < End; ++i) {
+		float* Record = Build->Records + 4 * (size_t)Next[Build->Grid->Keys[i] >> Build->Shift]++;
+		Record[0] = Build->Points[i].x;
+		Record[1] = Build->Points[i].y;
+		Record[2] = Build->Points[i].z;
+		memcpy(Record + 3, &i, sizeof(int));
+	}
+}
+
+/* Counting sort of the records of every digit into its own range of buckets */
+SYL_INLINE void _s_hashgrid_digits(int Begin, int End, int WorkerIndex, void* UserData)
+{
+	_shashgrid_build* Build = (_shashgrid_build*)UserData;
+	shashgrid* Grid = Build->Grid;
+	int* Cells = Grid->Cells;
+	int d, i, k, Index;
+	(void)WorkerIndex;
+
+	for (d = Begin; d < End; ++d) {
+		int First = d << Build->Shift, Last = (d + 1) << Build->Shift;
+		int Start = Build->Digits[d];
+
+		memset(Cells + First, 0, (size_t)(Last - First) * sizeof(int));
+		for (i = Build->Digits[d]; i < Build->Digits[d + 1]; ++i) {
+			memcpy(&Index, Build->Records + 4 * (size_t)i + 3, sizeof(int));
+			Cells[Grid->Keys[Index]]++;
+		}
+		for (k = First; k < Last; ++k) {
+			int Size = Cells[k];
+			Cells[k] = Start;
+			Start += Size;
+		}
+		for (i = Build->Digits[d]; i < Build->Digits[d + 1]; ++i) {
+			const float* Record = Build->Records + 4 * (size_t)i;
+			int Slot;
+			memcpy(&Index, Record + 3, sizeof(int));
+			Slot = Cells[Grid->Keys[Index]]++;
+			Grid->X[Slot] = Record[0];
+			Grid->Y[Slot] = Record[1];
+			Grid->Z[Slot] = Record[2];
+			Grid->Index[Slot] = Index;
+		}
+		/* Every start moved to its end, shift them back */
+		for (k = Last - 1; k > First; --k)
+			Cells[k] = Cells[k - 1];
+		Cells[First] = Build->Digits[d];
+	}
+}
+
+/*
+ * Every chunk computes its keys and counts the top key bits, the prefix sum
+ * over digits and chunks gives every chunk its own slots, so the chunks
+ * scatter in parallel and keep input order. Digits own disjoint bucket
+ * ranges and are finished in parallel.
+ */
+SYL_INLINE void _s_hashgrid_sort_parallel(_shashgrid_build* Build)
+{
+	int Histogram[_SYL_HASHGRID_CHUNKS][_SYL_HASHGRID_DIGITS];
+	shashgrid* Grid = Build->Grid;
+	int Chunks, Start = 0, c, d;
+
+	Build->Histogram = Histogram;
+	Build->Grain = (Grid->Count + _SYL_HASHGRID_CHUNKS - 1) / _SYL_HASHGRID_CHUNKS;
+	Build->Shift = 0;
+	while ((Grid->TableSize >> Build->Shift) > _SYL_HASHGRID_DIGITS)
+		++Build->Shift;
+	Chunks = (Grid->Count + Build->Grain - 1) / Build->Grain;
+	s_parallel_for(Grid->Count, Build->Grain, _s_hashgrid_count, Build);
+
+	for (d = 0; d < _SYL_HASHGRID_DIGITS; ++d) {
+		Build->Digits[d] = Start;
+		for (c = 0; c < Chunks; ++c) {
+			int Size = Histogram[c][d];
+			Histogram[c][d] = Start;
+			Start += Size;
+		}
+	}
+	Build->Digits[_SYL_HASHGRID_DIGITS] = Start;
+
+	s_parallel_for(Grid->Count, Build->Grain, _s_hashgrid_scatter, Build);
+	s_parallel_for(_SYL_HASHGRID_DIGITS, 4, _s_hashgrid_digits, Build);
+	Grid->Cells[Grid->TableSize] = Grid->Count;
+}
+#endif
+
+/* Sorted point ranges [Ranges[2n], Ranges[2n + 1]) covering the buckets around a cell */
+SYL_INLINE int _s_hashgrid_ranges(const shashgrid* Grid, int x, int y, int z, int* Ranges)
+{
+	unsigned int Keys[27];
+	int KeyCount = 0, Count = 0, dx, dy, dz, i, j;
+
+	for (dz = -1; dz <= 1; ++dz)
+		for (dy = -1; dy <= 1; ++dy)
+			for (dx = -1; dx <= 1; ++dx)
+				Keys[KeyCount++] = _s_hashgrid_key(x + dx, y + dy, z + dz, Grid->TableSize);
+
+	for (i = 1; i < KeyCount; ++i) {
+		unsigned int Key = Keys[i];
+		for (j = i; j > 0 && Keys[j - 1] > Key; --j)
+			Keys[j] = Keys[j - 1];
+		Keys[j] = Key;
+	}
+
+	for (i = 0; i < KeyCount; i = j) {
+		for (j = i + 1; j < KeyCount && Keys[j] <= Keys[j - 1] + 1; ++j)
+			;
+		int First = Grid->Cells[Keys[i]], Last = Grid->Cells[Keys[j - 1] + 1];
+		if (First == Last)
+			continue;
+		Ranges[2 * Count] = First;
+		Ranges[2 * Count + 1] = Last;
+		++Count;
+	}
+	return(Count);
+}
+
+/* Bits of the points in [First, Last) from First within the radius */
+_SYL_FORCE_INLINE int _s_hashgrid_scan(const shashgrid* Grid, int First, int Last, _snf PX, _snf PY, _snf PZ, _snf RadiusSq)
+{
+	_snf dx = _s_nf_sub(_s_nf_load(Grid->X + First), PX);
+	_snf dy = _s_nf_sub(_s_nf_load(Grid->Y + First), PY);
+	_snf dz = _s_nf_sub(_s_nf_load(Grid->Z + First), PZ);
+	_snf Distance = _s_nf_madd(dz, dz, _s_nf_madd(dy, dy, _s_nf_mul(dx, dx)));
+	int Rest = Last - First < _SYL_LANES ? Last - First : _SYL_LANES;
+	return(~_s_nm_bits(_s_nf_gt(Distance, RadiusSq)) & ((1 << Rest) - 1));
+}
+
+/* Bytes s_hashgrid_build needs for Count points */
+SYL_INLINE size_t s_hashgrid_memory_size(int Count)
+{
+	_SYL_PROFILE(s_hashgrid_memory_size);
+	if (Count < 0)
+		Count = 0;
+	return(3 * ((size_t)Count + _SYL_LANES) * sizeof(float) + (size_t)Count * (sizeof(int) + sizeof(unsigned int) + 4 * sizeof(float)) +
+		((size_t)_s_hashgrid_table_size(Count) + 1) * sizeof(int));
+}
+
+SYL_INLINE void s_hashgrid_build(shashgrid* Grid, void* Memory, const svec3* Points, int Count, float CellSize)
+{
+	_SYL_PROFILE(s_hashgrid_build);
+	_shashgrid_build Build;
+	size_t Padded;
+	float* Records;
+	int* Cells;
+	int i, k;
+
+	if (Count < 0)
+		Count = 0;
+	Padded = (size_t)Count + _SYL_LANES;
+	Grid->X = (float*)Memory;
+	Grid->Y = Grid->X + Padded;
+	Grid->Z = Grid->Y + Padded;
+	Grid->Index = (int*)(Grid->Z + Padded);
+	Grid->Keys = (unsigned int*)(Grid->Index + Count);
+	Grid->Cells = (int*)(Grid->Keys + Count);
+	Grid->Count = Count;
+	Grid->TableSize = _s_hashgrid_table_size(Count);
+	Grid->CellSize = CellSize;
+	Grid->InvCellSize = 1.0f / CellSize;
+	Records = (float*)(Grid->Cells + Grid->TableSize + 1);
+	for (k = 0; k < _SYL_LANES; ++k) {
+		Grid->X[Count + k] = 0.0f;
+		Grid->Y[Count + k] = 0.0f;
+		Grid->Z[Count + k] = 0.0f;
+	}
+
+	Build.Grid = Grid;
+	Build.Points = Points;
+	Build.Records = Records;
+#if defined(SYL_THREADS)
+	if (Count >= _SYL_HASHGRID_WIDE && s_threads_count() > 1) {
+		_s_hashgrid_sort_parallel(&Build);
+		return;
+	}
+	s_parallel_for(Count, 16384, _s_hashgrid_keys, &Build);
+#else
+	_s_hashgrid_keys(0, Count, 0, &Build);
+#endif
+
+	/* Count into Cells[Key + 1], prefix sum to starts, scatter moves every start to its end */
+	Cells = Grid->Cells;
+	memset(Cells, 0, ((size_t)Grid->TableSize + 1) * sizeof(int));
+	for (i = 0; i < Count; ++i)
+		Cells[Grid->Keys[i] + 1]++;
+	for (k = 0; k < Grid->TableSize; ++k)
+		Cells[k + 1] += Cells[k];
+
+	/* One 16 byte record per point touches one cache line instead of four, the records are split afterwards */
+	for (i = 0; i < Count; ++i) {
+		float* Record = Records + 4 * (size_t)Cells[Grid->Keys[i]]++;
+		Record[0] = Points[i].x;
+		Record[1] = Points[i].y;
+		Record[2] = Points[i].z;
+		memcpy(Record + 3, &i, sizeof(int));
+	}
+	for (i = 0; i < Count; ++i) {
+		const float* Record = Records + 4 * (size_t)i;
+		Grid->X[i] = Record[0];
+		Grid->Y[i] = Record[1];
+		Grid->Z[i] = Record[2];
+		memcpy(Grid->Index + i, Record + 3, sizeof(int));
+	}
+	memmove(Cells + 1, Cells, (size_t)Grid->TableSize * sizeof(int));
+	Cells[0] = 0;
+}
+
+/* Points within Radius of Point, Radius can't be larger than CellSize. Returns the total even past Capacity */
+SYL_INLINE int s_hashgrid_radius(const shashgrid* Grid, svec3 Point, float Radius, int* OutIndex, int Capacity)
+{
+	_SYL_PROFILE(s_hashgrid_radius);
+	int Ranges[2 * 27];
+	_snf PX = _s_nf_set1(Point.x), PY = _s_nf_set1(Point.y), PZ = _s_nf_set1(Point.z);
+	_snf RadiusSq = _s_nf_set1(Radius * Radius);
+	int Found = 0, RangeCount, j, l, n;
+
+	if (Grid->Count <= 0)
+		return(0);
+	RangeCount = _s_hashgrid_ranges(Grid, (int)floorf(Point.x * Grid->InvCellSize), (int)floorf(Point.y * Grid->InvCellSize),
+		(int)floorf(Point.z * Grid->InvCellSize), Ranges);
+
+	for (n = 0; n < RangeCount; ++n) {
+		int Last = Ranges[2 * n + 1];
+		for (j = Ranges[2 * n]; j < Last; j += _SYL_LANES) {
+			int Bits = _s_hashgrid_scan(Grid, j, Last, PX, PY, PZ, RadiusSq);
+			for (l = 0; Bits; ++l, Bits >>= 1) {
+				if (!(Bits & 1))
+					continue;
+				if (Found < Capacity)
+					OutIndex[Found] = Grid->Index[j + l];
+				++Found;
+			}
+		}
+	}
+	return(Found);
+}
+
+/*
+ * Pairs within Radius found from the sorted points [Begin, End), Radius can't
+ * be larger than CellSize. Ranges don't share pairs so they can be run on
+ * different threads. Returns the total even past Capacity.
+ */
+SYL_INLINE int s_hashgrid_pairs(const shashgrid* Grid, float Radius, int Begin, int End, spair* Out, int Capacity)
+{
+	_SYL_PROFILE(s_hashgrid_pairs);
+	int Ranges[2 * 27];
+	_snf RadiusSq = _s_nf_set1(Radius * Radius);
+	int Found = 0, RangeCount = 0, x = 0, y = 0, z = 0, i, j, l, n;
+
+	if (Begin < 0)
+		Begin = 0;
+	if (End > Grid->Count)
+		End = Grid->Count;
+
+	for (i = Begin; i < End; ++i) {
+		int cx = (int)floorf(Grid->X[i] * Grid->InvCellSize);
+		int cy = (int)floorf(Grid->Y[i] * Grid->InvCellSize);
+		int cz = (int)floorf(Grid->Z[i] * Grid->InvCellSize);
+		_snf PX = _s_nf_set1(Grid->X[i]), PY = _s_nf_set1(Grid->Y[i]), PZ = _s_nf_set1(Grid->Z[i]);
+
+		if (i == Begin || cx != x || cy != y || cz != z) {
+			x = cx;
+			y = cy;
+			z = cz;
+			RangeCount = _s_hashgrid_ranges(Grid, x, y, z, Ranges);
+		}
+
+		for (n = 0; n < RangeCount; ++n) {
+			int First = Ranges[2 * n] > i ? Ranges[2 * n] : i + 1, Last = Ranges[2 * n + 1];
+			for (j = First; j < Last; j += _SYL_LANES) {
+				int Bits = _s_hashgrid_scan(Grid, j, Last, PX, PY, PZ, RadiusSq);
+				for (l = 0; Bits; ++l, Bits >>= 1) {
+					if (!(Bits & 1))
+						continue;
+					if (Found < Capacity) {
+						Out[Found].A = Grid->Index[i];
+						Out[Found].B = Grid->Index[j + l];
+					}
+					++Found;
+				}
+			}
+		}
+	}
+	return(Found);
+}
+
+/*********************************************
+ *              SWEEP AND PRUNE               *
+ *********************************************/
+
+/*
+ * Boxes are sorted by their minimum along the sweep axis, the axis with the
+ * largest variance of box centers. Between frames the order is kept and fixed
+ * with an insertion sort, which is close to linear while bodies move a little.
+ * A full sort only runs on the first update and when the sweep axis changes.
+ * The axis only changes when another one has clearly more variance so it
+ * doesn't flip between nearly equal axes every frame.
+ *
+ * A box is tested against the boxes after it until their minimum passes its
+ * maximum. The other two axes are tested _SYL_LANES boxes at a time. The
+ * arrays are padded with empty boxes so blocks can run past the end.
+ */
+
+#define _SYL_SAP_SWITCH 1.25f
+
+_SYL_FORCE_INLINE void _s_sap_swap(float* Key, int* Order, int a, int b)
+{
+	float k = Key[a];
+	int o = Order[a];
+	Key[a] = Key[b];
+	Key[b] = k;
+	Order[a] = Order[b];
+	Order[b] = o;
+}
+
+SYL_INLINE void _s_sap_insertion(float* Key, int* Order, int Lo, int Hi)
+{
+	int i, j;
+
+	for (i = Lo + 1; i <= Hi; ++i) {
+		float k = Key[i];
+		int o = Order[i];
+		for (j = i; j > Lo && Key[j - 1] > k; --j) {
+			Key[j] = Key[j - 1];
+			Order[j] = Order[j - 1];
+		}
+		Key[j] = k;
+		Order[j] = o;
+	}
+}
+
+/* Quicksort on [Lo, Hi], recursing into the smaller side keeps the stack logarithmic */
+SYL_INLINE void _s_sap_sort(float* Key, int* Order, int Lo, int Hi)
+{
+	while (Hi - Lo > 16) {
+		float a = Key[Lo], b = Key[Lo + (Hi - Lo) / 2], c = Key[Hi];
+		float Pivot = a < b ? (b < c ? b : (a < c ? c : a)) : (a < c ? a : (b < c ? c : b));
+		int i = Lo, j = Hi;
+
+		while (i <= j) {
+			while (Key[i] < Pivot)
+				++i;
+			while (Key[j] > Pivot)
+				--j;
+			if (i <= j)
+				_s_sap_swap(Key, Order, i++, j--);
+		}
+		if (j - Lo < Hi - i) {
+			_s_sap_sort(Key, Order, Lo, j);
+			Lo = i;
+		}
+		else {
+			_s_sap_sort(Key, Order, i, Hi);
+			Hi = j;
+		}
+	}
+	_s_sap_insertion(Key, Order, Lo, Hi);
+}
+
+/* Bytes s_sap_init needs for Count bodies */
+SYL_INLINE size_t s_sap_memory_size(int Count)
+{
+	_SYL_PROFILE(s_sap_memory_size);
+	if (Count < 0)
+		Count = 0;
+	return(6 * ((size_t)Count + _SYL_LANES) * sizeof(float) + (size_t)Count * sizeof(int));
+}
+
+/* Set up for Count bodies, has to run again when bodies are added or removed */
+SYL_INLINE void s_sap_init(ssap* Sap, void* Memory, int Count)
+{
+	_SYL_PROFILE(s_sap_init);
+	size_t Padded;
+	int i, k;
+
+	if (Count < 0)
+		Count = 0;
+	Padded = (size_t)Count + _SYL_LANES;
+	for (k = 0; k < 3; ++k) {
+		Sap->Min[k] = (float*)Memory + 2 * k * Padded;
+		Sap->Max[k] = Sap->Min[k] + Padded;
+		/* Padding never overlaps anything */
+		for (i = Count; i < Count + _SYL_LANES; ++i) {
+			Sap->Min[k][i] = INFINITY;
+			Sap->Max[k][i] = -INFINITY;
+		}
+	}
+	Sap->Order = (int*)((float*)Memory + 6 * Padded);
+	for (i = 0; i < Count; ++i)
+		Sap->Order[i] = i;
+	Sap->Count = Count;
+	Sap->Axis = -1;
+}
+
+/* Take the current bounds of every body and sort them again */
+SYL_INLINE void s_sap_update(ssap* Sap, const svec3* Min, const svec3* Max)
+{
+	_SYL_PROFILE(s_sap_update);
+	double Sum[3] = { 0.0, 0.0, 0.0 }, SumSq[3] = { 0.0, 0.0, 0.0 }, Variance[3];
+	int Count = Sap->Count, Axis = 0, i, k;
+
+	if (Count <= 0)
+		return;
+
+	for (i = 0; i < Count; ++i) {
+		for (k = 0; k < 3; ++k) {
+			double c = 0.5 * ((double)Min[i].e[k] + (double)Max[i].e[k]);
+			Sum[k] += c;
+			SumSq[k] += c * c;
+		}
+	}
+	for (k = 0; k < 3; ++k) {
+		Variance[k] = SumSq[k] / Count - (Sum[k] / Count) * (Sum[k] / Count);
+		if (Variance[k] > Variance[Axis])
+			Axis = k;
+	}
+	if (Sap->Axis >= 0 && Variance[Axis] <= _SYL_SAP_SWITCH * Variance[Sap->Axis])
+		Axis = Sap->Axis;
+
+	float* Key = Sap->Min[0];
+	for (i = 0; i < Count; ++i)
+		Key[i] = Min[Sap->Order[i]].e[Axis];
+	if (Axis != Sap->Axis)
+		_s_sap_sort(Key, Sap->Order, 0, Count - 1);
+	else
+		_s_sap_insertion(Key, Sap->Order, 0, Count - 1);
+	Sap->Axis = Axis;
+
+	for (i = 0; i < Count; ++i) {
+		int Body = Sap->Order[i];
+		Sap->Max[0][i] = Max[Body].e[Axis];
+		for (k = 1; k < 3; ++k) {
+			Sap->Min[k][i] = Min[Body].e[(Axis + k) % 3];
+			Sap->Max[k][i] = Max[Body].e[(Axis + k) % 3];
+		}
+	}
+}
+
+/*
+ * Overlapping boxes found from the sorted slots [Begin, End). Touching boxes
+ * overlap. Ranges don't share pairs so they can be run on different threads.
+ * Returns the total even past Capacity.
+ */
+SYL_INLINE int s_sap_pairs(const ssap* Sap, int Begin, int End, spair* Out, int Capacity)
+{
+	_SYL_PROFILE(s_sap_pairs);
+	const float *Min0 = Sap->Min[0], *Min1 = Sap->Min[1], *Min2 = Sap->Min[2];
+	const float *Max0 = Sap->Max[0], *Max1 = Sap->Max[1], *Max2 = Sap->Max[2];
+	int Found = 0, i, j, l;
+
+	if (Begin < 0)
+		Begin = 0;
+	if (End > Sap->Count)
+		End = Sap->Count;
+
+	for (i = Begin; i < End; ++i) {
+		_snf Limit = _s_nf_set1(Max0[i]);
+		_snf Lo1 = _s_nf_set1(Min1[i]), Hi1 = _s_nf_set1(Max1[i]);
+		_snf Lo2 = _s_nf_set1(Min2[i]), Hi2 = _s_nf_set1(Max2[i]);
+
+		/* The padding ends the sweep, its minimum is infinite */
+		for (j = i + 1; Min0[j] <= Max0[i]; j += _SYL_LANES) {
+			_snm Apart = _s_nf_gt(_s_nf_load(Min0 + j), Limit);
+			Apart = _s_nm_or(Apart, _s_nf_gt(_s_nf_load(Min1 + j), Hi1));
+			Apart = _s_nm_or(Apart, _s_nf_gt(Lo1, _s_nf_load(Max1 + j)));
+			Apart = _s_nm_or(Apart, _s_nf_gt(_s_nf_load(Min2 + j), Hi2));
+			Apart = _s_nm_or(Apart, _s_nf_gt(Lo2, _s_nf_load(Max2 + j)));
+			int Bits = ~_s_nm_bits(Apart) & ((1 << _SYL_LANES) - 1);
+
+			for (l = 0; Bits; ++l, Bits >>= 1) {
+				if (!(Bits & 1))
+					continue;
+				if (Found < Capacity) {
+					Out[Found].A = Sap->Order[i];
+					Out[Found].B = Sap->Order[j + l];
+				}
+				++Found;
+			}
+		}
+	}
+	return(Found);
+}
+
+/*********************************************
+ *                 GJK AND EPA                *
+ *********************************************/
+
+/*
+ * GJK works on the Minkowski difference A - B through the support functions
+ * of both shapes. Every simplex vertex keeps the support points on A and B
+ * and the direction it was found in. The closest point of the simplex to the
+ * origin is found with the Voronoi region tests from Ericson's Real-Time
+ * Collision Detection, which also drop the vertices that don't contribute.
+ *
+ * Warm starting rebuilds the simplex from the directions of the last one.
+ * Fresh support points are taken along them, so the cache stays valid when
+ * the shapes move. Coherent pairs usually finish in one or two iterations.
+ *
+ * EPA starts from the tetrahedron GJK ends with, blowing lower dimensional
+ * simplices up first, and grows the polytope towards the closest face until
+ * the support point doesn't get further than that face.
+ */
+
+#define _SYL_GJK_ITERATIONS 64
+#define _SYL_GJK_EPSILON 1e-6f
+#define _SYL_GJK_TOLERANCE 1e-5f
+#define _SYL_EPA_ITERATIONS 64
+#define _SYL_EPA_TOLERANCE 1e-4f
+#define _SYL_EPA_VERTICES 64
+#define _SYL_EPA_FACES 128
+
+
+typedef struct _sgjk_vertex
+{
+	svec3 A, B, W, Direction;
+} _sgjk_vertex;
+
+typedef struct _sgjk_simplex
+{
+	_sgjk_vertex V[4];
+	float L[4];
+	int Count;
+} _sgjk_simplex;
+
+typedef struct _sepa_face
+{
+	int V[3];
+	svec3 Normal;
+	float Distance;
+} _sepa_face;
+
+/* Index of the hull point furthest along Direction, _SYL_LANES points at a time */
+SYL_INLINE int _s_hull_support(const svec3* Points, int Count, svec3 Direction)
+{
+	const float* In[3] = { Points->e, Points->e + 1, Points->e + 2 };
+	_snf DX = _s_nf_set1(Direction.x), DY = _s_nf_set1(Direction.y), DZ = _s_nf_set1(Direction.z);
+	_snf Best = _s_nf_set1(-INFINITY), Lanes = _s_nf_ramp(0.0f, 1.0f);
+	_sni Index = _s_nf_to_int(Lanes), BestIndex = _s_ni_set1(0), Step = _s_ni_set1(_SYL_LANES);
+	float Values[_SYL_LANES];
+	unsigned int Indices[_SYL_LANES];
+	_snf V[3];
+	int i, l, Result = 0;
+
+	for (i = 0; i < Count; i += _SYL_LANES) {
+		int Rest = Count - i < _SYL_LANES ? Count - i : _SYL_LANES;
+		_s_vec_load(In, 3, 3, i, Rest, V);
+		_snf Dot = _s_nf_madd(V[2], DZ, _s_nf_madd(V[1], DY, _s_nf_mul(V[0], DX)));
+		/* Padded lanes never win */
+		Dot = _s_nf_select(_s_nf_gt(_s_nf_set1((float)Rest), Lanes), Dot, _s_nf_set1(-INFINITY));
+		_snm Better = _s_nf_gt(Dot, Best);
+		Best = _s_nf_select(Better, Dot, Best);
+		BestIndex = _s_ni_select(Better, Index, BestIndex);
+		Index = _s_ni_add(Index, Step);
+	}
+
+	_s_nf_store(Values, Best);
+	_s_ni_store(Indices, BestIndex);
+	for (l = 1; l < _SYL_LANES; ++l)
+		if (Values[l] > Values[Result])
+			Result = l;
+	return((int)Indices[Result]);
+}
+
+/* Support point in world space, the transform is applied as M * Support(M^T * Direction) */
+SYL_INLINE svec3 s_convex_support(const sconvex* Shape, svec3 Direction)
+{
+	_SYL_PROFILE(s_convex_support);
+	const smat3x4* M = &Shape->Transform;
+	svec3 d, p = SVEC3(0.0f, 0.0f, 0.0f), Result;
+	int k;
+
+	for (k = 0; k < 3; ++k)
+		d.e[k] = M->e2[0][k] * Direction.x + M->e2[1][k] * Direction.y + M->e2[2][k] * Direction.z;
+
+	switch (Shape->Type) {
+	case S_CONVEX_SPHERE:
+		break;
+	case S_CONVEX_BOX:
+		p.x = d.x >= 0.0f ? Shape->Extents.x : -Shape->Extents.x;
+		p.y = d.y >= 0.0f ? Shape->Extents.y : -Shape->Extents.y;
+		p.z = d.z >= 0.0f ? Shape->Extents.z : -Shape->Extents.z;
+		break;
+	case S_CONVEX_CAPSULE:
+		p.y = d.y >= 0.0f ? Shape->HalfHeight : -Shape->HalfHeight;
+		break;
+	case S_CONVEX_HULL:
+		if (Shape->PointCount > 0)
+			p = Shape->Points[_s_hull_support(Shape->Points, Shape->PointCount, d)];
+		break;
+	case S_CONVEX_CUSTOM:
+		p = Shape->Support(d, Shape->UserData);
+		break;
+	}
+
+	for (k = 0; k < 3; ++k)
+		Result.e[k] = M->e2[k][0] * p.x + M->e2[k][1] * p.y + M->e2[k][2] * p.z + M->e2[k][3];
+
+	/* The radius is in world units and rounds whatever the core shape is */
+	if (Shape->Radius > 0.0f) {
+		float Length = sqrtf(s_vec3_dot(Direction, Direction));
+		if (Length > 0.0f)
+			Result = s_vec3_add(Result, s_vec3_mul_scalar(Direction, Shape->Radius / Length));
+	}
+	return(Result);
+}
+
+_SYL_FORCE_INLINE _sgjk_vertex _s_gjk_support(const sconvex* A, const sconvex* B, svec3 Direction)
+{
+	_sgjk_vertex v;
+	v.A = s_convex_support(A, Direction);
+	v.B = s_convex_support(B, s_vec3_negate(Direction));
+	v.W = s_vec3_sub(v.A, v.B);
+	v.Direction = Direction;
+	return(v);
+}
+
+/* Closest point of triangle a b c to the origin, writes the contributing vertices to Out */
+SYL_INLINE svec3 _s_gjk_triangle(const _sgjk_vertex* a, const _sgjk_vertex* b, const _sgjk_vertex* c, _sgjk_simplex* Out)
+{
+	svec3 ab = s_vec3_sub(b->W, a->W), ac = s_vec3_sub(c->W, a->W);
+	float d1 = -s_vec3_dot(ab, a->W), d2 = -s_vec3_dot(ac, a->W);
+	float d3 = -s_vec3_dot(ab, b->W), d4 = -s_vec3_dot(ac, b->W);
+	float d5 = -s_vec3_dot(ab, c->W), d6 = -s_vec3_dot(ac, c->W);
+	float va, vb, vc, v, w, Denom;
+
+	if (d1 <= 0.0f && d2 <= 0.0f) {
+		Out->V[0] = *a; Out->L[0] = 1.0f; Out->Count = 1;
+		return(a->W);
+	}
+	if (d3 >= 0.0f && d4 <= d3) {
+		Out->V[0] = *b; Out->L[0] = 1.0f; Out->Count = 1;
+		return(b->W);
+	}
+	vc = d1 * d4 - d3 * d2;
+	if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f) {
+		v = d1 / (d1 - d3);
+		Out->V[0] = *a; Out->V[1] = *b; Out->L[0] = 1.0f - v; Out->L[1] = v; Out->Count = 2;
+		return(s_vec3_add(a->W, s_vec3_mul_scalar(ab, v)));
+	}
+	if (d6 >= 0.0f && d5 <= d6) {
+		Out->V[0] = *c; Out->L[0] = 1.0f; Out->Count = 1;
+		return(c->W);
+	}
+	vb = d5 * d2 - d1 * d6;
+	if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f) {
+		w = d2 / (d2 - d6);
+		Out->V[0] = *a; Out->V[1] = *c; Out->L[0] = 1.0f - w; Out->L[1] = w; Out->Count = 2;
+		return(s_vec3_add(a->W, s_vec3_mul_scalar(ac, w)));
+	}
+	va = d3 * d6 - d5 * d4;
+	if (va <= 0.0f && d4 - d3 >= 0.0f && d5 - d6 >= 0.0f) {
+		w = (d4 - d3) / ((d4 - d3) + (d5 - d6));
+		Out->V[0] = *b; Out->V[1] = *c; Out->L[0] = 1.0f - w; Out->L[1] = w; Out->Count = 2;
+		return(s_vec3_add(b->W, s_vec3_mul_scalar(s_vec3_sub(c->W, b->W), w)));
+	}
+
+	Denom = 1.0f / (va + vb + vc);
+	v = vb * Denom;
+	w = vc * Denom;
+	Out->V[0] = *a; Out->V[1] = *b; Out->V[2] = *c;
+	Out->L[0] = 1.0f - v - w; Out->L[1] = v; Out->L[2] = w;
+	Out->Count = 3;
+	return(s_vec3_add(a->W, s_vec3_add(s_vec3_mul_scalar(ab, v), s_vec3_mul_scalar(ac, w))));
+}
+
+/* Closest point of the simplex to the origin, the simplex is reduced to the vertices that contribute */
+SYL_INLINE svec3 _s_gjk_closest(_sgjk_simplex* S)
+{
+	static const int Faces[4][4] = { { 0, 1, 2, 3 }, { 0, 3, 1, 2 }, { 0, 2, 3, 1 }, { 1, 3, 2, 0 } };
+	_sgjk_simplex Best, Candidate;
+	svec3 Result, v;
+	float BestDistance = INFINITY;
+	int f;
+
+	switch (S->Count) {
+	case 1:
+		S->L[0] = 1.0f;
+		return(S->V[0].W);
+	case 2: {
+		svec3 ab = s_vec3_sub(S->V[1].W, S->V[0].W);
+		float Length = s_vec3_dot(ab, ab);
+		float t = Length > 0.0f ? -s_vec3_dot(S->V[0].W, ab) / Length : 0.0f;
+		if (t <= 0.0f) {
+			S->Count = 1;
+			S->L[0] = 1.0f;
+			return(S->V[0].W);
+		}
+		if (t >= 1.0f) {
+			S->V[0] = S->V[1];
+			S->Count = 1;
+			S->L[0] = 1.0f;
+			return(S->V[0].W);
+		}
+		S->L[0] = 1.0f - t;
+		S->L[1] = t;
+		return(s_vec3_add(S->V[0].W, s_vec3_mul_scalar(ab, t)));
+	}
+	case 3:
+		Result = _s_gjk_triangle(&S->V[0], &S->V[1], &S->V[2], &Best);
+		*S = Best;
+		return(Result);
+	}
+
+	/* The origin is inside unless it is beyond one of the faces, a flat tetrahedron has no inside */
+	Result = SVEC3(0.0f, 0.0f, 0.0f);
+	for (f = 0; f < 4; ++f) {
+		const _sgjk_vertex *a = &S->V[Faces[f][0]], *b = &S->V[Faces[f][1]], *c = &S->V[Faces[f][2]], *d = &S->V[Faces[f][3]];
+		svec3 n = s_vec3_cross(s_vec3_sub(b->W, a->W), s_vec3_sub(c->W, a->W));
+		float SideOrigin = -s_vec3_dot(a->W, n), SideOther = s_vec3_dot(s_vec3_sub(d->W, a->W), n);
+		if (SideOrigin * SideOther >= 0.0f && SideOther != 0.0f)
+			continue;
+
+		v = _s_gjk_triangle(a, b, c, &Candidate);
+		if (s_vec3_dot(v, v) < BestDistance) {
+			BestDistance = s_vec3_dot(v, v);
+			Best = Candidate;
+			Result = v;
+		}
+	}
+	if (BestDistance < INFINITY)
+		*S = Best;
+	return(Result);
+}
+
+_SYL_FORCE_INLINE svec3 _s_convex_center(const sconvex* Shape)
+{
+	return(SVEC3(Shape->Transform.e2[0][3], Shape->Transform.e2[1][3], Shape->Transform.e2[2][3]));
+}
+
+/* Vertices closer than the tolerance are the same point, adding them again makes the simplex degenerate */
+SYL_INLINE bool _s_gjk_contains(const _sgjk_simplex* S, svec3 w, float Scale)
+{
+	int k;
+	for (k = 0; k < S->Count; ++k) {
+		svec3 Delta = s_vec3_sub(w, S->V[k].W);
+		if (s_vec3_dot(Delta, Delta) <= _SYL_GJK_EPSILON * _SYL_GJK_EPSILON * Scale)
+			return(true);
+	}
+	return(false);
+}
+
+/*
+ * Runs GJK and leaves the last simplex in S. Returns true when the shapes
+ * intersect. With EarlyOut it stops as soon as a separating direction is
+ * seen, V is then not the closest point.
+ */
+SYL_INLINE bool _s_gjk(const sconvex* A, const sconvex* B, sgjk_cache* Cache, bool EarlyOut, _sgjk_simplex* S, svec3* V, int* Iterations)
+{
+	_sgjk_simplex Previous;
+	svec3 v, PreviousV = SVEC3(0.0f, 0.0f, 0.0f), d;
+	float Scale = 1e-12f, PreviousDistance = INFINITY;
+	bool Intersect = false;
+	int i, k;
+
+	S->Count = 0;
+	if (Cache) {
+		for (i = 0; i < Cache->Count && i < 4; ++i) {
+			_sgjk_vertex w = _s_gjk_support(A, B, Cache->Directions[i]);
+			Scale = Scale > s_vec3_dot(w.W, w.W) ? Scale : s_vec3_dot(w.W, w.W);
+			if (!_s_gjk_contains(S, w.W, Scale))
+				S->V[S->Count++] = w;
+		}
+	}
+	if (S->Count == 0) {
+		d = s_vec3_sub(_s_convex_center(B), _s_convex_center(A));
+		if (s_vec3_dot(d, d) == 0.0f)
+			d = SVEC3(1.0f, 0.0f, 0.0f);
+		S->V[0] = _s_gjk_support(A, B, d);
+		S->Count = 1;
+	}
+
+	for (i = 0; i < _SYL_GJK_ITERATIONS; ++i) {
+		v = _s_gjk_closest(S);
+		for (k = 0; k < S->Count; ++k)
+			Scale = Scale > s_vec3_dot(S->V[k].W, S->V[k].W) ? Scale : s_vec3_dot(S->V[k].W, S->V[k].W);
+
+		float vv = s_vec3_dot(v, v);
+		if (S->Count == 4 || vv <= _SYL_GJK_EPSILON * _SYL_GJK_EPSILON * Scale) {
+			Intersect = true;
+			break;
+		}
+		/* Rounding can make a degenerate simplex step away from the origin, keep the last good one */
+		if (vv >= PreviousDistance) {
+			*S = Previous;
+			v = PreviousV;
+			break;
+		}
+
+		d = s_vec3_negate(v);
+		_sgjk_vertex w = _s_gjk_support(A, B, d);
+		float vw = s_vec3_dot(v, w.W);
+		if (EarlyOut && vw > 0.0f)
+			break;
+		/* No progress towards the origin, v is the closest point */
+		if (vv - vw <= _SYL_GJK_TOLERANCE * vv || _s_gjk_contains(S, w.W, Scale))
+			break;
+
+		Previous = *S;
+		PreviousV = v;
+		PreviousDistance = vv;
+		S->V[S->Count++] = w;
+	}
+	/* Out of iterations, the last vertex was added without a closest point, drop it again */
+	if (i == _SYL_GJK_ITERATIONS) {
+		*S = Previous;
+		v = PreviousV;
+	}
+
+	if (Cache) {
+		Cache->Count = S->Count;
+		for (k = 0; k < S->Count; ++k)
+			Cache->Directions[k] = S->V[k].Direction;
+	}
+	*V = v;
+	if (Iterations)
+		*Iterations = i < _SYL_GJK_ITERATIONS ? i + 1 : i;
+	return(Intersect);
+}
+
+SYL_INLINE void _s_gjk_result(const _sgjk_simplex* S, svec3 v, bool Intersect, int Iterations, sgjk_result* Result)
+{
+	svec3 PA = SVEC3(0.0f, 0.0f, 0.0f), PB = SVEC3(0.0f, 0.0f, 0.0f);
+	int k;
+
+	for (k = 0; k < S->Count && !Intersect; ++k) {
+		PA = s_vec3_add(PA, s_vec3_mul_scalar(S->V[k].A, S->L[k]));
+		PB = s_vec3_add(PB, s_vec3_mul_scalar(S->V[k].B, S->L[k]));
+	}
+	Result->Intersect = Intersect;
+	Result->Iterations = Iterations;
+	Result->Depth = 0.0f;
+	Result->Distance = Intersect ? 0.0f : sqrtf(s_vec3_dot(v, v));
+	Result->Normal = Result->Distance > 0.0f ? s_vec3_mul_scalar(v, -1.0f / Result->Distance) : SVEC3(0.0f, 0.0f, 0.0f);
+	Result->PointA = PA;
+	Result->PointB = PB;
+}
+
+/* Adds supports until the simplex is a tetrahedron with volume, false when the shapes only touch */
+SYL_INLINE bool _s_epa_blowup(const sconvex* A, const sconvex* B, _sgjk_simplex* S)
+{
+	static const float Axes[6][3] = { { 1, 0, 0 }, { -1, 0, 0 }, { 0, 1, 0 }, { 0, -1, 0 }, { 0, 0, 1 }, { 0, 0, -1 } };
+	float Scale = 1e-12f;
+	int i, k;
+
+	for (k = 0; k < S->Count; ++k)
+		Scale = Scale > s_vec3_dot(S->V[k].W, S->V[k].W) ? Scale : s_vec3_dot(S->V[k].W, S->V[k].W);
+
+	while (S->Count < 4) {
+		svec3 Directions[8];
+		int DirectionCount = 0;
+
+		if (S->Count == 3) {
+			svec3 n = s_vec3_cross(s_vec3_sub(S->V[1].W, S->V[0].W), s_vec3_sub(S->V[2].W, S->V[0].W));
+			Directions[DirectionCount++] = n;
+			Directions[DirectionCount++] = s_vec3_negate(n);
+		}
+		else if (S->Count == 2) {
+			svec3 Edge = s_vec3_sub(S->V[1].W, S->V[0].W);
+			for (i = 0; i < 6; i += 2)
+				Directions[DirectionCount++] = s_vec3_cross(Edge, SVEC3(Axes[i][0], Axes[i][1], Axes[i][2]));
+		}
+		else {
+			for (i = 0; i < 6; ++i)
+				Directions[DirectionCount++] = SVEC3(Axes[i][0], Axes[i][1], Axes[i][2]);
+		}
+		if (S->Count == 2) {
+			for (i = 0; i < 3; ++i)
+				Directions[DirectionCount++] = s_vec3_negate(Directions[i]);
+		}
+
+		/* Keep the support that adds the most to the simplex */
+		float BestSize = 0.0f;
+		_sgjk_vertex Best;
+		for (i = 0; i < DirectionCount; ++i) {
+			if (s_vec3_dot(Directions[i], Directions[i]) == 0.0f)
+				continue;
+			_sgjk_vertex w = _s_gjk_support(A, B, Directions[i]);
+			svec3 e = s_vec3_sub(w.W, S->V[0].W);
+			float Size;
+			if (S->Count == 1)
+				Size = s_vec3_dot(e, e);
+			else if (S->Count == 2) {
+				svec3 c = s_vec3_cross(s_vec3_sub(S->V[1].W, S->V[0].W), e);
+				Size = s_vec3_dot(c, c);
+			}
+			else {
+				float Volume = s_vec3_dot(s_vec3_cross(s_vec3_sub(S->V[1].W, S->V[0].W), s_vec3_sub(S->V[2].W, S->V[0].W)), e);
+				Size = Volume * Volume;
+			}
+			if (Size > BestSize) {
+				BestSize = Size;
+				Best = w;
+			}
+		}
+		/* Sizes are lengths, areas and volumes squared */
+		float Threshold = _SYL_GJK_EPSILON * Scale;
+		for (k = 1; k < S->Count; ++k)
+			Threshold *= _SYL_GJK_EPSILON * Scale;
+		if (BestSize <= Threshold)
+			return(false);
+		S->V[S->Count++] = Best;
+	}
+	return(true);
+}
+
+SYL_INLINE bool _s_epa_face(const svec3* W, int a, int b, int c, svec3 Inside, _sepa_face* Face)
+{
+	svec3 n = s_vec3_cross(s_vec3_sub(W[b], W[a]), s_vec3_sub(W[c], W[a]));
+	float Length = sqrtf(s_vec3_dot(n, n));
+
+	if (Length <= 0.0f)
+		return(false);
+	n = s_vec3_mul_scalar(n, 1.0f / Length);
+	Face->V[0] = a;
+	Face->V[1] = b;
+	Face->V[2] = c;
+	if (s_vec3_dot(n, s_vec3_sub(W[a], Inside)) < 0.0f) {
+		Face->V[1] = c;
+		Face->V[2] = b;
+		n = s_vec3_negate(n);
+	}
+	Face->Normal = n;
+	Face->Distance = s_vec3_dot(n, W[a]);
+	return(true);
+}
+
+/* Penetration of intersecting shapes from the GJK simplex, fills the depth, normal and points */
+SYL_INLINE void _s_epa(const sconvex* A, const sconvex* B, _sgjk_simplex* S, sgjk_result* Result)
+{
+	static const int Start[4][3] = { { 0, 1, 2 }, { 0, 3, 1 }, { 0, 2, 3 }, { 1, 3, 2 } };
+	svec3 W[_SYL_EPA_VERTICES], PA[_SYL_EPA_VERTICES], PB[_SYL_EPA_VERTICES];
+	_sepa_face Faces[_SYL_EPA_FACES];
+	int Edges[3 * _SYL_EPA_FACES][2];
+	svec3 Inside = SVEC3(0.0f, 0.0f, 0.0f);
+	int VertexCount = 4, FaceCount = 0, Closest = 0, i, j, k, f;
+
+	Result->Depth = 0.0f;
+	Result->Distance = 0.0f;
+	if (!_s_epa_blowup(A, B, S)) {
+		/* Touching, there is no depth to resolve */
+		Result->PointA = S->V[0].A;
+		Result->PointB = S->V[0].B;
+		return;
+	}
+
+	for (k = 0; k < 4; ++k) {
+		W[k] = S->V[k].W;
+		PA[k] = S->V[k].A;
+		PB[k] = S->V[k].B;
+		Inside = s_vec3_add(Inside, s_vec3_mul_scalar(W[k], 0.25f));
+	}
+	for (f = 0; f < 4; ++f)
+		if (_s_epa_face(W, Start[f][0], Start[f][1], Start[f][2], Inside, &Faces[FaceCount]))
+			++FaceCount;
+
+	for (i = 0; i < _SYL_EPA_ITERATIONS && FaceCount > 0; ++i) {
+		Closest = 0;
+		for (f = 1; f < FaceCount; ++f)
+			if (Faces[f].Distance < Faces[Closest].Distance)
+				Closest = f;
+
+		_sepa_face Face = Faces[Closest];
+		_sgjk_vertex w = _s_gjk_support(A, B, Face.Normal);
+		float Distance = s_vec3_dot(w.W, Face.Normal);
+		if (Distance - Face.Distance <= _SYL_EPA_TOLERANCE * (1.0f + Face.Distance) || VertexCount == _SYL_EPA_VERTICES)
+			break;
+
+		int New = VertexCount++;
+		int EdgeCount = 0;
+		W[New] = w.W;
+		PA[New] = w.A;
+		PB[New] = w.B;
+
+		/* Remove every face the new point sees, edges seen twice are inside the hole */
+		for (f = 0; f < FaceCount; ) {
+			if (s_vec3_dot(Faces[f].Normal, s_vec3_sub(w.W, W[Faces[f].V[0]])) <= 0.0f) {
+				++f;
+				continue;
+			}
+			for (k = 0; k < 3; ++k) {
+				int e0 = Faces[f].V[k], e1 = Faces[f].V[(k + 1) % 3];
+				for (j = 0; j < EdgeCount; ++j)
+					if (Edges[j][0] == e1 && Edges[j][1] == e0)
+						break;
+				if (j < EdgeCount) {
+					Edges[j][0] = Edges[EdgeCount - 1][0];
+					Edges[j][1] = Edges[EdgeCount - 1][1];
+					--EdgeCount;
+				}
+				else {
+					Edges[EdgeCount][0] = e0;
+					Edges[EdgeCount][1] = e1;
+					++EdgeCount;
+				}
+			}
+			Faces[f] = Faces[--FaceCount];
+		}
+
+		for (j = 0; j < EdgeCount && FaceCount < _SYL_EPA_FACES; ++j)
+			if (_s_epa_face(W, Edges[j][0], Edges[j][1], New, Inside, &Faces[FaceCount]))
+				++FaceCount;
+	}
+
+	if (FaceCount == 0)
+		return;
+	Closest = 0;
+	for (f = 1; f < FaceCount; ++f)
+		if (Faces[f].Distance < Faces[Closest].Distance)
+			Closest = f;
+
+	/* Barycentric coordinates of the origin projected on the closest face */
+	{
+		_sepa_face* Face = &Faces[Closest];
+		int a = Face->V[0], b = Face->V[1], c = Face->V[2];
+		svec3 p = s_vec3_mul_scalar(Face->Normal, Face->Distance);
+		svec3 v0 = s_vec3_sub(W[b], W[a]), v1 = s_vec3_sub(W[c], W[a]), v2 = s_vec3_sub(p, W[a]);
+		float d00 = s_vec3_dot(v0, v0), d01 = s_vec3_dot(v0, v1), d11 = s_vec3_dot(v1, v1);
+		float d20 = s_vec3_dot(v2, v0), d21 = s_vec3_dot(v2, v1);
+		float Denom = d00 * d11 - d01 * d01;
+		float v = Denom != 0.0f ? (d11 * d20 - d01 * d21) / Denom : 0.0f;
+		float u = Denom != 0.0f ? (d00 * d21 - d01 * d20) / Denom : 0.0f;
+		float t = 1.0f - v - u;
+
+		Result->Depth = Face->Distance;
+		Result->Normal = Face->Normal;
+		Result->PointA = s_vec3_add(s_vec3_mul_scalar(PA[a], t), s_vec3_add(s_vec3_mul_scalar(PA[b], v), s_vec3_mul_scalar(PA[c], u)));
+		Result->PointB = s_vec3_add(s_vec3_mul_scalar(PB[a], t), s_vec3_add(s_vec3_mul_scalar(PB[b], v), s_vec3_mul_scalar(PB[c], u)));
+	}
+}
+
+/* Boolean test, stops at the first separating direction */
+SYL_INLINE bool s_gjk_intersect(const sconvex* A, const sconvex* B, sgjk_cache* Cache)
+{
+	_SYL_PROFILE(s_gjk_intersect);
+	_sgjk_simplex S;
+	svec3 v;
+	return(_s_gjk(A, B, Cache, true, &S, &v, NULL));
+}
+
+/* Distance and closest points of separated shapes */
+SYL_INLINE bool s_gjk_distance(const sconvex* A, const sconvex* B, sgjk_cache* Cache, sgjk_result* Result)
+{
+	_SYL_PROFILE(s_gjk_distance);
+	_sgjk_simplex S;
+	svec3 v;
+	int Iterations;
+	bool Intersect = _s_gjk(A, B, Cache, false, &S, &v, &Iterations);
+	_s_gjk_result(&S, v, Intersect, Iterations, Result);
+	return(Intersect);
+}
+
+/* Like s_gjk_distance, intersecting shapes also get their penetration from EPA */
+SYL_INLINE bool s_gjk_penetration(const sconvex* A, const sconvex* B, sgjk_cache* Cache, sgjk_result* Result)
+{
+	_SYL_PROFILE(s_gjk_penetration);
+	_sgjk_simplex S;
+	svec3 v;
+	int Iterations;
+	bool Intersect = _s_gjk(A, B, Cache, false, &S, &v, &Iterations);
+	_s_gjk_result(&S, v, Intersect, Iterations, Result);
+	if (Intersect)
+		_s_epa(A, B, &S, Result);
+	return(Intersect);
+}
+
+/*********************************************
+ *               OBB OVERLAP                  *
+ *********************************************/
+
+/*
+ * Separating axis test of one box against _SYL_LANES boxes at once. With R
+ * the rotation of every box in the frame of the tested one, the 15 axes are
+ * the 3 axes of each box and their 9 cross products, following Ericson's
+ * Real-Time Collision Detection. Lanes that found a separating axis stay
+ * separated, the loop leaves as soon as every lane did.
+ *
+ * For contacts the penetration along every axis is divided by the length of
+ * the axis, cross products of nearly parallel axes are skipped. Only the
+ * axis number is tracked in the lanes, the normal is built for the boxes
+ * that overlap.
+ */
+
+#define _SYL_OBB_EPSILON 1e-6f
+#define _SYL_OBB_PARALLEL 1e-3f
+
+SYL_INLINE sobb s_obb_from_quat(svec3 Center, svec3 Extents, squat Rotation)
+{
+	_SYL_PROFILE(s_obb_from_quat);
+	float x = Rotation.x, y = Rotation.y, z = Rotation.z, w = Rotation.w;
+	sobb Result;
+
+	Result.Center = Center;
+	Result.Extents = Extents;
+	Result.Axes[0] = SVEC3(1.0f - 2.0f * (y * y + z * z), 2.0f * (x * y + w * z), 2.0f * (x * z - w * y));
+	Result.Axes[1] = SVEC3(2.0f * (x * y - w * z), 1.0f - 2.0f * (x * x + z * z), 2.0f * (y * z + w * x));
+	Result.Axes[2] = SVEC3(2.0f * (x * z + w * y), 2.0f * (y * z - w * x), 1.0f - 2.0f * (x * x + y * y));
+	return(Result);
+}
+
+SYL_INLINE size_t s_obb_soa_memory_size(int Count)
+{
+	_SYL_PROFILE(s_obb_soa_memory_size);
+	if (Count < 0)
+		Count = 0;
+	return(15 * ((size_t)Count + _SYL_LANES) * sizeof(float));
+}
+
+/* Transposes the boxes into Memory, has to run again when they move */
+SYL_INLINE void s_obb_soa_build(sobb_soa* Soa, void* Memory, const sobb* Boxes, int Count)
+{
+	_SYL_PROFILE(s_obb_soa_build);
+	float* Base = (float*)Memory;
+	size_t Padded;
+	int i, k, c;
+
+	if (Count < 0)
+		Count = 0;
+	Padded = (size_t)Count + _SYL_LANES;
+	for (k = 0; k < 3; ++k) {
+		Soa->Center[k] = Base + k * Padded;
+		Soa->Extents[k] = Base + (3 + k) * Padded;
+		for (c = 0; c < 3; ++c)
+			Soa->Axes[k][c] = Base + (6 + 3 * k + c) * Padded;
+	}
+	Soa->Count = Count;
+
+	for (i = 0; i < Count; ++i) {
+		for (k = 0; k < 3; ++k) {
+			Soa->Center[k][i] = Boxes[i].Center.e[k];
+			Soa->Extents[k][i] = Boxes[i].Extents.e[k];
+			for (c = 0; c < 3; ++c)
+				Soa->Axes[k][c][i] = Boxes[i].Axes[k].e[c];
+		}
+	}
+	/* Padding is read by the last batch and masked out */
+	for (k = 0; k < 15; ++k)
+		memset(Base + k * Padded + Count, 0, _SYL_LANES * sizeof(float));
+}
+
+/* World axis of SAT axis number Axis, 0-2 are the axes of A, 3-5 of B and the rest their cross products */
+SYL_INLINE svec3 _s_obb_axis(const sobb* A, const sobb_soa* B, int Index, int Axis)
+{
+	svec3 b[3];
+	int k;
+
+	for (k = 0; k < 3; ++k)
+		b[k] = SVEC3(B->Axes[k][0][Index], B->Axes[k][1][Index], B->Axes[k][2][Index]);
+	if (Axis < 3)
+		return(A->Axes[Axis]);
+	if (Axis < 6)
+		return(b[Axis - 3]);
+	Axis -= 6;
+	svec3 n = s_vec3_cross(A->Axes[Axis / 3], b[Axis % 3]);
+	return(s_vec3_mul_scalar(n, 1.0f / sqrtf(s_vec3_dot(n, n))));
+}
+
+/*
+ * Tests Box against Boxes in [Begin, End) and writes the index of every box
+ * that overlaps it. OutNormal and OutDepth can be NULL, otherwise they get
+ * the axis of least penetration pointing from Box to the other box. Returns
+ * the number of overlapping boxes, even past Capacity.
+ */
+SYL_INLINE int s_obb_overlap_batch(const sobb* Box, const sobb_soa* Boxes, int Begin, int End, int* OutIndex, svec3* OutNormal, float* OutDepth, int Capacity)
+{
+	_SYL_PROFILE(s_obb_overlap_batch);
+	bool Contacts = OutNormal || OutDepth;
+	_snf ea[3], a[3][3], Zero = _s_nf_set1(0.0f);
+	float Depth[_SYL_LANES], Axis[_SYL_LANES];
+	int Found = 0, n, i, j, k, l;
+
+	if (Begin < 0)
+		Begin = 0;
+	if (End > Boxes->Count)
+		End = Boxes->Count;
+
+	for (k = 0; k < 3; ++k) {
+		ea[k] = _s_nf_set1(Box->Extents.e[k]);
+		for (j = 0; j < 3; ++j)
+			a[k][j] = _s_nf_set1(Box->Axes[k].e[j]);
+	}
+
+	for (n = Begin; n < End; n += _SYL_LANES) {
+		_snf t[3], R[3][3], AbsR[3][3], eb[3], T[3], b[3][3];
+		_snf Best = _s_nf_set1(INFINITY), BestAxis = Zero;
+		_snm Separated = _s_nf_gt(_s_nf_ramp((float)n, 1.0f), _s_nf_set1((float)End - 0.5f));
+		int AllSeparated = (1 << _SYL_LANES) - 1;
+
+		for (k = 0; k < 3; ++k) {
+			T[k] = _s_nf_sub(_s_nf_load(Boxes->Center[k] + n), _s_nf_set1(Box->Center.e[k]));
+			eb[k] = _s_nf_load(Boxes->Extents[k] + n);
+			for (j = 0; j < 3; ++j)
+				b[k][j] = _s_nf_load(Boxes->Axes[k][j] + n);
+		}
+		for (i = 0; i < 3; ++i) {
+			t[i] = _s_nf_madd(T[2], a[i][2], _s_nf_madd(T[1], a[i][1], _s_nf_mul(T[0], a[i][0])));
+			for (j = 0; j < 3; ++j) {
+				R[i][j] = _s_nf_madd(b[j][2], a[i][2], _s_nf_madd(b[j][1], a[i][1], _s_nf_mul(b[j][0], a[i][0])));
+				/* Keeps cross products of parallel axes from separating by rounding */
+				AbsR[i][j] = _s_nf_add(_s_nf_abs(R[i][j]), _s_nf_set1(_SYL_OBB_EPSILON));
+			}
+		}
+
+#define _SYL_OBB_AXIS(Radius, Distance, Scale, Number) \
+		do { \
+			_snf Overlap = _s_nf_sub(Radius, Distance); \
+			Separated = _s_nm_or(Separated, _s_nf_gt(Zero, Overlap)); \
+			if (Contacts) { \
+				_snf Pen = _s_nf_mul(Overlap, Scale); \
+				_snm Less = _s_nf_gt(Best, Pen); \
+				Best = _s_nf_select(Less, Pen, Best); \
+				BestAxis = _s_nf_select(Less, _s_nf_set1((float)(Number)), BestAxis); \
+			} \
+		} while (0)
+
+		/* Axes of Box */
+		for (i = 0; i < 3; ++i) {
+			_snf rb = _s_nf_madd(eb[2], AbsR[i][2], _s_nf_madd(eb[1], AbsR[i][1], _s_nf_mul(eb[0], AbsR[i][0])));
+			_SYL_OBB_AXIS(_s_nf_add(ea[i], rb), _s_nf_abs(t[i]), _s_nf_set1(1.0f), i);
+		}
+		if (_s_nm_bits(Separated) == AllSeparated)
+			continue;
+
+		/* Axes of the other boxes */
+		for (j = 0; j < 3; ++j) {
+			_snf ra = _s_nf_madd(ea[2], AbsR[2][j], _s_nf_madd(ea[1], AbsR[1][j], _s_nf_mul(ea[0], AbsR[0][j])));
+			_snf d = _s_nf_madd(t[2], R[2][j], _s_nf_madd(t[1], R[1][j], _s_nf_mul(t[0], R[0][j])));
+			_SYL_OBB_AXIS(_s_nf_add(ra, eb[j]), _s_nf_abs(d), _s_nf_set1(1.0f), 3 + j);
+		}
+		if (_s_nm_bits(Separated) == AllSeparated)
+			continue;
+
+		/* Cross products */
+		for (i = 0; i < 3; ++i) {
+			int i1 = (i + 1) % 3, i2 = (i + 2) % 3;
+			for (j = 0; j < 3; ++j) {
+				int j1 = (j + 1) % 3, j2 = (j + 2) % 3;
+				_snf ra = _s_nf_madd(ea[i1], AbsR[i2][j], _s_nf_mul(ea[i2], AbsR[i1][j]));
+				_snf rb = _s_nf_madd(eb[j1], AbsR[i][j2], _s_nf_mul(eb[j2], AbsR[i][j1]));
+				_snf d = _s_nf_sub(_s_nf_mul(t[i2], R[i1][j]), _s_nf_mul(t[i1], R[i2][j]));
+				_snf Scale = Zero;
+				if (Contacts) {
+					/* |a x b| is the sine of the angle between them */
+					_snf Sine = _s_nf_sqrt_exact(_s_nf_max(_s_nf_sub(_s_nf_set1(1.0f), _s_nf_mul(R[i][j], R[i][j])), Zero));
+					_snm Valid = _s_nf_gt(Sine, _s_nf_set1(_SYL_OBB_PARALLEL));
+					Scale = _s_nf_select(Valid, _s_nf_div(_s_nf_set1(1.0f), _s_nf_max(Sine, _s_nf_set1(_SYL_OBB_PARALLEL))), _s_nf_set1(INFINITY));
+				}
+				_SYL_OBB_AXIS(_s_nf_add(ra, rb), _s_nf_abs(d), Scale, 6 + 3 * i + j);
+			}
+			if (_s_nm_bits(Separated) == AllSeparated)
+				break;
+		}
+#undef _SYL_OBB_AXIS
+
+		int Bits = ~_s_nm_bits(Separated) & AllSeparated;
+		if (!Bits)
+			continue;
+		_s_nf_store(Depth, Best);
+		_s_nf_store(Axis, BestAxis);
+		for (l = 0; Bits; ++l, Bits >>= 1) {
+			if (!(Bits & 1))
+				continue;
+			if (Found < Capacity) {
+				OutIndex[Found] = n + l;
+				if (Contacts) {
+					svec3 Normal = _s_obb_axis(Box, Boxes, n + l, (int)Axis[l]);
+					svec3 Delta = SVEC3(Boxes->Center[0][n + l] - Box->Center.x, Boxes->Center[1][n + l] - Box->Center.y, Boxes->Center[2][n + l] - Box->Center.z);
+					if (s_vec3_dot(Normal, Delta) < 0.0f)
+						Normal = s_vec3_negate(Normal);
+					if (OutNormal)
+						OutNormal[Found] = Normal;
+					if (OutDepth)
+						OutDepth[Found] = Depth[l];
+				}
+			}
+			++Found;
+		}
+	}
+	return(Found);
+}
+
+/*********************************************
+ *            SPHERES AND CAPSULES            *
+ *********************************************/
+
+/*
+ * Pair i of a batch is A[i] against B[i]. Every kernel finds the closest
+ * points of the cores, the center of a sphere and the segment of a capsule,
+ * and the radii are taken off their distance. The closest points of two
+ * segments follow Ericson's Real-Time Collision Detection with the branches
+ * turned into selects, parallel and zero length segments included.
+ */
+
+#define _SYL_CONTACT_EPSILON 1e-12f
+
+/* In holds the arrays of A then B, Core gets the core points of A and B and both radii */
+typedef void (*_scontact_kernel)(const _snf* In, _snf* Core);
+
+_SYL_FORCE_INLINE _snf _s_nf_saturate(_snf a)
+{
+	return(_s_nf_min(_s_nf_max(a, _s_nf_set1(0.0f)), _s_nf_set1(1.0f)));
+}
+
+/* Parameter of the point on segment P + t * d closest to Point */
+_SYL_FORCE_INLINE _snf _s_segment_closest(const _snf* P, const _snf* d, const _snf* Point)
+{
+	_snf Length = _s_nf_madd(d[2], d[2], _s_nf_madd(d[1], d[1], _s_nf_mul(d[0], d[0])));
+	_snf Along = _s_nf_set1(0.0f);
+	int k;
+
+	for (k = 0; k < 3; ++k)
+		Along = _s_nf_madd(_s_nf_sub(Point[k], P[k]), d[k], Along);
+	_snf t = _s_nf_div(Along, _s_nf_max(Length, _s_nf_set1(_SYL_CONTACT_EPSILON)));
+	return(_s_nf_select(_s_nf_gt(Length, _s_nf_set1(_SYL_CONTACT_EPSILON)), _s_nf_saturate(t), _s_nf_set1(0.0f)));
+}
+
+_SYL_FORCE_INLINE void _s_contact_sphere_sphere(const _snf* In, _snf* Core)
+{
+	int k;
+	for (k = 0; k < 3; ++k) {
+		Core[k] = In[k];
+		Core[3 + k] = In[4 + k];
+	}
+	Core[6] = In[3];
+	Core[7] = In[7];
+}
+
+_SYL_FORCE_INLINE void _s_contact_sphere_capsule(const _snf* In, _snf* Core)
+{
+	_snf d[3];
+	int k;
+
+	for (k = 0; k < 3; ++k)
+		d[k] = _s_nf_sub(In[7 + k], In[4 + k]);
+	_snf t = _s_segment_closest(In + 4, d, In);
+	for (k = 0; k < 3; ++k) {
+		Core[k] = In[k];
+		Core[3 + k] = _s_nf_madd(d[k], t, In[4 + k]);
+	}
+	Core[6] = In[3];
+	Core[7] = In[10];
+}
+
+_SYL_FORCE_INLINE void _s_contact_capsule_capsule(const _snf* In, _snf* Core)
+{
+	const _snf *P1 = In, *P2 = In + 7;
+	_snf d1[3], d2[3], r[3], Zero = _s_nf_set1(0.0f), Epsilon = _s_nf_set1(_SYL_CONTACT_EPSILON);
+	_snf a = Zero, b = Zero, c = Zero, e = Zero, f = Zero;
+	int k;
+
+	for (k = 0; k < 3; ++k) {
+		d1[k] = _s_nf_sub(In[3 + k], P1[k]);
+		d2[k] = _s_nf_sub(In[10 + k], P2[k]);
+		r[k] = _s_nf_sub(P1[k], P2[k]);
+		a = _s_nf_madd(d1[k], d1[k], a);
+		b = _s_nf_madd(d1[k], d2[k], b);
+		c = _s_nf_madd(d1[k], r[k], c);
+		e = _s_nf_madd(d2[k], d2[k], e);
+		f = _s_nf_madd(d2[k], r[k], f);
+	}
+
+	_snm SegmentA = _s_nf_gt(a, Epsilon), SegmentB = _s_nf_gt(e, Epsilon), PointB = _s_nf_gt(Epsilon, e);
+	_snf InvA = _s_nf_div(_s_nf_set1(1.0f), _s_nf_max(a, Epsilon));
+	_snf InvE = _s_nf_div(_s_nf_set1(1.0f), _s_nf_max(e, Epsilon));
+	_snf Denom = _s_nf_sub(_s_nf_mul(a, e), _s_nf_mul(b, b));
+
+	/* Closest points of the infinite lines, any s works for parallel ones */
+	_snm Skew = _s_nf_gt(Denom, _s_nf_mul(_s_nf_mul(a, e), _s_nf_set1(1e-6f)));
+	_snf s = _s_nf_div(_s_nf_sub(_s_nf_mul(b, f), _s_nf_mul(c, e)), _s_nf_max(Denom, Epsilon));
+	s = _s_nf_select(Skew, _s_nf_saturate(s), Zero);
+	_snf t = _s_nf_mul(_s_nf_madd(b, s, f), InvE);
+
+	/* Clamp t to the segment and move s to the closest point of that end */
+	_snf Low = _s_nf_saturate(_s_nf_mul(_s_nf_sub(Zero, c), InvA));
+	_snf High = _s_nf_saturate(_s_nf_mul(_s_nf_sub(b, c), InvA));
+	_snm Below = _s_nm_or(_s_nf_gt(Zero, t), PointB);
+	_snm Above = _s_nm_andnot(Below, _s_nf_gt(t, _s_nf_set1(1.0f)));
+	s = _s_nf_select(Below, Low, _s_nf_select(Above, High, s));
+	t = _s_nf_select(Below, Zero, _s_nf_select(Above, _s_nf_set1(1.0f), t));
+
+	/* A is a point */
+	s = _s_nf_select(SegmentA, s, Zero);
+	t = _s_nf_select(SegmentA, t, _s_nf_select(SegmentB, _s_nf_saturate(_s_nf_mul(f, InvE)), Zero));
+
+	for (k = 0; k < 3; ++k) {
+		Core[k] = _s_nf_madd(d1[k], s, P1[k]);
+		Core[3 + k] = _s_nf_madd(d2[k], t, P2[k]);
+	}
+	Core[6] = In[6];
+	Core[7] = In[13];
+}
+
+/* Set bits of a lane mask without branching on them */
+_SYL_FORCE_INLINE int _s_bit_count(int Bits)
+{
+	Bits = Bits - ((Bits >> 1) & 0x55);
+	Bits = (Bits & 0x33) + ((Bits >> 2) & 0x33);
+	return((Bits + (Bits >> 4)) & 0x0F);
+}
+
+/* Turns core points and radii into the contact, returns the lanes that overlap */
+_SYL_FORCE_INLINE _snm _s_contact_finish(const _snf* Core, _snf* R)
+{
+	_snf d[3], LengthSq = _s_nf_set1(0.0f);
+	int k;
+
+	for (k = 0; k < 3; ++k) {
+		d[k] = _s_nf_sub(Core[3 + k], Core[k]);
+		LengthSq = _s_nf_madd(d[k], d[k], LengthSq);
+	}
+	/* Cores that meet have no direction, the normal falls back to +x */
+	_snm Apart = _s_nf_gt(LengthSq, _s_nf_set1(_SYL_CONTACT_EPSILON));
+	_snf Length = _s_nf_sqrt_exact(LengthSq);
+	_snf Inv = _s_nf_div(_s_nf_set1(1.0f), _s_nf_max(Length, _s_nf_set1(_SYL_CONTACT_EPSILON)));
+	R[1] = _s_nf_select(Apart, _s_nf_mul(d[0], Inv), _s_nf_set1(1.0f));
+	R[2] = _s_nf_select(Apart, _s_nf_mul(d[1], Inv), _s_nf_set1(0.0f));
+	R[3] = _s_nf_select(Apart, _s_nf_mul(d[2], Inv), _s_nf_set1(0.0f));
+	R[0] = _s_nf_sub(Length, _s_nf_add(Core[6], Core[7]));
+
+	/* Halfway between the surface of A at Core A + n * rA and the surface of B at Core B - n * rB */
+	_snf Offset = _s_nf_mul(_s_nf_add(_s_nf_sub(Core[6], Core[7]), Length), _s_nf_set1(0.5f));
+	for (k = 0; k < 3; ++k)
+		R[4 + k] = _s_nf_madd(R[1 + k], Offset, Core[k]);
+	return(_s_nf_gt(_s_nf_set1(0.0f), R[0]));
+}
+
+_SYL_FORCE_INLINE int _s_contact_pairs(_scontact_kernel Kernel, const float* const* In, int Inputs, int Begin, int End, scontact_soa* Out)
+{
+	float* Outputs[7] = { Out->Distance, Out->NormalX, Out->NormalY, Out->NormalZ, Out->PointX, Out->PointY, Out->PointZ };
+	int OutputCount = Out->PointX ? 7 : 4;
+	_snf P[14], Core[8], R[7];
+	int Found = 0, i = Begin, k;
+
+	for (; i + _SYL_LANES <= End; i += _SYL_LANES) {
+		for (k = 0; k < Inputs; ++k)
+			P[k] = _s_nf_load(In[k] + i);
+		Kernel(P, Core);
+		int Bits = _s_nm_bits(_s_contact_finish(Core, R));
+		for (k = 0; k < OutputCount; ++k)
+			_s_nf_store(Outputs[k] + i, R[k]);
+		Found += _s_bit_count(Bits);
+	}
+
+	if (i < End) {
+		float Block[14][_SYL_LANES] = { { 0 } };
+		int Rest = End - i, j;
+
+		for (k = 0; k < Inputs; ++k) {
+			for (j = 0; j < Rest; ++j)
+				Block[k][j] = In[k][i + j];
+			P[k] = _s_nf_load(Block[k]);
+		}
+		Kernel(P, Core);
+		int Bits = _s_nm_bits(_s_contact_finish(Core, R)) & ((1 << Rest) - 1);
+		for (k = 0; k < OutputCount; ++k) {
+			_s_nf_store(Block[k], R[k]);
+			for (j = 0; j < Rest; ++j)
+				Outputs[k][i + j] = Block[k][j];
+		}
+		Found += _s_bit_count(Bits);
+	}
+	return(Found);
+}
+
+/* Each function returns the number of overlapping pairs in [Begin, End) */
+SYL_INLINE int s_sphere_sphere_batch(const ssphere_soa* A, const ssphere_soa* B, int Begin, int End, scontact_soa* Out)
+{
+	_SYL_PROFILE(s_sphere_sphere_batch);
+	const float* In[8] = { A->X, A->Y, A->Z, A->Radius, B->X, B->Y, B->Z, B->Radius };
+	return(_s_contact_pairs(_s_contact_sphere_sphere, In, 8, Begin, End, Out));
+}
+
+SYL_INLINE int s_sphere_capsule_batch(const ssphere_soa* A, const scapsule_soa* B, int Begin, int End, scontact_soa* Out)
+{
+	_SYL_PROFILE(s_sphere_capsule_batch);
+	const float* In[11] = { A->X, A->Y, A->Z, A->Radius, B->PX, B->PY, B->PZ, B->QX, B->QY, B->QZ, B->Radius };
+	return(_s_contact_pairs(_s_contact_sphere_capsule, In, 11, Begin, End, Out));
+}
+
+SYL_INLINE int s_capsule_capsule_batch(const scapsule_soa* A, const scapsule_soa* B, int Begin, int End, scontact_soa* Out)
+{
+	_SYL_PROFILE(s_capsule_capsule_batch);
+	const float* In[14] = { A->PX, A->PY, A->PZ, A->QX, A->QY, A->QZ, A->Radius, B->PX, B->PY, B->PZ, B->QX, B->QY, B->QZ, B->Radius };
+	return(_s_contact_pairs(_s_contact_capsule_capsule, In, 14, Begin, End, Out));
+}
+
+/*********************************************
+ *           MESH NORMALS AND TANGENTS        *
+ *********************************************/
+
+/*
+ * Face normals are the cross product of two edges, their length is twice the
+ * area so summing them weights every face by its area. Face tangents point
+ * along increasing u, scaled to the same length as the face normal, and w
+ * carries the uv winding weighted the same way. Vertices take the direction
+ * of the sums, tangents are made orthogonal to the vertex normal and w ends
+ * up as the sign of the winding most of the area agrees on.
+ *
+ * Triangles go one at a time, gathering their corners into lanes costs more
+ * than the few products it saves. Without adjacency the results are added
+ * to the vertices right away. With adjacency the faces are written to the
+ * caller's scratch first and every vertex sums its own triangles, so chunks
+ * of vertices can run on different threads without sharing any output.
+ */
+
+#define _SYL_MESH_GRAIN 4096
+
+typedef struct _smesh_job
+{
+	const svec3* Positions;
+	const svec3* Normals;
+	const svec2* UVs;
+	const unsigned int* Indices;
+	const smesh_adjacency* Adjacency;
+	float* Faces;
+	svec3* OutNormals;
+	svec4* OutTangents;
+} _smesh_job;
+
+SYL_INLINE size_t s_mesh_adjacency_memory_size(int VertexCount, int TriangleCount)
+{
+	_SYL_PROFILE(s_mesh_adjacency_memory_size);
+	if (VertexCount < 0)
+		VertexCount = 0;
+	if (TriangleCount < 0)
+		TriangleCount = 0;
+	return(((size_t)VertexCount + 1) * sizeof(int) + 3 * (size_t)TriangleCount * sizeof(int));
+}
+
+/* Per triangle results of one s_mesh_normals or s_mesh_tangents call with adjacency */
+SYL_INLINE size_t s_mesh_scratch_size(int TriangleCount)
+{
+	_SYL_PROFILE(s_mesh_scratch_size);
+	if (TriangleCount < 0)
+		TriangleCount = 0;
+	return(4 * (size_t)TriangleCount * sizeof(float));
+}
+
+/* Only depends on the indices, build it once per topology */
+SYL_INLINE void s_mesh_adjacency_build(smesh_adjacency* Adjacency, void* Memory, const unsigned int* Indices, int VertexCount, int TriangleCount)
+{
+	_SYL_PROFILE(s_mesh_adjacency_build);
+	int *Offsets, *Triangles, i, v;
+
+	if (VertexCount < 0)
+		VertexCount = 0;
+	if (TriangleCount < 0)
+		TriangleCount = 0;
+	Offsets = (int*)Memory;
+	Triangles = Offsets + VertexCount + 1;
+	Adjacency->Offsets = Offsets;
+	Adjacency->Triangles = Triangles;
+	Adjacency->VertexCount = VertexCount;
+	Adjacency->TriangleCount = TriangleCount;
+
+	/* Counting sort of the corners by vertex, Offsets[v + 1] is where vertex v is filled and ends up as its end */
+	memset(Offsets, 0, ((size_t)VertexCount + 1) * sizeof(int));
+	for (i = 0; i < 3 * TriangleCount; ++i)
+		++Offsets[Indices[i] + 1];
+	for (v = 0; v < VertexCount; ++v)
+		Offsets[v + 1] += Offsets[v];
+	for (v = VertexCount; v > 0; --v)
+		Offsets[v] = Offsets[v - 1];
+	for (i = 0; i < 3 * TriangleCount; ++i)
+		Triangles[Offsets[Indices[i] + 1]++] = i / 3;
+}
+
+/* Face normals, or tangents when there are UVs, of triangles [Begin, End). Tangents is constant after inlining */
+_SYL_FORCE_INLINE void _s_mesh_triangles(const _smesh_job* Job, int Begin, int End, bool Tangents)
+{
+	const svec3* Positions = Job->Positions;
+	const svec2* UVs = Job->UVs;
+	const unsigned int* Indices = Job->Indices;
+	float* Faces = Job->Faces;
+	svec3* OutNormals = Job->OutNormals;
+	svec4* OutTangents = Job->OutTangents;
+	int i, c;
+
+	for (i = Begin; i < End; ++i) {
+		const unsigned int i0 = Indices[3 * (size_t)i], i1 = Indices[3 * (size_t)i + 1], i2 = Indices[3 * (size_t)i + 2];
+		const svec3 p0 = Positions[i0];
+		const float e1x = Positions[i1].x - p0.x, e1y = Positions[i1].y - p0.y, e1z = Positions[i1].z - p0.z;
+		const float e2x = Positions[i2].x - p0.x, e2y = Positions[i2].y - p0.y, e2z = Positions[i2].z - p0.z;
+		float Rx = e1y * e2z - e1z * e2y, Ry = e1z * e2x - e1x * e2z, Rz = e1x * e2y - e1y * e2x, Rw = 0.0f;
+
+		if (Tangents) {
+			const svec2 uv0 = UVs[i0];
+			const float du1 = UVs[i1].x - uv0.x, dv1 = UVs[i1].y - uv0.y, du2 = UVs[i2].x - uv0.x, dv2 = UVs[i2].y - uv0.y;
+			const float Det = du1 * dv2 - du2 * dv1;
+			const float Winding = Det > 0.0f ? 1.0f : (Det < 0.0f ? -1.0f : 0.0f);
+			const float Area = sqrtf(Rx * Rx + Ry * Ry + Rz * Rz);
+			float TangentSq, Scale;
+
+			Rx = (e1x * dv2 - e2x * dv1) * Winding;
+			Ry = (e1y * dv2 - e2y * dv1) * Winding;
+			Rz = (e1z * dv2 - e2z * dv1) * Winding;
+			TangentSq = Rx * Rx + Ry * Ry + Rz * Rz;
+			Scale = TangentSq > _SYL_VEC_EPSILON_SQ ? Area / sqrtf(TangentSq) : 0.0f;
+			Rx *= Scale;
+			Ry *= Scale;
+			Rz *= Scale;
+			Rw = Winding * Area;
+		}
+
+		if (Faces) {
+			float* Face = Faces + (size_t)i * (Tangents ? 4 : 3);
+			Face[0] = Rx;
+			Face[1] = Ry;
+			Face[2] = Rz;
+			if (Tangents)
+				Face[3] = Rw;
+			continue;
+		}
+		for (c = 0; c < 3; ++c) {
+			const unsigned int v = c == 0 ? i0 : (c == 1 ? i1 : i2);
+			if (Tangents) {
+				OutTangents[v].x += Rx;
+				OutTangents[v].y += Ry;
+				OutTangents[v].z += Rz;
+				OutTangents[v].w += Rw;
+			} else {
+				OutNormals[v].x += Rx;
+				OutNormals[v].y += Ry;
+				OutNormals[v].z += Rz;
+			}
+		}
+	}
+}
+
+SYL_INLINE void _s_mesh_faces(int Begin, int End, int WorkerIndex, void* UserData)
+{
+	_smesh_job* Job = (_smesh_job*)UserData;
+	(void)WorkerIndex;
+	if (Job->UVs)
+		_s_mesh_triangles(Job, Begin, End, true);
+	else
+		_s_mesh_triangles(Job, Begin, End, false);
+}
+
+/* Makes the summed tangents of vertices [Begin, End) unit length and orthogonal to the normals */
+SYL_INLINE void _s_mesh_tangent_frames(const svec3* Normals, svec4* Tangents, int Begin, int End)
+{
+	const float* N[3] = { Normals->e, Normals->e + 1, Normals->e + 2 };
+	const float* T[4] = { Tangents->e, Tangents->e + 1, Tangents->e + 2, Tangents->e + 3 };
+	float* O[4] = { Tangents->e, Tangents->e + 1, Tangents->e + 2, Tangents->e + 3 };
+	_snf Zero = _s_nf_set1(0.0f), One = _s_nf_set1(1.0f);
+	int i, k;
+
+	for (i = Begin; i < End; i += _SYL_LANES) {
+		int Rest = End - i < _SYL_LANES ? End - i : _SYL_LANES;
+		_snf n[3], t[4], Perp[3];
+		_s_vec_load(N, 3, 3, i, Rest, n);
+		_s_vec_load(T, 4, 4, i, Rest, t);
+
+		_snf Summed = _s_nf_madd(t[2], t[2], _s_nf_madd(t[1], t[1], _s_nf_mul(t[0], t[0])));
+		_snf Along = _s_nf_madd(n[2], t[2], _s_nf_madd(n[1], t[1], _s_nf_mul(n[0], t[0])));
+		for (k = 0; k < 3; ++k)
+			t[k] = _s_nf_sub(t[k], _s_nf_mul(n[k], Along));
+
+		/* Tangents along the normal, or without any uv direction, become x or y crossed with the normal */
+		_snm UseX = _s_nf_gt(_s_nf_set1(0.9f), _s_nf_abs(n[0]));
+		Perp[0] = _s_nf_select(UseX, Zero, n[2]);
+		Perp[1] = _s_nf_select(UseX, _s_nf_sub(Zero, n[2]), Zero);
+		Perp[2] = _s_nf_select(UseX, n[1], _s_nf_sub(Zero, n[0]));
+
+		_snf LengthSq = _s_nf_madd(t[2], t[2], _s_nf_madd(t[1], t[1], _s_nf_mul(t[0], t[0])));
+		_snm Valid = _s_nf_gt(LengthSq, _s_nf_madd(Summed, _s_nf_set1(1e-6f), _s_nf_set1(_SYL_VEC_EPSILON_SQ)));
+		for (k = 0; k < 3; ++k)
+			t[k] = _s_nf_select(Valid, t[k], Perp[k]);
+
+		LengthSq = _s_nf_madd(t[2], t[2], _s_nf_madd(t[1], t[1], _s_nf_mul(t[0], t[0])));
+		_snf Inv = _s_nf_select(_s_nf_gt(LengthSq, _s_nf_set1(_SYL_VEC_EPSILON_SQ)), _s_nf_rsqrt_nr(_s_nf_max(LengthSq, _s_nf_set1(_SYL_VEC_EPSILON_SQ))), Zero);
+		for (k = 0; k < 3; ++k)
+			t[k] = _s_nf_mul(t[k], Inv);
+		t[3] = _s_nf_select(_s_nf_gt(Zero, t[3]), _s_nf_set1(-1.0f), One);
+		_s_vec_store(O, 4, 4, i, Rest, t);
+	}
+}
+
+/* Sums the faces around vertices [Begin, End), Stride is constant after inlining */
+_SYL_FORCE_INLINE void _s_mesh_gather(const smesh_adjacency* Adjacency, const float* Faces, float* Out, int Begin, int End, int Stride)
+{
+	int v, f, k;
+
+	for (v = Begin; v < End; ++v) {
+		float Sum[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+		for (f = Adjacency->Offsets[v]; f < Adjacency->Offsets[v + 1]; ++f) {
+			const float* Face = Faces + (size_t)Adjacency->Triangles[f] * Stride;
+			for (k = 0; k < Stride; ++k)
+				Sum[k] += Face[k];
+		}
+		for (k = 0; k < Stride; ++k)
+			Out[(size_t)v * Stride + k] = Sum[k];
+	}
+}
+
+SYL_INLINE void _s_mesh_vertices(int Begin, int End, int WorkerIndex, void* UserData)
+{
+	_smesh_job* Job = (_smesh_job*)UserData;
+	(void)WorkerIndex;
+
+	if (Job->UVs) {
+		_s_mesh_gather(Job->Adjacency, Job->Faces, Job->OutTangents->e, Begin, End, 4);
+		_s_mesh_tangent_frames(Job->Normals, Job->OutTangents, Begin, End);
+	}
+	else {
+		_s_mesh_gather(Job->Adjacency, Job->Faces, Job->OutNormals->e, Begin, End, 3);
+		s_vec3_normalize_array(Job->OutNormals + Begin, Job->OutNormals + Begin, End - Begin, false);
+	}
+}
+
+SYL_INLINE void _s_mesh_run(_smesh_job* Job, int VertexCount, int TriangleCount)
+{
+	if (Job->Faces) {
+#if defined(SYL_THREADS)
+		s_parallel_for(TriangleCount, _SYL_MESH_GRAIN, _s_mesh_faces, Job);
+		s_parallel_for(VertexCount, _SYL_MESH_GRAIN, _s_mesh_vertices, Job);
+#else
+		_s_mesh_faces(0, TriangleCount, 0, Job);
+		_s_mesh_vertices(0, VertexCount, 0, Job);
+#endif
+		return;
+	}
+
+	if (Job->UVs) {
+		memset(Job->OutTangents, 0, (size_t)VertexCount * sizeof(svec4));
+		_s_mesh_faces(0, TriangleCount, 0, Job);
+		_s_mesh_tangent_frames(Job->Normals, Job->OutTangents, 0, VertexCount);
+	}
+	else {
+		memset(Job->OutNormals, 0, (size_t)VertexCount * sizeof(svec3));
+		_s_mesh_faces(0, TriangleCount, 0, Job);
+		s_vec3_normalize_array(Job->OutNormals, Job->OutNormals, VertexCount, false);
+	}
+}
+
+/*
+ * Area weighted vertex normals. Adjacency and Scratch are needed for the threaded
+ * path, Scratch holds s_mesh_scratch_size bytes and belongs to this call only.
+ */
+SYL_INLINE void s_mesh_normals(const svec3* Positions, const unsigned int* Indices, int VertexCount, int TriangleCount, const smesh_adjacency* Adjacency, void* Scratch, svec3* OutNormals)
+{
+	_SYL_PROFILE(s_mesh_normals);
+	_smesh_job Job = { Positions, NULL, NULL, Indices, Adjacency, Adjacency ? (float*)Scratch : NULL, OutNormals, NULL };
+	_s_mesh_run(&Job, VertexCount, TriangleCount);
+}
+
+/* Tangents with the handedness of the bitangent in w, Normals are the vertex normals */
+SYL_INLINE void s_mesh_tangents(const svec3* Positions, const svec3* Normals, const svec2* UVs, const unsigned int* Indices, int VertexCount, int TriangleCount, const smesh_adjacency* Adjacency, void* Scratch, svec4* OutTangents)
+{
+	_SYL_PROFILE(s_mesh_tangents);
+	_smesh_job Job = { Positions, Normals, UVs, Indices, Adjacency, Adjacency ? (float*)Scratch : NULL, NULL, OutTangents };
+	_s_mesh_run(&Job, VertexCount, TriangleCount);
+}
+
+/*********************************************
+ *              BOUNDING VOLUMES              *
+ *********************************************/
+
+/*
+ * The sphere starts from the furthest apart pair of extreme points along 7
+ * directions and grows over every point as in Ritter's algorithm. Blocks of
+ * points already inside are skipped with one compare, only the points outside
+ * go through the scalar growth. Refinement shrinks the sphere and grows it again
+ * from a different starting point, keeping the smallest (Ericson, Real-Time
+ * Collision Detection 4.3.5). The radius is then set to the furthest point from
+ * the center so every point is inside.
+ *
+ * The box axes are the eigenvectors of the covariance of the points. Products
+ * are summed around the first point in float lanes and moved into doubles every
+ * _SYL_REDUCE_FLUSH steps. When the world axes give a smaller box they are used
+ * instead, which happens for boxy shapes where the covariance is not telling.
+ */
+
+#define _SYL_BOUNDS_DIRECTIONS 7
+#define _SYL_BOUNDS_SHRINK 0.95f
+#define _SYL_JACOBI_SWEEPS 16
+
+/* Projections on x, y, z and the 4 diagonals, the diagonals don't need to be unit length to find the extremes */
+_SYL_FORCE_INLINE void _s_sphere_project(svec3 p, float* Dot)
+{
+	float s = p.x + p.y, d = p.x - p.y;
+	Dot[0] = p.x;
+	Dot[1] = p.y;
+	Dot[2] = p.z;
+	Dot[3] = s + p.z;
+	Dot[4] = s - p.z;
+	Dot[5] = d + p.z;
+	Dot[6] = d - p.z;
+}
+
+/* Points with the lowest and highest projection on every direction, written out so the lanes stay in registers */
+SYL_INLINE void _s_sphere_extremes(const svec3* Points, int Count, int* MinIndex, int* MaxIndex)
+{
+	const float* In[3] = { Points->e, Points->e + 1, Points->e + 2 };
+	_snf Lo[_SYL_BOUNDS_DIRECTIONS], Hi[_SYL_BOUNDS_DIRECTIONS], V[3];
+	_sni LoIndex[_SYL_BOUNDS_DIRECTIONS], HiIndex[_SYL_BOUNDS_DIRECTIONS];
+	_sni Index = _s_nf_to_int(_s_nf_ramp(0.0f, 1.0f)), Step = _s_ni_set1(_SYL_LANES);
+	float Min[_SYL_BOUNDS_DIRECTIONS], Max[_SYL_BOUNDS_DIRECTIONS], Dot[_SYL_BOUNDS_DIRECTIONS];
+	float LoValues[_SYL_LANES], HiValues[_SYL_LANES];
+	unsigned int LoIndices[_SYL_LANES], HiIndices[_SYL_LANES];
+	int i, k, l;
+
+	for (k = 0; k < _SYL_BOUNDS_DIRECTIONS; ++k) {
+		Lo[k] = _s_nf_set1(INFINITY);
+		Hi[k] = _s_nf_set1(-INFINITY);
+		LoIndex[k] = HiIndex[k] = _s_ni_set1(0);
+	}
+
+#define _SYL_SPHERE_EXTREME(k, Dot) \
+		do { \
+			_snm Lower = _s_nf_gt(Lo[k], Dot), Higher = _s_nf_gt(Dot, Hi[k]); \
+			Lo[k] = _s_nf_select(Lower, Dot, Lo[k]); \
+			Hi[k] = _s_nf_select(Higher, Dot, Hi[k]); \
+			LoIndex[k] = _s_ni_select(Lower, Index, LoIndex[k]); \
+			HiIndex[k] = _s_ni_select(Higher, Index, HiIndex[k]); \
+		} while (0)
+
+	for (i = 0; i + _SYL_LANES <= Count; i += _SYL_LANES) {
+		_s_vec_load(In, 3, 3, i, _SYL_LANES, V);
+		_snf s = _s_nf_add(V[0], V[1]), d = _s_nf_sub(V[0], V[1]);
+		_SYL_SPHERE_EXTREME(0, V[0]);
+		_SYL_SPHERE_EXTREME(1, V[1]);
+		_SYL_SPHERE_EXTREME(2, V[2]);
+		_SYL_SPHERE_EXTREME(3, _s_nf_add(s, V[2]));
+		_SYL_SPHERE_EXTREME(4, _s_nf_sub(s, V[2]));
+		_SYL_SPHERE_EXTREME(5, _s_nf_add(d, V[2]));
+		_SYL_SPHERE_EXTREME(6, _s_nf_sub(d, V[2]));
+		Index = _s_ni_add(Index, Step);
+	}
+
+#undef _SYL_SPHERE_EXTREME
+
+	for (k = 0; k < _SYL_BOUNDS_DIRECTIONS; ++k) {
+		int a = 0, b = 0;
+		_s_nf_store(LoValues, Lo[k]);
+		_s_nf_store(HiValues, Hi[k]);
+		_s_ni_store(LoIndices, LoIndex[k]);
+		_s_ni_store(HiIndices, HiIndex[k]);
+		/* Ties go to the lowest index like the scalar loop, so the chosen points don't depend on the lane count */
+		for (l = 1; l < _SYL_LANES; ++l) {
+			a = (LoValues[l] < LoValues[a] || (LoValues[l] == LoValues[a] && LoIndices[l] < LoIndices[a])) ? l : a;
+			b = (HiValues[l] > HiValues[b] || (HiValues[l] == HiValues[b] && HiIndices[l] < HiIndices[b])) ? l : b;
+		}
+		Min[k] = LoValues[a];
+		Max[k] = HiValues[b];
+		MinIndex[k] = (int)LoIndices[a];
+		MaxIndex[k] = (int)HiIndices[b];
+	}
+
+	for (; i < Count; ++i) {
+		_s_sphere_project(Points[i], Dot);
+		for (k = 0; k < _SYL_BOUNDS_DIRECTIONS; ++k) {
+			if (Dot[k] < Min[k]) {
+				Min[k] = Dot[k];
+				MinIndex[k] = i;
+			}
+			if (Dot[k] > Max[k]) {
+				Max[k] = Dot[k];
+				MaxIndex[k] = i;
+			}
+		}
+	}
+}
+
+/* Grow the sphere just enough to hold Point, it still holds everything it held before */
+_SYL_FORCE_INLINE void _s_sphere_grow(ssphere* Sphere, svec3 Point)
+{
+	svec3 d = s_vec3_sub(Point, Sphere->Center);
+	float DistanceSq = s_vec3_dot(d, d);
+
+	if (DistanceSq > Sphere->Radius * Sphere->Radius) {
+		float Distance = sqrtf(DistanceSq);
+		float Radius = (Sphere->Radius + Distance) * 0.5f;
+		Sphere->Center = s_vec3_add(Sphere->Center, s_vec3_mul_scalar(d, (Radius - Sphere->Radius) / Distance));
+		Sphere->Radius = Radius;
+	}
+}
+
+SYL_INLINE void _s_sphere_grow_range(const svec3* Points, int Begin, int End, ssphere* Sphere)
+{
+	const float* In[3] = { Points->e, Points->e + 1, Points->e + 2 };
+	_snf Lanes = _s_nf_ramp(0.0f, 1.0f), C[3], RadiusSq, V[3];
+	int i, k, l;
+
+	for (k = 0; k < 3; ++k)
+		C[k] = _s_nf_set1(Sphere->Center.e[k]);
+	RadiusSq = _s_nf_set1(Sphere->Radius * Sphere->Radius);
+
+	for (i = Begin; i < End; i += _SYL_LANES) {
+		int Rest = End - i < _SYL_LANES ? End - i : _SYL_LANES;
+		_s_vec_load(In, 3, 3, i, Rest, V);
+		_snf dx = _s_nf_sub(V[0], C[0]), dy = _s_nf_sub(V[1], C[1]), dz = _s_nf_sub(V[2], C[2]);
+		_snf DistanceSq = _s_nf_madd(dz, dz, _s_nf_madd(dy, dy, _s_nf_mul(dx, dx)));
+		int Outside = _s_nm_bits(_s_nm_and(_s_nf_gt(_s_nf_set1((float)Rest), Lanes), _s_nf_gt(DistanceSq, RadiusSq)));
+		if (!Outside)
+			continue;
+
+		/* Growing for one point can take in the next ones, the scalar test sees the new sphere */
+		for (l = 0; l < Rest; ++l)
+			if ((Outside >> l) & 1)
+				_s_sphere_grow(Sphere, Points[i + l]);
+		for (k = 0; k < 3; ++k)
+			C[k] = _s_nf_set1(Sphere->Center.e[k]);
+		RadiusSq = _s_nf_set1(Sphere->Radius * Sphere->Radius);
+	}
+}
+
+/* Distance to the furthest point */
+SYL_INLINE float _s_sphere_radius(const svec3* Points, int Count, svec3 Center)
+{
+	const float* In[3] = { Points->e, Points->e + 1, Points->e + 2 };
+	_snf C[3] = { _s_nf_set1(Center.x), _s_nf_set1(Center.y), _s_nf_set1(Center.z) };
+	_snf Best = _s_nf_set1(0.0f), V[3];
+	float Values[_SYL_LANES], Result = 0.0f;
+	int i, l;
+
+	for (i = 0; i < Count; i += _SYL_LANES) {
+		int Rest = Count - i < _SYL_LANES ? Count - i : _SYL_LANES;
+		_s_vec_load(In, 3, 3, i, Rest, V);
+		/* Padded lanes repeat the center and add nothing */
+		if (Rest < _SYL_LANES) {
+			_snm Valid = _s_nf_gt(_s_nf_set1((float)Rest), _s_nf_ramp(0.0f, 1.0f));
+			V[0] = _s_nf_select(Valid, V[0], C[0]);
+			V[1] = _s_nf_select(Valid, V[1], C[1]);
+			V[2] = _s_nf_select(Valid, V[2], C[2]);
+		}
+		_snf dx = _s_nf_sub(V[0], C[0]), dy = _s_nf_sub(V[1], C[1]), dz = _s_nf_sub(V[2], C[2]);
+		Best = _s_nf_max(Best, _s_nf_madd(dz, dz, _s_nf_madd(dy, dy, _s_nf_mul(dx, dx))));
+	}
+
+	_s_nf_store(Values, Best);
+	for (l = 0; l < _SYL_LANES; ++l)
+		Result = Values[l] > Result ? Values[l] : Result;
+	return(sqrtf(Result));
+}
+
+/* Covariance of the points, summed relative to the first point to keep the precision far from the origin */
+SYL_INLINE void _s_bounds_covariance(const svec3* Points, int Count, double (*Covariance)[3])
+{
+	const float* In[3] = { Points->e, Points->e + 1, Points->e + 2 };
+	_snf Origin[3] = { _s_nf_set1(Points->x), _s_nf_set1(Points->y), _s_nf_set1(Points->z) };
+	_snf Lanes = _s_nf_ramp(0.0f, 1.0f), Zero = _s_nf_set1(0.0f), Sum[9], V[3];
+	double Total[9][_SYL_LANES], Mean[3], Products[6];
+	int i, j, k, Flush = 0;
+
+	for (k = 0; k < 9; ++k) {
+		Sum[k] = Zero;
+		for (j = 0; j < _SYL_LANES; ++j)
+			Total[k][j] = 0.0;
+	}
+
+	for (i = 0; i < Count; i += _SYL_LANES) {
+		int Rest = Count - i < _SYL_LANES ? Count - i : _SYL_LANES;
+		_s_vec_load(In, 3, 3, i, Rest, V);
+		_snm Valid = _s_nf_gt(_s_nf_set1((float)Rest), Lanes);
+		_snf dx = _s_nf_select(Valid, _s_nf_sub(V[0], Origin[0]), Zero);
+		_snf dy = _s_nf_select(Valid, _s_nf_sub(V[1], Origin[1]), Zero);
+		_snf dz = _s_nf_select(Valid, _s_nf_sub(V[2], Origin[2]), Zero);
+		Sum[0] = _s_nf_add(Sum[0], dx);
+		Sum[1] = _s_nf_add(Sum[1], dy);
+		Sum[2] = _s_nf_add(Sum[2], dz);
+		Sum[3] = _s_nf_madd(dx, dx, Sum[3]);
+		Sum[4] = _s_nf_madd(dx, dy, Sum[4]);
+		Sum[5] = _s_nf_madd(dx, dz, Sum[5]);
+		Sum[6] = _s_nf_madd(dy, dy, Sum[6]);
+		Sum[7] = _s_nf_madd(dy, dz, Sum[7]);
+		Sum[8] = _s_nf_madd(dz, dz, Sum[8]);
+		if (++Flush == _SYL_REDUCE_FLUSH) {
+			_s_vec_reduce_flush(9, Sum, Total);
+			Flush = 0;
+		}
+	}
+	_s_vec_reduce_flush(9, Sum, Total);
+
+	for (k = 0; k < 9; ++k) {
+		double s = 0.0;
+		for (j = 0; j < _SYL_LANES; ++j)
+			s += Total[k][j];
+		if (k < 3)
+			Mean[k] = s / Count;
+		else
+			Products[k - 3] = s / Count;
+	}
+
+	Covariance[0][0] = Products[0] - Mean[0] * Mean[0];
+	Covariance[0][1] = Covariance[1][0] = Products[1] - Mean[0] * Mean[1];
+	Covariance[0][2] = Covariance[2][0] = Products[2] - Mean[0] * Mean[2];
+	Covariance[1][1] = Products[3] - Mean[1] * Mean[1];
+	Covariance[1][2] = Covariance[2][1] = Products[4] - Mean[1] * Mean[2];
+	Covariance[2][2] = Products[5] - Mean[2] * Mean[2];
+}
+
+/* Cyclic Jacobi rotations, A ends up diagonal with the eigenvalues and the columns of Vectors are the eigenvectors */
+SYL_INLINE void _s_jacobi_eigen(double (*A)[3], double (*Vectors)[3])
+{
+	static const int Pairs[3][2] = { { 0, 1 }, { 0, 2 }, { 1, 2 } };
+	int Sweep, n, k;
+
+	for (n = 0; n < 3; ++n)
+		for (k = 0; k < 3; ++k)
+			Vectors[n][k] = n == k ? 1.0 : 0.0;
+
+	for (Sweep = 0; Sweep < _SYL_JACOBI_SWEEPS; ++Sweep) {
+		double Off = A[0][1] * A[0][1] + A[0][2] * A[0][2] + A[1][2] * A[1][2];
+		double Diagonal = A[0][0] * A[0][0] + A[1][1] * A[1][1] + A[2][2] * A[2][2];
+		if (Off <= 1e-30 * Diagonal)
+			break;
+
+		for (n = 0; n < 3; ++n) {
+			int p = Pairs[n][0], q = Pairs[n][1];
+			double Theta, t, c, s;
+			if (A[p][q] == 0.0)
+				continue;
+
+			Theta = (A[q][q] - A[p][p]) / (2.0 * A[p][q]);
+			t = 1.0 / (fabs(Theta) + sqrt(Theta * Theta + 1.0));
+			t = Theta < 0.0 ? -t : t;
+			c = 1.0 / sqrt(t * t + 1.0);
+			s = t * c;
+
+			for (k = 0; k < 3; ++k) {
+				double kp = A[k][p], kq = A[k][q];
+				A[k][p] = c * kp - s * kq;
+				A[k][q] = s * kp + c * kq;
+			}
+			for (k = 0; k < 3; ++k) {
+				double pk = A[p][k], qk = A[q][k];
+				A[p][k] = c * pk - s * qk;
+				A[q][k] = s * pk + c * qk;
+			}
+			for (k = 0; k < 3; ++k) {
+				double kp = Vectors[k][p], kq = Vectors[k][q];
+				Vectors[k][p] = c * kp - s * kq;
+				Vectors[k][q] = s * kp + c * kq;
+			}
+		}
+	}
+}
+
+/*
+ * Lowest and highest projection on the 3 axes in Min[0..2] and on the world
+ * axes in Min[3..5]. Points are projected relative to Points[0], far from the
+ * origin the absolute projections would lose the small extents.
+ */
+SYL_INLINE void _s_obb_extremes(const svec3* Points, int Count, const svec3* Axes, float* Min, float* Max)
+{
+	const float* In[3] = { Points->e, Points->e + 1, Points->e + 2 };
+	_snf A[3][3], Lo[6], Hi[6], V[3], O[3];
+	float Values[_SYL_LANES];
+	int i, k, l;
+
+	for (k = 0; k < 6; ++k) {
+		Lo[k] = _s_nf_set1(INFINITY);
+		Hi[k] = _s_nf_set1(-INFINITY);
+	}
+	for (k = 0; k < 9; ++k)
+		A[k / 3][k % 3] = _s_nf_set1(Axes[k / 3].e[k % 3]);
+	for (k = 0; k < 3; ++k)
+		O[k] = _s_nf_set1(Points[0].e[k]);
+
+	for (i = 0; i + _SYL_LANES <= Count; i += _SYL_LANES) {
+		_s_vec_load(In, 3, 3, i, _SYL_LANES, V);
+		for (k = 0; k < 3; ++k)
+			V[k] = _s_nf_sub(V[k], O[k]);
+		_snf d0 = _s_nf_madd(V[2], A[0][2], _s_nf_madd(V[1], A[0][1], _s_nf_mul(V[0], A[0][0])));
+		_snf d1 = _s_nf_madd(V[2], A[1][2], _s_nf_madd(V[1], A[1][1], _s_nf_mul(V[0], A[1][0])));
+		_snf d2 = _s_nf_madd(V[2], A[2][2], _s_nf_madd(V[1], A[2][1], _s_nf_mul(V[0], A[2][0])));
+		Lo[0] = _s_nf_min(Lo[0], d0);
+		Hi[0] = _s_nf_max(Hi[0], d0);
+		Lo[1] = _s_nf_min(Lo[1], d1);
+		Hi[1] = _s_nf_max(Hi[1], d1);
+		Lo[2] = _s_nf_min(Lo[2], d2);
+		Hi[2] = _s_nf_max(Hi[2], d2);
+		Lo[3] = _s_nf_min(Lo[3], V[0]);
+		Hi[3] = _s_nf_max(Hi[3], V[0]);
+		Lo[4] = _s_nf_min(Lo[4], V[1]);
+		Hi[4] = _s_nf_max(Hi[4], V[1]);
+		Lo[5] = _s_nf_min(Lo[5], V[2]);
+		Hi[5] = _s_nf_max(Hi[5], V[2]);
+	}
+
+	for (k = 0; k < 6; ++k) {
+		_s_nf_store(Values, Lo[k]);
+		Min[k] = Values[0];
+		for (l = 1; l < _SYL_LANES; ++l)
+			Min[k] = Values[l] < Min[k] ? Values[l] : Min[k];
+		_s_nf_store(Values, Hi[k]);
+		Max[k] = Values[0];
+		for (l = 1; l < _SYL_LANES; ++l)
+			Max[k] = Values[l] > Max[k] ? Values[l] : Max[k];
+	}
+
+	for (; i < Count; ++i) {
+		svec3 p = s_vec3_sub(Points[i], Points[0]);
+		for (k = 0; k < 6; ++k) {
+			float Dot = k < 3 ? s_vec3_dot(p, Axes[k]) : p.e[k - 3];
+			Min[k] = Dot < Min[k] ? Dot : Min[k];
+			Max[k] = Dot > Max[k] ? Dot : Max[k];
+		}
+	}
+}
+
+/* Iterations is the number of refinement passes, 0 gives the plain Ritter sphere */
+SYL_INLINE ssphere s_bounding_sphere(const svec3* Points, int Count, int Iterations)
+{
+	_SYL_PROFILE(s_bounding_sphere);
+	float Best = -1.0f;
+	int MinIndex[_SYL_BOUNDS_DIRECTIONS], MaxIndex[_SYL_BOUNDS_DIRECTIONS], k;
+	ssphere Result, Work;
+
+	if (Count <= 0) {
+		Result.Center = SVEC3(0.0f, 0.0f, 0.0f);
+		Result.Radius = 0.0f;
+		return(Result);
+	}
+
+	_s_sphere_extremes(Points, Count, MinIndex, MaxIndex);
+	for (k = 0; k < _SYL_BOUNDS_DIRECTIONS; ++k) {
+		svec3 a = Points[MinIndex[k]], b = Points[MaxIndex[k]], d = s_vec3_sub(b, a);
+		float DistanceSq = s_vec3_dot(d, d);
+		if (DistanceSq > Best) {
+			Best = DistanceSq;
+			Result.Center = s_vec3_add(a, s_vec3_mul_scalar(d, 0.5f));
+			Result.Radius = sqrtf(DistanceSq) * 0.5f;
+		}
+	}
+	_s_sphere_grow_range(Points, 0, Count, &Result);
+
+	Work = Result;
+	for (k = 1; k <= Iterations; ++k) {
+		int Start = (int)((long long)Count * k / (Iterations + 1));
+		Work.Radius *= _SYL_BOUNDS_SHRINK;
+		_s_sphere_grow_range(Points, Start, Count, &Work);
+		_s_sphere_grow_range(Points, 0, Start, &Work);
+		if (Work.Radius < Result.Radius)
+			Result = Work;
+	}
+
+	Result.Radius = _s_sphere_radius(Points, Count, Result.Center);
+	return(Result);
+}
+
+/*
+ * Box along the principal axes of the points, or along the world axes when
+ * that box is smaller. Axes[0] is the direction of the largest spread: the
+ * largest eigenvalue for the first, the largest extent for the second.
+ */
+SYL_INLINE sobb s_bounding_obb(const svec3* Points, int Count)
+{
+	_SYL_PROFILE(s_bounding_obb);
+	double Covariance[3][3], Vectors[3][3];
+	svec3 Directions[6];
+	float Min[6], Max[6], Volume[2];
+	int Order[3] = { 0, 1, 2 }, Axis[3], Best, k;
+	sobb Result;
+
+	if (Count <= 0) {
+		Result.Center = Result.Extents = SVEC3(0.0f, 0.0f, 0.0f);
+		Result.Axes[0] = SVEC3(1.0f, 0.0f, 0.0f);
+		Result.Axes[1] = SVEC3(0.0f, 1.0f, 0.0f);
+		Result.Axes[2] = SVEC3(0.0f, 0.0f, 1.0f);
+		return(Result);
+	}
+
+	_s_bounds_covariance(Points, Count, Covariance);
+	_s_jacobi_eigen(Covariance, Vectors);
+
+	/* Largest eigenvalue first */
+	for (k = 0; k < 2; ++k) {
+		int n;
+		for (n = 2; n > k; --n) {
+			if (Covariance[Order[n]][Order[n]] > Covariance[Order[n - 1]][Order[n - 1]]) {
+				int t = Order[n];
+				Order[n] = Order[n - 1];
+				Order[n - 1] = t;
+			}
+		}
+	}
+
+	/* Rebuilt in float as a right handed orthonormal basis */
+	for (k = 0; k < 2; ++k) {
+		svec3 a = SVEC3((float)Vectors[0][Order[k]], (float)Vectors[1][Order[k]], (float)Vectors[2][Order[k]]);
+		Directions[k] = s_vec3_mul_scalar(a, 1.0f / sqrtf(s_vec3_dot(a, a)));
+	}
+	Directions[2] = s_vec3_cross(Directions[0], Directions[1]);
+	Directions[2] = s_vec3_mul_scalar(Directions[2], 1.0f / sqrtf(s_vec3_dot(Directions[2], Directions[2])));
+	Directions[1] = s_vec3_cross(Directions[2], Directions[0]);
+	Directions[3] = SVEC3(1.0f, 0.0f, 0.0f);
+	Directions[4] = SVEC3(0.0f, 1.0f, 0.0f);
+	Directions[5] = SVEC3(0.0f, 0.0f, 1.0f);
+
+	_s_obb_extremes(Points, Count, Directions, Min, Max);
+	for (k = 0; k < 2; ++k)
+		Volume[k] = (Max[3 * k] - Min[3 * k]) * (Max[3 * k + 1] - Min[3 * k + 1]) * (Max[3 * k + 2] - Min[3 * k + 2]);
+	Best = Volume[1] < Volume[0] ? 3 : 0;
+	for (k = 0; k < 3; ++k)
+		Axis[k] = Best + k;
+
+	/* World axes are sorted by extent, the PCA ones already are by eigenvalue */
+	if (Best == 3) {
+		for (k = 0; k < 2; ++k) {
+			int n;
+			for (n = 2; n > k; --n) {
+				if (Max[Axis[n]] - Min[Axis[n]] > Max[Axis[n - 1]] - Min[Axis[n - 1]]) {
+					int t = Axis[n];
+					Axis[n] = Axis[n - 1];
+					Axis[n - 1] = t;
+				}
+			}
+		}
+	}
+
+	/* Extremes are relative to Points[0] */
+	Result.Center = Points[0];
+	for (k = 0; k < 3; ++k) {
+		Result.Axes[k] = Directions[Axis[k]];
+		Result.Extents.e[k] = (Max[Axis[k]] - Min[Axis[k]]) * 0.5f;
+		Result.Center = s_vec3_add(Result.Center, s_vec3_mul_scalar(Directions[Axis[k]], (Max[Axis[k]] + Min[Axis[k]]) * 0.5f));
+	}
+	/* An odd permutation of the world axes flips the last one to stay right handed */
+	if (Best == 3)
+		Result.Axes[2] = s_vec3_cross(Result.Axes[0], Result.Axes[1]);
+	return(Result);
+}
+
 #ifdef __cplusplus
 _SYL_CPP_EXTERN_END
 #endif
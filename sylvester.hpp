@@ -0,0 +1,670 @@
+// Sylvester - optimized linear math library
+// https://github.com/hsnovel/Sylvester
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+//
+// C++ front-end over sylvester.h, see sylvester.h for the full license text.
+
+/*   Sylvester C++
+ *
+ *   ===========================================================================
+ *
+ *   Value types with operators over the C types. Arithmetic on vectors builds
+ *   an expression that is evaluated once on assignment, so a * k + b is a
+ *   single SIMD expression and becomes a fused multiply-add when
+ *   SYL_ENABLE_AVX is defined. Define the same SYL_ENABLE_* flags as for
+ *   sylvester.h, SYL_IMPLEMENTATION still has to be defined in one file.
+ *
+ *   Expressions hold their operands by value, it is safe to keep one in an
+ *   auto variable but it is evaluated again every time it is used.
+ *
+ *   DO NOT ACCESS ANYTHING IN syl::detail, IT IS INTERNAL ONLY.
+ *
+ *   ===========================================================================
+ *
+ */
+
+#ifndef SYLVESTER_HPP
+#define SYLVESTER_HPP
+
+#include "sylvester.h"
+#include <type_traits>
+
+/*
+ * Constructors and the pure functions below are constexpr from C++14 on, so
+ * constant matrices and vectors are built at compile time. Outside of constant
+ * expressions they take the SIMD path when the compiler can tell the two apart.
+ */
+#if __cplusplus >= 201402L || (defined(_MSVC_LANG) && _MSVC_LANG >= 201402L)
+#	define SYL_CONSTEXPR constexpr
+#	if defined(__cpp_lib_is_constant_evaluated)
+#		define _SYL_CONSTANT_EVALUATED() std::is_constant_evaluated()
+#	elif defined(__clang__)
+#		if __has_builtin(__builtin_is_constant_evaluated)
+#			define _SYL_CONSTANT_EVALUATED() __builtin_is_constant_evaluated()
+#		else
+#			define _SYL_CONSTANT_EVALUATED() true
+#		endif
+#	elif (defined(__GNUC__) && __GNUC__ >= 9) || (defined(_MSC_VER) && _MSC_VER >= 1925)
+#		define _SYL_CONSTANT_EVALUATED() __builtin_is_constant_evaluated()
+#	else
+#		define _SYL_CONSTANT_EVALUATED() true
+#	endif
+#else
+#	define SYL_CONSTEXPR
+#	define _SYL_CONSTANT_EVALUATED() false
+#endif
+
+namespace syl
+{
+
+namespace detail
+{
+
+/* Every vector is evaluated as four lanes, unused lanes are zero */
+#if defined(SYL_ENABLE_SSE4) || defined(SYL_ENABLE_AVX)
+typedef __m128 pack;
+
+static inline pack set1(float a) { return(_mm_set1_ps(a)); }
+static inline pack set(float x, float y, float z, float w) { return(_mm_setr_ps(x, y, z, w)); }
+static inline pack load4(const float* p) { return(_mm_loadu_ps(p)); }
+static inline void store4(float* p, pack a) { _mm_storeu_ps(p, a); }
+static inline pack add(pack a, pack b) { return(_mm_add_ps(a, b)); }
+static inline pack sub(pack a, pack b) { return(_mm_sub_ps(a, b)); }
+static inline pack mul(pack a, pack b) { return(_mm_mul_ps(a, b)); }
+static inline pack div(pack a, pack b) { return(_mm_div_ps(a, b)); }
+static inline pack neg(pack a) { return(_mm_xor_ps(a, _mm_set1_ps(-0.0f))); }
+static inline pack min(pack a, pack b) { return(_mm_min_ps(a, b)); }
+static inline pack max(pack a, pack b) { return(_mm_max_ps(a, b)); }
+static inline float lane(pack a, int i) { float e[4]; _mm_storeu_ps(e, a); return(e[i]); }
+/* Only the first Dims lanes, the rest can hold anything after a division */
+static inline float dot(pack a, pack b, int Dims)
+{
+	switch (Dims) {
+	case 2: return(_mm_cvtss_f32(_mm_dp_ps(a, b, 0x31)));
+	case 3: return(_mm_cvtss_f32(_mm_dp_ps(a, b, 0x71)));
+	default: return(_mm_cvtss_f32(_mm_dp_ps(a, b, 0xF1)));
+	}
+}
+static inline pack splat(pack a, int i)
+{
+	switch (i) {
+	case 0: return(_mm_shuffle_ps(a, a, _MM_SHUFFLE(0, 0, 0, 0)));
+	case 1: return(_mm_shuffle_ps(a, a, _MM_SHUFFLE(1, 1, 1, 1)));
+	case 2: return(_mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 2, 2, 2)));
+	default: return(_mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 3, 3, 3)));
+	}
+}
+/* yzx swizzle for cross products */
+static inline pack yzx(pack a) { return(_mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 0, 2, 1))); }
+#if defined(SYL_ENABLE_AVX)
+static inline pack madd(pack a, pack b, pack c) { return(_mm_fmadd_ps(a, b, c)); }
+static inline pack msub(pack a, pack b, pack c) { return(_mm_fmsub_ps(a, b, c)); }
+static inline pack nmadd(pack a, pack b, pack c) { return(_mm_fnmadd_ps(a, b, c)); }
+#else
+static inline pack madd(pack a, pack b, pack c) { return(_mm_add_ps(_mm_mul_ps(a, b), c)); }
+static inline pack msub(pack a, pack b, pack c) { return(_mm_sub_ps(_mm_mul_ps(a, b), c)); }
+static inline pack nmadd(pack a, pack b, pack c) { return(_mm_sub_ps(c, _mm_mul_ps(a, b))); }
+#endif
+#else
+struct pack { float e[4]; };
+
+static inline pack set(float x, float y, float z, float w) { pack r = { { x, y, z, w } }; return(r); }
+static inline pack set1(float a) { return(set(a, a, a, a)); }
+static inline pack load4(const float* p) { return(set(p[0], p[1], p[2], p[3])); }
+static inline void store4(float* p, pack a) { for (int i = 0; i < 4; ++i) p[i] = a.e[i]; }
+#define _SYL_HPP_LANES(expr) pack r; for (int i = 0; i < 4; ++i) r.e[i] = (expr); return(r)
+static inline pack add(pack a, pack b) { _SYL_HPP_LANES(a.e[i] + b.e[i]); }
+static inline pack sub(pack a, pack b) { _SYL_HPP_LANES(a.e[i] - b.e[i]); }
+static inline pack mul(pack a, pack b) { _SYL_HPP_LANES(a.e[i] * b.e[i]); }
+static inline pack div(pack a, pack b) { _SYL_HPP_LANES(a.e[i] / b.e[i]); }
+static inline pack neg(pack a) { _SYL_HPP_LANES(-a.e[i]); }
+static inline pack min(pack a, pack b) { _SYL_HPP_LANES(a.e[i] < b.e[i] ? a.e[i] : b.e[i]); }
+static inline pack max(pack a, pack b) { _SYL_HPP_LANES(a.e[i] > b.e[i] ? a.e[i] : b.e[i]); }
+static inline pack madd(pack a, pack b, pack c) { _SYL_HPP_LANES(a.e[i] * b.e[i] + c.e[i]); }
+static inline pack msub(pack a, pack b, pack c) { _SYL_HPP_LANES(a.e[i] * b.e[i] - c.e[i]); }
+static inline pack nmadd(pack a, pack b, pack c) { _SYL_HPP_LANES(c.e[i] - a.e[i] * b.e[i]); }
+static inline pack splat(pack a, int n) { _SYL_HPP_LANES(a.e[n]); }
+static inline pack yzx(pack a) { return(set(a.e[1], a.e[2], a.e[0], a.e[3])); }
+#undef _SYL_HPP_LANES
+static inline float lane(pack a, int i) { return(a.e[i]); }
+static inline float dot(pack a, pack b, int Dims)
+{
+	float r = 0.0f;
+	for (int i = 0; i < (Dims ? Dims : 4); ++i)
+		r += a.e[i] * b.e[i];
+	return(r);
+}
+#endif
+
+/* Everything that can be evaluated into a pack derives from this */
+struct expr_tag {};
+
+template<class T>
+struct is_expr { enum { value = std::is_base_of<expr_tag, typename std::decay<T>::type>::value }; };
+
+/* Scalars broadcast and match any dimension */
+struct scalar_expr : expr_tag
+{
+	enum { Dims = 0 };
+	float k;
+	explicit scalar_expr(float K) : k(K) {}
+	pack eval() const { return(set1(k)); }
+};
+
+template<class L, class R>
+struct dims_of
+{
+	static_assert((int)L::Dims == 0 || (int)R::Dims == 0 || (int)L::Dims == (int)R::Dims,
+		      "sylvester: vector dimensions don't match");
+	enum { value = (int)L::Dims ? (int)L::Dims : (int)R::Dims };
+};
+
+struct op_add;
+struct op_sub;
+struct op_mul;
+struct op_div;
+
+template<class Op, class L, class R>
+struct binary_expr : expr_tag
+{
+	enum { Dims = dims_of<L, R>::value };
+	L l;
+	R r;
+	binary_expr(const L& Left, const R& Right) : l(Left), r(Right) {}
+	pack eval() const { return(Op::apply(l, r)); }
+};
+
+template<class E>
+struct neg_expr : expr_tag
+{
+	enum { Dims = E::Dims };
+	E e;
+	explicit neg_expr(const E& Expr) : e(Expr) {}
+	pack eval() const { return(neg(e.eval())); }
+};
+
+/* Products next to a sum or a difference are fused */
+struct op_add
+{
+	template<class L, class R>
+	static pack apply(const L& l, const R& r) { return(add(l.eval(), r.eval())); }
+	template<class A, class B, class R>
+	static pack apply(const binary_expr<op_mul, A, B>& l, const R& r) { return(madd(l.l.eval(), l.r.eval(), r.eval())); }
+	template<class L, class A, class B>
+	static pack apply(const L& l, const binary_expr<op_mul, A, B>& r) { return(madd(r.l.eval(), r.r.eval(), l.eval())); }
+	template<class A, class B, class C, class D>
+	static pack apply(const binary_expr<op_mul, A, B>& l, const binary_expr<op_mul, C, D>& r)
+	{
+		return(madd(l.l.eval(), l.r.eval(), mul(r.l.eval(), r.r.eval())));
+	}
+};
+
+struct op_sub
+{
+	template<class L, class R>
+	static pack apply(const L& l, const R& r) { return(sub(l.eval(), r.eval())); }
+	template<class A, class B, class R>
+	static pack apply(const binary_expr<op_mul, A, B>& l, const R& r) { return(msub(l.l.eval(), l.r.eval(), r.eval())); }
+	template<class L, class A, class B>
+	static pack apply(const L& l, const binary_expr<op_mul, A, B>& r) { return(nmadd(r.l.eval(), r.r.eval(), l.eval())); }
+	template<class A, class B, class C, class D>
+	static pack apply(const binary_expr<op_mul, A, B>& l, const binary_expr<op_mul, C, D>& r)
+	{
+		return(msub(l.l.eval(), l.r.eval(), mul(r.l.eval(), r.r.eval())));
+	}
+};
+
+struct op_mul
+{
+	template<class L, class R>
+	static pack apply(const L& l, const R& r) { return(mul(l.eval(), r.eval())); }
+};
+
+struct op_div
+{
+	template<class L, class R>
+	static pack apply(const L& l, const R& r) { return(div(l.eval(), r.eval())); }
+};
+
+template<class L, class R>
+struct both_expr { enum { value = is_expr<L>::value && is_expr<R>::value }; };
+
+/* Dimension of a compound assignment, 0 when either side isn't an expression
+   so dims_of is only instantiated, and its static_assert only fires, for ours */
+template<class L, class R, bool = both_expr<L, R>::value>
+struct assign_dims { enum { value = 0 }; };
+
+template<class L, class R>
+struct assign_dims<L, R, true> { enum { value = dims_of<L, R>::value }; };
+
+} // namespace detail
+
+/*********************************************
+ *                  VECTORS                   *
+ *********************************************/
+
+struct vec2 : detail::expr_tag
+{
+	enum { Dims = 2 };
+	union { svec2 c; struct { float x, y; }; float e[2]; };
+
+	SYL_CONSTEXPR vec2() : c() {}
+	SYL_CONSTEXPR vec2(float X, float Y) : c{ { X, Y } } {}
+	SYL_CONSTEXPR explicit vec2(float Value) : c{ { Value, Value } } {}
+	SYL_CONSTEXPR vec2(svec2 Vector) : c(Vector) {}
+	template<class E, class = typename std::enable_if<detail::is_expr<E>::value && (int)E::Dims == 2>::type>
+	vec2(const E& Expr) { store(Expr.eval()); }
+	template<class E>
+	typename std::enable_if<detail::is_expr<E>::value && (int)E::Dims == 2, vec2&>::type
+	operator=(const E& Expr) { store(Expr.eval()); return(*this); }
+
+	SYL_CONSTEXPR operator svec2() const { return(c); }
+	float& operator[](int i) { return(e[i]); }
+	float operator[](int i) const { return(e[i]); }
+
+	detail::pack eval() const { return(detail::set(x, y, 0.0f, 0.0f)); }
+	void store(detail::pack p) { x = detail::lane(p, 0); y = detail::lane(p, 1); }
+};
+
+struct vec3 : detail::expr_tag
+{
+	enum { Dims = 3 };
+	union { svec3 c; struct { float x, y, z; }; float e[3]; };
+
+	SYL_CONSTEXPR vec3() : c() {}
+	SYL_CONSTEXPR vec3(float X, float Y, float Z) : c{ { X, Y, Z } } {}
+	SYL_CONSTEXPR explicit vec3(float Value) : c{ { Value, Value, Value } } {}
+	SYL_CONSTEXPR vec3(svec3 Vector) : c(Vector) {}
+	template<class E, class = typename std::enable_if<detail::is_expr<E>::value && (int)E::Dims == 3>::type>
+	vec3(const E& Expr) { store(Expr.eval()); }
+	template<class E>
+	typename std::enable_if<detail::is_expr<E>::value && (int)E::Dims == 3, vec3&>::type
+	operator=(const E& Expr) { store(Expr.eval()); return(*this); }
+
+	SYL_CONSTEXPR operator svec3() const { return(c); }
+	float& operator[](int i) { return(e[i]); }
+	float operator[](int i) const { return(e[i]); }
+
+	/* svec3 is 12 bytes, it is never read or written as 16 */
+	detail::pack eval() const { return(detail::set(x, y, z, 0.0f)); }
+	void store(detail::pack p)
+	{
+		float t[4];
+		detail::store4(t, p);
+		x = t[0]; y = t[1]; z = t[2];
+	}
+};
+
+struct vec4 : detail::expr_tag
+{
+	enum { Dims = 4 };
+	union { svec4 c; struct { float x, y, z, w; }; float e[4]; };
+
+	SYL_CONSTEXPR vec4() : c() {}
+	SYL_CONSTEXPR vec4(float X, float Y, float Z, float W) : c{ { X, Y, Z, W } } {}
+	SYL_CONSTEXPR explicit vec4(float Value) : c{ { Value, Value, Value, Value } } {}
+	SYL_CONSTEXPR vec4(const vec3& Vector, float W) : c{ { Vector.c.x, Vector.c.y, Vector.c.z, W } } {}
+	SYL_CONSTEXPR vec4(svec4 Vector) : c(Vector) {}
+	template<class E, class = typename std::enable_if<detail::is_expr<E>::value && (int)E::Dims == 4>::type>
+	vec4(const E& Expr) { store(Expr.eval()); }
+	template<class E>
+	typename std::enable_if<detail::is_expr<E>::value && (int)E::Dims == 4, vec4&>::type
+	operator=(const E& Expr) { store(Expr.eval()); return(*this); }
+
+	SYL_CONSTEXPR operator svec4() const { return(c); }
+	float& operator[](int i) { return(e[i]); }
+	float operator[](int i) const { return(e[i]); }
+
+	detail::pack eval() const { return(detail::load4(e)); }
+	void store(detail::pack p) { detail::store4(e, p); }
+};
+
+/* Operators, any mix of vectors and expressions of the same dimension */
+template<class L, class R>
+inline typename std::enable_if<detail::both_expr<L, R>::value, detail::binary_expr<detail::op_add, L, R> >::type
+operator+(const L& Left, const R& Right) { return(detail::binary_expr<detail::op_add, L, R>(Left, Right)); }
+
+template<class L, class R>
+inline typename std::enable_if<detail::both_expr<L, R>::value, detail::binary_expr<detail::op_sub, L, R> >::type
+operator-(const L& Left, const R& Right) { return(detail::binary_expr<detail::op_sub, L, R>(Left, Right)); }
+
+template<class L, class R>
+inline typename std::enable_if<detail::both_expr<L, R>::value, detail::binary_expr<detail::op_mul, L, R> >::type
+operator*(const L& Left, const R& Right) { return(detail::binary_expr<detail::op_mul, L, R>(Left, Right)); }
+
+template<class L, class R>
+inline typename std::enable_if<detail::both_expr<L, R>::value, detail::binary_expr<detail::op_div, L, R> >::type
+operator/(const L& Left, const R& Right) { return(detail::binary_expr<detail::op_div, L, R>(Left, Right)); }
+
+template<class E>
+inline typename std::enable_if<detail::is_expr<E>::value, detail::binary_expr<detail::op_mul, E, detail::scalar_expr> >::type
+operator*(const E& Expr, float Value) { return(detail::binary_expr<detail::op_mul, E, detail::scalar_expr>(Expr, detail::scalar_expr(Value))); }
+
+template<class E>
+inline typename std::enable_if<detail::is_expr<E>::value, detail::binary_expr<detail::op_mul, detail::scalar_expr, E> >::type
+operator*(float Value, const E& Expr) { return(detail::binary_expr<detail::op_mul, detail::scalar_expr, E>(detail::scalar_expr(Value), Expr)); }
+
+template<class E>
+inline typename std::enable_if<detail::is_expr<E>::value, detail::binary_expr<detail::op_div, E, detail::scalar_expr> >::type
+operator/(const E& Expr, float Value) { return(detail::binary_expr<detail::op_div, E, detail::scalar_expr>(Expr, detail::scalar_expr(Value))); }
+
+template<class E>
+inline typename std::enable_if<detail::is_expr<E>::value, detail::neg_expr<E> >::type
+operator-(const E& Expr) { return(detail::neg_expr<E>(Expr)); }
+
+template<class V, class E>
+inline typename std::enable_if<(int)detail::assign_dims<V, E>::value >= 2, V&>::type
+operator+=(V& Vector, const E& Expr) { Vector.store(detail::add(Vector.eval(), Expr.eval())); return(Vector); }
+
+template<class V, class E>
+inline typename std::enable_if<(int)detail::assign_dims<V, E>::value >= 2, V&>::type
+operator-=(V& Vector, const E& Expr) { Vector.store(detail::sub(Vector.eval(), Expr.eval())); return(Vector); }
+
+template<class V>
+inline typename std::enable_if<detail::is_expr<V>::value && (int)V::Dims >= 2, V&>::type
+operator*=(V& Vector, float Value) { Vector.store(detail::mul(Vector.eval(), detail::set1(Value))); return(Vector); }
+
+template<class V>
+inline typename std::enable_if<detail::is_expr<V>::value && (int)V::Dims >= 2, V&>::type
+operator/=(V& Vector, float Value) { Vector.store(detail::div(Vector.eval(), detail::set1(Value))); return(Vector); }
+
+template<class L, class R>
+inline typename std::enable_if<detail::both_expr<L, R>::value, float>::type
+dot(const L& Left, const R& Right)
+{
+	return(detail::dot(Left.eval(), Right.eval(), detail::dims_of<L, R>::value));
+}
+
+template<class E>
+inline typename std::enable_if<detail::is_expr<E>::value, float>::type
+length(const E& Expr) { return(sqrtf(dot(Expr, Expr))); }
+
+template<class E>
+inline typename std::enable_if<detail::is_expr<E>::value, detail::binary_expr<detail::op_mul, E, detail::scalar_expr> >::type
+normalize(const E& Expr) { return(Expr * (1.0f / length(Expr))); }
+
+template<class L, class R>
+inline typename std::enable_if<detail::both_expr<L, R>::value, detail::binary_expr<detail::op_mul, L, R> >::type
+hadamard(const L& Left, const R& Right) { return(Left * Right); }
+
+inline vec2 min(const vec2& a, const vec2& b) { vec2 r; r.store(detail::min(a.eval(), b.eval())); return(r); }
+inline vec3 min(const vec3& a, const vec3& b) { vec3 r; r.store(detail::min(a.eval(), b.eval())); return(r); }
+inline vec4 min(const vec4& a, const vec4& b) { vec4 r; r.store(detail::min(a.eval(), b.eval())); return(r); }
+inline vec2 max(const vec2& a, const vec2& b) { vec2 r; r.store(detail::max(a.eval(), b.eval())); return(r); }
+inline vec3 max(const vec3& a, const vec3& b) { vec3 r; r.store(detail::max(a.eval(), b.eval())); return(r); }
+inline vec4 max(const vec4& a, const vec4& b) { vec4 r; r.store(detail::max(a.eval(), b.eval())); return(r); }
+
+template<class L, class R>
+inline typename std::enable_if<detail::both_expr<L, R>::value && (int)detail::dims_of<L, R>::value == 3, vec3>::type
+cross(const L& Left, const R& Right)
+{
+	detail::pack a = Left.eval(), b = Right.eval();
+	vec3 Result;
+	Result.store(detail::yzx(detail::msub(a, detail::yzx(b), detail::mul(detail::yzx(a), b))));
+	return(Result);
+}
+
+/*********************************************
+ *                QUATERNIONS                 *
+ *********************************************/
+
+struct quat
+{
+	union { squat c; struct { float x, y, z, w; }; float e[4]; };
+
+	SYL_CONSTEXPR quat() : c{ { 0.0f, 0.0f, 0.0f, 1.0f } } {}
+	SYL_CONSTEXPR quat(float X, float Y, float Z, float W) : c{ { X, Y, Z, W } } {}
+	SYL_CONSTEXPR quat(squat Quat) : c(Quat) {}
+	SYL_CONSTEXPR operator squat() const { return(c); }
+
+	/* Axis has to be normalized */
+	static quat axis_angle(const vec3& Axis, float Angle)
+	{
+		float s = sinf(Angle * 0.5f);
+		return(quat(Axis.x * s, Axis.y * s, Axis.z * s, cosf(Angle * 0.5f)));
+	}
+};
+
+/* Hamilton product, Left * Right applies Right first */
+inline quat operator*(const quat& Left, const quat& Right)
+{
+	return(quat(Left.w * Right.x + Left.x * Right.w + Left.y * Right.z - Left.z * Right.y,
+		    Left.w * Right.y - Left.x * Right.z + Left.y * Right.w + Left.z * Right.x,
+		    Left.w * Right.z + Left.x * Right.y - Left.y * Right.x + Left.z * Right.w,
+		    Left.w * Right.w - Left.x * Right.x - Left.y * Right.y - Left.z * Right.z));
+}
+
+inline quat conjugate(const quat& Quat) { return(quat(-Quat.x, -Quat.y, -Quat.z, Quat.w)); }
+
+inline quat normalize(const quat& Quat)
+{
+	float Inv = 1.0f / sqrtf(Quat.x * Quat.x + Quat.y * Quat.y + Quat.z * Quat.z + Quat.w * Quat.w);
+	return(quat(Quat.x * Inv, Quat.y * Inv, Quat.z * Inv, Quat.w * Inv));
+}
+
+/* v + 2w(u x v) + 2u x (u x v) for a unit quaternion */
+inline vec3 operator*(const quat& Quat, const vec3& Vector)
+{
+	vec3 u(Quat.x, Quat.y, Quat.z);
+	vec3 t = cross(u, Vector) * 2.0f;
+	return(Vector + t * Quat.w + cross(u, t));
+}
+
+/*********************************************
+ *                  MATRICES                  *
+ *********************************************/
+
+/* Column-major like smat4, operator[] returns a column */
+struct mat4
+{
+	smat4 c;
+
+	SYL_CONSTEXPR mat4() : c{ { 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f } } {}
+	/* Same order as SMAT4F, one column after another */
+	SYL_CONSTEXPR mat4(float m00, float m01, float m02, float m03,
+			   float m10, float m11, float m12, float m13,
+			   float m20, float m21, float m22, float m23,
+			   float m30, float m31, float m32, float m33)
+		: c{ { m00, m01, m02, m03, m10, m11, m12, m13, m20, m21, m22, m23, m30, m31, m32, m33 } } {}
+	SYL_CONSTEXPR mat4(smat4 Matrix) : c(Matrix) {}
+	SYL_CONSTEXPR operator smat4() const { return(c); }
+
+	vec4& operator[](int i) { return(*reinterpret_cast<vec4*>(&c.e[i * 4])); }
+	const vec4& operator[](int i) const { return(*reinterpret_cast<const vec4*>(&c.e[i * 4])); }
+
+	/* Element i of e[16], also usable in constant expressions */
+	SYL_CONSTEXPR float at(int i) const
+	{
+		switch (i) {
+		case 0: return(c.m00); case 1: return(c.m01); case 2: return(c.m02); case 3: return(c.m03);
+		case 4: return(c.m10); case 5: return(c.m11); case 6: return(c.m12); case 7: return(c.m13);
+		case 8: return(c.m20); case 9: return(c.m21); case 10: return(c.m22); case 11: return(c.m23);
+		case 12: return(c.m30); case 13: return(c.m31); case 14: return(c.m32); default: return(c.m33);
+		}
+	}
+
+	static SYL_CONSTEXPR mat4 identity() { return(mat4()); }
+	static mat4 trs(const vec3& Translation, const quat& Rotation, const vec3& Scale)
+	{
+		return(mat4(s_mat4_from_trs(Translation, Rotation, Scale)));
+	}
+	static SYL_CONSTEXPR mat4 ortho_rh(float Left, float Right, float Bottom, float Top, float Near, float Far);
+	static SYL_CONSTEXPR mat4 perspective_rh(float Fov, float AspectRatio, float Near, float Far);
+};
+
+namespace detail
+{
+SYL_CONSTEXPR inline mat4 cx_mat4(const float* e)
+{
+	return(mat4(e[0], e[1], e[2], e[3], e[4], e[5], e[6], e[7],
+		    e[8], e[9], e[10], e[11], e[12], e[13], e[14], e[15]));
+}
+
+/* Taylor series after reducing to [-pi, pi], only used in constant expressions */
+SYL_CONSTEXPR inline double cx_tan(double x)
+{
+	const double Pi = 3.14159265358979323846;
+	long long k = (long long)(x / (2.0 * Pi) + (x >= 0.0 ? 0.5 : -0.5));
+	x -= (double)k * 2.0 * Pi;
+	double Sin = x, Cos = 1.0, s = x, c = 1.0;
+	for (int n = 1; n < 16; ++n) {
+		s *= -x * x / ((2.0 * n) * (2.0 * n + 1.0));
+		c *= -x * x / ((2.0 * n - 1.0) * (2.0 * n));
+		Sin += s;
+		Cos += c;
+	}
+	return(Sin / Cos);
+}
+
+template<class V>
+struct is_vec
+{
+	enum { value = std::is_same<V, vec2>::value || std::is_same<V, vec3>::value || std::is_same<V, vec4>::value };
+};
+
+SYL_CONSTEXPR inline float cx_op(int Op, float a, float b) { return(Op == 0 ? a + b : Op == 1 ? a - b : a * b); }
+
+template<int Op>
+SYL_CONSTEXPR inline vec2 cx_lanes(const vec2& a, const vec2& b)
+{
+	return(vec2(cx_op(Op, a.c.x, b.c.x), cx_op(Op, a.c.y, b.c.y)));
+}
+
+template<int Op>
+SYL_CONSTEXPR inline vec3 cx_lanes(const vec3& a, const vec3& b)
+{
+	return(vec3(cx_op(Op, a.c.x, b.c.x), cx_op(Op, a.c.y, b.c.y), cx_op(Op, a.c.z, b.c.z)));
+}
+
+template<int Op>
+SYL_CONSTEXPR inline vec4 cx_lanes(const vec4& a, const vec4& b)
+{
+	return(vec4(cx_op(Op, a.c.x, b.c.x), cx_op(Op, a.c.y, b.c.y), cx_op(Op, a.c.z, b.c.z), cx_op(Op, a.c.w, b.c.w)));
+}
+
+static inline pack transform(const smat4& m, pack v)
+{
+	pack r = mul(load4(m.e), splat(v, 0));
+	r = madd(load4(m.e + 4), splat(v, 1), r);
+	r = madd(load4(m.e + 8), splat(v, 2), r);
+	return(madd(load4(m.e + 12), splat(v, 3), r));
+}
+} // namespace detail
+
+inline SYL_CONSTEXPR mat4 operator*(const mat4& Left, const mat4& Right)
+{
+	if (!_SYL_CONSTANT_EVALUATED()) {
+		mat4 Result;
+		for (int i = 0; i < 4; ++i)
+			detail::store4(Result.c.e + i * 4, detail::transform(Left.c, detail::load4(Right.c.e + i * 4)));
+		return(Result);
+	}
+	float r[16] = {};
+	for (int i = 0; i < 4; ++i)
+		for (int j = 0; j < 4; ++j)
+			for (int k = 0; k < 4; ++k)
+				r[i * 4 + j] += Left.at(k * 4 + j) * Right.at(i * 4 + k);
+	return(detail::cx_mat4(r));
+}
+
+inline vec4 operator*(const mat4& Matrix, const vec4& Vector)
+{
+	vec4 Result;
+	Result.store(detail::transform(Matrix.c, Vector.eval()));
+	return(Result);
+}
+
+inline mat4& operator*=(mat4& Left, const mat4& Right) { Left = Left * Right; return(Left); }
+
+/* Points get the translation, directions don't */
+inline vec3 transform_point(const mat4& Matrix, const vec3& Point)
+{
+	vec3 Result;
+	Result.store(detail::transform(Matrix.c, detail::set(Point.x, Point.y, Point.z, 1.0f)));
+	return(Result);
+}
+
+inline vec3 transform_vector(const mat4& Matrix, const vec3& Vector)
+{
+	vec3 Result;
+	Result.store(detail::transform(Matrix.c, Vector.eval()));
+	return(Result);
+}
+
+inline SYL_CONSTEXPR mat4 transpose(const mat4& Matrix)
+{
+	if (!_SYL_CONSTANT_EVALUATED()) {
+		mat4 Result;
+		for (int i = 0; i < 4; ++i)
+			for (int j = 0; j < 4; ++j)
+				Result.c.e[i * 4 + j] = Matrix.c.e[j * 4 + i];
+		return(Result);
+	}
+	float r[16] = {};
+	for (int i = 0; i < 4; ++i)
+		for (int j = 0; j < 4; ++j)
+			r[i * 4 + j] = Matrix.at(j * 4 + i);
+	return(detail::cx_mat4(r));
+}
+
+inline SYL_CONSTEXPR mat4 mat4::ortho_rh(float Left, float Right, float Bottom, float Top, float Near, float Far)
+{
+	return(mat4(2.0f / (Right - Left), 0.0f, 0.0f, 0.0f,
+		    0.0f, 2.0f / (Top - Bottom), 0.0f, 0.0f,
+		    0.0f, 0.0f, -2.0f / (Far - Near), 0.0f,
+		    -(Right + Left) / (Right - Left), -(Top + Bottom) / (Top - Bottom), -(Far + Near) / (Far - Near), 1.0f));
+}
+
+inline SYL_CONSTEXPR mat4 mat4::perspective_rh(float Fov, float AspectRatio, float Near, float Far)
+{
+	float TanHalfFov = _SYL_CONSTANT_EVALUATED() ? (float)detail::cx_tan(Fov * 0.5) : tanf(Fov * 0.5f);
+	return(mat4(1.0f / (AspectRatio * TanHalfFov), 0.0f, 0.0f, 0.0f,
+		    0.0f, 1.0f / TanHalfFov, 0.0f, 0.0f,
+		    0.0f, 0.0f, -(Far + Near) / (Far - Near), -1.0f,
+		    0.0f, 0.0f, -(2.0f * Far * Near) / (Far - Near), 0.0f));
+}
+
+/* Component wise functions that can run at compile time, the operators above can't */
+template<class V>
+inline SYL_CONSTEXPR typename std::enable_if<detail::is_vec<V>::value, V>::type
+add(const V& Left, const V& Right)
+{
+	if (!_SYL_CONSTANT_EVALUATED()) {
+		V Result;
+		Result.store(detail::add(Left.eval(), Right.eval()));
+		return(Result);
+	}
+	return(detail::cx_lanes<0>(Left, Right));
+}
+
+template<class V>
+inline SYL_CONSTEXPR typename std::enable_if<detail::is_vec<V>::value, V>::type
+sub(const V& Left, const V& Right)
+{
+	if (!_SYL_CONSTANT_EVALUATED()) {
+		V Result;
+		Result.store(detail::sub(Left.eval(), Right.eval()));
+		return(Result);
+	}
+	return(detail::cx_lanes<1>(Left, Right));
+}
+
+template<class V>
+inline SYL_CONSTEXPR typename std::enable_if<detail::is_vec<V>::value, V>::type
+mul(const V& Left, const V& Right)
+{
+	if (!_SYL_CONSTANT_EVALUATED()) {
+		V Result;
+		Result.store(detail::mul(Left.eval(), Right.eval()));
+		return(Result);
+	}
+	return(detail::cx_lanes<2>(Left, Right));
+}
+
+template<class V>
+inline SYL_CONSTEXPR typename std::enable_if<detail::is_vec<V>::value, V>::type
+mul(const V& Vector, float Value) { return(mul(Vector, V(Value))); }
+
+} // namespace syl
+
+#endif // SYLVESTER_HPP
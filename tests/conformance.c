@@ -0,0 +1,1620 @@
+/*
+ * Differential conformance test. The same file is built once per instruction
+ * set, every build runs every function on the same inputs and writes the
+ * results to a file. Compare mode reads the scalar results and the SIMD ones
+ * and prints the largest ULP difference per function.
+ *
+ *   conformance write <file>                  run everything, write the results
+ *   conformance compare <scalar> <file>...    report, fails past a bound
+ *   conformance cpu <sse4|avx>                exit 0 if this machine runs the build
+ *
+ * Inputs come from a fixed LCG and a table of edge values, so every build sees
+ * the same numbers. The components of a vector or matrix are compared in ULPs
+ * of the largest component, and every function has a bound for the kind of
+ * arithmetic it does, see the classes below. Integers, booleans and indices
+ * have to match exactly. Build instructions are in README.md.
+ */
+
+#define SYL_IMPLEMENTATION
+#include "../sylvester.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CASES 512
+#define ARRAY_COUNT 1031
+
+typedef unsigned int uint;
+
+/*********************************************
+ *                  INPUTS                    *
+ *********************************************/
+
+static unsigned int Seed;
+static int Case, Draw;
+
+static const float Edges[] = {
+	0.0f, -0.0f, 1.0f, -1.0f, 0.5f, -0.5f, 2.0f, 3.0f, -7.25f, 1e-6f, -1e-6f, 1e6f, -1e6f, 0.1f, 100.0f, 1e-30f,
+};
+#define EDGE_COUNT ((int)(sizeof(Edges) / sizeof(Edges[0])))
+#define EDGE_CASES 64
+
+static unsigned int next_uint(void)
+{
+	Seed = Seed * 1664525u + 1013904223u;
+	return(Seed);
+}
+
+/* Uniform in [Min, Max) */
+static float next_float(float Min, float Max)
+{
+	return(Min + (Max - Min) * (float)(next_uint() >> 8) * (1.0f / 16777216.0f));
+}
+
+static float gen_float(void)
+{
+	if (Case < EDGE_CASES)
+		return(Edges[(Case * 7 + Draw++) % EDGE_COUNT]);
+	if ((Case & 15) == 0)
+		return(next_float(-1000.0f, 1000.0f));
+	return(next_float(-10.0f, 10.0f));
+}
+
+static double gen_double(void) { return(gen_float()); }
+static int gen_int(void) { return((int)next_uint()); }
+static uint gen_uint(void) { return(next_uint()); }
+static svec2 gen_svec2(void) { svec2 r; r.x = gen_float(); r.y = gen_float(); return(r); }
+static svec3 gen_svec3(void) { svec3 r; r.x = gen_float(); r.y = gen_float(); r.z = gen_float(); return(r); }
+static svec4 gen_svec4(void) { svec4 r; r.x = gen_float(); r.y = gen_float(); r.z = gen_float(); r.w = gen_float(); return(r); }
+
+static smat4 gen_smat4(void)
+{
+	smat4 r;
+	for (int i = 0; i < 16; ++i)
+		r.e[i] = gen_float();
+	return(r);
+}
+
+static smat3x4 gen_smat3x4(void)
+{
+	smat3x4 r;
+	for (int i = 0; i < 12; ++i)
+		r.e[i] = gen_float();
+	return(r);
+}
+
+static squat gen_squat(void)
+{
+	squat q;
+	float Length = 0.0f;
+	for (int i = 0; i < 4; ++i) {
+		q.e[i] = next_float(-1.0f, 1.0f);
+		Length += q.e[i] * q.e[i];
+	}
+	Length = Length > 1e-6f ? 1.0f / sqrtf(Length) : 0.0f;
+	for (int i = 0; i < 4; ++i)
+		q.e[i] = Length != 0.0f ? q.e[i] * Length : (i == 3);
+	return(q);
+}
+
+/* Rotation and translation without scale */
+static smat3x4 gen_rigid(void)
+{
+	squat q = gen_squat();
+	smat4 m = s_mat4_from_trs(SVEC3(next_float(-5.0f, 5.0f), next_float(-5.0f, 5.0f), next_float(-5.0f, 5.0f)), q, SVEC3(1.0f, 1.0f, 1.0f));
+	return(s_mat3x4_from_mat4(m));
+}
+
+static void fill(float* Out, int Count, float Min, float Max)
+{
+	for (int i = 0; i < Count; ++i)
+		Out[i] = next_float(Min, Max);
+}
+
+/*********************************************
+ *                  OUTPUT                    *
+ *********************************************/
+
+static FILE* Output;
+
+/* Largest ULP difference from the scalar build, by kind of function */
+enum
+{
+	EXACT = 0,          /* the SIMD path does the scalar operations in the scalar order */
+	ROUNDED = 8,        /* a few roundings differ: reciprocal square roots, horizontal adds */
+	ACCUMULATED = 64,   /* dot and matrix products, decompositions and reductions summed in another order */
+	SERIES = 1024,      /* long chains over accumulated results, such as the covariance eigenvectors */
+	TOLERANCE = 1 << 20 /* solvers that stop on a tolerance and inverse projection near the far plane */
+};
+
+static void begin(const char* Name, unsigned int Ulp)
+{
+	fputc('F', Output);
+	fwrite(Name, 1, strlen(Name) + 1, Output);
+	fwrite(&Ulp, 4, 1, Output);
+	Seed = 12345u;
+}
+
+/* Components of one vector or matrix, compared against the largest of them */
+static void out_group(const float* Values, int Count)
+{
+	fputc('v', Output);
+	fputc(Count, Output);
+	fwrite(Values, 4, Count, Output);
+}
+
+static void out_f(float Value) { out_group(&Value, 1); }
+static void out_i(int Value) { fputc('i', Output); fwrite(&Value, 4, 1, Output); }
+static void out_d(double Value) { out_f((float)Value); }
+static void out_u(uint Value) { out_i((int)Value); }
+static void out_b(bool Value) { out_i(Value ? 1 : 0); }
+static void out_floats(const float* Values, int Count) { for (int i = 0; i < Count; ++i) out_f(Values[i]); }
+static void out_ints(const int* Values, int Count) { for (int i = 0; i < Count; ++i) out_i(Values[i]); }
+static void out_v2(svec2 v) { out_group(v.e, 2); }
+static void out_v3(svec3 v) { out_group(v.e, 3); }
+static void out_v4(svec4 v) { out_group(v.e, 4); }
+static void out_q(squat q) { out_group(q.e, 4); }
+static void out_m4(smat4 m) { out_group(m.e, 16); }
+static void out_m34(smat3x4 m) { out_group(m.e, 12); }
+
+#define OUT(x) _Generic((x), \
+	float: out_f, double: out_d, int: out_i, uint: out_u, bool: out_b, \
+	svec2: out_v2, svec3: out_v3, svec4: out_v4, squat: out_q, smat4: out_m4, smat3x4: out_m34)(x)
+
+/* One call per case, arguments are drawn left to right */
+#define CHECK0(Fn, Ulp) \
+	begin(#Fn, Ulp); for (Case = 0; Case < CASES; ++Case) { Draw = 0; OUT(Fn()); }
+#define CHECK1(Fn, Ulp, A) \
+	begin(#Fn, Ulp); for (Case = 0; Case < CASES; ++Case) { Draw = 0; A a = gen_##A(); OUT(Fn(a)); }
+#define CHECK2(Fn, Ulp, A, B) \
+	begin(#Fn, Ulp); for (Case = 0; Case < CASES; ++Case) { Draw = 0; A a = gen_##A(); B b = gen_##B(); OUT(Fn(a, b)); }
+#define CHECK3(Fn, Ulp, A, B, C) \
+	begin(#Fn, Ulp); for (Case = 0; Case < CASES; ++Case) { \
+		Draw = 0; A a = gen_##A(); B b = gen_##B(); C c = gen_##C(); OUT(Fn(a, b, c)); }
+#define CHECK4(Fn, Ulp, A, B, C, D) \
+	begin(#Fn, Ulp); for (Case = 0; Case < CASES; ++Case) { \
+		Draw = 0; A a = gen_##A(); B b = gen_##B(); C c = gen_##C(); D d = gen_##D(); OUT(Fn(a, b, c, d)); }
+#define CHECK5(Fn, Ulp, A, B, C, D, E) \
+	begin(#Fn, Ulp); for (Case = 0; Case < CASES; ++Case) { \
+		Draw = 0; A a = gen_##A(); B b = gen_##B(); C c = gen_##C(); D d = gen_##D(); E e = gen_##E(); OUT(Fn(a, b, c, d, e)); }
+#define CHECK6(Fn, Ulp, A, B, C, D, E, F) \
+	begin(#Fn, Ulp); for (Case = 0; Case < CASES; ++Case) { \
+		Draw = 0; A a = gen_##A(); B b = gen_##B(); C c = gen_##C(); D d = gen_##D(); E e = gen_##E(); F f = gen_##F(); \
+		OUT(Fn(a, b, c, d, e, f)); }
+/* The first argument is passed by pointer and written back */
+#define CHECKP1(Fn, Ulp, A) \
+	begin(#Fn, Ulp); for (Case = 0; Case < CASES; ++Case) { Draw = 0; A a = gen_##A(); Fn(&a); OUT(a); }
+#define CHECKP2(Fn, Ulp, A, B) \
+	begin(#Fn, Ulp); for (Case = 0; Case < CASES; ++Case) { Draw = 0; A a = gen_##A(); B b = gen_##B(); OUT(Fn(&a, b)); OUT(a); }
+#define CHECKP2R(Fn, Ulp, A, B) \
+	begin(#Fn, Ulp); for (Case = 0; Case < CASES; ++Case) { Draw = 0; A a = gen_##A(); B b = gen_##B(); OUT(Fn(a, &b)); OUT(b); }
+
+/*********************************************
+ *              SCALAR FUNCTIONS              *
+ *********************************************/
+
+static void check_scalar(void)
+{
+	CHECK1(s_radian_to_degree, EXACT, float);
+	CHECK1(s_degree_to_radian, EXACT, float);
+	CHECK1(s_roundf, EXACT, float);
+	CHECK1(s_roundd, EXACT, double);
+	CHECK1(s_ceilf, EXACT, float);
+	CHECK1(s_ceild, EXACT, double);
+	CHECK1(s_floorf, EXACT, float);
+	CHECK1(s_floord, EXACT, double);
+	CHECK1(s_bgra_unpack, EXACT, int);
+	CHECK1(s_bgra_pack, EXACT, svec4);
+	CHECK1(s_rgba_unpack, EXACT, uint);
+	CHECK1(s_rgba_pack, EXACT, svec4);
+	CHECK3(s_clampf, EXACT, float, float, float);
+	CHECK3(s_clampd, EXACT, float, float, float);
+	CHECK3(s_clampi, EXACT, int, int, int);
+	CHECK1(s_clamp01f, EXACT, float);
+	CHECK1(s_clamp01d, EXACT, double);
+	CHECK1(s_clamp_above_zero, EXACT, float);
+	CHECK1(s_clamp_below_zero, EXACT, float);
+	CHECK3(s_is_in_range, EXACT, float, float, float);
+	CHECK3(s_lerp, EXACT, float, float, float);
+	CHECK1(s_square, EXACT, float);
+	CHECK1(s_abs, EXACT, float);
+	CHECK2(s_pythagorean, EXACT, float, float);
+	CHECK2(s_maxf, EXACT, float, float);
+	CHECK2(s_maxi, EXACT, int, int);
+	CHECK2(s_mini, EXACT, int, int);
+	CHECK2(s_minf, EXACT, float, float);
+	CHECK2(s_mod, EXACT, float, float);
+	CHECK2(s_pow, EXACT, float, float);
+	CHECK2(s_truncatef, EXACT, float, float);
+	CHECK2(s_truncated, EXACT, double, double);
+	CHECK3(s_normalize, EXACT, float, float, float);
+	CHECK5(s_map, EXACT, float, float, float, float, float);
+	CHECK1(s_rgb_to_hsv, EXACT, svec3);
+}
+
+/*********************************************
+ *                  VECTORS                   *
+ *********************************************/
+
+static void check_vec2(void)
+{
+	CHECK2(SVEC2, EXACT, float, float);
+	begin("SVEC2A", EXACT);
+	for (Case = 0; Case < CASES; ++Case) {
+		float a[2] = { gen_float(), gen_float() };
+		OUT(SVEC2A(a));
+	}
+	CHECKP1(s_vec2_zero, EXACT, svec2);
+	CHECK2(s_vec2_equal, EXACT, svec2, svec2);
+	CHECK2(s_vec2_equal_scalar, EXACT, svec2, float);
+	CHECK2(s_vec2_not_equal, EXACT, svec2, svec2);
+	CHECK2(s_vec2_not_equal_scalar, EXACT, svec2, float);
+	CHECK2(s_vec2_greater, EXACT, svec2, svec2);
+	CHECK2(s_vec2_greater_scalar, EXACT, svec2, float);
+	CHECK2(s_vec2_greater_equal, EXACT, svec2, svec2);
+	CHECK2(s_vec2_greater_equal_scalar, EXACT, svec2, float);
+	CHECK2(s_vec2_less, EXACT, svec2, svec2);
+	CHECK2(s_vec2_less_scalar, EXACT, svec2, float);
+	CHECK2(s_vec2_less_equal, EXACT, svec2, svec2);
+	CHECK2(s_vec2_less_equal_scalar, EXACT, svec2, float);
+	CHECK2(s_vec2_add, EXACT, svec2, svec2);
+	CHECKP2(s_vec2p_add, EXACT, svec2, svec2);
+	CHECK2(s_vec2_add_scalar, EXACT, svec2, float);
+	CHECKP2(s_vec2p_add_scalar, EXACT, svec2, float);
+	CHECK2(s_vec2_sub, EXACT, svec2, svec2);
+	CHECKP2(s_vec2p_sub, EXACT, svec2, svec2);
+	CHECK2(s_vec2_sub_scalar, EXACT, svec2, float);
+	CHECK2(s_scalar_sub_vec2, EXACT, float, svec2);
+	CHECKP2(s_vec2p_sub_scalar, EXACT, svec2, float);
+	CHECKP2R(s_scalar_sub_vec2p, EXACT, float, svec2);
+	CHECK2(s_vec2_mul, EXACT, svec2, svec2);
+	CHECKP2(s_vec2p_mul, EXACT, svec2, svec2);
+	CHECK2(s_vec2_mul_scalar, EXACT, svec2, float);
+	CHECKP2(s_vec2p_mul_scalar, EXACT, svec2, float);
+	CHECK2(s_vec2_div, EXACT, svec2, svec2);
+	CHECKP2(s_vec2p_div, EXACT, svec2, svec2);
+	CHECK2(s_vec2_div_scalar, EXACT, svec2, float);
+	CHECK2(s_scalar_div_vec2, EXACT, float, svec2);
+	CHECKP2(s_vec2p_div_scalar, EXACT, svec2, float);
+	CHECKP2R(s_scalar_div_vec2p, EXACT, float, svec2);
+	CHECK1(s_vec2_negate, EXACT, svec2);
+	CHECK1(s_vec2_floor, EXACT, svec2);
+	CHECK1(s_vec2_round, EXACT, svec2);
+	CHECK2(s_vec2_dot, EXACT, svec2, svec2);
+	CHECK2(s_vec2_hadamard, EXACT, svec2, svec2);
+	CHECK3(s_vec2_lerp, EXACT, svec2, svec2, float);
+	CHECK3(s_vec2_clamp, EXACT, svec2, svec2, svec2);
+	CHECK1(s_vec2_length, EXACT, svec2);
+	CHECK2(s_vec2_distance, EXACT, svec2, svec2);
+	CHECK1(s_vec2_normalize, EXACT, svec2);
+	CHECK2(s_vec2_reflect, EXACT, svec2, svec2);
+	CHECK2(s_vec2_project, EXACT, svec2, svec2);
+	CHECK2(s_vec2_max_vector, EXACT, svec2, svec2);
+	CHECK2(s_vec2_min_vector, EXACT, svec2, svec2);
+	CHECK1(s_vec2_max, EXACT, svec2);
+	CHECK1(s_vec2_min, EXACT, svec2);
+	CHECK1(s_vec2_sum, EXACT, svec2);
+	CHECK3(s_triangle_area, EXACT, svec2, svec2, svec2);
+}
+
+static void check_vec3(void)
+{
+	CHECK3(SVEC3, EXACT, float, float, float);
+	begin("SVEC3A", EXACT);
+	for (Case = 0; Case < CASES; ++Case) {
+		float a[3] = { gen_float(), gen_float(), gen_float() };
+		OUT(SVEC3A(a));
+	}
+	CHECKP1(s_vec3_zero, EXACT, svec3);
+	CHECK2(s_vec3_equal, EXACT, svec3, svec3);
+	CHECK2(s_vec3_equal_scalar, EXACT, svec3, float);
+	CHECK2(s_vec3_not_equal, EXACT, svec3, svec3);
+	CHECK2(s_vec3_not_equal_scalar, EXACT, svec3, float);
+	CHECK2(s_vec3_greater, EXACT, svec3, svec3);
+	CHECK2(s_vec3_less, EXACT, svec3, svec3);
+	CHECK2(s_vec3_less_scalar, EXACT, svec3, float);
+	CHECK2(s_vec3_greater_equal, EXACT, svec3, svec3);
+	CHECK2(s_vec3_greater_equal_scalar, EXACT, svec3, float);
+	CHECK2(s_vec3_less_equal, EXACT, svec3, svec3);
+	CHECK2(s_vec3_less_equal_scalar, EXACT, svec3, float);
+	CHECK2(s_vec3_add, EXACT, svec3, svec3);
+	CHECKP2(s_vec3p_add, EXACT, svec3, svec3);
+	CHECK2(s_vec3_add_scalar, EXACT, svec3, float);
+	CHECKP2(s_vec3p_add_scalar, EXACT, svec3, float);
+	CHECK2(s_vec3_sub, EXACT, svec3, svec3);
+	CHECKP2(s_vec3p_sub, EXACT, svec3, svec3);
+	CHECK2(s_vec3_sub_scalar, EXACT, svec3, float);
+	CHECKP2(s_vec3p_sub_saclar, EXACT, svec3, float);
+	CHECK2(s_scalar_sub_vec3, EXACT, float, svec3);
+	CHECKP2R(s_scalar_sub_vec3p, EXACT, float, svec3);
+	CHECK2(s_vec3_mul, EXACT, svec3, svec3);
+	CHECKP2(s_vec3p_mul, EXACT, svec3, svec3);
+	CHECK2(s_vec3_mul_scalar, EXACT, svec3, float);
+	CHECKP2(s_vec3p_mul_scalar, EXACT, svec3, float);
+	CHECK2(s_vec3_div, EXACT, svec3, svec3);
+	CHECKP2(s_vec3p_div, EXACT, svec3, svec3);
+	CHECK2(s_vec3_div_scalar, EXACT, svec3, float);
+	CHECKP2(s_vec3p_div_scalar, EXACT, svec3, float);
+	CHECK2(s_scalar_div_vec3, EXACT, float, svec3);
+	CHECKP2R(s_scalar_div_vec3p, EXACT, float, svec3);
+	CHECK1(s_vec3_floor, EXACT, svec3);
+	CHECK1(s_vec3_round, EXACT, svec3);
+	CHECK1(s_vec3_negate, EXACT, svec3);
+	CHECK2(s_vec3_dot, EXACT, svec3, svec3);
+	CHECK2(s_vec3_hadamard, EXACT, svec3, svec3);
+	CHECK1(s_vec3_length, EXACT, svec3);
+	CHECK2(s_vec3_distance, EXACT, svec3, svec3);
+	CHECK1(s_vec3_normalize, EXACT, svec3);
+	CHECK1(s_vec3_max, EXACT, svec3);
+	CHECK1(s_vec3_min, EXACT, svec3);
+	CHECK1(s_vec3_min_value, EXACT, svec3);
+	CHECK1(s_vec3_sum, EXACT, svec3);
+	CHECK2(s_vec3_max_vector, EXACT, svec3, svec3);
+	CHECK2(s_vec3_min_vector, EXACT, svec3, svec3);
+	CHECK3(s_vec3_clamp, EXACT, svec3, svec3, svec3);
+	CHECK3(s_vec3_lerp, EXACT, svec3, svec3, float);
+	CHECK2(s_vec3_project, EXACT, svec3, svec3);
+	CHECK2(s_vec3_cross, EXACT, svec3, svec3);
+	CHECK2(Slope, EXACT, svec3, svec3);
+}
+
+static void check_vec4(void)
+{
+	CHECK4(SVEC4, EXACT, float, float, float, float);
+	begin("SVEC4A", EXACT);
+	for (Case = 0; Case < CASES; ++Case) {
+		float a[4] = { gen_float(), gen_float(), gen_float(), gen_float() };
+		OUT(SVEC4A(a));
+	}
+	CHECK2(SVEC4VF, EXACT, svec3, float);
+	CHECKP1(s_vector4_zero, EXACT, svec4);
+	CHECK2(s_vec4_equal, EXACT, svec4, svec4);
+	CHECK2(s_vec4_equal_scalar, EXACT, svec4, float);
+	CHECK2(s_vec4_not_equal, EXACT, svec4, svec4);
+	CHECK2(s_vec4_not_equal_scalar, EXACT, svec4, float);
+	CHECK2(s_vec4_greater, EXACT, svec4, svec4);
+	CHECK2(s_vec4_less, EXACT, svec4, svec4);
+	CHECK2(s_vec4_less_scalar, EXACT, svec4, float);
+	CHECK2(s_vec4_greater_equal, EXACT, svec4, svec4);
+	CHECK2(s_vec4_greater_equal_scalar, EXACT, svec4, float);
+	CHECK2(s_vec4_less_equal, EXACT, svec4, svec4);
+	CHECK2(s_vec4_less_equal_scalar, EXACT, svec4, float);
+	CHECK2(s_vec4_add, EXACT, svec4, svec4);
+	CHECKP2(s_vec4p_add, EXACT, svec4, svec4);
+	CHECK2(s_vec4_add_scalar, EXACT, svec4, float);
+	CHECKP2(s_vec4p_add_scalar, EXACT, svec4, float);
+	CHECK2(s_vec4_sub, EXACT, svec4, svec4);
+	CHECKP2(s_vec4p_sub, EXACT, svec4, svec4);
+	CHECK2(s_vec4_sub_scalar, EXACT, svec4, float);
+	CHECKP2(s_vec4p_sub_scalar, EXACT, svec4, float);
+	CHECK2(s_scalar_vec4_sub, EXACT, float, svec4);
+	CHECKP2R(s_scalar_sub_vec4p, EXACT, float, svec4);
+	CHECK2(s_vec4_mul, EXACT, svec4, svec4);
+	CHECKP2(s_vec4p_mul, EXACT, svec4, svec4);
+	CHECK2(s_vec4_mul_scalar, EXACT, svec4, float);
+	CHECKP2(s_vec4p_mul_scalar, EXACT, svec4, float);
+	CHECK2(s_vec4_div, EXACT, svec4, svec4);
+	CHECKP2(s_vec4p_div, EXACT, svec4, svec4);
+	CHECK2(s_vec4_div_scalar, EXACT, svec4, float);
+	CHECKP2(s_vec4p_div_scalar, EXACT, svec4, float);
+	CHECK1(s_vec4_floor, EXACT, svec4);
+	CHECK1(s_vec4_round, EXACT, svec4);
+	CHECK1(s_vec4_negate, EXACT, svec4);
+	CHECK2(s_vec4_dot, ACCUMULATED, svec4, svec4);
+	CHECK2(s_vec4_hadamard, EXACT, svec4, svec4);
+	CHECK1(s_vec4_length, ROUNDED, svec4);
+	CHECK2(s_vec4_distance, ROUNDED, svec4, svec4);
+	CHECK1(s_vec4_normalize, ROUNDED, svec4);
+	CHECK3(s_vec4_lerp, EXACT, svec4, svec4, float);
+	CHECK2(s_vec4_cross, EXACT, svec4, svec4);
+	CHECK2(s_vec4_project, ACCUMULATED, svec4, svec4);
+	CHECK2(s_vec4_max_vector, EXACT, svec4, svec4);
+	CHECK2(s_vec4_min_vector, EXACT, svec4, svec4);
+	CHECK3(s_vec4_clamp, EXACT, svec4, svec4, svec4);
+	CHECK1(s_vec4_max, EXACT, svec4);
+	CHECK1(s_vec4_min, EXACT, svec4);
+	CHECK1(s_vec4_sum, EXACT, svec4);
+}
+
+/*********************************************
+ *                  MATRICES                  *
+ *********************************************/
+
+static void check_matrix(void)
+{
+	CHECK1(SMAT4, EXACT, float);
+	begin("SMAT4F", EXACT);
+	for (Case = 0; Case < CASES; ++Case) {
+		float m[16];
+		for (int i = 0; i < 16; ++i)
+			m[i] = gen_float();
+		OUT(SMAT4F(m[0], m[1], m[2], m[3], m[4], m[5], m[6], m[7], m[8], m[9], m[10], m[11], m[12], m[13], m[14], m[15]));
+	}
+	begin("SMAT4A", EXACT);
+	for (Case = 0; Case < CASES; ++Case) {
+		float m[16];
+		for (int i = 0; i < 16; ++i)
+			m[i] = gen_float();
+		OUT(SMAT4A(m));
+	}
+	CHECKP1(s_mat4_zero, EXACT, smat4);
+	CHECK0(s_mat4_identity, EXACT);
+	CHECKP1(s_mat4_identityp, EXACT, smat4);
+	begin("s_mat4_is_identity", EXACT);
+	for (Case = 0; Case < CASES; ++Case) {
+		smat4 m = (Case & 1) ? gen_smat4() : s_mat4_identity();
+		OUT(s_mat4_is_identity(m));
+	}
+	CHECK2(s_mat4_mul, ACCUMULATED, smat4, smat4);
+	CHECK1(s_mat4_transpose, EXACT, smat4);
+	begin("s_mat4_inverse_noscale", ACCUMULATED);
+	for (Case = 0; Case < CASES; ++Case)
+		OUT(s_mat4_inverse_noscale(s_mat4_from_mat3x4(gen_rigid())));
+	CHECK2(s_mat4_transform, ACCUMULATED, smat4, svec4);
+	CHECK2(s_mat4_mul_vec4, ACCUMULATED, smat4, svec4);
+	CHECK2(s_mat4_mul_vec3, ACCUMULATED, smat4, svec3);
+	CHECK2(s_mat4_translate, EXACT, smat4, svec3);
+	CHECK2(s_mat4_scale, EXACT, smat4, svec3);
+	begin("s_mat4_rotate", EXACT);
+	for (Case = 0; Case < CASES; ++Case) {
+		Draw = 0;
+		smat4 m = gen_smat4();
+		float Angle = gen_float();
+		OUT(s_mat4_rotate(&m, Angle, gen_svec3()));
+	}
+	CHECK1(s_mat4_xrotation, EXACT, float);
+	CHECK1(s_mat4_yrotation, EXACT, float);
+	CHECK1(s_mat4_zrotation, EXACT, float);
+	CHECK1(s_mat4_translation, EXACT, svec3);
+	begin("s_mat4_perspective_projection_rh", EXACT);
+	for (Case = 0; Case < CASES; ++Case)
+		OUT(s_mat4_perspective_projection_rh(next_float(0.2f, 2.5f), next_float(0.5f, 3.0f), next_float(0.01f, 1.0f), next_float(10.0f, 1000.0f)));
+	CHECK6(s_mat4_ortho_rh, EXACT, float, float, float, float, float, float);
+	CHECK0(s_mat3x4_identity, EXACT);
+	CHECK1(s_mat3x4_from_mat4, EXACT, smat4);
+	CHECK1(s_mat4_from_mat3x4, EXACT, smat3x4);
+	CHECK2(s_mat3x4_mul, ACCUMULATED, smat3x4, smat3x4);
+	begin("s_mat3x4_mul_array", EXACT);
+	{
+		static smat3x4 A[ARRAY_COUNT], B[ARRAY_COUNT], Out[ARRAY_COUNT];
+		for (int i = 0; i < ARRAY_COUNT; ++i) {
+			A[i] = gen_smat3x4();
+			B[i] = gen_smat3x4();
+		}
+		s_mat3x4_mul_array(A, B, Out, ARRAY_COUNT);
+		for (int i = 0; i < ARRAY_COUNT; ++i)
+			OUT(Out[i]);
+	}
+	begin("s_mat3x4_inverse", ACCUMULATED);
+	for (Case = 0; Case < CASES; ++Case) {
+		smat3x4 m = gen_rigid();
+		float Scale = next_float(0.5f, 2.0f);
+		for (int i = 0; i < 12; ++i)
+			m.e[i] *= (i % 4 != 3) ? Scale : 1.0f;
+		OUT(s_mat3x4_inverse(m));
+	}
+	CHECK2(s_mat3x4_transform_point, ACCUMULATED, smat3x4, svec3);
+	CHECK2(s_mat3x4_transform_vector, EXACT, smat3x4, svec3);
+
+	begin("s_mat4_decompose", ACCUMULATED);
+	for (Case = 0; Case < CASES; ++Case) {
+		stransform t = s_mat4_decompose(s_mat4_from_trs(gen_svec3(), gen_squat(), SVEC3(next_float(0.1f, 3.0f), next_float(0.1f, 3.0f), next_float(0.1f, 3.0f))));
+		OUT(t.Translation);
+		OUT(t.Rotation);
+		OUT(t.Scale);
+	}
+	begin("s_mat4_from_trs", ACCUMULATED);
+	for (Case = 0; Case < CASES; ++Case)
+		OUT(s_mat4_from_trs(gen_svec3(), gen_squat(), gen_svec3()));
+	{
+		static stransform T[ARRAY_COUNT], D[ARRAY_COUNT];
+		static smat4 M[ARRAY_COUNT], I[ARRAY_COUNT];
+		begin("s_mat4_from_trs_array", ACCUMULATED);
+		for (int i = 0; i < ARRAY_COUNT; ++i) {
+			T[i].Translation = gen_svec3();
+			T[i].Rotation = gen_squat();
+			T[i].Scale = SVEC3(next_float(0.1f, 3.0f), next_float(0.1f, 3.0f), next_float(0.1f, 3.0f));
+		}
+		s_mat4_from_trs_array(T, M, I, ARRAY_COUNT);
+		for (int i = 0; i < ARRAY_COUNT; ++i) {
+			OUT(M[i]);
+			OUT(I[i]);
+		}
+		begin("s_mat4_decompose_array", ACCUMULATED);
+		s_mat4_decompose_array(M, D, ARRAY_COUNT);
+		for (int i = 0; i < ARRAY_COUNT; ++i) {
+			OUT(D[i].Translation);
+			OUT(D[i].Rotation);
+			OUT(D[i].Scale);
+		}
+	}
+}
+
+/*********************************************
+ *               ARRAY KERNELS                *
+ *********************************************/
+
+static void check_projection(void)
+{
+	static svec3 P[ARRAY_COUNT], S[ARRAY_COUNT], W[ARRAY_COUNT];
+	static unsigned char Clipped[ARRAY_COUNT];
+	smat4 Projection = s_mat4_perspective_projection_rh(1.0f, 16.0f / 9.0f, 0.1f, 100.0f);
+	smat4 View, ViewProjection;
+	sviewport Viewport = { 10.0f, 20.0f, 1920.0f, 1080.0f, 0.0f, 1.0f };
+	int i;
+
+	Seed = 4040u;
+	View = s_mat4_from_trs(SVEC3(1.0f, -2.0f, -3.0f), gen_squat(), SVEC3(1.0f, 1.0f, 1.0f));
+	ViewProjection = s_mat4_mul(Projection, View);
+	for (i = 0; i < ARRAY_COUNT; ++i)
+		P[i] = SVEC3(next_float(-20.0f, 20.0f), next_float(-20.0f, 20.0f), next_float(-20.0f, 20.0f));
+
+	begin("s_project_points", ACCUMULATED);
+	OUT(s_project_points(ViewProjection, Viewport, P, S, Clipped, ARRAY_COUNT));
+	for (i = 0; i < ARRAY_COUNT; ++i) {
+		OUT((int)Clipped[i]);
+		if (!Clipped[i])
+			OUT(S[i]);
+	}
+	begin("s_unproject_points", TOLERANCE);
+	OUT(s_unproject_points(ViewProjection, Viewport, S, W, Clipped, ARRAY_COUNT));
+	for (i = 0; i < ARRAY_COUNT; ++i) {
+		OUT((int)Clipped[i]);
+		if (!Clipped[i])
+			OUT(W[i]);
+	}
+}
+
+static void check_quantization(void)
+{
+	static float F[ARRAY_COUNT], Back[ARRAY_COUNT];
+	static unsigned char U8[ARRAY_COUNT];
+	static signed char S8[ARRAY_COUNT];
+	static unsigned short U16[3 * ARRAY_COUNT];
+	static short S16[ARRAY_COUNT];
+	static svec4 V4[ARRAY_COUNT], V4Back[ARRAY_COUNT];
+	static svec3 V3[ARRAY_COUNT], V3Back[ARRAY_COUNT];
+	static unsigned int Packed[ARRAY_COUNT];
+	int i;
+
+	Seed = 777u;
+	fill(F, ARRAY_COUNT, -1.25f, 1.25f);
+	F[0] = 0.0f;
+	F[1] = 1.0f;
+	F[2] = -1.0f;
+	F[3] = 0.5f;
+
+	begin("s_pack_unorm8", EXACT);
+	s_pack_unorm8(F, U8, ARRAY_COUNT);
+	for (i = 0; i < ARRAY_COUNT; ++i)
+		OUT((int)U8[i]);
+	begin("s_unpack_unorm8", EXACT);
+	s_unpack_unorm8(U8, Back, ARRAY_COUNT);
+	out_floats(Back, ARRAY_COUNT);
+	begin("s_pack_snorm8", EXACT);
+	s_pack_snorm8(F, S8, ARRAY_COUNT);
+	for (i = 0; i < ARRAY_COUNT; ++i)
+		OUT((int)S8[i]);
+	begin("s_unpack_snorm8", EXACT);
+	s_unpack_snorm8(S8, Back, ARRAY_COUNT);
+	out_floats(Back, ARRAY_COUNT);
+	begin("s_pack_unorm16", EXACT);
+	s_pack_unorm16(F, U16, ARRAY_COUNT);
+	for (i = 0; i < ARRAY_COUNT; ++i)
+		OUT((int)U16[i]);
+	begin("s_unpack_unorm16", EXACT);
+	s_unpack_unorm16(U16, Back, ARRAY_COUNT);
+	out_floats(Back, ARRAY_COUNT);
+	begin("s_pack_snorm16", EXACT);
+	s_pack_snorm16(F, S16, ARRAY_COUNT);
+	for (i = 0; i < ARRAY_COUNT; ++i)
+		OUT((int)S16[i]);
+	begin("s_unpack_snorm16", EXACT);
+	s_unpack_snorm16(S16, Back, ARRAY_COUNT);
+	out_floats(Back, ARRAY_COUNT);
+
+	for (i = 0; i < ARRAY_COUNT; ++i)
+		V4[i] = SVEC4(next_float(-1.25f, 1.25f), next_float(-1.25f, 1.25f), next_float(-1.25f, 1.25f), next_float(-1.25f, 1.25f));
+	begin("s_vec4_pack_unorm1010102", EXACT);
+	s_vec4_pack_unorm1010102(V4, Packed, ARRAY_COUNT);
+	for (i = 0; i < ARRAY_COUNT; ++i)
+		OUT(Packed[i]);
+	begin("s_vec4_unpack_unorm1010102", EXACT);
+	s_vec4_unpack_unorm1010102(Packed, V4Back, ARRAY_COUNT);
+	for (i = 0; i < ARRAY_COUNT; ++i)
+		OUT(V4Back[i]);
+	begin("s_vec4_pack_snorm1010102", EXACT);
+	s_vec4_pack_snorm1010102(V4, Packed, ARRAY_COUNT);
+	for (i = 0; i < ARRAY_COUNT; ++i)
+		OUT(Packed[i]);
+	begin("s_vec4_unpack_snorm1010102", EXACT);
+	s_vec4_unpack_snorm1010102(Packed, V4Back, ARRAY_COUNT);
+	for (i = 0; i < ARRAY_COUNT; ++i)
+		OUT(V4Back[i]);
+
+	for (i = 0; i < ARRAY_COUNT; ++i)
+		V3[i] = SVEC3(next_float(-50.0f, 50.0f), next_float(0.0f, 10.0f), 3.0f);
+	begin("s_quant_range_from_aabb", EXACT);
+	for (Case = 0; Case < CASES; ++Case) {
+		squant_range r = s_quant_range_from_aabb(gen_svec3(), gen_svec3());
+		OUT(r.Scale);
+		OUT(r.Offset);
+	}
+	begin("s_quant_range_from_points", EXACT);
+	squant_range Range = s_quant_range_from_points(V3, ARRAY_COUNT);
+	OUT(Range.Scale);
+	OUT(Range.Offset);
+	begin("s_vec3_pack_position_unorm16", EXACT);
+	s_vec3_pack_position_unorm16(V3, U16, ARRAY_COUNT, Range);
+	for (i = 0; i < 3 * ARRAY_COUNT; ++i)
+		OUT((int)U16[i]);
+	begin("s_vec3_unpack_position_unorm16", EXACT);
+	s_vec3_unpack_position_unorm16(U16, V3Back, ARRAY_COUNT, Range);
+	for (i = 0; i < ARRAY_COUNT; ++i)
+		OUT(V3Back[i]);
+}
+
+static void check_vector_arrays(void)
+{
+	static svec3 A3[ARRAY_COUNT], B3[ARRAY_COUNT], O3[ARRAY_COUNT];
+	static svec4 A4[ARRAY_COUNT], B4[ARRAY_COUNT], O4[ARRAY_COUNT];
+	static float X[8][ARRAY_COUNT], O[4][ARRAY_COUNT], Out[ARRAY_COUNT];
+	int i, k, Precise;
+
+	Seed = 999u;
+	for (i = 0; i < ARRAY_COUNT; ++i) {
+		A3[i] = SVEC3(next_float(-10.0f, 10.0f), next_float(-10.0f, 10.0f), next_float(-10.0f, 10.0f));
+		B3[i] = SVEC3(next_float(-10.0f, 10.0f), next_float(-10.0f, 10.0f), next_float(-10.0f, 10.0f));
+		A4[i] = SVEC4(next_float(-10.0f, 10.0f), next_float(-10.0f, 10.0f), next_float(-10.0f, 10.0f), next_float(-10.0f, 10.0f));
+		B4[i] = SVEC4(next_float(-10.0f, 10.0f), next_float(-10.0f, 10.0f), next_float(-10.0f, 10.0f), next_float(-10.0f, 10.0f));
+	}
+	A3[5] = SVEC3(0.0f, 0.0f, 0.0f);
+	A4[5] = SVEC4(0.0f, 0.0f, 0.0f, 0.0f);
+	for (k = 0; k < 8; ++k)
+		fill(X[k], ARRAY_COUNT, -10.0f, 10.0f);
+
+	for (Precise = 0; Precise < 2; ++Precise) {
+		begin(Precise ? "s_vec3_normalize_array precise" : "s_vec3_normalize_array", Precise ? EXACT : ROUNDED);
+		s_vec3_normalize_array(A3, O3, ARRAY_COUNT, Precise);
+		for (i = 0; i < ARRAY_COUNT; ++i)
+			OUT(O3[i]);
+		begin(Precise ? "s_vec3_length_array precise" : "s_vec3_length_array", Precise ? EXACT : ROUNDED);
+		s_vec3_length_array(A3, Out, ARRAY_COUNT, Precise);
+		out_floats(Out, ARRAY_COUNT);
+		begin(Precise ? "s_vec4_normalize_array precise" : "s_vec4_normalize_array", Precise ? EXACT : ROUNDED);
+		s_vec4_normalize_array(A4, O4, ARRAY_COUNT, Precise);
+		for (i = 0; i < ARRAY_COUNT; ++i)
+			OUT(O4[i]);
+		begin(Precise ? "s_vec4_length_array precise" : "s_vec4_length_array", Precise ? EXACT : ROUNDED);
+		s_vec4_length_array(A4, Out, ARRAY_COUNT, Precise);
+		out_floats(Out, ARRAY_COUNT);
+		begin(Precise ? "s_vec3_normalize_soa precise" : "s_vec3_normalize_soa", Precise ? EXACT : ROUNDED);
+		s_vec3_normalize_soa(X[0], X[1], X[2], O[0], O[1], O[2], ARRAY_COUNT, Precise);
+		for (k = 0; k < 3; ++k)
+			out_floats(O[k], ARRAY_COUNT);
+		begin(Precise ? "s_vec3_length_soa precise" : "s_vec3_length_soa", Precise ? EXACT : ROUNDED);
+		s_vec3_length_soa(X[0], X[1], X[2], Out, ARRAY_COUNT, Precise);
+		out_floats(Out, ARRAY_COUNT);
+		begin(Precise ? "s_vec4_normalize_soa precise" : "s_vec4_normalize_soa", Precise ? EXACT : ROUNDED);
+		s_vec4_normalize_soa(X[0], X[1], X[2], X[3], O[0], O[1], O[2], O[3], ARRAY_COUNT, Precise);
+		for (k = 0; k < 4; ++k)
+			out_floats(O[k], ARRAY_COUNT);
+		begin(Precise ? "s_vec4_length_soa precise" : "s_vec4_length_soa", Precise ? EXACT : ROUNDED);
+		s_vec4_length_soa(X[0], X[1], X[2], X[3], Out, ARRAY_COUNT, Precise);
+		out_floats(Out, ARRAY_COUNT);
+	}
+	begin("s_vec3_dot_array", EXACT);
+	s_vec3_dot_array(A3, B3, Out, ARRAY_COUNT);
+	out_floats(Out, ARRAY_COUNT);
+	begin("s_vec4_dot_array", EXACT);
+	s_vec4_dot_array(A4, B4, Out, ARRAY_COUNT);
+	out_floats(Out, ARRAY_COUNT);
+	begin("s_vec3_dot_soa", EXACT);
+	s_vec3_dot_soa(X[0], X[1], X[2], X[3], X[4], X[5], Out, ARRAY_COUNT);
+	out_floats(Out, ARRAY_COUNT);
+	begin("s_vec4_dot_soa", EXACT);
+	s_vec4_dot_soa(X[0], X[1], X[2], X[3], X[4], X[5], X[6], X[7], Out, ARRAY_COUNT);
+	out_floats(Out, ARRAY_COUNT);
+}
+
+/* Reductions over every length up to a few blocks, so the tails are covered */
+static void check_reductions(void)
+{
+	static svec2 V2[ARRAY_COUNT];
+	static svec3 V3[ARRAY_COUNT];
+	static svec4 V4[ARRAY_COUNT];
+	static float Weights[ARRAY_COUNT];
+	svec2 Minvec2, Maxvec2;
+	svec3 Minvec3, Maxvec3;
+	svec4 Minvec4, Maxvec4;
+	int i;
+
+	Seed = 4242u;
+	for (i = 0; i < ARRAY_COUNT; ++i) {
+		V2[i] = SVEC2(next_float(-10.0f, 10.0f), next_float(-10.0f, 10.0f));
+		V3[i] = SVEC3(next_float(-10.0f, 10.0f), next_float(-10.0f, 10.0f), next_float(-10.0f, 10.0f));
+		V4[i] = SVEC4(next_float(-10.0f, 10.0f), next_float(-10.0f, 10.0f), next_float(-10.0f, 10.0f), next_float(-10.0f, 10.0f));
+		Weights[i] = next_float(0.0f, 2.0f);
+	}
+
+#define CHECK_REDUCE(N, V) \
+	begin("s_" #N "_min_array", EXACT); \
+	for (i = 0; i <= 40; ++i) \
+		OUT(s_##N##_min_array(V, i < 40 ? i : ARRAY_COUNT)); \
+	begin("s_" #N "_max_array", EXACT); \
+	for (i = 0; i <= 40; ++i) \
+		OUT(s_##N##_max_array(V, i < 40 ? i : ARRAY_COUNT)); \
+	begin("s_" #N "_sum_array", ACCUMULATED); \
+	for (i = 0; i <= 40; ++i) \
+		OUT(s_##N##_sum_array(V, i < 40 ? i : ARRAY_COUNT)); \
+	begin("s_" #N "_mean_array", ACCUMULATED); \
+	for (i = 0; i <= 40; ++i) \
+		OUT(s_##N##_mean_array(V, i < 40 ? i : ARRAY_COUNT)); \
+	begin("s_" #N "_centroid_array", ACCUMULATED); \
+	for (i = 0; i <= 40; ++i) \
+		OUT(s_##N##_centroid_array(V, Weights, i < 40 ? i : ARRAY_COUNT)); \
+	begin("s_" #N "_bounds_array", EXACT); \
+	for (i = 0; i <= 40; ++i) { \
+		s_##N##_bounds_array(V, i < 40 ? i : ARRAY_COUNT, &Min##N, &Max##N); \
+		OUT(Min##N); \
+		OUT(Max##N); \
+	}
+	CHECK_REDUCE(vec2, V2)
+	CHECK_REDUCE(vec3, V3)
+	CHECK_REDUCE(vec4, V4)
+#undef CHECK_REDUCE
+}
+
+/*********************************************
+ *            PARTICLES AND NOISE             *
+ *********************************************/
+
+static void check_particles(void)
+{
+	static float Arrays[11][ARRAY_COUNT];
+	sparticle_forces Forces = { { { 0.0f, -9.81f, 0.0f } }, { { 1.0f, 0.0f, 0.5f } }, 0.3f };
+	svec3 KillMin[2] = { { { -1.0f, -1.0f, -1.0f } }, { { 3.0f, -10.0f, -10.0f } } };
+	svec3 KillMax[2] = { { { 1.0f, 1.0f, 1.0f } }, { { 10.0f, 10.0f, 10.0f } } };
+	sparticles P;
+	int Step, k;
+
+	for (int Verlet = 0; Verlet < 2; ++Verlet) {
+		Seed = 4242u;
+		for (k = 0; k < 11; ++k)
+			fill(Arrays[k], ARRAY_COUNT, -5.0f, 5.0f);
+		for (k = 0; k < ARRAY_COUNT; ++k) {
+			Arrays[9][k] = next_float(0.0f, 1.0f);
+			Arrays[10][k] = next_float(0.5f, 2.0f);
+		}
+		P.PosX = Arrays[0]; P.PosY = Arrays[1]; P.PosZ = Arrays[2];
+		P.VelX = Arrays[3]; P.VelY = Arrays[4]; P.VelZ = Arrays[5];
+		P.PrevX = Arrays[6]; P.PrevY = Arrays[7]; P.PrevZ = Arrays[8];
+		P.Age = Arrays[9];
+		P.Lifetime = Arrays[10];
+		P.Count = ARRAY_COUNT;
+
+		begin(Verlet ? "s_particles_integrate_verlet" : "s_particles_integrate_euler", EXACT);
+		for (Step = 0; Step < 8; ++Step) {
+			if (Verlet)
+				s_particles_integrate_verlet(&P, 0, P.Count, Forces, 1.0f / 60.0f);
+			else
+				s_particles_integrate_euler(&P, 0, P.Count, Forces, 1.0f / 60.0f);
+		}
+		for (k = 0; k < 11; ++k)
+			out_floats(Arrays[k], ARRAY_COUNT);
+	}
+
+	begin("s_particles_compact", EXACT);
+	OUT(s_particles_compact(&P, KillMin, KillMax, 2));
+	OUT(P.Count);
+	for (k = 0; k < 11; ++k)
+		out_floats(Arrays[k], P.Count);
+}
+
+static void check_noise(void)
+{
+	static float X[4][ARRAY_COUNT], Out[4][ARRAY_COUNT];
+	snoise_fbm Fbm = { 4, 0.7f, 2.0f, 0.5f, false };
+	snoise_fbm Ridged = { 3, 1.3f, 2.1f, 0.6f, true };
+	const snoise_fbm* Settings[3] = { NULL, &Fbm, &Ridged };
+	int s, k;
+
+	Seed = 31337u;
+	for (k = 0; k < 4; ++k)
+		fill(X[k], ARRAY_COUNT, -40.0f, 40.0f);
+	X[0][0] = X[1][0] = X[2][0] = X[3][0] = 0.0f;
+
+	CHECK2(s_noise_perlin2, EXACT, svec2, int);
+	CHECK2(s_noise_perlin3, EXACT, svec3, int);
+	CHECK2(s_noise_perlin4, EXACT, svec4, int);
+	CHECK2(s_noise_simplex2, EXACT, svec2, int);
+	CHECK2(s_noise_simplex3, EXACT, svec3, int);
+	CHECK2(s_noise_simplex4, EXACT, svec4, int);
+
+#define CHECK_NOISE(Name, Call, Outputs) \
+	begin(Name, EXACT); \
+	for (s = 0; s < 3; ++s) { \
+		Call; \
+		for (k = 0; k < Outputs; ++k) \
+			out_floats(Out[k], ARRAY_COUNT); \
+	}
+	CHECK_NOISE("s_noise_perlin2_array", s_noise_perlin2_array(X[0], X[1], Out[0], ARRAY_COUNT, 7, Settings[s]), 1)
+	CHECK_NOISE("s_noise_perlin3_array", s_noise_perlin3_array(X[0], X[1], X[2], Out[0], ARRAY_COUNT, 7, Settings[s]), 1)
+	CHECK_NOISE("s_noise_perlin4_array", s_noise_perlin4_array(X[0], X[1], X[2], X[3], Out[0], ARRAY_COUNT, 7, Settings[s]), 1)
+	CHECK_NOISE("s_noise_simplex2_array", s_noise_simplex2_array(X[0], X[1], Out[0], ARRAY_COUNT, 7, Settings[s]), 1)
+	CHECK_NOISE("s_noise_simplex3_array", s_noise_simplex3_array(X[0], X[1], X[2], Out[0], ARRAY_COUNT, 7, Settings[s]), 1)
+	CHECK_NOISE("s_noise_simplex4_array", s_noise_simplex4_array(X[0], X[1], X[2], X[3], Out[0], ARRAY_COUNT, 7, Settings[s]), 1)
+	CHECK_NOISE("s_noise_perlin2_deriv_array", s_noise_perlin2_deriv_array(X[0], X[1], Out[0], Out[1], Out[2], ARRAY_COUNT, 7, Settings[s]), 3)
+	CHECK_NOISE("s_noise_perlin3_deriv_array",
+		s_noise_perlin3_deriv_array(X[0], X[1], X[2], Out[0], Out[1], Out[2], Out[3], ARRAY_COUNT, 7, Settings[s]), 4)
+	CHECK_NOISE("s_noise_simplex2_deriv_array", s_noise_simplex2_deriv_array(X[0], X[1], Out[0], Out[1], Out[2], ARRAY_COUNT, 7, Settings[s]), 3)
+	CHECK_NOISE("s_noise_simplex3_deriv_array",
+		s_noise_simplex3_deriv_array(X[0], X[1], X[2], Out[0], Out[1], Out[2], Out[3], ARRAY_COUNT, 7, Settings[s]), 4)
+#undef CHECK_NOISE
+
+	/* 37 x 29 and 13 x 11 x 7 grids, neither is a multiple of a block */
+	begin("s_noise_perlin2_grid", EXACT);
+	s_noise_perlin2_grid(Out[0], 37, 29, SVEC2(-3.2f, 1.7f), 0.13f, 3, &Fbm);
+	out_floats(Out[0], 37 * 29);
+	begin("s_noise_simplex2_grid", EXACT);
+	s_noise_simplex2_grid(Out[0], 37, 29, SVEC2(-3.2f, 1.7f), 0.13f, 3, &Fbm);
+	out_floats(Out[0], 37 * 29);
+	begin("s_noise_perlin3_grid", EXACT);
+	s_noise_perlin3_grid(Out[0], 13, 11, 7, SVEC3(0.4f, -2.0f, 5.5f), 0.21f, 3, NULL);
+	out_floats(Out[0], 13 * 11 * 7);
+	begin("s_noise_simplex3_grid", EXACT);
+	s_noise_simplex3_grid(Out[0], 13, 11, 7, SVEC3(0.4f, -2.0f, 5.5f), 0.21f, 3, NULL);
+	out_floats(Out[0], 13 * 11 * 7);
+}
+
+static void check_random(void)
+{
+	static unsigned int U[ARRAY_COUNT];
+	static float F[3][ARRAY_COUNT];
+	static squat Q[ARRAY_COUNT];
+	srand_state State;
+	int i, k;
+
+#define CHECK_RAND(Name, Call, Outputs) \
+	begin(Name, EXACT); \
+	s_rand_init(&State, 0x1234abcdull); \
+	Call; \
+	for (k = 0; k < Outputs; ++k) \
+		out_floats(F[k], ARRAY_COUNT);
+	begin("s_rand_init", EXACT);
+	s_rand_init(&State, 0x1234abcdull);
+	out_ints((const int*)State.S, 4 * _SYL_RAND_LANES);
+	begin("s_rand_jump", EXACT);
+	s_rand_jump(&State);
+	out_ints((const int*)State.S, 4 * _SYL_RAND_LANES);
+	begin("s_rand_uint", EXACT);
+	s_rand_init(&State, 0x1234abcdull);
+	s_rand_uint(&State, U, ARRAY_COUNT);
+	for (i = 0; i < ARRAY_COUNT; ++i)
+		OUT(U[i]);
+	CHECK_RAND("s_rand_float", s_rand_float(&State, F[0], ARRAY_COUNT), 1)
+	CHECK_RAND("s_rand_unit_disk", s_rand_unit_disk(&State, F[0], F[1], ARRAY_COUNT), 2)
+	CHECK_RAND("s_rand_unit_sphere", s_rand_unit_sphere(&State, F[0], F[1], F[2], ARRAY_COUNT), 3)
+	CHECK_RAND("s_rand_hemisphere", s_rand_hemisphere(&State, F[0], F[1], F[2], ARRAY_COUNT), 3)
+	CHECK_RAND("s_rand_cosine_hemisphere", s_rand_cosine_hemisphere(&State, F[0], F[1], F[2], ARRAY_COUNT), 3)
+#undef CHECK_RAND
+	begin("s_rand_rotation", EXACT);
+	s_rand_init(&State, 0x1234abcdull);
+	s_rand_rotation(&State, Q, ARRAY_COUNT);
+	for (i = 0; i < ARRAY_COUNT; ++i)
+		OUT(Q[i]);
+}
+
+/*********************************************
+ *           SPLINES AND ANIMATION            *
+ *********************************************/
+
+static void check_spline(void)
+{
+	static svec4 Points[40];
+	static float T[ARRAY_COUNT], Distance[ARRAY_COUNT], OutT[ARRAY_COUNT];
+	static float Pos[4 * ARRAY_COUNT], Tangent[4 * ARRAY_COUNT], Table[257];
+	const char* Names[4] = { "catmull rom", "bezier", "hermite", "bspline" };
+	char Name[96];
+	int Type, Dims, i;
+
+	Seed = 2024u;
+	for (i = 0; i < 40; ++i)
+		Points[i] = SVEC4(next_float(-10.0f, 10.0f), next_float(-10.0f, 10.0f), next_float(-10.0f, 10.0f), next_float(-10.0f, 10.0f));
+	fill(T, ARRAY_COUNT, -0.1f, 1.1f);
+	for (i = 0; i < 64; ++i)
+		T[i] = i / 63.0f;
+
+	for (Type = 0; Type < 4; ++Type) {
+		for (Dims = 2; Dims <= 4; ++Dims) {
+			sspline Spline = Dims == 2 ? s_spline_vec2((const svec2*)Points, 40, (sspline_type)Type) :
+				(Dims == 3 ? s_spline_vec3((const svec3*)Points, 40, (sspline_type)Type) : s_spline_vec4(Points, 40, (sspline_type)Type));
+			float Length;
+
+			snprintf(Name, sizeof(Name), "s_spline_eval %s vec%d", Names[Type], Dims);
+			begin(Name, EXACT);
+			OUT(s_spline_segments(&Spline));
+			s_spline_eval(&Spline, T, ARRAY_COUNT, Pos, Tangent);
+			out_floats(Pos, Dims * ARRAY_COUNT);
+			out_floats(Tangent, Dims * ARRAY_COUNT);
+
+			snprintf(Name, sizeof(Name), "s_spline_build_arclength %s vec%d", Names[Type], Dims);
+			begin(Name, EXACT);
+			Length = s_spline_build_arclength(&Spline, Table, 257);
+			OUT(Length);
+			out_floats(Table, 257);
+
+			snprintf(Name, sizeof(Name), "s_spline_distance_to_t %s vec%d", Names[Type], Dims);
+			begin(Name, EXACT);
+			for (i = 0; i < ARRAY_COUNT; ++i)
+				Distance[i] = next_float(-0.1f, 1.1f) * Length;
+			s_spline_distance_to_t(Table, 257, Distance, OutT, ARRAY_COUNT);
+			out_floats(OutT, ARRAY_COUNT);
+
+			snprintf(Name, sizeof(Name), "s_spline_sample_constant_speed %s vec%d", Names[Type], Dims);
+			begin(Name, EXACT);
+			s_spline_sample_constant_speed(&Spline, Table, 257, ARRAY_COUNT, Pos, Tangent);
+			out_floats(Pos, Dims * ARRAY_COUNT);
+			out_floats(Tangent, Dims * ARRAY_COUNT);
+		}
+	}
+}
+
+static void check_animation(void)
+{
+	enum { TRACKS = 37, KEYS = 9 };
+	static float Times[KEYS], Vectors[TRACKS][3 * KEYS], Rotations[TRACKS][4 * KEYS];
+	static strack Vec[TRACKS], Rot[TRACKS], Scale[TRACKS];
+	static svec3 V[TRACKS];
+	static squat Q[TRACKS];
+	static stransform Transforms[TRACKS];
+	int i, k;
+
+	Seed = 55u;
+	for (k = 0; k < KEYS; ++k)
+		Times[k] = k * 0.25f + (k > 4 ? 0.1f : 0.0f);
+	for (i = 0; i < TRACKS; ++i) {
+		fill(Vectors[i], 3 * KEYS, -3.0f, 3.0f);
+		for (k = 0; k < KEYS; ++k) {
+			squat q = gen_squat();
+			memcpy(Rotations[i] + 4 * k, q.e, sizeof(q.e));
+		}
+	}
+
+	begin("s_track", EXACT);
+	for (i = 0; i < TRACKS; ++i) {
+		strack t = s_track(Times, Vectors[i], 1 + i % KEYS);
+		OUT(t.KeyCount);
+		OUT(t.Cursor);
+	}
+
+	begin("s_tracks_sample_vec3", EXACT);
+	for (i = 0; i < TRACKS; ++i)
+		Vec[i] = s_track(Times, Vectors[i], 1 + i % KEYS);
+	for (k = 0; k < 40; ++k) {
+		s_tracks_sample_vec3(Vec, TRACKS, k * 0.06f - 0.1f, V, 0);
+		for (i = 0; i < TRACKS; ++i)
+			OUT(V[i]);
+	}
+	begin("s_tracks_sample_quat", ROUNDED);
+	for (i = 0; i < TRACKS; ++i)
+		Rot[i] = s_track(Times, Rotations[i], KEYS);
+	for (k = 0; k < 40; ++k) {
+		s_tracks_sample_quat(Rot, TRACKS, 2.2f - k * 0.06f, Q, 0);
+		for (i = 0; i < TRACKS; ++i)
+			OUT(Q[i]);
+	}
+	begin("s_tracks_sample_transforms", ROUNDED);
+	for (i = 0; i < TRACKS; ++i) {
+		Vec[i] = s_track(Times, Vectors[i], KEYS);
+		Rot[i] = s_track(Times, Rotations[i], KEYS);
+		Scale[i] = s_track(Times, Vectors[(i + 1) % TRACKS], KEYS);
+	}
+	for (k = 0; k < 40; ++k) {
+		s_tracks_sample_transforms(Vec, Rot, Scale, TRACKS, k * 0.05f, Transforms);
+		for (i = 0; i < TRACKS; ++i) {
+			OUT(Transforms[i].Translation);
+			OUT(Transforms[i].Rotation);
+			OUT(Transforms[i].Scale);
+		}
+	}
+}
+
+/*********************************************
+ *                  SPATIAL                   *
+ *********************************************/
+
+enum { CLOUD = 4099, QUERIES = 257, CAPACITY = 64, PAIRS = 1 << 16 };
+
+static svec3 Cloud[CLOUD], Queries[QUERIES];
+static int Index[QUERIES * CAPACITY], Found[QUERIES];
+
+/* The same points and queries for every structure */
+static void gen_cloud(void)
+{
+	int i;
+	Seed = 8086u;
+	for (i = 0; i < CLOUD; ++i)
+		Cloud[i] = SVEC3(next_float(0.0f, 20.0f), next_float(0.0f, 20.0f), next_float(0.0f, 5.0f));
+	for (i = 0; i < QUERIES; ++i)
+		Queries[i] = SVEC3(next_float(-1.0f, 21.0f), next_float(-1.0f, 21.0f), next_float(-1.0f, 6.0f));
+}
+
+static int compare_int(const void* a, const void* b)
+{
+	return(*(const int*)a < *(const int*)b ? -1 : *(const int*)a > *(const int*)b);
+}
+
+/* Radius queries return indices in no particular order */
+static void out_sorted(int* Values, int Count)
+{
+	Count = Count < CAPACITY ? Count : CAPACITY;
+	qsort(Values, Count, sizeof(int), compare_int);
+	out_ints(Values, Count);
+}
+
+static void check_kdtree(void)
+{
+	enum { K = 7 };
+	static float DistanceSq[QUERIES * K];
+	void* Memory = malloc(s_kdtree_memory_size(CLOUD));
+	skdtree Tree;
+	int q;
+
+	gen_cloud();
+	s_kdtree_build(&Tree, Memory, Cloud, CLOUD);
+
+	begin("s_kdtree_nearest", EXACT);
+	for (q = 0; q < QUERIES; ++q) {
+		int n = s_kdtree_nearest(&Tree, Queries[q], K, Index, DistanceSq);
+		OUT(n);
+		out_ints(Index, n);
+		out_floats(DistanceSq, n);
+	}
+	begin("s_kdtree_radius", EXACT);
+	for (q = 0; q < QUERIES; ++q) {
+		int n = s_kdtree_radius(&Tree, Queries[q], 0.6f, Index, NULL, CAPACITY);
+		OUT(n);
+		out_sorted(Index, n);
+	}
+	begin("s_kdtree_nearest_batch", EXACT);
+	s_kdtree_nearest_batch(&Tree, Queries, QUERIES, K, Index, DistanceSq);
+	out_ints(Index, QUERIES * K);
+	out_floats(DistanceSq, QUERIES * K);
+	begin("s_kdtree_radius_batch", EXACT);
+	s_kdtree_radius_batch(&Tree, Queries, QUERIES, 0.6f, Index, NULL, CAPACITY, Found);
+	for (q = 0; q < QUERIES; ++q) {
+		OUT(Found[q]);
+		out_sorted(Index + q * CAPACITY, Found[q]);
+	}
+	free(Memory);
+}
+
+static spair Pairs[PAIRS];
+
+static int compare_pair(const void* a, const void* b)
+{
+	const spair* p = (const spair*)a;
+	const spair* q = (const spair*)b;
+	if (p->A != q->A)
+		return(p->A < q->A ? -1 : 1);
+	return(p->B < q->B ? -1 : p->B > q->B);
+}
+
+/* Pairs come in no particular order, they are written sorted with the lower index first */
+static void out_pairs(int Count)
+{
+	for (int i = 0; i < Count; ++i) {
+		if (Pairs[i].A > Pairs[i].B) {
+			int t = Pairs[i].A;
+			Pairs[i].A = Pairs[i].B;
+			Pairs[i].B = t;
+		}
+	}
+	qsort(Pairs, Count, sizeof(spair), compare_pair);
+	OUT(Count);
+	out_ints((const int*)Pairs, 2 * Count);
+}
+
+static void check_hashgrid(void)
+{
+	void* Memory = malloc(s_hashgrid_memory_size(CLOUD));
+	shashgrid Grid;
+	int q;
+
+	gen_cloud();
+	s_hashgrid_build(&Grid, Memory, Cloud, CLOUD, 0.6f);
+
+	begin("s_hashgrid_radius", EXACT);
+	for (q = 0; q < QUERIES; ++q) {
+		int n = s_hashgrid_radius(&Grid, Queries[q], 0.6f, Index, CAPACITY);
+		OUT(n);
+		out_sorted(Index, n);
+	}
+	begin("s_hashgrid_pairs", EXACT);
+	out_pairs(s_hashgrid_pairs(&Grid, 0.6f, 0, CLOUD, Pairs, PAIRS));
+	free(Memory);
+}
+
+static void check_sap(void)
+{
+	static svec3 Min[CLOUD], Max[CLOUD];
+	void* Memory = malloc(s_sap_memory_size(CLOUD));
+	ssap Sap;
+	int i;
+
+	gen_cloud();
+	for (i = 0; i < CLOUD; ++i) {
+		Min[i] = s_vec3_sub_scalar(Cloud[i], next_float(0.05f, 0.4f));
+		Max[i] = s_vec3_add_scalar(Cloud[i], next_float(0.05f, 0.4f));
+	}
+	s_sap_init(&Sap, Memory, CLOUD);
+	s_sap_update(&Sap, Min, Max);
+
+	begin("s_sap_pairs", EXACT);
+	out_pairs(s_sap_pairs(&Sap, 0, CLOUD, Pairs, PAIRS));
+	for (i = 0; i < CLOUD; ++i) {
+		svec3 Move = SVEC3(next_float(-0.2f, 0.2f), next_float(-0.2f, 0.2f), next_float(-0.2f, 0.2f));
+		Min[i] = s_vec3_add(Min[i], Move);
+		Max[i] = s_vec3_add(Max[i], Move);
+	}
+	begin("s_sap_update", EXACT);
+	s_sap_update(&Sap, Min, Max);
+	out_pairs(s_sap_pairs(&Sap, 0, CLOUD, Pairs, PAIRS));
+	free(Memory);
+}
+
+/*********************************************
+ *                 COLLISION                  *
+ *********************************************/
+
+static svec3 custom_support(svec3 Direction, const void* UserData)
+{
+	float Size = *(const float*)UserData;
+	return(SVEC3(Direction.x < 0.0f ? -Size : Size, Direction.y < 0.0f ? -Size : Size, Direction.z < 0.0f ? -0.5f * Size : 0.5f * Size));
+}
+
+static sconvex gen_convex(const svec3* Hull, int HullCount, const float* Size)
+{
+	sconvex Shape;
+	memset(&Shape, 0, sizeof(Shape));
+	Shape.Type = (sconvex_type)(next_uint() % 5);
+	Shape.Transform = gen_rigid();
+	Shape.Extents = SVEC3(next_float(0.2f, 1.5f), next_float(0.2f, 1.5f), next_float(0.2f, 1.5f));
+	Shape.Radius = Shape.Type == S_CONVEX_SPHERE || Shape.Type == S_CONVEX_CAPSULE ? next_float(0.2f, 1.0f) : 0.0f;
+	Shape.HalfHeight = next_float(0.1f, 1.0f);
+	Shape.Points = Hull;
+	Shape.PointCount = HullCount;
+	Shape.Support = custom_support;
+	Shape.UserData = Size;
+	return(Shape);
+}
+
+static void out_gjk(bool Hit, const sgjk_result* Result)
+{
+	OUT(Hit);
+	OUT(Result->Intersect);
+	OUT(Result->Distance);
+	OUT(Result->Depth);
+	OUT(Result->Normal);
+	OUT(Result->PointA);
+	OUT(Result->PointB);
+}
+
+static void check_gjk(void)
+{
+	enum { HULL = 29 };
+	static svec3 Hull[HULL];
+	float Size = 0.7f;
+	int i;
+
+	Seed = 1999u;
+	for (i = 0; i < HULL; ++i)
+		Hull[i] = SVEC3(next_float(-1.0f, 1.0f), next_float(-1.0f, 1.0f), next_float(-1.0f, 1.0f));
+
+	begin("s_convex_support", ROUNDED);
+	for (Case = 0; Case < CASES; ++Case) {
+		sconvex Shape = gen_convex(Hull, HULL, &Size);
+		OUT(s_convex_support(&Shape, gen_svec3()));
+	}
+	begin("s_gjk_intersect", EXACT);
+	for (Case = 0; Case < CASES; ++Case) {
+		sconvex A = gen_convex(Hull, HULL, &Size), B = gen_convex(Hull, HULL, &Size);
+		OUT(s_gjk_intersect(&A, &B, NULL));
+	}
+	begin("s_gjk_distance", TOLERANCE);
+	for (Case = 0; Case < CASES; ++Case) {
+		sconvex A = gen_convex(Hull, HULL, &Size), B = gen_convex(Hull, HULL, &Size);
+		sgjk_result Result;
+		bool Hit = s_gjk_distance(&A, &B, NULL, &Result);
+		out_gjk(Hit, &Result);
+	}
+	begin("s_gjk_penetration", TOLERANCE);
+	for (Case = 0; Case < CASES; ++Case) {
+		sconvex A = gen_convex(Hull, HULL, &Size), B = gen_convex(Hull, HULL, &Size);
+		sgjk_result Result;
+		bool Hit = s_gjk_penetration(&A, &B, NULL, &Result);
+		out_gjk(Hit, &Result);
+	}
+}
+
+static void check_obb(void)
+{
+	enum { BOXES = 1031 };
+	static sobb Boxes[BOXES];
+	static svec3 Normals[BOXES];
+	static int Hits[BOXES];
+	static float Depth[BOXES];
+	void* Memory = malloc(s_obb_soa_memory_size(BOXES));
+	sobb_soa Soa;
+	int i, k;
+
+	Seed = 2001u;
+	begin("s_obb_from_quat", EXACT);
+	for (i = 0; i < BOXES; ++i) {
+		Boxes[i] = s_obb_from_quat(SVEC3(next_float(-4.0f, 4.0f), next_float(-4.0f, 4.0f), next_float(-4.0f, 4.0f)),
+			SVEC3(next_float(0.1f, 1.5f), next_float(0.1f, 1.5f), next_float(0.1f, 1.5f)), gen_squat());
+		OUT(Boxes[i].Center);
+		OUT(Boxes[i].Extents);
+		for (k = 0; k < 3; ++k)
+			OUT(Boxes[i].Axes[k]);
+	}
+	begin("s_obb_overlap_batch", EXACT);
+	s_obb_soa_build(&Soa, Memory, Boxes, BOXES);
+	for (i = 0; i < 64; ++i) {
+		int n = s_obb_overlap_batch(&Boxes[i], &Soa, i % 5, BOXES - i % 7, Hits, Normals, Depth, BOXES);
+		OUT(n);
+		out_ints(Hits, n);
+		for (k = 0; k < n; ++k)
+			OUT(Normals[k]);
+		out_floats(Depth, n);
+	}
+	free(Memory);
+}
+
+static void check_contacts(void)
+{
+	enum { COUNT = 1031 };
+	static float Arrays[14][COUNT], Contacts[7][COUNT];
+	int i, k;
+
+	Seed = 2003u;
+	for (k = 0; k < 14; ++k)
+		fill(Arrays[k], COUNT, -2.0f, 2.0f);
+	for (i = 0; i < COUNT; ++i) {
+		Arrays[6][i] = next_float(0.1f, 1.0f);
+		Arrays[13][i] = next_float(0.1f, 1.0f);
+	}
+	/* Coincident centers and segments */
+	for (k = 0; k < 6; ++k)
+		Arrays[7 + k][0] = Arrays[k][0];
+
+	ssphere_soa SA = { Arrays[0], Arrays[1], Arrays[2], Arrays[6] };
+	ssphere_soa SB = { Arrays[7], Arrays[8], Arrays[9], Arrays[13] };
+	scapsule_soa CA = { Arrays[0], Arrays[1], Arrays[2], Arrays[3], Arrays[4], Arrays[5], Arrays[6] };
+	scapsule_soa CB = { Arrays[7], Arrays[8], Arrays[9], Arrays[10], Arrays[11], Arrays[12], Arrays[13] };
+	scontact_soa Out = { Contacts[0], Contacts[1], Contacts[2], Contacts[3], Contacts[4], Contacts[5], Contacts[6] };
+
+	begin("s_sphere_sphere_batch", EXACT);
+	OUT(s_sphere_sphere_batch(&SA, &SB, 0, COUNT, &Out));
+	for (k = 0; k < 7; ++k)
+		out_floats(Contacts[k], COUNT);
+	begin("s_sphere_capsule_batch", EXACT);
+	OUT(s_sphere_capsule_batch(&SA, &CB, 0, COUNT, &Out));
+	for (k = 0; k < 7; ++k)
+		out_floats(Contacts[k], COUNT);
+	begin("s_capsule_capsule_batch", EXACT);
+	OUT(s_capsule_capsule_batch(&CA, &CB, 0, COUNT, &Out));
+	for (k = 0; k < 7; ++k)
+		out_floats(Contacts[k], COUNT);
+}
+
+/*********************************************
+ *              MESH AND BOUNDS               *
+ *********************************************/
+
+static void check_mesh(void)
+{
+	enum { SIDE = 23, VERTICES = SIDE * SIDE, TRIANGLES = 2 * (SIDE - 1) * (SIDE - 1) };
+	static svec3 Positions[VERTICES], Normals[VERTICES];
+	static svec2 UVs[VERTICES];
+	static svec4 Tangents[VERTICES];
+	static unsigned int Indices[3 * TRIANGLES];
+	smesh_adjacency Adjacency;
+	void *Memory, *Scratch;
+	int x, y, t = 0, Shared;
+
+	Seed = 6502u;
+	for (y = 0; y < SIDE; ++y) {
+		for (x = 0; x < SIDE; ++x) {
+			Positions[y * SIDE + x] = SVEC3((float)x, next_float(-0.5f, 0.5f), (float)y);
+			UVs[y * SIDE + x] = SVEC2(x / (SIDE - 1.0f) * (y > SIDE / 2 ? -1.0f : 1.0f), y / (SIDE - 1.0f));
+		}
+	}
+	for (y = 0; y + 1 < SIDE; ++y) {
+		for (x = 0; x + 1 < SIDE; ++x) {
+			unsigned int v = (unsigned int)(y * SIDE + x);
+			Indices[t++] = v; Indices[t++] = v + SIDE; Indices[t++] = v + 1;
+			Indices[t++] = v + 1; Indices[t++] = v + SIDE; Indices[t++] = v + SIDE + 1;
+		}
+	}
+
+	Memory = malloc(s_mesh_adjacency_memory_size(VERTICES, TRIANGLES));
+	Scratch = malloc(s_mesh_scratch_size(TRIANGLES));
+	begin("s_mesh_adjacency_build", EXACT);
+	s_mesh_adjacency_build(&Adjacency, Memory, Indices, VERTICES, TRIANGLES);
+	out_ints(Adjacency.Offsets, VERTICES + 1);
+	out_ints(Adjacency.Triangles, 3 * TRIANGLES);
+
+	for (Shared = 0; Shared < 2; ++Shared) {
+		begin(Shared ? "s_mesh_normals adjacency" : "s_mesh_normals", ROUNDED);
+		s_mesh_normals(Positions, Indices, VERTICES, TRIANGLES, Shared ? &Adjacency : NULL, Shared ? Scratch : NULL, Normals);
+		for (x = 0; x < VERTICES; ++x)
+			OUT(Normals[x]);
+		begin(Shared ? "s_mesh_tangents adjacency" : "s_mesh_tangents", ROUNDED);
+		s_mesh_tangents(Positions, Normals, UVs, Indices, VERTICES, TRIANGLES, Shared ? &Adjacency : NULL, Shared ? Scratch : NULL, Tangents);
+		for (x = 0; x < VERTICES; ++x)
+			OUT(Tangents[x]);
+	}
+	free(Memory);
+	free(Scratch);
+}
+
+static void check_bounds(void)
+{
+	enum { COUNT = 1031 };
+	static svec3 Points[COUNT];
+	int Set, n, k;
+
+	for (Set = 0; Set < 3; ++Set) {
+		Seed = 77u + Set;
+		for (n = 0; n < COUNT; ++n) {
+			svec3 p = SVEC3(next_float(-1.0f, 1.0f), next_float(-1.0f, 1.0f), next_float(-1.0f, 1.0f));
+			if (Set == 1)
+				p = SVEC3(p.x * 5.0f + p.y, p.y * 0.5f, p.z * 0.1f + p.x);
+			if (Set == 2)
+				p = s_vec3_add(s_vec3_mul_scalar(p, 0.01f), SVEC3(1000.0f, -20.0f, 3.0f));
+			Points[n] = p;
+		}
+		begin(Set == 0 ? "s_bounding_sphere" : (Set == 1 ? "s_bounding_sphere flat" : "s_bounding_sphere far"), EXACT);
+		for (n = 1; n <= COUNT; n += 97) {
+			ssphere s = s_bounding_sphere(Points, n, 4);
+			OUT(s.Center);
+			OUT(s.Radius);
+		}
+		begin(Set == 0 ? "s_bounding_obb" : (Set == 1 ? "s_bounding_obb flat" : "s_bounding_obb far"), SERIES);
+		for (n = 1; n <= COUNT; n += 97) {
+			sobb b = s_bounding_obb(Points, n);
+			OUT(b.Center);
+			OUT(b.Extents);
+			for (k = 0; k < 3; ++k)
+				OUT(b.Axes[k]);
+		}
+	}
+}
+
+/*********************************************
+ *                  COMPARE                   *
+ *********************************************/
+
+typedef struct result
+{
+	char Name[96];
+	unsigned int Bound;
+	double MaxUlp;
+	float MaxAbs;
+	int Mismatches;
+	int NaNs;
+	int Values;
+} result;
+
+/* Spacing of floats at the magnitude of Scale */
+static double ulp_size(float Scale)
+{
+	int Exponent;
+	if (!(Scale > 1.17549435e-38f))
+		return(1.40129846e-45);
+	frexpf(Scale, &Exponent);
+	return(ldexp(1.0, Exponent - 24));
+}
+
+/* The difference of every component in ULPs of the largest component, so a lane that cancelled
+   to near zero is judged on the scale of the numbers it came from */
+static void compare_group(const float* A, const float* B, int Count, result* Result)
+{
+	float Scale = 0.0f;
+	int i;
+
+	for (i = 0; i < Count; ++i) {
+		float a = fabsf(A[i]), b = fabsf(B[i]);
+		if (a == a && a != INFINITY && a > Scale)
+			Scale = a;
+		if (b == b && b != INFINITY && b > Scale)
+			Scale = b;
+	}
+	for (i = 0; i < Count; ++i) {
+		double Ulp;
+		Result->Values++;
+		if (A[i] == B[i] || (A[i] != A[i] && B[i] != B[i]))
+			continue;
+		if (A[i] != A[i] || B[i] != B[i] || fabsf(A[i]) == INFINITY || fabsf(B[i]) == INFINITY) {
+			Result->NaNs++;
+			continue;
+		}
+		Ulp = fabs((double)A[i] - (double)B[i]) / ulp_size(Scale);
+		if (Ulp > Result->MaxUlp)
+			Result->MaxUlp = Ulp;
+		if (fabsf(A[i] - B[i]) > Result->MaxAbs)
+			Result->MaxAbs = fabsf(A[i] - B[i]);
+	}
+}
+
+static unsigned char* read_file(const char* Path, long* Size)
+{
+	FILE* File = fopen(Path, "rb");
+	unsigned char* Data;
+	if (!File)
+		return(NULL);
+	fseek(File, 0, SEEK_END);
+	*Size = ftell(File);
+	fseek(File, 0, SEEK_SET);
+	Data = (unsigned char*)malloc(*Size + 1);
+	if (fread(Data, 1, *Size, File) != (size_t)*Size) {
+		fclose(File);
+		free(Data);
+		return(NULL);
+	}
+	fclose(File);
+	return(Data);
+}
+
+/* Walks both files function by function, returns the number of functions or -1 when they don't line up */
+static int compare_files(const unsigned char* A, long SizeA, const unsigned char* B, long SizeB, result* Results, int Capacity)
+{
+	float GroupA[16], GroupB[16];
+	long a = 0, b = 0;
+	int Count = -1;
+
+	while (a < SizeA && b < SizeB) {
+		unsigned char TagA = A[a++], TagB = B[b++];
+		if (TagA != TagB)
+			return(-1);
+		if (TagA == 'F') {
+			const char* Name = (const char*)A + a;
+			long Length = (long)strlen(Name) + 1;
+			if (strcmp(Name, (const char*)B + b) != 0 || ++Count >= Capacity || a + Length + 4 > SizeA)
+				return(-1);
+			memset(&Results[Count], 0, sizeof(result));
+			snprintf(Results[Count].Name, sizeof(Results[Count].Name), "%s", Name);
+			memcpy(&Results[Count].Bound, A + a + Length, 4);
+			a += Length + 4;
+			b += Length + 4;
+			continue;
+		}
+		if (Count < 0)
+			return(-1);
+		if (TagA == 'v') {
+			int n = A[a];
+			if (n != B[b] || n > 16 || a + 1 + 4 * n > SizeA || b + 1 + 4 * n > SizeB)
+				return(-1);
+			memcpy(GroupA, A + a + 1, 4 * n);
+			memcpy(GroupB, B + b + 1, 4 * n);
+			compare_group(GroupA, GroupB, n, &Results[Count]);
+			a += 1 + 4 * n;
+			b += 1 + 4 * n;
+			continue;
+		}
+		if (TagA != 'i' || a + 4 > SizeA || b + 4 > SizeB)
+			return(-1);
+		Results[Count].Values++;
+		if (memcmp(A + a, B + b, 4) != 0)
+			Results[Count].Mismatches++;
+		a += 4;
+		b += 4;
+	}
+	return((a == SizeA && b == SizeB) ? Count + 1 : -1);
+}
+
+static int compare(int FileCount, char** Files)
+{
+	enum { MAX_FUNCTIONS = 1024 };
+	static result Results[8][MAX_FUNCTIONS];
+	unsigned char* Data[8];
+	long Size[8];
+	int Functions = 0, Failed = 0, f, i;
+
+	if (FileCount > 8)
+		FileCount = 8;
+	for (f = 0; f < FileCount; ++f) {
+		Data[f] = read_file(Files[f], &Size[f]);
+		if (!Data[f]) {
+			fprintf(stderr, "can't read %s\n", Files[f]);
+			return(2);
+		}
+	}
+	for (f = 1; f < FileCount; ++f) {
+		Functions = compare_files(Data[0], Size[0], Data[f], Size[f], Results[f], MAX_FUNCTIONS);
+		if (Functions < 0) {
+			fprintf(stderr, "%s and %s don't run the same functions\n", Files[0], Files[f]);
+			return(2);
+		}
+	}
+
+	printf("%-48s %8s", "function", "bound");
+	for (f = 1; f < FileCount; ++f)
+		printf(" %24s", Files[f]);
+	printf("\n");
+	for (i = 0; i < Functions; ++i) {
+		printf("%-48s %8u", Results[1][i].Name, Results[1][i].Bound);
+		for (f = 1; f < FileCount; ++f) {
+			const result* r = &Results[f][i];
+			char Cell[48];
+			if (r->Mismatches)
+				snprintf(Cell, sizeof(Cell), "%d/%d differ", r->Mismatches, r->Values);
+			else if (r->NaNs)
+				snprintf(Cell, sizeof(Cell), "%d/%d nan or inf", r->NaNs, r->Values);
+			else
+				snprintf(Cell, sizeof(Cell), "%.0f (%.2g)", ceil(r->MaxUlp), r->MaxAbs);
+			if (r->Mismatches || r->NaNs || r->MaxUlp > r->Bound) {
+				Failed++;
+				strcat(Cell, " !");
+			}
+			printf(" %24s", Cell);
+		}
+		printf("\n");
+	}
+	printf("%d functions, %d results past their bound or with differing integers\n", Functions, Failed);
+	for (f = 0; f < FileCount; ++f)
+		free(Data[f]);
+	return(Failed ? 1 : 0);
+}
+
+int main(int argc, char** argv)
+{
+	if (argc == 3 && strcmp(argv[1], "write") == 0) {
+		Output = fopen(argv[2], "wb");
+		if (!Output) {
+			fprintf(stderr, "can't write %s\n", argv[2]);
+			return(2);
+		}
+		check_scalar();
+		check_vec2();
+		check_vec3();
+		check_vec4();
+		check_matrix();
+		check_projection();
+		check_quantization();
+		check_vector_arrays();
+		check_reductions();
+		check_particles();
+		check_noise();
+		check_random();
+		check_spline();
+		check_animation();
+		check_kdtree();
+		check_hashgrid();
+		check_sap();
+		check_gjk();
+		check_obb();
+		check_contacts();
+		check_mesh();
+		check_bounds();
+		fclose(Output);
+		return(0);
+	}
+	if (argc >= 4 && strcmp(argv[1], "compare") == 0)
+		return(compare(argc - 2, argv + 2));
+	if (argc == 3 && strcmp(argv[1], "cpu") == 0) {
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+		__builtin_cpu_init();
+		if (strcmp(argv[2], "sse4") == 0)
+			return(__builtin_cpu_supports("sse4.1") ? 0 : 1);
+		if (strcmp(argv[2], "avx") == 0)
+			return((__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) ? 0 : 1);
+#endif
+		return(1);
+	}
+	fprintf(stderr, "usage: %s write <file>\n       %s compare <scalar> <file>...\n       %s cpu <sse4|avx>\n", argv[0], argv[0], argv[0]);
+	return(2);
+}
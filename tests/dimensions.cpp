@@ -0,0 +1,29 @@
+/* Compile-only check of the C++ operators, built by make -C tests check.
+   The file has to compile as is and has to fail with SYL_MISMATCH defined,
+   vectors of different sizes never mix, compound assignments included. */
+
+#include "sylvester.hpp"
+#include <string>
+
+using namespace syl;
+
+int main()
+{
+	vec3 A(1.0f, 2.0f, 3.0f), B(4.0f);
+	vec4 C(1.0f);
+
+	A += B * 2.0f;
+	A -= B - A;
+	A *= 0.5f;
+	C /= 2.0f;
+
+	/* Unrelated types still find their own operators */
+	std::string Text("syl");
+	Text += "vester";
+
+#ifdef SYL_MISMATCH
+	A += C;
+#endif
+
+	return((int)(A.x + C.x) + (int)Text.size());
+}